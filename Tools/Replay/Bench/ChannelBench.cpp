@@ -0,0 +1,177 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ChannelBench.cpp
+/// Description  :  Measures channel throughput and latency with one and eight consumers.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Services/DataLink/Channel.h"
+
+namespace
+{
+	constexpr const unsigned BENCH_CAPACITY = 4096;
+	constexpr const unsigned BENCH_RECORDS = 2000000;
+
+	/* about the size of a combat event */
+	struct Record
+	{
+		long long			Time;
+		unsigned long long	Payload[7];
+	};
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		double				WritesPerSec;
+		double				ReadsPerSec;		/* per consumer */
+		double				OverflowRatio;
+		double				DropRatio;
+		long long			LatencyMedian;
+		long long			LatencyP99;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Writes aRecords records from aProducers threads while aConsumers threads read them.
+	/// 	Every 64th record read is timed from its write.
+	///----------------------------------------------------------------------------------------------------
+	Result Run(unsigned aProducers, unsigned aConsumers, unsigned aRecords)
+	{
+		std::vector<unsigned long long> memory(Channel::GetSize(sizeof(Record), BENCH_CAPACITY) / sizeof(unsigned long long) + 8);
+		ChannelHeader* channel = reinterpret_cast<ChannelHeader*>((reinterpret_cast<uintptr_t>(memory.data()) + 63) & ~static_cast<uintptr_t>(63));
+		Channel::Initialize(channel, sizeof(Record), BENCH_CAPACITY, aProducers > 1);
+
+		std::atomic<bool> isWriting{ true };
+		std::atomic<unsigned> started{ 0 };
+
+		std::vector<int> consumers(aConsumers);
+		std::vector<unsigned long long> reads(aConsumers);
+		std::vector<std::vector<long long>> latencies(aConsumers);
+
+		for (unsigned c = 0; c < aConsumers; c++)
+		{
+			consumers[c] = Channel::Subscribe(channel);
+		}
+
+		std::vector<std::thread> readers;
+
+		for (unsigned c = 0; c < aConsumers; c++)
+		{
+			readers.emplace_back([&, c]()
+			{
+				Record record{};
+				started++;
+
+				while (true)
+				{
+					bool isLast = !isWriting;
+
+					if (Channel::Read(channel, consumers[c], &record))
+					{
+						if ((reads[c]++ & 63) == 0) { latencies[c].push_back(Now() - record.Time); }
+						continue;
+					}
+
+					if (isLast) { break; }
+					std::this_thread::yield();
+				}
+			});
+		}
+
+		while (started < aConsumers) { std::this_thread::yield(); }
+
+		long long start = Now();
+
+		std::vector<std::thread> writers;
+
+		for (unsigned p = 0; p < aProducers; p++)
+		{
+			writers.emplace_back([&]()
+			{
+				Record record{};
+
+				for (unsigned i = 0; i < aRecords / aProducers; i++)
+				{
+					record.Time = Now();
+					record.Payload[0] = i;
+					Channel::Write(channel, &record);
+
+					/* a game thread does other work between events */
+					if ((i & 255) == 255) { std::this_thread::yield(); }
+				}
+			});
+		}
+
+		for (std::thread& writer : writers) { writer.join(); }
+
+		long long written = Now() - start;
+		isWriting = false;
+
+		for (std::thread& reader : readers) { reader.join(); }
+
+		long long elapsed = Now() - start;
+
+		Result result{};
+		result.WritesPerSec = aRecords / (written / 1e9);
+
+		std::vector<long long> all;
+		unsigned long long overflows = 0;
+
+		for (unsigned c = 0; c < aConsumers; c++)
+		{
+			result.ReadsPerSec += reads[c] / (elapsed / 1e9) / aConsumers;
+			overflows += channel->Consumers[consumers[c]].Overflows;
+			all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+		}
+
+		result.OverflowRatio = static_cast<double>(overflows) / aConsumers / aRecords;
+		result.DropRatio = static_cast<double>(channel->Dropped) / aRecords;
+
+		if (!all.empty())
+		{
+			std::sort(all.begin(), all.end());
+			result.LatencyMedian = all[all.size() / 2];
+			result.LatencyP99 = all[all.size() * 99 / 100];
+		}
+
+		return result;
+	}
+
+	void Print(const char* aName, const Result& aResult)
+	{
+		printf("%-30s %12.2f %12.2f %10.2f%% %8.2f%% %12lld %12lld\n", aName,
+			aResult.WritesPerSec / 1e6, aResult.ReadsPerSec / 1e6, aResult.OverflowRatio * 100.0, aResult.DropRatio * 100.0,
+			aResult.LatencyMedian, aResult.LatencyP99);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned records = argc > 1 ? static_cast<unsigned>(atoi(argv[1])) : BENCH_RECORDS;
+
+	printf("%u records of %zu bytes, %u slots, %u hardware threads.\n\n", records, sizeof(Record), BENCH_CAPACITY, std::thread::hardware_concurrency());
+	printf("%-30s %12s %12s %11s %9s %12s %12s\n", "Setup", "Mwrites/s", "Mreads/s", "overflowed", "dropped", "median ns", "p99 ns");
+
+	Print("1 producer, 1 consumer", Run(1, 1, records));
+	Print("1 producer, 8 consumers", Run(1, 8, records));
+	Print("4 producers, 1 consumer", Run(4, 1, records));
+	Print("4 producers, 8 consumers", Run(4, 8, records));
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatchBench.cpp
+/// Description  :  Replays a recording through CEventApi::Raise to per-event and to batched subscribers.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Consts.h"
+#include "Shared.h"
+#include "Events/CombatBatchApi.h"
+#include "Events/EventHandler.h"
+#include "Services/Recorder/Recorder.h"
+#include "Services/Recorder/Recording.h"
+#include "Services/Watchdog/CallbackWatchdog.h"
+
+namespace
+{
+	constexpr const int BENCH_MAX_SUBSCRIBERS = 8;
+
+	long long Damage[BENCH_MAX_SUBSCRIBERS];
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/* what a DPS meter does with an event, one callback per addon */
+	template <int N>
+	void ConsumeEvent(void* aEventArgs)
+	{
+		const EvCombatData* combatData = (const EvCombatData*)aEventArgs;
+
+		if (combatData->Event && !combatData->Event->IsStateChange && !combatData->Event->Buff)
+		{
+			Damage[N] += combatData->Event->Value;
+		}
+	}
+
+	template <int N>
+	void ConsumeBatch(const CombatBatch* aBatch)
+	{
+		long long damage = 0;
+
+		for (uint32_t i = 0; i < aBatch->Count; i++)
+		{
+			if (!aBatch->IsStateChange[i] && !aBatch->Buff[i])
+			{
+				damage += aBatch->Value[i];
+			}
+		}
+
+		Damage[N] += damage;
+	}
+
+	const EVENT_CONSUME EventCallbacks[BENCH_MAX_SUBSCRIBERS] = {
+		ConsumeEvent<0>, ConsumeEvent<1>, ConsumeEvent<2>, ConsumeEvent<3>,
+		ConsumeEvent<4>, ConsumeEvent<5>, ConsumeEvent<6>, ConsumeEvent<7>
+	};
+
+	const EVENT_CONSUME_COMBATBATCH BatchCallbacks[BENCH_MAX_SUBSCRIBERS] = {
+		ConsumeBatch<0>, ConsumeBatch<1>, ConsumeBatch<2>, ConsumeBatch<3>,
+		ConsumeBatch<4>, ConsumeBatch<5>, ConsumeBatch<6>, ConsumeBatch<7>
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Combat Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Combat
+	{
+		const char*									Identifier;
+		EvCombatData*								Data;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Frame Struct
+	/// 	The combat events that arrived before the frame.
+	///----------------------------------------------------------------------------------------------------
+	struct Frame
+	{
+		size_t										Begin;
+		size_t										End;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Load:
+	/// 	Reads the whole recording, so decoding is not part of the measurement.
+	///----------------------------------------------------------------------------------------------------
+	bool Load(const char* aPath, CRecordingReader& aReader, std::vector<RecordedEvent>& aOutEvents, std::vector<Combat>& aOutCombat, std::vector<Frame>& aOutFrames)
+	{
+		if (!aReader.Open(aPath)) { return false; }
+
+		while (const RecordedEvent* ev = aReader.Next())
+		{
+			if (ev->Type == ERecordType::Frame || ev->Type == ERecordType::Combat)
+			{
+				aOutEvents.push_back(*ev);
+			}
+		}
+
+		size_t begin = 0;
+
+		/* the copies point into themselves, the names stay in the reader */
+		for (RecordedEvent& ev : aOutEvents)
+		{
+			if (ev.Type == ERecordType::Frame)
+			{
+				aOutFrames.push_back({ begin, aOutCombat.size() });
+				begin = aOutCombat.size();
+				continue;
+			}
+
+			ev.CombatData.Event = ev.CombatData.Event ? &ev.Event : nullptr;
+			ev.CombatData.Source = ev.CombatData.Source ? &ev.Source : nullptr;
+			ev.CombatData.Destination = ev.CombatData.Destination ? &ev.Destination : nullptr;
+
+			const char* identifier = ev.Stream == ECombatStream::Squad ? EV_ARCDPS_COMBATEVENT_SQUAD_RAW : EV_ARCDPS_COMBATEVENT_LOCAL_RAW;
+			aOutCombat.push_back({ identifier, &ev.CombatData });
+		}
+
+		aOutFrames.push_back({ begin, aOutCombat.size() });
+
+		return !aReader.IsCorrupt();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		long long									ArcTime;		/* raising, on the ArcDPS thread */
+		long long									RenderTime;		/* flushing, on the render thread */
+		long long									Damage;			/* of the last subscriber */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Replay:
+	/// 	Raises every combat event of the recording with aSubscribers addons subscribed per event or to batches.
+	/// 	The batches are flushed at every frame, like GUI::Render does.
+	///----------------------------------------------------------------------------------------------------
+	Result Replay(const std::vector<Combat>& aCombat, const std::vector<Frame>& aFrames, int aSubscribers, bool aIsBatched, int aRepetitions)
+	{
+		Result result{};
+
+		for (int r = 0; r < aRepetitions; r++)
+		{
+			CEventApi events;
+			CCombatBatchApi batches;
+			EventApi = &events;
+			CombatBatchApi = &batches;
+
+			for (int s = 0; s < aSubscribers; s++)
+			{
+				Damage[s] = 0;
+
+				for (const char* identifier : { EV_ARCDPS_COMBATEVENT_LOCAL_RAW, EV_ARCDPS_COMBATEVENT_SQUAD_RAW })
+				{
+					if (aIsBatched)
+					{
+						batches.Subscribe(identifier, BatchCallbacks[s]);
+					}
+					else
+					{
+						events.Subscribe(identifier, EventCallbacks[s]);
+					}
+				}
+			}
+
+			for (const Frame& frame : aFrames)
+			{
+				long long start = Now();
+
+				for (size_t i = frame.Begin; i < frame.End; i++)
+				{
+					events.Raise(aCombat[i].Identifier, aCombat[i].Data);
+				}
+
+				long long raised = Now();
+
+				batches.Flush();
+
+				result.ArcTime += raised - start;
+				result.RenderTime += Now() - raised;
+			}
+
+			result.Damage = Damage[aSubscribers - 1];
+
+			/* every subscriber saw the same events */
+			for (int s = 0; s < aSubscribers; s++)
+			{
+				if (Damage[s] != result.Damage) { result.Damage = -1; }
+			}
+
+			EventApi = nullptr;
+			CombatBatchApi = nullptr;
+		}
+
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf(
+			"Usage: nexus-combatbatch-bench <recording> [repetitions]\n"
+			"\n"
+			"Raises the combat events of the recording through CEventApi::Raise, once with addons\n"
+			"subscribed per event and once with them subscribed to batches flushed every frame.\n");
+		return 1;
+	}
+
+	int repetitions = argc > 2 ? atoi(argv[2]) : 3;
+
+	CRecordingReader reader;
+	std::vector<RecordedEvent> events;
+	std::vector<Combat> combat;
+	std::vector<Frame> frames;
+
+	if (!Load(argv[1], reader, events, combat, frames))
+	{
+		fprintf(stderr, "\"%s\" is not a recording or corrupt.\n", argv[1]);
+		return 1;
+	}
+
+	if (combat.empty())
+	{
+		fprintf(stderr, "\"%s\" has no combat events.\n", argv[1]);
+		return 1;
+	}
+
+	CCallbackWatchdog watchdog(Logger);
+	CCombatRecorder recorder;
+	CallbackWatchdog = &watchdog;
+	CombatRecorder = &recorder;
+
+	double total = static_cast<double>(combat.size()) * repetitions;
+
+	printf("%zu combat events, %zu frames, %d repetitions.\n\n", combat.size(), frames.size() - 1, repetitions);
+	printf("%-12s %-10s %16s %16s %16s %14s\n", "Subscribers", "Delivery", "ArcDPS ns/event", "render ns/event", "events/s", "damage");
+
+	for (int subscribers : { 1, 4, 8 })
+	{
+		for (bool isBatched : { false, true })
+		{
+			Result result = Replay(combat, frames, subscribers, isBatched, repetitions);
+
+			double arc = result.ArcTime / total;
+			double render = result.RenderTime / total;
+
+			printf("%-12d %-10s %16.1f %16.1f %16.0f %14lld\n", subscribers, isBatched ? "batched" : "per event",
+				arc, render, 1e9 / (arc + render), result.Damage);
+		}
+	}
+
+	CallbackWatchdog = nullptr;
+	CombatRecorder = nullptr;
+
+	return 0;
+}
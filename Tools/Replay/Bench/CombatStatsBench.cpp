@@ -0,0 +1,378 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatStatsBench.cpp
+/// Description  :  Compares addons aggregating a recording each on their own to reading DL_COMBAT_STATS.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Events/CombatBatchBuffer.h"
+#include "Services/CombatStats/CombatStats.h"
+#include "Services/DataLink/SeqLock.h"
+#include "Services/Recorder/Recording.h"
+
+namespace
+{
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// CAddonStats Class
+	/// 	What every addon does today: hash maps per agent and per boon, updated for every event.
+	///----------------------------------------------------------------------------------------------------
+	class CAddonStats
+	{
+	public:
+		void Consume(const EvCombatData* aCombatData)
+		{
+			if (!aCombatData->Event)
+			{
+				const ArcDPS::AgentShort* agent = aCombatData->Source;
+
+				if (!agent || agent->Specialization != 0) { return; }
+
+				if (agent->Profession != 0)
+				{
+					Agent& entry = this->Agents[agent->ID];
+					entry.Name = agent->Name ? agent->Name : "";
+					this->Masters[static_cast<uint16_t>(aCombatData->Destination->ID)] = agent->ID;
+				}
+				else
+				{
+					this->Agents.erase(agent->ID);
+				}
+
+				return;
+			}
+
+			const ArcDPS::CombatEvent* ev = aCombatData->Event;
+
+			if (ev->IsStateChange || ev->IsActivation) { return; }
+
+			if (ev->IsBuffRemove)
+			{
+				auto it = this->Agents.find(ev->SrcAgent);
+
+				if (it != this->Agents.end() && ev->IsBuffRemove == 1)
+				{
+					Boon& boon = it->second.Boons[ev->SkillID];
+					uint64_t end = ev->Time < boon.Until ? ev->Time : boon.Until;
+
+					if (boon.Since && end > boon.Since) { boon.Covered += end - boon.Since; }
+
+					boon.Since = 0;
+				}
+
+				return;
+			}
+
+			if (ev->Buff && ev->BuffDmg == 0)
+			{
+				auto it = this->Agents.find(ev->DstAgent);
+
+				if (it != this->Agents.end() && ev->Value > 0)
+				{
+					Boon& boon = it->second.Boons[ev->SkillID];
+
+					if (boon.Since && boon.Until < ev->Time)
+					{
+						boon.Covered += boon.Until - boon.Since;
+						boon.Since = 0;
+					}
+
+					if (!boon.Since) { boon.Since = boon.Until = ev->Time; }
+
+					boon.Until = (boon.Until > ev->Time ? boon.Until : ev->Time) + ev->Value;
+				}
+
+				return;
+			}
+
+			auto it = this->Agents.find(ev->SrcAgent);
+
+			if (it == this->Agents.end())
+			{
+				auto master = this->Masters.find(ev->SrcMasterInstID);
+
+				if (!ev->SrcMasterInstID || master == this->Masters.end()) { return; }
+
+				it = this->Agents.find(master->second);
+
+				if (it == this->Agents.end()) { return; }
+			}
+
+			if (ev->Buff)
+			{
+				if (ev->Result == 0) { it->second.Damage += ev->BuffDmg; }
+			}
+			else if (ev->Result <= 2 || ev->Result == 8 || ev->Result == 9)
+			{
+				it->second.Damage += ev->Value;
+			}
+		}
+
+		long long GetDamage() const
+		{
+			long long damage = 0;
+
+			for (const auto& [id, agent] : this->Agents)
+			{
+				damage += agent.Damage;
+			}
+
+			return damage;
+		}
+
+	private:
+		struct Boon
+		{
+			uint64_t								Covered;
+			uint64_t								Since;
+			uint64_t								Until;
+		};
+
+		struct Agent
+		{
+			std::string								Name;
+			long long								Damage;
+			std::unordered_map<uint32_t, Boon>		Boons;
+		};
+
+		std::unordered_map<uint64_t, Agent>			Agents;
+		std::unordered_map<uint16_t, uint64_t>		Masters;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Frame Struct
+	/// 	The squad events that arrived before the frame.
+	///----------------------------------------------------------------------------------------------------
+	struct Frame
+	{
+		size_t										Begin;
+		size_t										End;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Load:
+	/// 	Reads the whole recording, so decoding is not part of the measurement.
+	///----------------------------------------------------------------------------------------------------
+	bool Load(const char* aPath, CRecordingReader& aReader, std::vector<RecordedEvent>& aOutEvents, std::vector<const EvCombatData*>& aOutSquad, std::vector<Frame>& aOutFrames)
+	{
+		if (!aReader.Open(aPath)) { return false; }
+
+		while (const RecordedEvent* ev = aReader.Next())
+		{
+			if (ev->Type == ERecordType::Frame || (ev->Type == ERecordType::Combat && ev->Stream == ECombatStream::Squad))
+			{
+				aOutEvents.push_back(*ev);
+			}
+		}
+
+		size_t begin = 0;
+
+		/* the copies point into themselves, the names stay in the reader */
+		for (RecordedEvent& ev : aOutEvents)
+		{
+			if (ev.Type == ERecordType::Frame)
+			{
+				aOutFrames.push_back({ begin, aOutSquad.size() });
+				begin = aOutSquad.size();
+				continue;
+			}
+
+			ev.CombatData.Event = ev.CombatData.Event ? &ev.Event : nullptr;
+			ev.CombatData.Source = ev.CombatData.Source ? &ev.Source : nullptr;
+			ev.CombatData.Destination = ev.CombatData.Destination ? &ev.Destination : nullptr;
+			aOutSquad.push_back(&ev.CombatData);
+		}
+
+		aOutFrames.push_back({ begin, aOutSquad.size() });
+
+		return !aReader.IsCorrupt();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Warm:
+	/// 	Loads the events of the frame into the cache, like ArcDPS just wrote them.
+	/// 	Otherwise streaming the whole recording from memory dominates both measurements.
+	///----------------------------------------------------------------------------------------------------
+	unsigned Warm(const std::vector<const EvCombatData*>& aSquad, const Frame& aFrame)
+	{
+		unsigned sum = 0;
+
+		for (size_t i = aFrame.Begin; i < aFrame.End; i++)
+		{
+			const EvCombatData* combatData = aSquad[i];
+			sum += combatData->Event ? combatData->Event->IsStateChange : 0;
+			sum += combatData->Source ? combatData->Source->IsSelf : 0;
+			sum += combatData->Destination ? combatData->Destination->IsSelf : 0;
+		}
+
+		return sum;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf(
+			"Usage: nexus-combatstats-bench <recording> [repetitions]\n"
+			"\n"
+			"Aggregates the squad events of the recording once per addon, like addons do on their own,\n"
+			"and once in CCombatStats with every addon copying DL_COMBAT_STATS per frame.\n");
+		return 1;
+	}
+
+	int repetitions = argc > 2 ? atoi(argv[2]) : 5;
+
+	CRecordingReader reader;
+	std::vector<RecordedEvent> events;
+	std::vector<const EvCombatData*> squad;
+	std::vector<Frame> frames;
+
+	if (!Load(argv[1], reader, events, squad, frames))
+	{
+		fprintf(stderr, "\"%s\" is not a recording or corrupt.\n", argv[1]);
+		return 1;
+	}
+
+	if (squad.empty())
+	{
+		fprintf(stderr, "\"%s\" has no squad events.\n", argv[1]);
+		return 1;
+	}
+
+	volatile unsigned warm = 0;
+
+	/* once per addon, every event goes through its maps */
+	long long addonTime = 0;
+	long long addonDamage = 0;
+
+	for (int r = 0; r < repetitions; r++)
+	{
+		CAddonStats addon;
+
+		for (const Frame& frame : frames)
+		{
+			warm = warm + Warm(squad, frame);
+
+			long long start = Now();
+
+			for (size_t i = frame.Begin; i < frame.End; i++)
+			{
+				addon.Consume(squad[i]);
+			}
+
+			addonTime += Now() - start;
+		}
+
+		addonDamage = addon.GetDamage();
+	}
+
+	/* once in total, the addons copy the result every frame */
+	long long collectTime = 0;
+	long long processTime = 0;
+	long long readTime = 0;
+	unsigned long long copies = 0;
+	long long engineDamage = 0;
+
+	std::unique_ptr<CombatStats> shared(new CombatStats());
+	std::unique_ptr<CombatStats> copy(new CombatStats());
+
+	for (int r = 0; r < repetitions; r++)
+	{
+		memset(shared.get(), 0, sizeof(CombatStats));
+
+		CCombatStats engine(shared.get());
+		CCombatBatchBuffer batch;
+		unsigned copiedVersion = 0;
+
+		for (const Frame& frame : frames)
+		{
+			warm = warm + Warm(squad, frame);
+
+			/* on the ArcDPS thread */
+			long long start = Now();
+
+			for (size_t i = frame.Begin; i < frame.End; i++)
+			{
+				if (!squad[i]->Event)
+				{
+					engine.Track(squad[i]);
+					continue;
+				}
+
+				batch.Append(squad[i]);
+
+				if (batch.IsFull())
+				{
+					engine.Process(batch.GetBatch());
+					batch.Clear();
+				}
+			}
+
+			/* on the render thread */
+			long long collected = Now();
+			engine.Process(batch.GetBatch());
+			batch.Clear();
+
+			/* in every addon, copied only if it changed */
+			long long processed = Now();
+			unsigned version = SeqLock::GetVersion(&shared->Version);
+
+			if (version != copiedVersion)
+			{
+				SeqLock::Read(&shared->Version, shared.get(), copy.get(), sizeof(CombatStats), &copiedVersion);
+				copies++;
+			}
+
+			long long read = Now();
+
+			collectTime += collected - start;
+			processTime += processed - collected;
+			readTime += read - processed;
+		}
+
+		engineDamage = 0;
+
+		for (uint32_t i = 0; i < shared->AgentCount; i++)
+		{
+			engineDamage += shared->Agents[i].Damage;
+		}
+	}
+
+	double total = static_cast<double>(squad.size()) * repetitions;
+	double addonPerEvent = addonTime / total;
+	double enginePerEvent = (collectTime + processTime) / total;
+	double readPerEvent = readTime / total;
+
+	printf("%zu squad events, %zu frames, %d repetitions, %u agents.\n", squad.size(), frames.size() - 1, repetitions, shared->AgentCount);
+	printf("Own aggregation per addon: %.1f ns/event (%.0f events/s).\n", addonPerEvent, 1e9 / addonPerEvent);
+	printf("CCombatStats:              %.1f ns/event (%.0f events/s), %.1f ns of it on the ArcDPS thread.\n", enginePerEvent, 1e9 / enginePerEvent, collectTime / total);
+	printf("Reading DL_COMBAT_STATS:   %.1f ns/event per addon (%.0f ns per frame, copied in %.0f%% of the frames).\n",
+		readPerEvent, static_cast<double>(readTime) / (frames.size() * repetitions), 100.0 * copies / (frames.size() * repetitions));
+	printf("Squad damage: %lld by the addon, %lld by CCombatStats.\n\n", addonDamage, engineDamage);
+
+	printf("%8s %18s %18s %10s\n", "Addons", "Own ns/event", "Shared ns/event", "Saved");
+
+	for (int addons : { 1, 2, 4, 8 })
+	{
+		double own = addonPerEvent * addons;
+		double shared = enginePerEvent + readPerEvent * addons;
+
+		printf("%8d %18.1f %18.1f %9.0f%%\n", addons, own, shared, 100.0 * (own - shared) / own);
+	}
+
+	return 0;
+}
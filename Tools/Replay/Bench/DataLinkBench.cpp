@@ -0,0 +1,224 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  DataLinkBench.cpp
+/// Description  :  Measures DataLink lookups, alone and while a writer keeps sharing resources, old against new.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Consts.h"
+#include "Services/DataLink/DataLink.h"
+
+namespace
+{
+	constexpr const int BENCH_CALLS = 10000000;
+	constexpr const int BENCH_RESOURCES = 31;		/* Nexus' own and a typical addon set */
+	constexpr const long long BENCH_SHARE_INTERVAL = 200; /* us between two resources of the writer */
+
+	std::atomic<uintptr_t> Sink{ 0 };
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// COldDataLink Class
+	/// 	The registry before: a std::string per lookup and the mutex around the map.
+	///----------------------------------------------------------------------------------------------------
+	class COldDataLink
+	{
+	public:
+		~COldDataLink()
+		{
+			for (auto& it : this->Registry) { delete[] (char*)it.second; }
+		}
+
+		void* GetResource(const char* aIdentifier)
+		{
+			std::string str = aIdentifier;
+
+			void* result = nullptr;
+
+			const std::lock_guard<std::mutex> lock(this->Mutex);
+
+			const auto& it = this->Registry.find(str);
+			if (it != this->Registry.end())
+			{
+				result = it->second;
+			}
+
+			return result;
+		}
+
+		void* ShareResource(const char* aIdentifier, size_t aResourceSize, bool)
+		{
+			std::string str = aIdentifier;
+
+			const std::lock_guard<std::mutex> lock(this->Mutex);
+
+			void*& pointer = this->Registry[str];
+			if (!pointer) { pointer = new char[aResourceSize](); }
+
+			return pointer;
+		}
+
+	private:
+		std::mutex								Mutex;
+		std::unordered_map<std::string, void*>	Registry;
+	};
+
+	template <typename T>
+	void Populate(T& aDataLink)
+	{
+		aDataLink.ShareResource(DL_MUMBLE_LINK, 64, false);
+		aDataLink.ShareResource(DL_NEXUS_LINK, 64, false);
+		aDataLink.ShareResource(DL_MUMBLE_HISTORY, 64, false);
+		aDataLink.ShareResource(DL_COMBAT_STATS, 64, false);
+
+		for (int i = 4; i < BENCH_RESOURCES; i++)
+		{
+			aDataLink.ShareResource(("ADDON_RESOURCE_" + std::to_string(i)).c_str(), 64, false);
+		}
+	}
+
+	template <typename Fn>
+	double PerCall(Fn aLookup, int aCalls)
+	{
+		uintptr_t sum = 0;
+
+		long long start = Now();
+		for (int i = 0; i < aCalls; i++)
+		{
+			sum += reinterpret_cast<uintptr_t>(aLookup());
+		}
+		double ns = static_cast<double>(Now() - start) / aCalls;
+
+		Sink = sum;
+		return ns;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		int		Shared;			/* resources the writer got to share */
+		double	LookupsPerSec;	/* of all readers */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Contend:
+	/// 	aReaders threads look DL_MUMBLE_LINK up while a writer shares a new resource every
+	/// 	BENCH_SHARE_INTERVAL microseconds, for aDuration nanoseconds.
+	///----------------------------------------------------------------------------------------------------
+	template <typename T>
+	Result Contend(T& aDataLink, int aReaders, long long aDuration)
+	{
+		std::atomic<bool> isRunning{ true };
+		std::atomic<int> started{ 0 };
+		std::atomic<unsigned long long> lookups{ 0 };
+
+		std::vector<std::thread> readers;
+
+		for (int r = 0; r < aReaders; r++)
+		{
+			readers.emplace_back([&]()
+			{
+				unsigned long long count = 0;
+				uintptr_t sum = 0;
+
+				started++;
+
+				while (isRunning)
+				{
+					sum += reinterpret_cast<uintptr_t>(aDataLink.GetResource(DL_MUMBLE_LINK));
+					count++;
+				}
+
+				lookups += count;
+				Sink = sum;
+			});
+		}
+
+		while (started < aReaders) { std::this_thread::yield(); }
+
+		Result result{};
+		long long start = Now();
+
+		while (Now() - start < aDuration)
+		{
+			aDataLink.ShareResource(("WRITER_" + std::to_string(result.Shared)).c_str(), 64, false);
+			result.Shared++;
+
+			std::this_thread::sleep_for(std::chrono::microseconds(BENCH_SHARE_INTERVAL));
+		}
+
+		isRunning = false;
+
+		for (std::thread& reader : readers) { reader.join(); }
+
+		result.LookupsPerSec = lookups / ((Now() - start) / 1e9);
+
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int calls = argc > 1 ? atoi(argv[1]) : BENCH_CALLS;
+	int seconds = argc > 2 ? atoi(argv[2]) : 2;
+
+	printf("%d calls, %d resources, %u hardware threads.\n\n", calls, BENCH_RESOURCES, std::thread::hardware_concurrency());
+	printf("%-40s %12s %12s\n", "Lookup", "old ns", "new ns");
+
+	{
+		COldDataLink oldLink;
+		CDataLink newLink;
+		Populate(oldLink);
+		Populate(newLink);
+
+		const DataLinkEntry* handle = newLink.GetHandle(DL_MUMBLE_HISTORY);
+
+		printf("%-40s %12.1f %12.1f\n", "DL_MUMBLE_LINK",
+			PerCall([&]() { return oldLink.GetResource(DL_MUMBLE_LINK); }, calls),
+			PerCall([&]() { return newLink.GetResource(DL_MUMBLE_LINK); }, calls));
+		printf("%-40s %12.1f %12.1f\n", "DL_MUMBLE_HISTORY, longer than the SSO",
+			PerCall([&]() { return oldLink.GetResource(DL_MUMBLE_HISTORY); }, calls),
+			PerCall([&]() { return newLink.GetResource(DL_MUMBLE_HISTORY); }, calls));
+		printf("%-40s %12s %12.1f\n", "DL_MUMBLE_HISTORY, by handle", "-",
+			PerCall([&]() { return newLink.GetResource(handle); }, calls));
+		printf("%-40s %12.1f %12.1f\n", "missing",
+			PerCall([&]() { return oldLink.GetResource("DL_NOT_SHARED"); }, calls),
+			PerCall([&]() { return newLink.GetResource("DL_NOT_SHARED"); }, calls));
+	}
+
+	printf("\nA writer sharing a resource every %lldus for %ds.\n\n", BENCH_SHARE_INTERVAL, seconds);
+	printf("%-12s %12s %12s %16s %16s\n", "Readers", "old shared", "new shared", "old Mlookups/s", "new Mlookups/s");
+
+	for (int readers : { 1, 4, 16 })
+	{
+		COldDataLink oldLink;
+		CDataLink newLink;
+		Populate(oldLink);
+		Populate(newLink);
+
+		Result oldResult = Contend(oldLink, readers, seconds * 1000000000LL);
+		Result newResult = Contend(newLink, readers, seconds * 1000000000LL);
+
+		printf("%-12d %12d %12d %16.2f %16.2f\n", readers, oldResult.Shared, newResult.Shared,
+			oldResult.LookupsPerSec / 1e6, newResult.LookupsPerSec / 1e6);
+	}
+
+	return 0;
+}
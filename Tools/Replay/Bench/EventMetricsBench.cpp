@@ -0,0 +1,113 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventMetricsBench.cpp
+/// Description  :  Measures what counting the metrics adds to a raise, against the whole raise.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+
+namespace
+{
+	constexpr const int BENCH_RAISES = 4000000;
+	constexpr const int BENCH_RUNS = 5;
+
+	std::atomic<long long> Sink{ 0 };
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/* as cheap as a subscriber gets, what is left is the cost of the bus */
+	void Empty1(void*) { Sink.fetch_add(0, std::memory_order_relaxed); }
+	void Empty2(void*) { Sink.fetch_add(0, std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------------------------
+	/// PerRaise:
+	/// 	Runs aRaise aRaises times on each of aThreads threads.
+	/// 	Returns the nanoseconds per raise of one thread, the best of BENCH_RUNS runs.
+	///----------------------------------------------------------------------------------------------------
+	template <typename Fn>
+	double PerRaise(Fn aRaise, int aThreads, int aRaises)
+	{
+		double best = 0;
+
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			std::vector<std::thread> threads;
+			long long start = Now();
+
+			for (int t = 0; t < aThreads; t++)
+			{
+				threads.emplace_back([&aRaise, aRaises]()
+				{
+					for (int i = 0; i < aRaises; i++) { aRaise(); }
+				});
+			}
+
+			for (std::thread& thread : threads) { thread.join(); }
+
+			double ns = static_cast<double>(Now() - start) / aRaises;
+			best = run == 0 ? ns : (std::min)(best, ns);
+		}
+
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int raises = argc > 1 ? atoi(argv[1]) : BENCH_RAISES;
+
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	CEventApi events;
+	EventApi = &events;
+
+	events.Subscribe("EV_BENCH", Empty1);
+	events.Subscribe("EV_BENCH", Empty2);
+
+	/* the counters of the same event, as Raise records into them */
+	CEventMetrics metrics;
+	CEventCounters* ev = metrics.GetEvent("EV_BENCH");
+	CSubscriberCounters* sub1 = metrics.GetSubscriber("EV_BENCH", Empty1, 0, "Nexus");
+	CSubscriberCounters* sub2 = metrics.GetSubscriber("EV_BENCH", Empty2, 0, "Nexus");
+
+	printf("%d raises of an event with two empty subscribers, best of %d, %u hardware threads.\n", raises, BENCH_RUNS, std::thread::hardware_concurrency());
+	printf("Times are per raise on one thread, a thread that is preempted counts the time it waits.\n\n");
+	printf("%-10s %16s %16s %10s\n", "Threads", "counting ns", "Raise ns", "share");
+
+	for (int threads : { 1, 4 })
+	{
+		/* the callback times are measured for the watchdog anyway, only the counting is added */
+		double counting = PerRaise([&]()
+		{
+			static thread_local long long time = 0;
+
+			ev->Raise();
+			sub1->Record(++time & 1023);
+			sub2->Record(time & 511);
+		}, threads, raises);
+
+		double raise = PerRaise([&]() { events.Raise("EV_BENCH", nullptr); }, threads, raises);
+
+		printf("%-10d %16.1f %16.1f %9.1f%%\n", threads, counting, raise, counting / raise * 100.0);
+	}
+
+	events.Shutdown();
+	EventApi = nullptr;
+	CallbackWatchdog = nullptr;
+
+	return 0;
+}
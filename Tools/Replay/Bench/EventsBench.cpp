@@ -0,0 +1,179 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventsBench.cpp
+/// Description  :  Measures how long a raiser is held up by slow subscribers, called, queued and on the render thread.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+#include "Shared.h"
+
+namespace
+{
+	constexpr const long long BENCH_SUBSCRIBER_TIME = 20000; /* ns every slow subscriber takes */
+
+	/* about the size of a combat event */
+	struct Payload
+	{
+		char	Data[64];
+	};
+
+	long long Now()
+	{
+		return CCallbackWatchdog::Now();
+	}
+
+	/* the time the raising thread itself spends, a worker preempting it on a busy machine does not count */
+	long long ThreadTime()
+	{
+		timespec time;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+		return time.tv_sec * 1000000000LL + time.tv_nsec;
+	}
+
+	void Spin(long long aNanoseconds)
+	{
+		long long end = Now() + aNanoseconds;
+		while (Now() < end) {}
+	}
+
+	void Slow1(void*) { Spin(BENCH_SUBSCRIBER_TIME); }
+	void Slow2(void*) { Spin(BENCH_SUBSCRIBER_TIME); }
+	void Slow3(void*) { Spin(BENCH_SUBSCRIBER_TIME); }
+
+	std::atomic<long long> FastCalls{ 0 };
+
+	void Fast(void*) { FastCalls++; }
+
+	void SetExecution(CEventApi& aEvents, EEventExecution aExecution)
+	{
+		for (EVENT_CONSUME callback : { Slow1, Slow2, Slow3 })
+		{
+			aEvents.SetExecution("EV_SLOW", callback, aExecution);
+		}
+	}
+
+	void WaitForExecutor(CEventApi& aEvents)
+	{
+		while (aEvents.GetExecutorStats().Pending > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	void Print(const char* aName, std::vector<long long>& aTimes)
+	{
+		std::sort(aTimes.begin(), aTimes.end());
+
+		printf("%-46s %12.2f %12.2f %12.2f\n", aName,
+			aTimes[aTimes.size() / 2] / 1000.0, aTimes[aTimes.size() * 99 / 100] / 1000.0, aTimes.back() / 1000.0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int raises = argc > 1 ? atoi(argv[1]) : 2000;
+
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	CEventApi events;
+	EventApi = &events;
+
+	events.Subscribe("EV_SLOW", Slow1, true);
+	events.Subscribe("EV_SLOW", Slow2, true);
+	events.Subscribe("EV_SLOW", Slow3, true);
+	events.Subscribe("EV_FAST", Fast, true);
+
+	Payload payload{};
+	std::vector<long long> times;
+	std::vector<long long> threadTimes;
+
+	printf("%d raises, 3 subscribers of %lldus, %u hardware threads.\n\n", raises, BENCH_SUBSCRIBER_TIME / 1000, std::thread::hardware_concurrency());
+	printf("%-46s %12s %12s %12s\n", "Raiser", "p50 us", "p99 us", "max us");
+
+	for (int i = 0; i < raises; i++)
+	{
+		long long start = Now();
+		events.Raise("EV_SLOW", &payload);
+		times.push_back(Now() - start);
+	}
+
+	Print("Raise", times);
+
+	/* a burst of ten, then a frame of rest for the workers */
+	times.clear();
+
+	for (int i = 0; i < raises; i++)
+	{
+		long long start = Now();
+		long long threadStart = ThreadTime();
+		events.RaiseQueued("EV_SLOW", &payload, sizeof(payload));
+		threadTimes.push_back(ThreadTime() - threadStart);
+		times.push_back(Now() - start);
+
+		if (i % 10 == 9) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+	}
+
+	Print("RaiseQueued", times);
+	Print("RaiseQueued, time of the raising thread", threadTimes);
+
+	WaitForExecutor(events);
+
+	SetExecution(events, EEventExecution::RenderThread);
+	times.clear();
+
+	for (int i = 0; i < raises; i++)
+	{
+		long long start = Now();
+		events.RaiseQueued("EV_SLOW", &payload, sizeof(payload));
+		times.push_back(Now() - start);
+
+		if (i % 10 == 9) { events.ProcessRenderQueue(); }
+	}
+
+	Print("RaiseQueued to the render thread", times);
+
+	events.ProcessRenderQueue();
+	SetExecution(events, EEventExecution::Any);
+
+	/* another thread keeps raising the slow event */
+	std::atomic<bool> isRaising{ true };
+	std::thread slow([&]()
+	{
+		while (isRaising) { events.Raise("EV_SLOW", &payload); }
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	times.clear();
+
+	for (int i = 0; i < raises; i++)
+	{
+		long long start = Now();
+		events.Raise("EV_FAST", &payload);
+		times.push_back(Now() - start);
+
+		std::this_thread::yield();
+	}
+
+	isRaising = false;
+	slow.join();
+
+	Print("Raise of another event during slow raises", times);
+
+	events.Shutdown();
+	EventApi = nullptr;
+	CallbackWatchdog = nullptr;
+
+	return 0;
+}
@@ -0,0 +1,684 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  FontAtlasBench.cpp
+/// Description  :  Measures font atlas rebuilds through CFontManager, with 10 fonts and a CJK locale.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Index.h"
+#include "Shared.h"
+#include "GUI/Fonts/FontManager.h"
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"
+
+namespace
+{
+	constexpr const int BENCH_HAN_CHARACTERS	= 3500;		/* the list of commonly used characters */
+	constexpr const int BENCH_TYPED_GLYPHS		= 20;		/* the typed text of the on-demand scenario */
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// FontFile Struct
+	///----------------------------------------------------------------------------------------------------
+	struct FontFile
+	{
+		std::vector<char>			Data;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// FontSpec Struct
+	/// 	A font as GUI::LoadFonts registers it.
+	///----------------------------------------------------------------------------------------------------
+	struct FontSpec
+	{
+		std::string					Identifier;
+		float						Size;
+		FontFile*					File;
+		bool						IsMerged;
+	};
+
+	bool ReadFile(const std::filesystem::path& aPath, FontFile& aOutFont)
+	{
+		std::ifstream file(aPath, std::ios::binary);
+
+		if (!file) { return false; }
+
+		aOutFont.Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		return !aOutFont.Data.empty();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// FontWriter Struct
+	/// 	Big endian, like every TrueType table.
+	///----------------------------------------------------------------------------------------------------
+	struct FontWriter
+	{
+		std::vector<char>			Data;
+
+		void U16(unsigned aValue)
+		{
+			Data.push_back(static_cast<char>((aValue >> 8) & 0xFF));
+			Data.push_back(static_cast<char>(aValue & 0xFF));
+		}
+
+		void U32(unsigned aValue)
+		{
+			U16(aValue >> 16);
+			U16(aValue & 0xFFFF);
+		}
+
+		void Align()
+		{
+			while (Data.size() % 4) { Data.push_back(0); }
+		}
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// GenerateCJKFont:
+	/// 	A TrueType font covering the CJK punctuation, unified ideographs and fullwidth forms, for trees
+	/// 	and machines without a CJK font. Every glyph is a few strokes derived from its codepoint, so it
+	/// 	costs about as much to rasterize and pack as a real one.
+	///----------------------------------------------------------------------------------------------------
+	FontFile GenerateCJKFont()
+	{
+		const unsigned ranges[][2] = { { 0x3000, 0x303F }, { 0x4E00, 0x9FFF }, { 0xFF00, 0xFFEF } };
+
+		unsigned glyphs = 1; /* .notdef */
+		for (const auto& range : ranges) { glyphs += range[1] - range[0] + 1; }
+
+		FontWriter glyf;
+		std::vector<unsigned> loca{ 0, 0 };
+
+		for (unsigned g = 1; g < glyphs; g++)
+		{
+			unsigned h = g * 2654435761u;
+
+			/* x0, y0, x1, y1 of two horizontal, two vertical and one short stroke */
+			const int strokes[5][4] = {
+				{ 100, 150 + static_cast<int>(h & 7) * 70, 924, 220 + static_cast<int>(h & 7) * 70 },
+				{ 160, 500 + static_cast<int>((h >> 3) & 7) * 40, 864, 570 + static_cast<int>((h >> 3) & 7) * 40 },
+				{ 200 + static_cast<int>((h >> 6) & 7) * 40, 80, 270 + static_cast<int>((h >> 6) & 7) * 40, 800 },
+				{ 600 + static_cast<int>((h >> 9) & 3) * 60, 120, 670 + static_cast<int>((h >> 9) & 3) * 60, 760 },
+				{ 300, 780 + static_cast<int>((h >> 11) & 1) * 30, 700, 840 + static_cast<int>((h >> 11) & 1) * 30 }
+			};
+
+			glyf.U16(5);
+			glyf.U16(100);
+			glyf.U16(80);
+			glyf.U16(924);
+			glyf.U16(870);
+
+			for (int c = 0; c < 5; c++) { glyf.U16(c * 4 + 3); }
+
+			glyf.U16(0); /* instructions */
+
+			for (int p = 0; p < 20; p++) { glyf.Data.push_back(1); /* on curve, 16 bit deltas */ }
+
+			/* clockwise, the deltas are relative to the previous point */
+			int last = 0;
+			for (const auto& s : strokes)
+			{
+				for (int x : { s[0], s[0], s[2], s[2] }) { glyf.U16(static_cast<unsigned>(x - last) & 0xFFFF); last = x; }
+			}
+
+			last = 0;
+			for (const auto& s : strokes)
+			{
+				for (int y : { s[1], s[3], s[3], s[1] }) { glyf.U16(static_cast<unsigned>(y - last) & 0xFFFF); last = y; }
+			}
+
+			glyf.Align();
+			loca.push_back(static_cast<unsigned>(glyf.Data.size()));
+		}
+
+		FontWriter cmap;
+		cmap.U16(0);
+		cmap.U16(1);
+		cmap.U16(3);	/* Windows */
+		cmap.U16(10);	/* UCS-4 */
+		cmap.U32(12);
+		cmap.U16(12);
+		cmap.U16(0);
+		cmap.U32(16 + 12 * 3);
+		cmap.U32(0);
+		cmap.U32(3);
+
+		unsigned glyph = 1;
+		for (const auto& range : ranges)
+		{
+			cmap.U32(range[0]);
+			cmap.U32(range[1]);
+			cmap.U32(glyph);
+			glyph += range[1] - range[0] + 1;
+		}
+
+		FontWriter head;
+		head.U32(0x00010000);
+		head.U32(0x00010000);
+		head.U32(0);
+		head.U32(0x5F0F3CF5);
+		head.U16(0x000B);
+		head.U16(1024);			/* units per em */
+		for (int i = 0; i < 4; i++) { head.U32(0); }
+		head.U16(0);
+		head.U16(0);
+		head.U16(1024);
+		head.U16(1024);
+		head.U16(0);
+		head.U16(8);
+		head.U16(2);
+		head.U16(1);			/* 32 bit loca */
+		head.U16(0);
+
+		FontWriter hhea;
+		hhea.U32(0x00010000);
+		hhea.U16(880);
+		hhea.U16(static_cast<unsigned>(-144) & 0xFFFF);
+		hhea.U16(0);
+		hhea.U16(1024);
+		hhea.U16(0);
+		hhea.U16(0);
+		hhea.U16(1024);
+		hhea.U16(1);
+		hhea.U16(0);
+		hhea.U16(0);
+		for (int i = 0; i < 5; i++) { hhea.U16(0); }
+		hhea.U16(1);			/* one advance for all */
+
+		FontWriter hmtx;
+		hmtx.U16(1024);
+		hmtx.U16(0);
+		for (unsigned g = 1; g < glyphs; g++) { hmtx.U16(0); }
+
+		FontWriter locaTable;
+		for (unsigned offset : loca) { locaTable.U32(offset); }
+
+		FontWriter maxp;
+		maxp.U32(0x00005000);
+		maxp.U16(glyphs);
+
+		const std::pair<const char*, FontWriter*> tables[] = {
+			{ "cmap", &cmap }, { "glyf", &glyf }, { "head", &head }, { "hhea", &hhea },
+			{ "hmtx", &hmtx }, { "loca", &locaTable }, { "maxp", &maxp }
+		};
+
+		FontWriter font;
+		font.U32(0x00010000);
+		font.U16(7);
+		font.U16(64);
+		font.U16(2);
+		font.U16(7 * 16 - 64);
+
+		unsigned offset = 12 + 7 * 16;
+		for (const auto& [tag, table] : tables)
+		{
+			table->Align();
+			font.Data.insert(font.Data.end(), tag, tag + 4);
+			font.U32(0);
+			font.U32(offset);
+			font.U32(static_cast<unsigned>(table->Data.size()));
+			offset += static_cast<unsigned>(table->Data.size());
+		}
+
+		for (const auto& [tag, table] : tables)
+		{
+			font.Data.insert(font.Data.end(), table->Data.begin(), table->Data.end());
+		}
+
+		return FontFile{ std::move(font.Data) };
+	}
+
+	std::string ToUTF8(unsigned aFirst, unsigned aLast)
+	{
+		std::string text;
+
+		for (unsigned c = aFirst; c <= aLast; c++)
+		{
+			ImWchar codepoint = static_cast<ImWchar>(c);
+			char buffer[5]{};
+			ImTextStrToUtf8(buffer, sizeof(buffer), &codepoint, &codepoint + 1);
+			text += buffer;
+		}
+
+		return text;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteLocale:
+	/// 	Writes a locale source, a text of at most 12 characters per identifier.
+	///----------------------------------------------------------------------------------------------------
+	void WriteLocale(const std::filesystem::path& aDirectory, const char* aIdentifier, const char* aDisplayName, const std::string& aCharacters)
+	{
+		std::ofstream file(aDirectory / (std::string(aIdentifier) + "_Main.json"));
+
+		file << "{ \"Identifier\": \"" << aIdentifier << "\", \"DisplayName\": \"" << aDisplayName << "\", \"Texts\": {";
+
+		const char* p = aCharacters.c_str();
+		const char* end = p + aCharacters.size();
+		int index = 0;
+
+		while (p < end)
+		{
+			std::string text;
+
+			for (int c = 0; c < 12 && p < end; c++)
+			{
+				unsigned codepoint = 0;
+				int length = ImTextCharFromUtf8(&codepoint, p, end);
+
+				/* nothing to escape in JSON */
+				if (codepoint != '"' && codepoint != '\\') { text.append(p, length); }
+
+				p += length;
+			}
+
+			file << (index ? "," : "") << "\"((" << index << "))\": \"" << text << "\"";
+			index++;
+		}
+
+		file << "} }";
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// SynthesizeLocales:
+	/// 	Stand-ins with the scripts of the bundled locales, for trees without the locale files.
+	///----------------------------------------------------------------------------------------------------
+	void SynthesizeLocales(const std::filesystem::path& aDirectory)
+	{
+		std::string latin = ToUTF8(0x20, 0x7E) + ToUTF8(0xC0, 0x17F);
+
+		WriteLocale(aDirectory, "en", "English", ToUTF8(0x20, 0x7E));
+		WriteLocale(aDirectory, "de", "Deutsch", latin);
+		WriteLocale(aDirectory, "fr", "Fran\xC3\xA7" "ais", latin);
+		WriteLocale(aDirectory, "es", "Espa\xC3\xB1ol", latin);
+		WriteLocale(aDirectory, "br", "Portugu\xC3\xAAs", latin);
+		WriteLocale(aDirectory, "cz", "\xC4\x8C" "e\xC5\xA1tina", latin);
+		WriteLocale(aDirectory, "it", "Italiano", latin);
+		WriteLocale(aDirectory, "pl", "Polski", latin);
+		WriteLocale(aDirectory, "ru", "\xD0\xA0\xD1\x83\xD1\x81\xD1\x81\xD0\xBA\xD0\xB8\xD0\xB9", ToUTF8(0x20, 0x7E) + ToUTF8(0x401, 0x401) + ToUTF8(0x410, 0x44F) + ToUTF8(0x451, 0x451));
+		WriteLocale(aDirectory, "cn", "\xE4\xB8\xAD\xE6\x96\x87", ToUTF8(0x20, 0x7E) + ToUTF8(0x3000, 0x3011) + ToUTF8(0xFF01, 0xFF1F) + ToUTF8(0x4E00, 0x4E00 + BENCH_HAN_CHARACTERS - 1));
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		int							Width;
+		int							Height;
+		int							Glyphs;
+		long long					BuildTime;		/* microseconds, rasterizing and converting to RGBA */
+		long long					RenderTime;		/* microseconds spent in Advance on the render thread */
+		long long					LongestFrame;	/* microseconds of the longest Advance */
+		bool						IsBuilt;
+		bool						IsFromCache;
+	};
+
+	int Notifications = 0;
+
+	void FontReceiver(const char*, ImFont*)
+	{
+		Notifications++;
+	}
+
+	void Describe(ImFontAtlas* aAtlas, Result& aResult)
+	{
+		aResult.Width = aAtlas->TexWidth;
+		aResult.Height = aAtlas->TexHeight;
+		aResult.Glyphs = 0;
+
+		for (ImFont* font : aAtlas->Fonts)
+		{
+			aResult.Glyphs += font->Glyphs.Size;
+		}
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Rebuild:
+	/// 	Calls CFontManager::Advance once per frame until the rebuild was swapped in or skipped.
+	///----------------------------------------------------------------------------------------------------
+	Result Rebuild(bool aIsCold)
+	{
+		CFontManager& fonts = CFontManager::GetInstance();
+
+		if (aIsCold)
+		{
+			std::error_code ec;
+			std::filesystem::remove(Index::F_FONTATLASCACHE, ec);
+		}
+
+		unsigned skipped = fonts.GetStats().Skipped;
+		unsigned cacheHits = fonts.GetStats().CacheHits;
+		Result result{};
+
+		while (fonts.GetStats().Skipped == skipped)
+		{
+			long long start = Now();
+			bool isSwapped = fonts.Advance();
+			long long time = Now() - start;
+
+			result.RenderTime += time;
+			result.LongestFrame = (std::max)(result.LongestFrame, time);
+
+			if (isSwapped)
+			{
+				result.IsBuilt = true;
+				result.IsFromCache = fonts.GetStats().CacheHits != cacheHits;
+				result.BuildTime = fonts.GetStats().LastDuration;
+				Describe(ImGui::GetIO().Fonts, result);
+				break;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return result;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// RebuildFromCache:
+	/// 	The start after the current atlas was built: its cache is set aside while another size is built,
+	/// 	then put back and the size is changed back, so the atlas is read from the cache again.
+	///----------------------------------------------------------------------------------------------------
+	Result RebuildFromCache()
+	{
+		CFontManager& fonts = CFontManager::GetInstance();
+
+		std::filesystem::path aside = Index::F_FONTATLASCACHE;
+		aside += ".aside";
+		std::filesystem::copy_file(Index::F_FONTATLASCACHE, aside, std::filesystem::copy_options::overwrite_existing);
+
+		float size = fonts.Get("MENOMONIA_N")->Size;
+		fonts.ResizeFont("MENOMONIA_N", size + 1.0f);
+		Rebuild(false);
+
+		std::filesystem::rename(aside, Index::F_FONTATLASCACHE);
+		fonts.ResizeFont("MENOMONIA_N", size);
+
+		return Rebuild(false);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Register:
+	/// 	Releases the registered fonts and adds aFonts in order, merged fonts have to follow their font.
+	///----------------------------------------------------------------------------------------------------
+	void Register(std::vector<FontSpec>& aRegistered, const std::vector<FontSpec>& aFonts)
+	{
+		CFontManager& fonts = CFontManager::GetInstance();
+
+		for (const FontSpec& font : aRegistered)
+		{
+			fonts.Release(font.Identifier.c_str(), FontReceiver);
+		}
+
+		for (const FontSpec& font : aFonts)
+		{
+			ImFontConfig config;
+			config.MergeMode = font.IsMerged;
+
+			fonts.AddFont(font.Identifier.c_str(), font.Size, font.File->Data.data(), font.File->Data.size(), FontReceiver, &config);
+		}
+
+		aRegistered = aFonts;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// OldRebuild:
+	/// 	CFontManager::Advance before the background build: the atlas is cleared, every text of every
+	/// 	loaded locale goes into the ranges and it is rasterized on the render thread.
+	///----------------------------------------------------------------------------------------------------
+	Result OldRebuild(const std::vector<FontSpec>& aFonts)
+	{
+		ImFontAtlas* atlas = IM_NEW(ImFontAtlas)();
+
+		long long start = Now();
+
+		ImFontGlyphRangesBuilder rb{};
+		ImWchar rangesLatinExt[] =
+		{
+			0x0100, 0x017F,
+			0x0180, 0x024F,
+			0,
+		};
+		rb.AddRanges(atlas->GetGlyphRangesDefault());
+		rb.AddRanges(rangesLatinExt);
+
+		for (const char* text : Language->GetAllTexts())
+		{
+			rb.AddText(text);
+		}
+
+		ImVector<ImWchar> ranges;
+		rb.BuildRanges(&ranges);
+
+		for (const FontSpec& font : aFonts)
+		{
+			ImFontConfig config;
+			config.FontData = IM_ALLOC(font.File->Data.size());
+			memcpy(config.FontData, font.File->Data.data(), font.File->Data.size());
+			config.FontDataSize = static_cast<int>(font.File->Data.size());
+			config.FontDataOwnedByAtlas = true;
+			config.SizePixels = font.Size;
+			config.GlyphRanges = ranges.Data;
+			config.MergeMode = font.IsMerged;
+			atlas->AddFont(&config);
+		}
+
+		unsigned char* pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+		Result result{};
+		result.BuildTime = result.RenderTime = result.LongestFrame = Now() - start;
+		result.IsBuilt = true;
+		Describe(atlas, result);
+
+		IM_DELETE(atlas);
+
+		return result;
+	}
+
+	void Print(const char* aName, const Result& aResult)
+	{
+		if (!aResult.IsBuilt)
+		{
+			printf("%-46s %8s %11s %10s %10.2f %10.2f\n", aName, "-", "skipped", "-", aResult.RenderTime / 1000.0, aResult.LongestFrame / 1000.0);
+			return;
+		}
+
+		printf("%-46s %8d %5dx%-5d %10.1f %10.2f %10.2f\n", aName, aResult.Glyphs, aResult.Width, aResult.Height,
+			aResult.BuildTime / 1000.0, aResult.RenderTime / 1000.0, aResult.LongestFrame / 1000.0);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetFonts:
+	/// 	The 10 fonts of GUI::LoadFonts up to the large UI scale, with aMerged merged into every UI font
+	/// 	like a user font selected in the options.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<FontSpec> GetFonts(FontFile& aProggy, FontFile& aMenomonia, FontFile& aTrebuchet, FontFile* aMerged)
+	{
+		std::vector<FontSpec> fonts = { { "FONT_DEFAULT", 13.0f, &aProggy, false } };
+
+		const FontSpec ui[] = {
+			{ "MENOMONIA_S", 16.0f, &aMenomonia, false }, { "MENOMONIA_BIG_S", 22.0f, &aMenomonia, false }, { "TREBUCHET_S", 15.0f, &aTrebuchet, false },
+			{ "MENOMONIA_N", 18.0f, &aMenomonia, false }, { "MENOMONIA_BIG_N", 24.0f, &aMenomonia, false }, { "TREBUCHET_N", 16.0f, &aTrebuchet, false },
+			{ "MENOMONIA_L", 20.0f, &aMenomonia, false }, { "MENOMONIA_BIG_L", 26.0f, &aMenomonia, false }, { "TREBUCHET_L", 17.5f, &aTrebuchet, false }
+		};
+
+		for (const FontSpec& font : ui)
+		{
+			fonts.push_back(font);
+
+			if (aMerged)
+			{
+				fonts.push_back({ font.Identifier + "_MERGE", font.Size, aMerged, true });
+			}
+		}
+
+		return fonts;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf(
+			"Usage: nexus-fontatlas-bench <fonts directory> [locales directory] [CJK font]\n"
+			"\n"
+			"Rebuilds the atlas of 10 Nexus fonts, e.g. from src/Resources/Fonts, through CFontManager with an\n"
+			"english and a CJK locale active, cold and from the atlas cache, against the rebuild on the render\n"
+			"thread it replaced.\n"
+			"Locales are read from *_Main.json files, stand-ins with the same scripts are used without a\n"
+			"directory or with \"-\". The CJK font is merged into every UI font, a generated one is used without.\n");
+		return 1;
+	}
+
+	std::filesystem::path fontDir = argv[1];
+	FontFile proggy, menomonia, trebuchet, cjk;
+
+	if (!ReadFile(fontDir / "ProggyClean.ttf", proggy) || !ReadFile(fontDir / "Menomonia.ttf", menomonia) || !ReadFile(fontDir / "TrebuchetMS.ttf", trebuchet))
+	{
+		fprintf(stderr, "\"%s\" lacks ProggyClean.ttf, Menomonia.ttf or TrebuchetMS.ttf.\n", argv[1]);
+		return 1;
+	}
+
+	bool isGenerated = !(argc > 3 && ReadFile(argv[3], cjk));
+	if (isGenerated) { cjk = GenerateCJKFont(); }
+
+	/* the packs are compiled next to the sources, so they are copied */
+	std::filesystem::path localeDir = std::filesystem::temp_directory_path() / ("nexus-fontatlas-bench-" + std::to_string(getpid()));
+	std::filesystem::create_directories(localeDir);
+
+	if (argc > 2 && std::string(argv[2]) != "-")
+	{
+		for (const auto& entry : std::filesystem::directory_iterator(argv[2]))
+		{
+			if (entry.path().extension() == ".json") { std::filesystem::copy_file(entry.path(), localeDir / entry.path().filename()); }
+		}
+	}
+	else
+	{
+		SynthesizeLocales(localeDir);
+	}
+
+	ImGui::CreateContext();
+
+	CLocalization localization;
+	Language = &localization;
+	localization.SetLocaleDirectory(localeDir);
+	localization.Advance();
+	localization.SetLanguage("en");
+
+	CFontManager& fontManager = CFontManager::GetInstance();
+
+	std::vector<FontSpec> latinFonts = GetFonts(proggy, menomonia, trebuchet, nullptr);
+	std::vector<FontSpec> cjkFonts = GetFonts(proggy, menomonia, trebuchet, &cjk);
+	std::vector<FontSpec> registered;
+
+	printf("%zu locales, CJK font %s (%zu KiB), %u hardware threads.\n", localization.GetLanguages().size(),
+		isGenerated ? "generated" : argv[3], cjk.Data.size() / 1024, std::thread::hardware_concurrency());
+	printf("Build is on the worker, render is the time Advance took on the render thread in total and at most per frame.\n\n");
+	printf("%-46s %8s %11s %10s %10s %10s\n", "Rebuild", "Glyphs", "Atlas", "build ms", "render ms", "frame ms");
+
+	Register(registered, latinFonts);
+	Print("10 fonts, en, cold", Rebuild(true));
+	Print("10 fonts, en, cache hit", RebuildFromCache());
+	Print("10 fonts, en, before (render thread)", OldRebuild(latinFonts));
+
+	/* switching to the CJK locale merges the CJK font, like selecting it in the options */
+	localization.SetLanguage("cn");
+	localization.Advance();
+	Register(registered, cjkFonts);
+	Print("10 fonts + CJK merged, cn, cold", Rebuild(true));
+	Print("10 fonts + CJK merged, cn, cache hit", RebuildFromCache());
+	Print("10 fonts + CJK merged, cn, before", OldRebuild(cjkFonts));
+
+	/* every language loaded, as the locales were before they were loaded on use */
+	for (const auto& entry : std::filesystem::directory_iterator(localeDir))
+	{
+		std::string identifier = entry.path().stem().string();
+		localization.Translate("((0))", identifier.substr(0, identifier.find('_')).c_str());
+	}
+
+	localization.Advance();
+	Print("10 fonts + CJK merged, every locale, before", OldRebuild(cjkFonts));
+
+	fontManager.ResizeFont("MENOMONIA_N", 19.0f);
+	Print("ResizeFont, cn", Rebuild(true));
+
+	fontManager.ResizeFont("MENOMONIA_N", 19.0f);
+	fontManager.Reload();
+	Print("Reload, unchanged", Rebuild(true));
+
+	/* typing text with glyphs missing from the atlas */
+	localization.SetLanguage("en");
+	localization.Advance();
+	Register(registered, latinFonts);
+	Rebuild(true);
+
+	long long perGlyph = 0;
+	long long perGlyphRender = 0;
+
+	for (int i = 0; i < BENCH_TYPED_GLYPHS; i++)
+	{
+		ImWchar codepoint = static_cast<ImWchar>(0x391 + i);
+		fontManager.RequestGlyphs(&codepoint, 1);
+
+		Result result = Rebuild(false);
+		perGlyph += result.BuildTime;
+		perGlyphRender += result.RenderTime;
+	}
+
+	/* one glyph per frame, collected for FONT_GLYPH_BATCH_DELAY */
+	int builds = fontManager.GetStats().Builds;
+
+	for (int i = 0; i < BENCH_TYPED_GLYPHS; i++)
+	{
+		ImWchar codepoint = static_cast<ImWchar>(0x3B1 + i);
+		fontManager.RequestGlyphs(&codepoint, 1);
+		fontManager.Advance();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	Result batched = Rebuild(false);
+
+	printf("\n%d on-demand glyphs typed, en:\n", BENCH_TYPED_GLYPHS);
+	printf("  slower than the delay, a build each:   %8.1f ms build, %6.2f ms render in %d builds\n", perGlyph / 1000.0, perGlyphRender / 1000.0, BENCH_TYPED_GLYPHS);
+	printf("  collected for %lldms:                 %8.1f ms build, %6.2f ms render in %u build\n", FONT_GLYPH_BATCH_DELAY,
+		batched.BuildTime / 1000.0, batched.RenderTime / 1000.0, fontManager.GetStats().Builds - builds);
+
+	FontAtlasStats stats = fontManager.GetStats();
+	printf("\n%u builds, %u skipped, %d notifications.\n", stats.Builds, stats.Skipped, Notifications);
+
+	fontManager.Shutdown();
+	ImGui::DestroyContext();
+	Language = nullptr;
+
+	std::error_code ec;
+	std::filesystem::remove(Index::F_FONTATLASCACHE, ec);
+	std::filesystem::remove_all(localeDir, ec);
+
+	return 0;
+}
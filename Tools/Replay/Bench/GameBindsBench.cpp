@@ -0,0 +1,281 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindsBench.cpp
+/// Description  :  Measures submitting and replaying game bind sequences, step by step against macros,
+///                 and the timing of InvokeAsync against a thread sleeping between press and release.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+#include "Hooks.h"
+#include "Index.h"
+
+namespace
+{
+	constexpr const int BENCH_DURATION = 20; /* milliseconds between press and release */
+
+	std::atomic<unsigned long long> Sent{ 0 };
+
+	/* when the key messages arrived, only recorded while timing */
+	std::atomic<bool> IsTiming{ false };
+	std::atomic<long long> KeyDown{ 0 };
+	std::atomic<long long> KeyUp{ 0 };
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	LRESULT GameWndProc(HWND, UINT aMsg, WPARAM, LPARAM)
+	{
+		if (IsTiming.load(std::memory_order_relaxed))
+		{
+			if (aMsg == WM_KEYDOWN) { KeyDown = Now(); }
+			else if (aMsg == WM_KEYUP) { KeyUp = Now(); }
+		}
+
+		Sent++;
+		return 0;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		double	SubmitNs;	/* per sequence, on the calling thread */
+		double	ReplayNs;	/* per message, from the first submission until the last message was sent */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Submits aRounds sequences and waits until aMessages messages were sent per sequence.
+	///----------------------------------------------------------------------------------------------------
+	Result Run(int aRounds, unsigned long long aMessages, const std::function<void()>& aSubmit)
+	{
+		Sent = 0;
+
+		long long submitted = 0;
+		long long start = Now();
+
+		for (int i = 0; i < aRounds; i++)
+		{
+			long long before = Now();
+			aSubmit();
+			submitted += Now() - before;
+		}
+
+		unsigned long long total = aMessages * aRounds;
+
+		while (Sent.load() < total)
+		{
+			std::this_thread::yield();
+		}
+
+		long long elapsed = Now() - start;
+
+		return Result{ static_cast<double>(submitted) / aRounds, static_cast<double>(elapsed) / total };
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Deviation Struct
+	/// 	Nanoseconds the messages were sent off the intended time, press at the call and release
+	/// 	BENCH_DURATION after it.
+	///----------------------------------------------------------------------------------------------------
+	struct Deviation
+	{
+		std::vector<long long>	Press;
+		std::vector<long long>	Release;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Time:
+	/// 	Calls aInvoke aInvocations times, one after the other, and records the deviations.
+	///----------------------------------------------------------------------------------------------------
+	Deviation Time(int aInvocations, const std::function<void()>& aInvoke)
+	{
+		Deviation deviation;
+		IsTiming = true;
+
+		for (int i = 0; i < aInvocations; i++)
+		{
+			KeyDown = 0;
+			KeyUp = 0;
+
+			long long start = Now();
+			aInvoke();
+
+			while (KeyUp.load() == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			deviation.Press.push_back(std::abs(KeyDown.load() - start));
+			deviation.Release.push_back(std::abs(KeyUp.load() - start - BENCH_DURATION * 1000000LL));
+
+			/* the next call at another point of the millisecond */
+			std::this_thread::sleep_for(std::chrono::microseconds(100 + (i % 7) * 130));
+		}
+
+		IsTiming = false;
+
+		return deviation;
+	}
+
+	void Print(const char* aName, Deviation& aDeviation)
+	{
+		auto percentile = [](std::vector<long long>& aTimes, int aPercent)
+		{
+			std::sort(aTimes.begin(), aTimes.end());
+			return aTimes[aTimes.size() * aPercent / 100] / 1000.0;
+		};
+
+		printf("%-44s %10.1f %10.1f %12.1f %12.1f\n", aName,
+			percentile(aDeviation.Press, 50), percentile(aDeviation.Press, 99),
+			percentile(aDeviation.Release, 50), percentile(aDeviation.Release, 99));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int stepCount = argc > 1 ? atoi(argv[1]) : 16;
+	int rounds = argc > 2 ? atoi(argv[2]) : 20000;
+	int invocations = argc > 3 ? atoi(argv[3]) : 200;
+
+	std::filesystem::remove(Index::F_GAMEBINDS);
+
+	Hooks::GW2::WndProc = GameWndProc;
+
+	CEventApi events;
+	CRawInputApi rawInput;
+	EventApi = &events;
+	RawInputApi = &rawInput;
+
+	{
+		CGameBindsApi api(&rawInput, Logger, &events);
+		GameBindsApi = &api;
+
+		/* the weapon and utility skills, every third with modifiers */
+		const EGameBinds skills[] = {
+			EGameBinds::SkillWeapon1, EGameBinds::SkillWeapon2, EGameBinds::SkillWeapon3, EGameBinds::SkillWeapon4,
+			EGameBinds::SkillWeapon5, EGameBinds::SkillHeal, EGameBinds::SkillUtility1, EGameBinds::SkillUtility2
+		};
+
+		for (size_t i = 0; i < sizeof(skills) / sizeof(skills[0]); i++)
+		{
+			api.Set(skills[i], InputBind(false, i % 3 == 0, i % 3 == 0, EInputBindType::Keyboard, static_cast<unsigned short>(0x02 + i)));
+		}
+
+		/* every step is due at once, so the replay measures the sending only */
+		std::vector<GameBindMacroStep> steps;
+
+		for (int i = 0; i < stepCount; i++)
+		{
+			steps.push_back(GameBindMacroStep{ skills[i % (sizeof(skills) / sizeof(skills[0]))], EGameBindMacroAction::Invoke, 0 });
+		}
+
+		unsigned macro = api.CreateMacro(steps.data(), static_cast<unsigned>(steps.size()));
+
+		/* the amount of messages one sequence sends */
+		Sent = 0;
+		api.InvokeMacro(macro);
+		while (api.GetHeld().size() > 0 || Sent.load() == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		unsigned long long messages = Sent.load();
+
+		printf("%d steps, %llu messages per sequence, %d sequences.\n\n", stepCount, messages, rounds);
+		printf("%-32s %16s %16s\n", "Submission", "ns/sequence", "ns/message sent");
+
+		Result result = Run(rounds, messages, [&]()
+		{
+			for (const GameBindMacroStep& step : steps)
+			{
+				api.PressAsync(step.GameBind);
+				api.ReleaseAsync(step.GameBind);
+			}
+		});
+		printf("%-32s %16.1f %16.1f\n", "PressAsync + ReleaseAsync", result.SubmitNs, result.ReplayNs);
+
+		result = Run(rounds, messages, [&]()
+		{
+			api.InvokeSequence(steps.data(), static_cast<unsigned>(steps.size()));
+		});
+		printf("%-32s %16.1f %16.1f\n", "InvokeSequence", result.SubmitNs, result.ReplayNs);
+
+		result = Run(rounds, messages, [&]()
+		{
+			api.InvokeMacro(macro);
+		});
+		printf("%-32s %16.1f %16.1f\n", "InvokeMacro", result.SubmitNs, result.ReplayNs);
+
+		api.DestroyMacro(macro);
+
+		/* a bind without modifiers, one key down and one key up */
+		const EGameBinds timed = EGameBinds::SkillWeapon2;
+
+		auto invoke = [&]()
+		{
+			api.InvokeAsync(timed, BENCH_DURATION);
+		};
+
+		/* InvokeAsync before the scheduler */
+		auto invokeThread = [&]()
+		{
+			std::thread([&api, timed]()
+			{
+				api.Press(timed);
+				std::this_thread::sleep_for(std::chrono::milliseconds(BENCH_DURATION));
+				api.Release(timed);
+			}).detach();
+		};
+
+		printf("\nInvokeAsync with %d ms, %d invocations, deviation from the intended time.\n\n", BENCH_DURATION, invocations);
+		printf("%-44s %10s %10s %12s %12s\n", "Timing", "press p50", "press p99", "release p50", "release p99");
+
+		for (bool isBusy : { false, true })
+		{
+			/* the game keeping a core busy */
+			std::atomic<bool> isSpinning{ isBusy };
+			std::thread spinner([&isSpinning]()
+			{
+				while (isSpinning.load(std::memory_order_relaxed)) {}
+			});
+
+			std::string suffix = isBusy ? ", busy thread" : "";
+
+			Deviation deviation = Time(invocations, invoke);
+			Print(("Scheduler" + suffix).c_str(), deviation);
+
+			deviation = Time(invocations, invokeThread);
+			Print(("std::thread + sleep_for (before)" + suffix).c_str(), deviation);
+
+			isSpinning = false;
+			spinner.join();
+		}
+
+		GameBindsApi = nullptr;
+	}
+
+	RawInputApi = nullptr;
+	EventApi = nullptr;
+	Hooks::GW2::WndProc = nullptr;
+
+	std::filesystem::remove(Index::F_GAMEBINDS);
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  InputBindBench.cpp
+/// Description  :  Measures WndProc per key message against the registry walk it replaced.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Shared.h"
+#include "Index.h"
+#include "Inputs/InputBinds/InputBindHandler.h"
+#include "Util/Inputs.h"
+
+namespace
+{
+	constexpr const int BENCH_MESSAGES = 1000000;	/* key presses, each followed by its release */
+
+	struct Message
+	{
+		UINT		Msg;
+		WPARAM		WParam;
+		LPARAM		LParam;
+	};
+
+	std::atomic<unsigned long long> Calls{ 0 };
+
+	void OnInputBind(const char*)
+	{
+		Calls++;
+	}
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// COldInputBinds Class
+	/// 	The matching before the lookup table: find_if over the registry for presses, the held binds for
+	/// 	releases and a locked map lookup in Invoke. Handlers are counted instead of started on a thread.
+	///----------------------------------------------------------------------------------------------------
+	class COldInputBinds
+	{
+	public:
+		std::map<std::string, ManagedInputBind>	Registry;
+
+		UINT WndProc(UINT uMsg, WPARAM wParam, LPARAM lParam)
+		{
+			bool isModifier = wParam == VK_MENU || wParam == VK_CONTROL || wParam == VK_SHIFT;
+			bool isDown = uMsg == WM_KEYDOWN || uMsg == WM_SYSKEYDOWN;
+
+			if (wParam == VK_MENU) { this->IsAltHeld = isDown; }
+			if (wParam == VK_CONTROL) { this->IsCtrlHeld = isDown; }
+			if (wParam == VK_SHIFT) { this->IsShiftHeld = isDown; }
+
+			InputBind ib{};
+			ib.Type = EInputBindType::Keyboard;
+			ib.Code = LParamToKMF(lParam).GetScanCode();
+
+			if (isDown)
+			{
+				if (!isModifier)
+				{
+					ib.Alt = this->IsAltHeld;
+					ib.Ctrl = this->IsCtrlHeld;
+					ib.Shift = this->IsShiftHeld;
+				}
+
+				auto heldBind = std::find_if(this->Registry.begin(), this->Registry.end(), [ib](auto& entry)
+				{
+					return entry.second.Bind == ib;
+				});
+
+				if (heldBind == this->Registry.end()) { return uMsg; }
+
+				this->HeldInputBinds[heldBind->first] = heldBind->second;
+
+				return this->Invoke(heldBind->first) ? 0 : uMsg;
+			}
+
+			std::vector<std::string> heldBindsPop;
+
+			for (auto& entry : this->HeldInputBinds)
+			{
+				if (entry.second.Bind.Type == ib.Type && entry.second.Bind.Code == ib.Code)
+				{
+					this->Invoke(entry.first, true);
+					heldBindsPop.push_back(entry.first);
+				}
+			}
+
+			for (auto entry : heldBindsPop)
+			{
+				this->HeldInputBinds.erase(entry);
+			}
+
+			return uMsg;
+		}
+
+	private:
+		std::mutex								Mutex;
+		std::map<std::string, ManagedInputBind>	HeldInputBinds;
+		bool									IsAltHeld = false;
+		bool									IsCtrlHeld = false;
+		bool									IsShiftHeld = false;
+
+		bool Invoke(std::string aIdentifier, bool aIsRelease = false)
+		{
+			const std::lock_guard<std::mutex> lock(this->Mutex);
+
+			auto& bind = this->Registry[aIdentifier];
+
+			if (bind.Handler && (bind.HandlerType == EInputBindHandlerType::DownOnly && !aIsRelease))
+			{
+				((INPUTBINDS_PROCESS)bind.Handler)(aIdentifier.c_str());
+				return true;
+			}
+
+			return false;
+		}
+	};
+
+	LPARAM MakeKeyLParam(unsigned short aScanCode, bool aIsDown)
+	{
+		LPARAM lp = 1;
+		lp |= static_cast<LPARAM>(aScanCode & 0xFF) << 16;
+		lp |= static_cast<LPARAM>(aScanCode & 0xE000 ? 1 : 0) << 24;
+		lp |= static_cast<LPARAM>(aIsDown ? 0 : 3) << 30;
+		return lp;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Returns the nanoseconds per message and the amount of messages that invoked a bind.
+	///----------------------------------------------------------------------------------------------------
+	template <typename WndProc>
+	double Run(const std::vector<Message>& aMessages, WndProc aWndProc, unsigned long long* aOutInvoked)
+	{
+		unsigned long long invoked = 0;
+
+		long long start = Now();
+
+		for (const Message& msg : aMessages)
+		{
+			invoked += aWndProc(msg.Msg, msg.WParam, msg.LParam) == 0;
+		}
+
+		long long elapsed = Now() - start;
+
+		*aOutInvoked = invoked;
+
+		return static_cast<double>(elapsed) / aMessages.size();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int bindCount = argc > 1 ? atoi(argv[1]) : 500;
+	int hitPercent = argc > 2 ? atoi(argv[2]) : 50;
+
+	srand(1);
+
+	/* unique binds over the regular and extended scan codes with every modifier combination */
+	std::set<std::tuple<bool, bool, bool, unsigned short>> unique;
+	std::vector<InputBind> binds;
+
+	while (static_cast<int>(binds.size()) < bindCount)
+	{
+		unsigned short code = static_cast<unsigned short>(1 + rand() % 0x58);
+		if (rand() % 4 == 0) { code |= 0xE000; }
+
+		/* modifiers on their own are not bound, so unbound presses never call a handler */
+		if ((code & 0xFF) == 0x1D || (code & 0xFF) == 0x2A || (code & 0xFF) == 0x38) { continue; }
+
+		InputBind ib(rand() % 4 == 0, rand() % 3 == 0, rand() % 4 == 0, EInputBindType::Keyboard, code);
+
+		if (unique.insert({ ib.Alt, ib.Ctrl, ib.Shift, ib.Code }).second)
+		{
+			binds.push_back(ib);
+		}
+	}
+
+	/* a press of a bound or random key with its modifiers, then the releases */
+	std::vector<Message> messages;
+	int presses = 0;
+
+	while (presses < BENCH_MESSAGES)
+	{
+		InputBind ib = binds[rand() % binds.size()];
+
+		if (rand() % 100 >= hitPercent)
+		{
+			ib.Code = static_cast<unsigned short>(0x59 + rand() % 0x20);
+		}
+
+		if (ib.Alt) { messages.push_back({ WM_SYSKEYDOWN, VK_MENU, MakeKeyLParam(0x38, true) }); }
+		if (ib.Ctrl) { messages.push_back({ WM_KEYDOWN, VK_CONTROL, MakeKeyLParam(0x1D, true) }); }
+		if (ib.Shift) { messages.push_back({ WM_KEYDOWN, VK_SHIFT, MakeKeyLParam(0x2A, true) }); }
+
+		messages.push_back({ WM_KEYDOWN, 0x41, MakeKeyLParam(ib.Code, true) });
+		messages.push_back({ WM_KEYUP, 0x41, MakeKeyLParam(ib.Code, false) });
+
+		if (ib.Shift) { messages.push_back({ WM_KEYUP, VK_SHIFT, MakeKeyLParam(0x2A, false) }); }
+		if (ib.Ctrl) { messages.push_back({ WM_KEYUP, VK_CONTROL, MakeKeyLParam(0x1D, false) }); }
+		if (ib.Alt) { messages.push_back({ WM_SYSKEYUP, VK_MENU, MakeKeyLParam(0x38, false) }); }
+
+		presses++;
+	}
+
+	std::filesystem::remove(Index::F_INPUTBINDS);
+
+	printf("%d keyboard binds, %d key presses (%d%% bound) with their modifiers, %zu messages.\n\n", bindCount, presses, hitPercent, messages.size());
+	printf("%-32s %12s %14s\n", "WndProc", "ns/message", "Handler calls");
+
+	{
+		COldInputBinds old;
+
+		for (int i = 0; i < bindCount; i++)
+		{
+			old.Registry["BENCH_BIND_" + std::to_string(i)] = { binds[i], EInputBindHandlerType::DownOnly, (void*)OnInputBind, EInputBindExecution::Worker };
+		}
+
+		Calls = 0;
+		unsigned long long invoked = 0;
+		double ns = Run(messages, [&](UINT aMsg, WPARAM aWParam, LPARAM aLParam) { return old.WndProc(aMsg, aWParam, aLParam); }, &invoked);
+		printf("%-32s %12.1f %14llu\n", "find_if + Invoke", ns, Calls.load());
+	}
+
+	{
+		CInputBindApi api(Logger);
+
+		for (int i = 0; i < bindCount; i++)
+		{
+			api.Register(("BENCH_BIND_" + std::to_string(i)).c_str(), EInputBindHandlerType::DownOnly, (void*)OnInputBind, binds[i]);
+		}
+
+		Calls = 0;
+		unsigned long long invoked = 0;
+		double ns = Run(messages, [&](UINT aMsg, WPARAM aWParam, LPARAM aLParam) { return api.WndProc(nullptr, aMsg, aWParam, aLParam); }, &invoked);
+
+		/* the handlers run on the executor workers */
+		while (Calls.load() < invoked)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		printf("%-32s %12.1f %14llu\n", "Lookup table + executor", ns, Calls.load());
+	}
+
+	std::filesystem::remove(Index::F_INPUTBINDS);
+
+	return 0;
+}
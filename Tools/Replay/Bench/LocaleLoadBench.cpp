@@ -0,0 +1,235 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  LocaleLoadBench.cpp
+/// Description  :  Measures loading the locales from compiled packs against parsing every JSON source.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Shared.h"
+#include "Services/Localization/Localization.h"
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+
+namespace
+{
+	constexpr const int BENCH_RUNS = 5;
+
+	const char* Languages[][2] = {
+		{ "en", "English" }, { "de", "Deutsch" }, { "fr", "Francais" }, { "es", "Espanol" }, { "br", "Portugues" },
+		{ "cz", "Cestina" }, { "it", "Italiano" }, { "pl", "Polski" }, { "ru", "Russkiy" }, { "cn", "Zhongwen" }
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// COldLocaleAtlas Class
+	/// 	CLocalization::BuildLocaleAtlas before the packs: every source is parsed on every start and
+	/// 	each text is copied into the atlas.
+	///----------------------------------------------------------------------------------------------------
+	class COldLocaleAtlas
+	{
+	public:
+		struct Locale
+		{
+			std::string							DisplayName;
+			std::map<std::string, const char*>	Texts;
+		};
+
+		std::map<std::string, Locale>	LocaleAtlas;
+
+		void Build(const std::filesystem::path& aDirectory)
+		{
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(aDirectory))
+			{
+				std::filesystem::path path = entry.path();
+
+				if (path.extension() != ".json") { continue; }
+
+				std::ifstream file(path);
+				json localeJson = json::parse(file);
+				file.close();
+
+				if (localeJson.is_null() || localeJson["Identifier"].is_null() || localeJson["Texts"].is_null()) { continue; }
+
+				std::string locId = localeJson["Identifier"].get<std::string>();
+
+				Locale& loc = this->LocaleAtlas[locId];
+
+				if (!localeJson["DisplayName"].is_null() && loc.DisplayName.empty())
+				{
+					localeJson["DisplayName"].get_to(loc.DisplayName);
+				}
+
+				for (auto& [key, value] : localeJson["Texts"].items())
+				{
+					if (value.is_null() || !value.is_string()) { continue; }
+
+					loc.Texts[key] = _strdup(value.get<std::string>().c_str());
+				}
+			}
+		}
+	};
+
+	double Now()
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/* resident set in KiB, the second field of statm is in pages */
+	long long ResidentKiB()
+	{
+		long long size = 0;
+		long long resident = 0;
+
+		FILE* statm = fopen("/proc/self/statm", "r");
+		if (!statm) { return 0; }
+
+		if (fscanf(statm, "%lld %lld", &size, &resident) != 2) { resident = 0; }
+		fclose(statm);
+
+		return resident * sysconf(_SC_PAGESIZE) / 1024;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteLocale:
+	/// 	Writes a locale source with aCount texts of about the length of the bundled ones.
+	///----------------------------------------------------------------------------------------------------
+	void WriteLocale(const std::filesystem::path& aPath, const char* aIdentifier, const char* aDisplayName, int aCount)
+	{
+		std::ofstream file(aPath);
+
+		file << "{ \"Identifier\": \"" << aIdentifier << "\", \"DisplayName\": \"" << aDisplayName << "\", \"Texts\": {";
+
+		for (int i = 0; i < aCount; i++)
+		{
+			/* the CJK locale is three bytes per character */
+			std::string text = strcmp(aIdentifier, "cn") == 0
+				? std::string("\xE8\xAE\xBE\xE7\xBD\xAE\xE9\x80\x89\xE9\xA1\xB9 ") + std::to_string(i) + " \xE5\xBF\xAB\xE6\x8D\xB7\xE9\x94\xAE\xE5\xB7\xB2\xE6\x9B\xB4\xE6\x94\xB9"
+				: std::string(aIdentifier) + " text number " + std::to_string(i) + " of the options window";
+
+			file << (i ? "," : "") << "\"((" << i << "))\": \"" << text << "\"";
+		}
+
+		file << "} }";
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Measure:
+	/// 	Runs aLoad in a fresh child process per run, so every run starts without anything loaded.
+	/// 	Prints the best time of BENCH_RUNS runs and the resident set it added.
+	///----------------------------------------------------------------------------------------------------
+	template <typename Fn>
+	void Measure(const char* aName, Fn aLoad)
+	{
+		int fds[2];
+		if (pipe(fds) != 0) { return; }
+
+		double best = 0;
+		long long resident = 0;
+
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			fflush(stdout);
+			pid_t pid = fork();
+
+			if (pid == 0)
+			{
+				long long before = ResidentKiB();
+				double start = Now();
+				aLoad();
+				double result[2] = { Now() - start, static_cast<double>(ResidentKiB() - before) };
+
+				ssize_t written = write(fds[1], result, sizeof(result));
+				_exit(written == sizeof(result) ? 0 : 1);
+			}
+
+			double result[2]{};
+			ssize_t received = read(fds[0], result, sizeof(result));
+			waitpid(pid, nullptr, 0);
+
+			if (received != sizeof(result)) { continue; }
+
+			best = run == 0 ? result[0] : (std::min)(best, result[0]);
+			resident = static_cast<long long>(result[1]);
+		}
+
+		close(fds[0]);
+		close(fds[1]);
+
+		printf("%-44s %12.2f %14lld\n", aName, best, resident);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+
+	for (int i = 1; i < argc; i++) { counts.push_back(atoi(argv[i])); }
+	if (counts.empty()) { counts = { 120, 5000 }; }
+
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / ("nexus-localeload-bench-" + std::to_string(getpid()));
+
+	printf("%zu locales, de active, each load in a fresh process, best of %d.\n", sizeof(Languages) / sizeof(Languages[0]), BENCH_RUNS);
+
+	for (int count : counts)
+	{
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir);
+
+		for (const auto& language : Languages)
+		{
+			WriteLocale(dir / (std::string(language[0]) + "_Main.json"), language[0], language[1], count);
+		}
+
+		printf("\n%d texts per locale, %llu KiB of sources.\n", count, static_cast<unsigned long long>(std::filesystem::file_size(dir / "de_Main.json")) * 10 / 1024);
+		printf("%-44s %12s %14s\n", "Load", "ms", "RSS KiB");
+
+		/* what was loaded is kept for the resident set, the child exits right after */
+		auto load = [&dir]()
+		{
+			CLocalization* loc = new CLocalization();
+			loc->SetLocaleDirectory(dir);
+			loc->Advance();
+			loc->SetLanguage("de");
+		};
+
+		Measure("JSON, every locale parsed (before)", [&dir]()
+		{
+			COldLocaleAtlas* atlas = new COldLocaleAtlas();
+			atlas->Build(dir);
+		});
+
+		/* the first start after the sources changed compiles the packs */
+		Measure("Packs, compiled from the sources", [&dir, &load]()
+		{
+			std::filesystem::remove_all(dir / "Packs");
+			load();
+		});
+
+		{
+			CLocalization loc;
+			loc.SetLocaleDirectory(dir);
+			loc.Advance();
+		}
+
+		Measure("Packs, en and de mapped", load);
+	}
+
+	std::filesystem::remove_all(dir);
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  LocalizationBench.cpp
+/// Description  :  Measures Translate against the std::map chain it replaced.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Shared.h"
+#include "Services/Localization/Localization.h"
+
+namespace
+{
+	constexpr const int BENCH_MISSING	= 10;	/* every n-th text is not translated into the active language */
+
+	///----------------------------------------------------------------------------------------------------
+	/// COldLocalization Class
+	/// 	The lookup before the translation tables: a chain of std::map lookups per call.
+	///----------------------------------------------------------------------------------------------------
+	class COldLocalization
+	{
+	public:
+		struct Locale
+		{
+			std::string							DisplayName;
+			std::map<std::string, const char*>	Texts;
+		};
+
+		std::map<std::string, Locale>	LocaleAtlas;
+		Locale*							ActiveLocale = nullptr;
+
+		const char* Translate(const char* aIdentifier, const char* aLanguageIdentifier = nullptr)
+		{
+			std::string identifier = aIdentifier;
+
+			if (aLanguageIdentifier)
+			{
+				std::string languageIdentifier = aLanguageIdentifier;
+
+				auto atlasIt = LocaleAtlas.find(languageIdentifier);
+
+				if (atlasIt != LocaleAtlas.end())
+				{
+					auto it = atlasIt->second.Texts.find(identifier);
+
+					if (it != atlasIt->second.Texts.end())
+					{
+						return it->second;
+					}
+				}
+			}
+
+			if (ActiveLocale)
+			{
+				auto it = ActiveLocale->Texts.find(identifier);
+
+				if (it != ActiveLocale->Texts.end())
+				{
+					return it->second;
+				}
+			}
+
+			if (!ActiveLocale || ActiveLocale->DisplayName != "English")
+			{
+				auto atlasIt = LocaleAtlas.find("en");
+
+				if (atlasIt != LocaleAtlas.end())
+				{
+					auto it = atlasIt->second.Texts.find(identifier);
+
+					if (it != atlasIt->second.Texts.end())
+					{
+						return it->second;
+					}
+				}
+			}
+
+			return aIdentifier;
+		}
+	};
+
+	double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::string Identifier(int aIndex)
+	{
+		char buffer[16];
+		snprintf(buffer, sizeof(buffer), "((%06d))", aIndex);
+		return buffer;
+	}
+
+	std::string Text(const char* aLanguage, int aIndex)
+	{
+		return std::string(aLanguage) + " text number " + std::to_string(aIndex);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteLocale:
+	/// 	Writes a locale source with aCount texts, every aStep-th identifier is left out.
+	///----------------------------------------------------------------------------------------------------
+	void WriteLocale(const std::filesystem::path& aPath, const char* aIdentifier, const char* aDisplayName, int aCount, int aStep)
+	{
+		std::ofstream file(aPath);
+
+		file << "{ \"Identifier\": \"" << aIdentifier << "\", \"DisplayName\": \"" << aDisplayName << "\", \"Texts\": {";
+
+		bool isFirst = true;
+
+		for (int i = 0; i < aCount; i++)
+		{
+			if (aStep && i % aStep == 0) { continue; }
+
+			file << (isFirst ? "" : ",") << "\"" << Identifier(i) << "\": \"" << Text(aIdentifier, i) << "\"";
+			isFirst = false;
+		}
+
+		file << "} }";
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Returns the lookups per second of aTranslate over all identifiers.
+	///----------------------------------------------------------------------------------------------------
+	template <typename Translate>
+	double Run(const std::vector<std::string>& aIdentifiers, long long aLookups, Translate aTranslate)
+	{
+		size_t sum = 0;
+		size_t i = 0;
+
+		double start = Now();
+
+		for (long long n = 0; n < aLookups; n++)
+		{
+			sum += reinterpret_cast<size_t>(aTranslate(aIdentifiers[i].c_str()));
+			i = i + 1 < aIdentifiers.size() ? i + 1 : 0;
+		}
+
+		double elapsed = Now() - start;
+
+		/* keeps the lookups from being optimized away */
+		if (sum == 1) { printf("\n"); }
+
+		return aLookups / elapsed;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int texts = argc > 1 ? atoi(argv[1]) : 1000;
+	long long lookups = argc > 2 ? atoll(argv[2]) : 5000000;
+
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / ("nexus-localization-bench-" + std::to_string(getpid()));
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	WriteLocale(dir / "en.json", "en", "English", texts, 0);
+	WriteLocale(dir / "de.json", "de", "Deutsch", texts, BENCH_MISSING);
+	WriteLocale(dir / "fr.json", "fr", "Francais", texts, BENCH_MISSING);
+
+	std::vector<std::string> identifiers;
+
+	for (int i = 0; i < texts; i++)
+	{
+		identifiers.push_back(Identifier(i));
+	}
+
+	/* the old atlas holds every language parsed */
+	COldLocalization old;
+	std::vector<std::string> pool;
+	pool.reserve(texts * 3);
+
+	for (const char* lang : { "en", "de", "fr" })
+	{
+		COldLocalization::Locale& locale = old.LocaleAtlas[lang];
+		locale.DisplayName = lang;
+
+		for (int i = 0; i < texts; i++)
+		{
+			if (lang[0] != 'e' && i % BENCH_MISSING == 0) { continue; }
+
+			pool.push_back(Text(lang, i));
+			locale.Texts[identifiers[i]] = pool.back().c_str();
+		}
+	}
+
+	old.ActiveLocale = &old.LocaleAtlas["de"];
+
+	CLocalization loc;
+	loc.SetLocaleDirectory(dir);
+	loc.Advance();
+	loc.SetLanguage("Deutsch");
+	loc.Translate(identifiers[0].c_str(), "fr");
+	loc.Advance();
+
+	printf("%d identifiers, %lld lookups each, active language de with %d%% english fallbacks.\n\n", texts, lookups, 100 / BENCH_MISSING);
+	printf("%-36s %16s %14s\n", "Lookup", "Lookups/s", "ns/lookup");
+
+	auto report = [](const char* aName, double aRate)
+	{
+		printf("%-36s %16.0f %14.1f\n", aName, aRate, 1e9 / aRate);
+	};
+
+	report("std::map chain, active", Run(identifiers, lookups, [&](const char* aId) { return old.Translate(aId); }));
+	report("Translate, active", Run(identifiers, lookups, [&](const char* aId) { return loc.Translate(aId); }));
+	report("std::map chain, into fr", Run(identifiers, lookups, [&](const char* aId) { return old.Translate(aId, "fr"); }));
+	report("Translate, into fr", Run(identifiers, lookups, [&](const char* aId) { return loc.Translate(aId, "fr"); }));
+
+	/* the render thread publishing a new table every frame while translating */
+	{
+		std::atomic<bool> isRunning{ true };
+		std::thread writer([&]()
+		{
+			int i = 0;
+
+			while (isRunning.load(std::memory_order_relaxed))
+			{
+				std::string text = "set " + std::to_string(i);
+				loc.Set(identifiers[i % texts].c_str(), "de", text.c_str());
+				loc.Advance();
+				i++;
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			}
+		});
+
+		report("Translate, publishing every 16 ms", Run(identifiers, lookups, [&](const char* aId) { return loc.Translate(aId); }));
+
+		isRunning = false;
+		writer.join();
+	}
+
+	printf("\nRetired tables left: %zu\n", loc.GetRetiredCount());
+
+	std::filesystem::remove_all(dir);
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  MumbleHistoryBench.cpp
+/// Description  :  Measures inserting MumbleLink samples and interpolated lookups into the history.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Services/Mumble/History.h"
+
+namespace
+{
+	constexpr const int BENCH_CALLS = 10000000;
+	constexpr const long long BENCH_INTERVAL = 16667; /* us, a game update per frame at 60 fps */
+
+	std::atomic<float> Sink{ 0 };
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	MumbleSample At(long long aTime, unsigned aTick)
+	{
+		float pos = static_cast<float>(aTime / 1000000.0);
+
+		MumbleSample sample{};
+		sample.Time = aTime;
+		sample.UITick = aTick;
+		sample.AvatarPosition = Vector3{ pos, 0.0f, pos };
+		sample.CameraPosition = Vector3{ pos, 2.0f, pos - 5.0f };
+		sample.CameraFront = Vector3{ 0.0f, 0.0f, 1.0f };
+		return sample;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Lookup:
+	/// 	Interpolates aCalls times at aBehind microseconds before the newest sample, returns the ns per call.
+	///----------------------------------------------------------------------------------------------------
+	double Lookup(const MumbleHistory* aHistory, long long aNewest, long long aBehind, int aCalls)
+	{
+		MumbleSample out{};
+		float sum = 0;
+
+		long long start = Now();
+
+		for (int i = 0; i < aCalls; i++)
+		{
+			/* a different time every call, like frames between two updates */
+			CMumbleHistory::Interpolate(aHistory, aNewest - aBehind + (i & 1023) * 10, &out);
+			sum += out.AvatarPosition.X;
+		}
+
+		double ns = static_cast<double>(Now() - start) / aCalls;
+		Sink = sum;
+		return ns;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int calls = argc > 1 ? atoi(argv[1]) : BENCH_CALLS;
+
+	Mumble::Data link{};
+	MumbleHistory history{};
+	CMumbleHistory sampler(&link, &history);
+
+	printf("%d calls, %u samples kept.\n\n", calls, MH_SAMPLES);
+	printf("%-44s %12s\n", "Operation", "ns/call");
+
+	/* insertion */
+	long long start = Now();
+	for (int i = 1; i <= calls; i++)
+	{
+		sampler.Push(At(i * BENCH_INTERVAL, i));
+	}
+	printf("%-44s %12.1f\n", "Push", static_cast<double>(Now() - start) / calls);
+
+	/* a frame with a game update: reads the link and pushes */
+	start = Now();
+	for (int i = 1; i <= calls; i++)
+	{
+		link.UITick = calls + i;
+		link.AvatarPosition.X = static_cast<float>(i);
+		sampler.Sample((calls + i) * BENCH_INTERVAL);
+	}
+	printf("%-44s %12.1f\n", "Sample, link updated", static_cast<double>(Now() - start) / calls);
+
+	/* a frame without one only sets the frame time */
+	start = Now();
+	for (int i = 1; i <= calls; i++)
+	{
+		sampler.Sample(i);
+	}
+	printf("%-44s %12.1f\n", "Sample, link unchanged", static_cast<double>(Now() - start) / calls);
+
+	/* lookups, the newest sample is at the end of the last loop */
+	long long newest = 2LL * calls * BENCH_INTERVAL;
+
+	printf("%-44s %12.1f\n", "Interpolate, extrapolated past the newest", Lookup(&history, newest, -BENCH_INTERVAL, calls));
+	printf("%-44s %12.1f\n", "Interpolate, one interval behind", Lookup(&history, newest, BENCH_INTERVAL, calls));
+	printf("%-44s %12.1f\n", "Interpolate, half the ring behind", Lookup(&history, newest, MH_SAMPLES / 2 * BENCH_INTERVAL, calls));
+	printf("%-44s %12.1f\n", "Interpolate, clamped to the oldest", Lookup(&history, newest, MH_SAMPLES * 2 * BENCH_INTERVAL, calls));
+
+	/* overlays of several addons looking up while the render thread pushes */
+	std::atomic<bool> isRunning{ true };
+	std::atomic<long long> newestPushed{ newest };
+	std::thread writer([&]()
+	{
+		for (long long i = 1; isRunning; i++)
+		{
+			long long time = newest + i * BENCH_INTERVAL;
+			sampler.Push(At(time, static_cast<unsigned>(i)));
+			newestPushed = time;
+		}
+	});
+
+	const int readerCount = 4;
+	std::vector<double> ns(readerCount);
+	std::vector<std::thread> readers;
+
+	for (int r = 0; r < readerCount; r++)
+	{
+		readers.emplace_back([&, r]()
+		{
+			MumbleSample out{};
+			float sum = 0;
+
+			long long begin = Now();
+
+			for (int i = 0; i < calls / readerCount; i++)
+			{
+				CMumbleHistory::Interpolate(&history, newestPushed - BENCH_INTERVAL, &out);
+				sum += out.AvatarPosition.X;
+			}
+
+			ns[r] = static_cast<double>(Now() - begin) / (calls / readerCount);
+			Sink = sum;
+		});
+	}
+
+	for (std::thread& reader : readers)
+	{
+		reader.join();
+	}
+
+	isRunning = false;
+	writer.join();
+
+	double total = 0;
+	for (double readerNs : ns) { total += readerNs; }
+	printf("%-44s %12.1f\n", "Interpolate, 4 readers while pushing", total / readerCount);
+
+	return 0;
+}
@@ -0,0 +1,216 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  MumbleReaderBench.cpp
+/// Description  :  Measures the CPU time of the MumbleLink reader per hour of idle play, old against new.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <time.h>
+
+#include "nlohmann/json.hpp"
+#include "Services/Mumble/IdentityParser.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+	/* standing in a city, the game updates the tick every frame */
+	const wchar_t* IDENTITY = L"{\"name\":\"Zojja Mistwalker\",\"profession\":6,\"spec\":48,\"race\":0,\"map_id\":1206,"
+		L"\"world_id\":268435458,\"team_color_id\":0,\"commander\":false,\"map\":1206,\"fov\":0.873,\"uisz\":1}";
+
+	Mumble::Data		Link{};
+	std::atomic<bool>	IsRunning{ true };
+
+	std::mutex				Mutex;
+	std::condition_variable	ConVar;
+
+	long long ThreadCpuNs()
+	{
+		timespec ts{};
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+		return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	}
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		unsigned long long	Ticks;
+		unsigned long long	Parses;
+		long long			CpuNs;
+		long long			WallNs;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// OldReader:
+	/// 	The loop before: one copy, the identity parsed with nlohmann every tick, 50x Sleep(1).
+	///----------------------------------------------------------------------------------------------------
+	Result OldReader(long long aDuration)
+	{
+		Result result{};
+		Mumble::Data snapshot{};
+		Mumble::Identity parsed{};
+
+		long long cpu = ThreadCpuNs();
+		long long start = Now();
+
+		while (Now() - start < aDuration)
+		{
+			memcpy(&snapshot, &Link, sizeof(Mumble::Data));
+			result.Ticks++;
+
+			if (snapshot.Identity[0])
+			{
+				try
+				{
+					json j = json::parse(std::wstring(snapshot.Identity));
+					std::string name = j["name"].get<std::string>();
+					strncpy(parsed.Name, name.c_str(), sizeof(parsed.Name) - 1);
+					parsed.MapID = j["map_id"].get<unsigned>();
+					parsed.FOV = j["fov"].get<float>();
+					parsed.UISize = static_cast<Mumble::EUIScale>(j["uisz"].get<unsigned>());
+					result.Parses++;
+				}
+				catch (...) {}
+			}
+
+			for (size_t i = 0; i < 50; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		result.CpuNs = ThreadCpuNs() - cpu;
+		result.WallNs = Now() - start;
+		return result;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// NewReader:
+	/// 	The loop now: two copies compared, the identity parsed on change, one wait per tick.
+	///----------------------------------------------------------------------------------------------------
+	Result NewReader(long long aDuration, unsigned aTickRate)
+	{
+		Result result{};
+		Mumble::Data snapshot{};
+		Mumble::Data check{};
+		decltype(Mumble::Data::Identity) previous = {};
+		Mumble::Identity parsed{};
+
+		long long cpu = ThreadCpuNs();
+		long long start = Now();
+
+		std::unique_lock<std::mutex> lock(Mutex);
+
+		while (Now() - start < aDuration)
+		{
+			lock.unlock();
+
+			memcpy(&snapshot, &Link, sizeof(Mumble::Data));
+			memcpy(&check, &Link, sizeof(Mumble::Data));
+			bool isConsistent = memcmp(&snapshot, &check, sizeof(Mumble::Data)) == 0;
+			result.Ticks++;
+
+			if (isConsistent && snapshot.Identity[0] && wcscmp(snapshot.Identity, previous) != 0)
+			{
+				memcpy(previous, snapshot.Identity, sizeof(previous));
+				Mumble::ParseIdentity(snapshot.Identity, sizeof(snapshot.Identity) / sizeof(snapshot.Identity[0]), &parsed);
+				result.Parses++;
+			}
+
+			lock.lock();
+			ConVar.wait_for(lock, std::chrono::milliseconds(aTickRate), [] { return !IsRunning; });
+		}
+
+		result.CpuNs = ThreadCpuNs() - cpu;
+		result.WallNs = Now() - start;
+		return result;
+	}
+
+	template <typename Fn>
+	Result RunOnThread(Fn aReader)
+	{
+		Result result{};
+		std::thread reader([&]() { result = aReader(); });
+		reader.join();
+		return result;
+	}
+
+	void Print(const char* aName, const Result& aResult)
+	{
+		double perHour = static_cast<double>(aResult.CpuNs) / aResult.WallNs * 3600.0;
+		printf("%-28s %10llu %10llu %16.2f\n", aName, aResult.Ticks, aResult.Parses, perHour);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int seconds = argc > 1 ? atoi(argv[1]) : 20;
+	long long duration = seconds * 1000000000LL;
+
+	wcsncpy(Link.Identity, IDENTITY, sizeof(Link.Identity) / sizeof(Link.Identity[0]) - 1);
+
+	/* the game, 60 frames per second */
+	std::atomic<bool> isGameRunning{ true };
+	std::thread game([&]()
+	{
+		while (isGameRunning)
+		{
+			Link.UITick++;
+			std::this_thread::sleep_for(std::chrono::microseconds(16667));
+		}
+	});
+
+	printf("Reader thread over %ds of idle play.\n\n", seconds);
+	printf("%-28s %10s %10s %16s\n", "Reader", "ticks", "parses", "cpu s/hour");
+
+	Print("old (50x Sleep(1))", RunOnThread([&]() { return OldReader(duration); }));
+	Print("new, gameplay (20ms)", RunOnThread([&]() { return NewReader(duration, 20); }));
+	Print("new, menus (250ms)", RunOnThread([&]() { return NewReader(duration, 250); }));
+	Print("new, minimized (1s)", RunOnThread([&]() { return NewReader(duration, 1000); }));
+
+	isGameRunning = false;
+	game.join();
+
+	/* a single parse of the identity */
+	const int parses = 100000;
+	Mumble::Identity identity{};
+	size_t length = wcslen(IDENTITY) + 1;
+
+	long long start = Now();
+	for (int i = 0; i < parses; i++)
+	{
+		json j = json::parse(std::wstring(IDENTITY));
+		identity.FOV = j["fov"].get<float>();
+	}
+	double oldNs = static_cast<double>(Now() - start) / parses;
+
+	start = Now();
+	for (int i = 0; i < parses; i++)
+	{
+		Mumble::ParseIdentity(IDENTITY, length, &identity);
+	}
+	double newNs = static_cast<double>(Now() - start) / parses;
+
+	printf("\n%-28s %10.2f us\n%-28s %10.2f us\n", "Identity parse, nlohmann", oldNs / 1000, "Identity parse, new", newNs / 1000);
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RawInputBench.cpp
+/// Description  :  Measures dispatching WM_MOUSEMOVE to key callbacks, registered filtered and unfiltered.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Shared.h"
+
+namespace
+{
+	constexpr const int BENCH_MESSAGES = 1000000;
+
+	std::atomic<unsigned long long> Calls{ 0 };
+
+	/* an addon looking at key messages only, it checks the message itself when unfiltered */
+	template <int N>
+	UINT OnKey(HWND, UINT uMsg, WPARAM, LPARAM)
+	{
+		if (uMsg < WM_KEYFIRST || uMsg > WM_KEYLAST) { return 1; }
+
+		Calls.fetch_add(1, std::memory_order_relaxed);
+		return 1;
+	}
+
+	template <int... N>
+	struct Callbacks
+	{
+		static constexpr WNDPROC_CALLBACK List[] = { OnKey<N>... };
+	};
+
+	/* distinct functions, the registry tells them apart by address */
+	using BenchCallbacks = Callbacks<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+		20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39>;
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Dispatches aMessages mouse moves with aCount callbacks and returns the ns per message.
+	///----------------------------------------------------------------------------------------------------
+	double Run(int aCount, bool aIsFiltered, int aMessages)
+	{
+		CRawInputApi api;
+
+		for (int i = 0; i < aCount; i++)
+		{
+			if (aIsFiltered)
+			{
+				api.Register(BenchCallbacks::List[i], WM_KEYFIRST, WM_KEYLAST);
+			}
+			else
+			{
+				api.Register(BenchCallbacks::List[i]);
+			}
+		}
+
+		Calls = 0;
+
+		long long start = Now();
+
+		for (int i = 0; i < aMessages; i++)
+		{
+			api.WndProc(nullptr, WM_MOUSEMOVE, 0, static_cast<LPARAM>(i & 0xFFFF));
+		}
+
+		return static_cast<double>(Now() - start) / aMessages;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int count = argc > 1 ? atoi(argv[1]) : 20;
+
+	if (count < 0 || count > static_cast<int>(sizeof(BenchCallbacks::List) / sizeof(BenchCallbacks::List[0])))
+	{
+		printf("Between 0 and %zu callbacks.\n", sizeof(BenchCallbacks::List) / sizeof(BenchCallbacks::List[0]));
+		return 1;
+	}
+
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	printf("%d callbacks for key messages, %d WM_MOUSEMOVE messages.\n\n", count, BENCH_MESSAGES);
+	printf("%-32s %12s\n", "Registration", "ns/message");
+
+	/* warm up */
+	Run(count, false, BENCH_MESSAGES / 10);
+
+	printf("%-32s %12.1f\n", "Unfiltered", Run(count, false, BENCH_MESSAGES));
+	printf("%-32s %12.1f\n", "Filtered to WM_KEYFIRST..LAST", Run(count, true, BENCH_MESSAGES));
+
+	CallbackWatchdog = nullptr;
+
+	return 0;
+}
@@ -0,0 +1,170 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  SeqLockBench.cpp
+/// Description  :  Measures consistent reads of versioned resources against plain copies, with and without a writer.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "Shared.h"
+#include "Services/DataLink/DataLink.h"
+
+namespace
+{
+	constexpr const int BENCH_READS = 2000000;
+	constexpr const int BENCH_RUNS = 3;
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Resource Struct
+	/// 	A version and words that all hold the same value, a copy with different words is torn.
+	///----------------------------------------------------------------------------------------------------
+	template <size_t Size>
+	struct Resource
+	{
+		unsigned	Version;
+		unsigned	Words[(Size - sizeof(unsigned)) / sizeof(unsigned)];
+
+		bool IsWhole() const
+		{
+			return std::all_of(std::begin(this->Words), std::end(this->Words), [this](unsigned aWord) { return aWord == this->Words[0]; });
+		}
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Result Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Result
+	{
+		double		ReadNs;		/* per read, the best of BENCH_RUNS runs */
+		long long	Torn;		/* copies with words of different writes */
+		long long	Failed;		/* reads that found no consistent copy within the retries */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Calls aRead aReads times, while aWrite is called in a loop on another thread if set.
+	///----------------------------------------------------------------------------------------------------
+	template <typename T, typename Read, typename Write>
+	Result Run(int aReads, Read aRead, Write* aWrite)
+	{
+		Result result{};
+
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			std::atomic<bool> isReading{ true };
+			std::thread writer;
+
+			if (aWrite)
+			{
+				writer = std::thread([&isReading, aWrite]()
+				{
+					unsigned value = 0;
+					while (isReading.load(std::memory_order_relaxed)) { (*aWrite)(++value); }
+				});
+			}
+
+			T copy;
+			long long torn = 0;
+			long long failed = 0;
+			long long start = Now();
+
+			for (int i = 0; i < aReads; i++)
+			{
+				if (!aRead(copy)) { failed++; }
+				else if (!copy.IsWhole()) { torn++; }
+			}
+
+			double ns = static_cast<double>(Now() - start) / aReads;
+
+			isReading = false;
+			if (writer.joinable()) { writer.join(); }
+
+			result.ReadNs = run == 0 ? ns : (std::min)(result.ReadNs, ns);
+			result.Torn += torn;
+			result.Failed += failed;
+		}
+
+		return result;
+	}
+
+	template <size_t Size>
+	void Measure(CDataLink& aDataLink, const char* aIdentifier, int aReads)
+	{
+		using T = Resource<Size>;
+
+		T* resource = (T*)aDataLink.ShareVersionedResource(aIdentifier, sizeof(T), offsetof(T, Version), false);
+
+		auto plain = [resource](T& aCopy)
+		{
+			memcpy(&aCopy, resource, sizeof(T));
+			return true;
+		};
+
+		auto seqLock = [resource](T& aCopy)
+		{
+			return SeqLock::Read(&resource->Version, resource, &aCopy, sizeof(T));
+		};
+
+		auto versioned = [&aDataLink, aIdentifier](T& aCopy)
+		{
+			return aDataLink.ReadResource(aIdentifier, &aCopy, sizeof(T), nullptr);
+		};
+
+		auto write = [resource](unsigned aValue)
+		{
+			SeqLock::BeginWrite(&resource->Version);
+			std::fill(std::begin(resource->Words), std::end(resource->Words), aValue);
+			SeqLock::EndWrite(&resource->Version);
+		};
+
+		using Write = decltype(write);
+		Write* none = nullptr;
+
+		auto print = [](const char* aName, const Result& aResult)
+		{
+			printf("%-36s %12.1f %12lld %12lld\n", aName, aResult.ReadNs, aResult.Torn, aResult.Failed);
+		};
+
+		printf("\n%zu bytes:\n", sizeof(T));
+
+		print("memcpy", Run<T>(aReads, plain, none));
+		print("SeqLock::Read", Run<T>(aReads, seqLock, none));
+		print("ReadResource", Run<T>(aReads, versioned, none));
+		print("memcpy, one writer", Run<T>(aReads, plain, &write));
+		print("SeqLock::Read, one writer", Run<T>(aReads, seqLock, &write));
+		print("ReadResource, one writer", Run<T>(aReads, versioned, &write));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int reads = argc > 1 ? atoi(argv[1]) : BENCH_READS;
+
+	CDataLink dataLink;
+
+	printf("%d reads, best of %d, %u hardware threads.\n", reads, BENCH_RUNS, std::thread::hardware_concurrency());
+	printf("Times include checking the copy. ReadResource adds the lookup of the identifier to SeqLock::Read.\n");
+	printf("The writer rewrites the resource in a loop, a reader that is preempted counts the time it waits.\n");
+	printf("%-36s %12s %12s %12s", "", "ns/read", "torn", "failed");
+
+	/* about a position, the mumble identity and a combat summary */
+	Measure<64>(dataLink, "DL_BENCH_64", reads);
+	Measure<256>(dataLink, "DL_BENCH_256", reads);
+	Measure<4096>(dataLink, "DL_BENCH_4096", reads / 8);
+
+	return 0;
+}
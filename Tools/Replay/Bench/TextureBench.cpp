@@ -0,0 +1,157 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureBench.cpp
+/// Description  :  Measures mip generation and BC3 encoding throughput and quality on a set of images.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "thirdparty/stb/stb_image.h"
+
+#include "Services/Textures/TextureProcessor.h"
+
+namespace
+{
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Image Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Image
+	{
+		std::string					Name;
+		TextureLevel				Level;
+	};
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf(
+			"Usage: nexus-texture-bench <directory> [repetitions]\n"
+			"\n"
+			"Generates mip chains and BC3 encodes every PNG in the directory, e.g. src/Resources,\n"
+			"and reports the throughput and the PSNR of the decoded base levels.\n");
+		return 1;
+	}
+
+	int repetitions = argc > 2 ? atoi(argv[2]) : 5;
+
+	std::vector<Image> images;
+
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(argv[1]))
+	{
+		if (entry.path().extension() != ".png") { continue; }
+
+		int width, height, comp;
+		unsigned char* data = stbi_load(entry.path().string().c_str(), &width, &height, &comp, 4);
+
+		if (!data) { continue; }
+
+		images.push_back(Image{
+			entry.path().lexically_relative(argv[1]).generic_string(),
+			TextureLevel{ (unsigned)width, (unsigned)height, (unsigned)width * 4, std::vector<unsigned char>(data, data + (size_t)width * height * 4) }
+		});
+
+		stbi_image_free(data);
+	}
+
+	if (images.empty())
+	{
+		fprintf(stderr, "\"%s\" has no PNG images.\n", argv[1]);
+		return 1;
+	}
+
+	std::sort(images.begin(), images.end(), [](const Image& aLeft, const Image& aRight) { return aLeft.Name < aRight.Name; });
+
+	long long mipTime = 0;
+	long long encodeTime = 0;
+	double basePixels = 0;
+	double chainPixels = 0;
+	size_t rawBytes = 0;
+	size_t encodedBytes = 0;
+	size_t compressible = 0;
+	double psnrSum = 0;
+	double psnrMin = INFINITY;
+
+	printf("%-40s %11s %8s %10s\n", "Image", "Size", "Levels", "PSNR dB");
+
+	for (const Image& image : images)
+	{
+		const TextureLevel& base = image.Level;
+		bool canCompress = TextureProcessor::CanCompress(base.Width, base.Height);
+		std::vector<TextureLevel> levels;
+
+		for (int r = 0; r < repetitions; r++)
+		{
+			long long start = Now();
+			levels = TextureProcessor::GenerateMips(base.Data.data(), base.Width, base.Height, 0);
+			mipTime += Now() - start;
+
+			/* like the loader, only textures with a multiple of 4 are encoded */
+			if (!canCompress) { continue; }
+
+			start = Now();
+
+			for (const TextureLevel& level : levels)
+			{
+				TextureLevel encoded = TextureProcessor::CompressBC3(level);
+
+				if (r == 0) { encodedBytes += encoded.Data.size(); }
+			}
+
+			encodeTime += Now() - start;
+		}
+
+		for (const TextureLevel& level : levels)
+		{
+			if (canCompress)
+			{
+				chainPixels += (double)level.Width * level.Height;
+				rawBytes += level.Data.size();
+			}
+		}
+
+		basePixels += (double)base.Width * base.Height;
+
+		if (!canCompress)
+		{
+			printf("%-40s %5ux%-5u %8zu %10s\n", image.Name.c_str(), base.Width, base.Height, levels.size(), "-");
+			continue;
+		}
+
+		compressible++;
+
+		double psnr = TextureProcessor::GetPSNR(base, TextureProcessor::DecompressBC3(TextureProcessor::CompressBC3(base)));
+		psnrSum += psnr;
+		psnrMin = (std::min)(psnrMin, psnr);
+
+		printf("%-40s %5ux%-5u %8zu %10.2f\n", image.Name.c_str(), base.Width, base.Height, levels.size(), psnr);
+	}
+
+	printf("\n%zu images, %zu encodable, %d repetitions.\n", images.size(), compressible, repetitions);
+	printf("Mip generation: %.1f Mpixel/s of base level.\n", basePixels * repetitions / (mipTime / 1e3));
+
+	if (compressible > 0)
+	{
+		printf("BC3 encoding:   %.1f Mpixel/s over the whole chains.\n", chainPixels * repetitions / (encodeTime / 1e3));
+		printf("BC3 quality:    %.2f dB PSNR on average, %.2f dB at worst.\n", psnrSum / compressible, psnrMin);
+		printf("Memory:         %zu KiB RGBA with mips, %zu KiB BC3 (%.1fx smaller).\n", rawBytes / 1024, encodedBytes / 1024, (double)rawBytes / encodedBytes);
+	}
+
+	return 0;
+}
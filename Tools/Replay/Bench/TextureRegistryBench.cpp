@@ -0,0 +1,214 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureRegistryBench.cpp
+/// Description  :  Measures texture lookups while a loader thread keeps inserting textures.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Util/ConcurrentMap.h"
+
+namespace
+{
+	constexpr const int BENCH_TEXTURES	= 200;		/* looked up by the readers, like QuickAccess icons */
+	constexpr const int BENCH_INSERTS	= 200000;	/* inserted by the loader thread at most */
+
+	struct Texture
+	{
+		unsigned	Width;
+		unsigned	Height;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// CMapRegistry Class
+	/// 	The registry before CConcurrentMap: a std::map under the loader mutex, looked up twice.
+	///----------------------------------------------------------------------------------------------------
+	class CMapRegistry
+	{
+	public:
+		Texture* Get(const char* aIdentifier)
+		{
+			std::string str = aIdentifier;
+
+			Texture* result = nullptr;
+
+			{
+				const std::lock_guard<std::mutex> lock(this->Mutex);
+				if (this->Registry.find(str) != this->Registry.end())
+				{
+					result = this->Registry[str];
+				}
+			}
+
+			return result;
+		}
+
+		void Insert(const char* aIdentifier, Texture* aTexture)
+		{
+			const std::lock_guard<std::mutex> lock(this->Mutex);
+			this->Registry[aIdentifier] = aTexture;
+		}
+
+	private:
+		std::mutex							Mutex;
+		std::map<std::string, Texture*>		Registry;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// CHashRegistry Class
+	/// 	The registry of CTextureLoader.
+	///----------------------------------------------------------------------------------------------------
+	class CHashRegistry
+	{
+	public:
+		Texture* Get(const char* aIdentifier)
+		{
+			std::atomic<Texture*>* slot = this->Registry.Find(aIdentifier);
+
+			return slot ? slot->load(std::memory_order_acquire) : nullptr;
+		}
+
+		Texture* const* GetHandle(const char* aIdentifier)
+		{
+			return reinterpret_cast<Texture* const*>(this->Registry.FindOrInsert(aIdentifier));
+		}
+
+		void Insert(const char* aIdentifier, Texture* aTexture)
+		{
+			this->Registry.FindOrInsert(aIdentifier)->store(aTexture, std::memory_order_release);
+		}
+
+	private:
+		CConcurrentMap<std::atomic<Texture*>>	Registry;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Returns the lookups per second of all readers, while the loader thread inserts.
+	///----------------------------------------------------------------------------------------------------
+	template <typename Registry, typename Lookup>
+	double Run(Registry& aRegistry, int aReaders, double aSeconds, const std::vector<std::string>& aNames, Lookup aLookup, int* aOutInserts)
+	{
+		static Texture texture{ 64, 64 };
+
+		std::atomic<bool> isRunning{ true };
+		std::atomic<unsigned long long> lookups{ 0 };
+		std::atomic<unsigned long long> misses{ 0 };
+
+		std::thread loader([&]()
+		{
+			char name[64];
+			int i = 0;
+
+			for (; i < BENCH_INSERTS && isRunning.load(std::memory_order_relaxed); i++)
+			{
+				snprintf(name, sizeof(name), "TEX_LOADED_%d", i);
+				aRegistry.Insert(name, &texture);
+			}
+
+			*aOutInserts = i;
+		});
+
+		std::vector<std::thread> readers;
+
+		for (int r = 0; r < aReaders; r++)
+		{
+			readers.emplace_back([&, r]()
+			{
+				unsigned long long count = 0;
+				unsigned long long missed = 0;
+				size_t i = r;
+
+				while (isRunning.load(std::memory_order_relaxed))
+				{
+					for (int n = 0; n < 1000; n++)
+					{
+						if (!aLookup(i)) { missed++; }
+						i = i + 1 < aNames.size() ? i + 1 : 0;
+					}
+
+					count += 1000;
+				}
+
+				lookups += count;
+				misses += missed;
+			});
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::duration<double>(aSeconds));
+		isRunning = false;
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (std::thread& reader : readers) { reader.join(); }
+		loader.join();
+
+		if (misses > 0) { fprintf(stderr, "%llu lookups missed.\n", misses.load()); }
+
+		return lookups / elapsed;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int readers = argc > 1 ? atoi(argv[1]) : 2;
+	double seconds = argc > 2 ? atof(argv[2]) : 1.0;
+
+	static Texture texture{ 32, 32 };
+
+	std::vector<std::string> names;
+
+	for (int i = 0; i < BENCH_TEXTURES; i++)
+	{
+		names.push_back("ICON_SHORTCUT_" + std::to_string(i));
+	}
+
+	printf("%d readers looking up %d textures, one loader thread inserting up to %d more, %.1f s each.\n\n", readers, BENCH_TEXTURES, BENCH_INSERTS, seconds);
+	printf("%-28s %16s %14s %16s\n", "Registry", "Lookups/s", "ns/lookup", "Loader inserts");
+
+	{
+		CMapRegistry registry;
+		for (const std::string& name : names) { registry.Insert(name.c_str(), &texture); }
+
+		int inserts = 0;
+		double rate = Run(registry, readers, seconds, names, [&](size_t i) { return registry.Get(names[i].c_str()); }, &inserts);
+		printf("%-28s %16.0f %14.1f %16d\n", "std::map + mutex", rate, 1e9 * readers / rate, inserts);
+	}
+
+	{
+		CHashRegistry registry;
+		for (const std::string& name : names) { registry.Insert(name.c_str(), &texture); }
+
+		int inserts = 0;
+		double rate = Run(registry, readers, seconds, names, [&](size_t i) { return registry.Get(names[i].c_str()); }, &inserts);
+		printf("%-28s %16.0f %14.1f %16d\n", "CConcurrentMap::Find", rate, 1e9 * readers / rate, inserts);
+	}
+
+	{
+		CHashRegistry registry;
+		for (const std::string& name : names) { registry.Insert(name.c_str(), &texture); }
+
+		/* resolved once, like QuickAccess shortcuts */
+		std::vector<Texture* const*> handles;
+		for (const std::string& name : names) { handles.push_back(registry.GetHandle(name.c_str())); }
+
+		int inserts = 0;
+		double rate = Run(registry, readers, seconds, names, [&](size_t i)
+		{
+			return reinterpret_cast<const std::atomic<Texture*>*>(handles[i])->load(std::memory_order_acquire);
+		}, &inserts);
+		printf("%-28s %16.0f %14.1f %16d\n", "Handle", rate, 1e9 * readers / rate, inserts);
+	}
+
+	return 0;
+}
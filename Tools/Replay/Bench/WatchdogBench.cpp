@@ -0,0 +1,125 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  WatchdogBench.cpp
+/// Description  :  Measures what timing a callback call with the callback watchdog costs.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+
+namespace
+{
+	constexpr const int BENCH_CALLS = 10000000;
+
+	std::atomic<unsigned long long> Calls{ 0 };
+
+	template <int N>
+	void OnRender()
+	{
+		Calls.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	typedef void (*BENCH_CALLBACK)();
+
+	template <int... N>
+	struct Callbacks
+	{
+		static constexpr BENCH_CALLBACK List[] = { OnRender<N>... };
+	};
+
+	/* distinct functions, the watchdog tells them apart by address */
+	using BenchCallbacks = Callbacks<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19>;
+
+	constexpr const int BENCH_CALLBACKS = sizeof(BenchCallbacks::List) / sizeof(BenchCallbacks::List[0]);
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Run:
+	/// 	Calls aCall aCalls times, cycling through aCallbacks callbacks, and returns the ns per call.
+	///----------------------------------------------------------------------------------------------------
+	template <typename Fn>
+	double Run(int aCalls, int aCallbacks, Fn aCall)
+	{
+		long long start = Now();
+
+		for (int i = 0; i < aCalls; i++)
+		{
+			aCall(BenchCallbacks::List[i % aCallbacks]);
+		}
+
+		return static_cast<double>(Now() - start) / aCalls;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int calls = argc > 1 ? atoi(argv[1]) : BENCH_CALLS;
+
+	CCallbackWatchdog watchdog(Logger);
+
+	/* the callbacks are too fast to ever be reported */
+	auto bare = [](BENCH_CALLBACK aCallback)
+	{
+		aCallback();
+	};
+
+	auto clock = [](BENCH_CALLBACK aCallback)
+	{
+		long long start = CCallbackWatchdog::Now();
+		aCallback();
+		long long time = CCallbackWatchdog::Now() - start;
+
+		/* keeps the reads */
+		if (time < 0) { Calls++; }
+	};
+
+	auto record = [&watchdog](BENCH_CALLBACK aCallback)
+	{
+		aCallback();
+		watchdog.Record(ECallbackType::Render, (void*)aCallback, 100);
+	};
+
+	auto instrumented = [&watchdog](BENCH_CALLBACK aCallback)
+	{
+		long long start = CCallbackWatchdog::Now();
+		aCallback();
+		long long time = CCallbackWatchdog::Now() - start;
+		watchdog.Record(ECallbackType::Render, (void*)aCallback, time);
+	};
+
+	/* warm up, claims the slots */
+	Run(calls / 10, BENCH_CALLBACKS, instrumented);
+
+	printf("%d calls.\n\n", calls);
+	printf("%-40s %12s\n", "Per callback call", "ns/call");
+	printf("%-40s %12.1f\n", "Bare call", Run(calls, 1, bare));
+	printf("%-40s %12.1f\n", "Two clock reads", Run(calls, 1, clock));
+	printf("%-40s %12.1f\n", "Record", Run(calls, 1, record));
+	printf("%-40s %12.1f\n", "Clock reads + Record, 1 callback", Run(calls, 1, instrumented));
+	printf("%-40s %12.1f\n", "Clock reads + Record, 20 callbacks", Run(calls, BENCH_CALLBACKS, instrumented));
+
+	/* the render thread and an event worker recording the same callbacks */
+	double ns[2] = {};
+	std::thread other([&]() { ns[1] = Run(calls, BENCH_CALLBACKS, instrumented); });
+	ns[0] = Run(calls, BENCH_CALLBACKS, instrumented);
+	other.join();
+	printf("%-40s %12.1f\n", "Clock reads + Record, 2 threads", (ns[0] + ns[1]) / 2);
+
+	double frame = Run(calls, BENCH_CALLBACKS, instrumented) - Run(calls, BENCH_CALLBACKS, bare);
+	printf("\nInstrumenting %d render callbacks costs %.2f us per frame, %llu calls were dropped.\n",
+		BENCH_CALLBACKS, frame * BENCH_CALLBACKS / 1000, watchdog.GetDropped());
+
+	return 0;
+}
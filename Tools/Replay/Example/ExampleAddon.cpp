@@ -0,0 +1,65 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ExampleAddon.cpp
+/// Description  :  Sums the damage of the local player, once per event and once per batch.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdio>
+
+#include "ReplayAPI.h"
+
+namespace
+{
+	ReplayAPI* API = nullptr;
+
+	uint64_t SelfAgent = 0;		/* batches only carry agent IDs, the events tell which one is the player */
+	long long EventDamage = 0;
+	long long BatchDamage = 0;
+
+	bool IsDamage(uint8_t aIsStateChange, uint8_t aIsActivation, uint8_t aIsBuffRemove)
+	{
+		return !aIsStateChange && !aIsActivation && !aIsBuffRemove;
+	}
+
+	void OnCombatEvent(void* aEventArgs)
+	{
+		EvCombatData* combatData = (EvCombatData*)aEventArgs;
+
+		if (!combatData || !combatData->Event || !combatData->Source || !combatData->Source->IsSelf) { return; }
+
+		const ArcDPS::CombatEvent* ev = combatData->Event;
+
+		SelfAgent = ev->SrcAgent;
+
+		if (!IsDamage(ev->IsStateChange, ev->IsActivation, ev->IsBuffRemove)) { return; }
+
+		EventDamage += ev->Buff ? ev->BuffDmg : ev->Value;
+	}
+
+	void OnCombatBatch(const CombatBatch* aBatch)
+	{
+		for (uint32_t i = 0; i < aBatch->Count; i++)
+		{
+			if (aBatch->SrcAgent[i] != SelfAgent || !IsDamage(aBatch->IsStateChange[i], aBatch->IsActivation[i], aBatch->IsBuffRemove[i])) { continue; }
+
+			BatchDamage += aBatch->Buff[i] ? aBatch->BuffDmg[i] : aBatch->Value[i];
+		}
+	}
+}
+
+extern "C" void ReplayLoad(ReplayAPI* aApi)
+{
+	API = aApi;
+	API->Events.Subscribe("EV_ARCDPS_COMBATEVENT_LOCAL_RAW", OnCombatEvent);
+	API->Events.SubscribeCombatBatch("EV_ARCDPS_COMBATEVENT_LOCAL_RAW", OnCombatBatch);
+}
+
+extern "C" void ReplayUnload()
+{
+	API->Events.Unsubscribe("EV_ARCDPS_COMBATEVENT_LOCAL_RAW", OnCombatEvent);
+	API->Events.UnsubscribeCombatBatch("EV_ARCDPS_COMBATEVENT_LOCAL_RAW", OnCombatBatch);
+
+	printf("Damage of the local player: %lld per event, %lld per batch.\n", EventDamage, BatchDamage);
+}
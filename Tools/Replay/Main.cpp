@@ -0,0 +1,201 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Main.cpp
+/// Description  :  Replays a recording of Nexus through addon logic compiled as shared objects.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <dlfcn.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReplayHost.h"
+
+#include "Services/Recorder/Recording.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		printf(
+			"Usage: nexus-replay [options] <recording> [addon.so ...]\n"
+			"\n"
+			"Replays the combat events and frames of a recording through the addons.\n"
+			"Addons export extern \"C\" ReplayLoad(ReplayAPI*) and optionally ReplayUnload().\n"
+			"\n"
+			"Options:\n"
+			"  --speed <factor>  Replays at the factor of the original speed. Default: 1.\n"
+			"  --max             Replays as fast as possible.\n"
+			"  --repeat <n>      Replays the recording n times. Default: 1.\n");
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetName:
+	/// 	Returns the symbol and the shared object of the callback.
+	/// 	Callbacks that are not exported are named by their offset, for addr2line.
+	///----------------------------------------------------------------------------------------------------
+	std::string GetName(void* aCallback)
+	{
+		Dl_info info{};
+
+		if (!dladdr(aCallback, &info)) { return "?"; }
+
+		std::string name;
+
+		if (info.dli_sname)
+		{
+			name = info.dli_sname;
+		}
+		else
+		{
+			char offset[32];
+			snprintf(offset, sizeof(offset), "+0x%zx", (size_t)((char*)aCallback - (char*)info.dli_fbase));
+			name = offset;
+		}
+
+		if (info.dli_fname)
+		{
+			const char* file = strrchr(info.dli_fname, '/');
+			name.append(" (").append(file ? file + 1 : info.dli_fname).append(")");
+		}
+
+		return name;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	double speed = 1.0;
+	int repeat = 1;
+	const char* recording = nullptr;
+	std::vector<const char*> addons;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+		{
+			speed = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max") == 0)
+		{
+			speed = 0.0;
+		}
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+		{
+			repeat = atoi(argv[++i]);
+		}
+		else if (argv[i][0] == '-')
+		{
+			PrintUsage();
+			return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+		else if (!recording)
+		{
+			recording = argv[i];
+		}
+		else
+		{
+			addons.push_back(argv[i]);
+		}
+	}
+
+	if (!recording || speed < 0.0 || repeat < 1)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	CReplayHost host;
+
+	for (const char* addon : addons)
+	{
+		if (!host.LoadAddon(addon)) { return 1; }
+	}
+
+	unsigned long long events = 0;
+	unsigned long long frames = 0;
+	long long recorded = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < repeat; i++)
+	{
+		CRecordingReader reader;
+
+		if (!reader.Open(recording))
+		{
+			fprintf(stderr, "\"%s\" is not a recording.\n", recording);
+			return 1;
+		}
+
+		/* every repetition continues the timeline, so the MumbleLink history keeps advancing */
+		long long offset = recorded;
+		auto repetitionStart = std::chrono::steady_clock::now();
+
+		while (const RecordedEvent* ev = reader.Next())
+		{
+			if (speed > 0.0)
+			{
+				std::this_thread::sleep_until(repetitionStart + std::chrono::microseconds(static_cast<long long>(ev->Time / speed)));
+			}
+
+			if (offset)
+			{
+				RecordedEvent shifted = *ev;
+				shifted.Time += offset;
+				shifted.Sample.Time += offset;
+				shifted.CombatData.Event = ev->CombatData.Event ? &shifted.Event : nullptr;
+				shifted.CombatData.Source = ev->CombatData.Source ? &shifted.Source : nullptr;
+				shifted.CombatData.Destination = ev->CombatData.Destination ? &shifted.Destination : nullptr;
+				host.Replay(&shifted);
+			}
+			else
+			{
+				host.Replay(ev);
+			}
+
+			if (ev->Type == ERecordType::Combat) { events++; }
+			else if (ev->Type == ERecordType::Frame) { frames++; }
+
+			if (ev->Time + offset > recorded) { recorded = ev->Time + offset; }
+		}
+
+		if (reader.IsCorrupt())
+		{
+			fprintf(stderr, "\"%s\" is corrupt, stopped after %llu events.\n", recording, events);
+		}
+	}
+
+	host.Flush();
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("Replayed %llu combat events and %llu frames of %.1fs in %.3fs (%.0f events/s, %.1fx).\n",
+		events, frames, recorded / 1000000.0, elapsed, events / elapsed, (recorded / 1000000.0) / elapsed);
+
+	std::vector<CallbackTime> timings = host.GetTimings();
+
+	if (!timings.empty())
+	{
+		printf("\n%12s %12s %12s %12s  %s\n", "Calls", "Total ms", "Avg ns", "Max us", "Callback");
+
+		for (const CallbackTime& timing : timings)
+		{
+			printf("%12llu %12.3f %12.0f %12.1f  %s\n",
+				timing.Calls,
+				timing.TotalTime / 1000000.0,
+				static_cast<double>(timing.TotalTime) / timing.Calls,
+				timing.MaxTime / 1000.0,
+				GetName(timing.Callback).c_str());
+		}
+	}
+
+	return 0;
+}
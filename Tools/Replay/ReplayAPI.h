@@ -0,0 +1,53 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ReplayAPI.h
+/// Description  :  The API the replay tool provides to addon logic compiled as shared objects.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef REPLAYAPI_H
+#define REPLAYAPI_H
+
+#include <cstddef>
+
+#include "Events/CombatBatch.h"
+#include "Events/FuncDefs.h"
+#include "Services/DataLink/FuncDefs.h"
+
+constexpr const unsigned RA_VERSION = 1;
+
+///----------------------------------------------------------------------------------------------------
+/// ReplayAPI Struct
+/// 	The members match the ones of AddonAPI, so the same event and DataLink code runs in both.
+/// 	Everything is called on the replay thread, in the order of the recording.
+///----------------------------------------------------------------------------------------------------
+struct ReplayAPI
+{
+	unsigned								Version;
+
+	struct EventsVT
+	{
+		EVENTS_RAISE						Raise;
+		EVENTS_RAISENOTIFICATION			RaiseNotification;
+		EVENTS_SUBSCRIBE					Subscribe;
+		EVENTS_SUBSCRIBE					Unsubscribe;
+		EVENTS_SUBSCRIBE_COMBATBATCH		SubscribeCombatBatch;
+		EVENTS_SUBSCRIBE_COMBATBATCH		UnsubscribeCombatBatch;
+	};
+	EventsVT								Events;
+
+	struct DataLinkVT
+	{
+		DATALINK_GETRESOURCE				Get;
+		DATALINK_SHARERESOURCE				Share;
+		DATALINK_INTERPOLATEMUMBLE			InterpolateMumble;
+	};
+	DataLinkVT								DataLink;
+};
+
+/* exported as extern "C" by the shared object, ReplayUnload is optional */
+typedef void (*REPLAY_LOAD)(ReplayAPI* aApi);
+typedef void (*REPLAY_UNLOAD)();
+
+#endif
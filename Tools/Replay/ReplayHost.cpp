@@ -0,0 +1,347 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ReplayHost.cpp
+/// Description  :  Hosts addon logic and feeds recorded events to it like Nexus does in game.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "ReplayHost.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	/* same identifiers as Consts, which depends on Windows */
+	constexpr const char* EV_ARCDPS_COMBATEVENT_LOCAL_RAW	= "EV_ARCDPS_COMBATEVENT_LOCAL_RAW";
+	constexpr const char* EV_ARCDPS_COMBATEVENT_SQUAD_RAW	= "EV_ARCDPS_COMBATEVENT_SQUAD_RAW";
+	constexpr const char* DL_MUMBLE_LINK					= "DL_MUMBLE_LINK";
+	constexpr const char* DL_MUMBLE_HISTORY					= "DL_MUMBLE_HISTORY";
+	constexpr const char* DL_COMBAT_STATS					= "DL_COMBAT_STATS";
+
+	/* the API is a table of plain function pointers */
+	CReplayHost* Host = nullptr;
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+CReplayHost::CReplayHost()
+{
+	Host = this;
+
+	this->API.Version = RA_VERSION;
+	this->API.Events.Raise = [](const char* aIdentifier, void* aEventData) { Host->Raise(aIdentifier, aEventData); };
+	this->API.Events.RaiseNotification = [](const char* aIdentifier) { Host->Raise(aIdentifier, nullptr); };
+	this->API.Events.Subscribe = [](const char* aIdentifier, EVENT_CONSUME aCallback) { Host->Subscribe(aIdentifier, aCallback); };
+	this->API.Events.Unsubscribe = [](const char* aIdentifier, EVENT_CONSUME aCallback) { Host->Unsubscribe(aIdentifier, aCallback); };
+	this->API.Events.SubscribeCombatBatch = [](const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aCallback) { Host->SubscribeCombatBatch(aIdentifier, aCallback); };
+	this->API.Events.UnsubscribeCombatBatch = [](const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aCallback) { Host->UnsubscribeCombatBatch(aIdentifier, aCallback); };
+	this->API.DataLink.Get = [](const char* aIdentifier) { return Host->GetResource(aIdentifier); };
+	this->API.DataLink.Share = [](const char* aIdentifier, size_t aResourceSize) { return Host->ShareResource(aIdentifier, aResourceSize); };
+	this->API.DataLink.InterpolateMumble = [](long long aTime, MumbleSample* aOutSample) { return Host->InterpolateMumble(aTime, aOutSample); };
+
+	this->MumbleLink = (Mumble::Data*)this->ShareResource(DL_MUMBLE_LINK, sizeof(Mumble::Data));
+	this->History = new CMumbleHistory(this->MumbleLink, (MumbleHistory*)this->ShareResource(DL_MUMBLE_HISTORY, sizeof(MumbleHistory)));
+	this->Stats = new CCombatStats((CombatStats*)this->ShareResource(DL_COMBAT_STATS, sizeof(CombatStats)));
+}
+
+CReplayHost::~CReplayHost()
+{
+	this->UnloadAddons();
+
+	delete this->Stats;
+	delete this->History;
+
+	Host = nullptr;
+}
+
+bool CReplayHost::LoadAddon(const std::filesystem::path& aPath)
+{
+	void* handle = dlopen(aPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+	if (!handle)
+	{
+		fprintf(stderr, "Could not load \"%s\": %s\n", aPath.c_str(), dlerror());
+		return false;
+	}
+
+	REPLAY_LOAD load = (REPLAY_LOAD)dlsym(handle, "ReplayLoad");
+
+	if (!load)
+	{
+		fprintf(stderr, "\"%s\" does not export ReplayLoad.\n", aPath.c_str());
+		dlclose(handle);
+		return false;
+	}
+
+	this->Addons.push_back({ aPath, handle, (REPLAY_UNLOAD)dlsym(handle, "ReplayUnload") });
+
+	load(&this->API);
+
+	return true;
+}
+
+void CReplayHost::UnloadAddons()
+{
+	/* the last batches belong to the recording */
+	this->Flush();
+
+	for (auto it = this->Addons.rbegin(); it != this->Addons.rend(); ++it)
+	{
+		if (it->Unload) { it->Unload(); }
+	}
+
+	/* closed after every addon unloaded, they may still unsubscribe each other's callbacks */
+	for (auto it = this->Addons.rbegin(); it != this->Addons.rend(); ++it)
+	{
+		dlclose(it->Handle);
+	}
+
+	this->Addons.clear();
+	this->Subscribers.clear();
+
+	for (std::vector<EVENT_CONSUME_COMBATBATCH>& subscribers : this->BatchSubscribers)
+	{
+		subscribers.clear();
+	}
+}
+
+void CReplayHost::Replay(const RecordedEvent* aEvent)
+{
+	switch (aEvent->Type)
+	{
+		case ERecordType::Combat:
+			this->Raise(aEvent->Stream == ECombatStream::Local ? EV_ARCDPS_COMBATEVENT_LOCAL_RAW : EV_ARCDPS_COMBATEVENT_SQUAD_RAW, (void*)&aEvent->CombatData);
+			break;
+
+		case ERecordType::Frame:
+			/* the game updates the link, Nexus samples it and flushes the batches before rendering */
+			if (aEvent->HasSample)
+			{
+				this->MumbleLink->UITick = aEvent->Sample.UITick;
+				this->MumbleLink->AvatarPosition = aEvent->Sample.AvatarPosition;
+				this->MumbleLink->CameraPosition = aEvent->Sample.CameraPosition;
+				this->MumbleLink->CameraFront = aEvent->Sample.CameraFront;
+			}
+
+			this->History->Sample(aEvent->Time);
+			this->Flush();
+			break;
+
+		default:
+			break;
+	}
+}
+
+void CReplayHost::Flush()
+{
+	for (int i = 0; i < static_cast<int>(ECombatStream::COUNT); i++)
+	{
+		this->Deliver(static_cast<ECombatStream>(i));
+	}
+}
+
+std::vector<CallbackTime> CReplayHost::GetTimings() const
+{
+	std::vector<CallbackTime> timings;
+
+	for (const auto& [callback, timing] : this->Timings)
+	{
+		timings.push_back(timing);
+	}
+
+	std::sort(timings.begin(), timings.end(), [](const CallbackTime& lhs, const CallbackTime& rhs)
+	{
+		return lhs.TotalTime > rhs.TotalTime;
+	});
+
+	return timings;
+}
+
+void CReplayHost::Raise(const char* aIdentifier, void* aEventData)
+{
+	ECombatStream stream;
+
+	if (GetStream(aIdentifier, &stream))
+	{
+		const EvCombatData* combatData = (const EvCombatData*)aEventData;
+
+		if (stream == ECombatStream::Squad)
+		{
+			this->Stats->Track(combatData);
+		}
+
+		/* same as Nexus, agent notifications are not batched and a full batch is delivered right away */
+		if (combatData && combatData->Event && (stream == ECombatStream::Squad || !this->BatchSubscribers[static_cast<int>(stream)].empty()))
+		{
+			CCombatBatchBuffer& batch = this->Batches[static_cast<int>(stream)];
+			batch.Append(combatData);
+
+			if (batch.IsFull())
+			{
+				this->Deliver(stream);
+			}
+		}
+	}
+
+	auto it = this->Subscribers.find(aIdentifier);
+
+	if (it == this->Subscribers.end()) { return; }
+
+	/* by index, a callback may subscribe or unsubscribe */
+	std::vector<EVENT_CONSUME>& subscribers = it->second;
+
+	for (size_t i = 0; i < subscribers.size(); i++)
+	{
+		EVENT_CONSUME callback = subscribers[i];
+
+		long long start = Now();
+		callback(aEventData);
+		this->Record((void*)callback, Now() - start);
+	}
+}
+
+void CReplayHost::Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback)
+{
+	if (!aIdentifier || !aConsumeEventCallback) { return; }
+
+	this->Subscribers[aIdentifier].push_back(aConsumeEventCallback);
+}
+
+void CReplayHost::Unsubscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback)
+{
+	if (!aIdentifier) { return; }
+
+	auto it = this->Subscribers.find(aIdentifier);
+
+	if (it == this->Subscribers.end()) { return; }
+
+	it->second.erase(std::remove(it->second.begin(), it->second.end(), aConsumeEventCallback), it->second.end());
+}
+
+void CReplayHost::SubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+{
+	ECombatStream stream;
+
+	if (!aConsumeBatchCallback || !GetStream(aIdentifier, &stream))
+	{
+		fprintf(stderr, "Combat batches can only be subscribed to for %s and %s.\n", EV_ARCDPS_COMBATEVENT_LOCAL_RAW, EV_ARCDPS_COMBATEVENT_SQUAD_RAW);
+		return;
+	}
+
+	this->BatchSubscribers[static_cast<int>(stream)].push_back(aConsumeBatchCallback);
+}
+
+void CReplayHost::UnsubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+{
+	ECombatStream stream;
+
+	if (!GetStream(aIdentifier, &stream)) { return; }
+
+	std::vector<EVENT_CONSUME_COMBATBATCH>& subscribers = this->BatchSubscribers[static_cast<int>(stream)];
+	subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), aConsumeBatchCallback), subscribers.end());
+}
+
+void* CReplayHost::GetResource(const char* aIdentifier)
+{
+	if (!aIdentifier) { return nullptr; }
+
+	auto it = this->Resources.find(aIdentifier);
+
+	return it != this->Resources.end() ? it->second.Memory.get() : nullptr;
+}
+
+void* CReplayHost::ShareResource(const char* aIdentifier, size_t aResourceSize)
+{
+	if (!aIdentifier || aResourceSize == 0) { return nullptr; }
+
+	auto it = this->Resources.find(aIdentifier);
+
+	if (it != this->Resources.end())
+	{
+		if (it->second.Size == aResourceSize)
+		{
+			return it->second.Memory.get();
+		}
+
+		fprintf(stderr, "Resource with name \"%s\" already exists with size %zu but size %zu was requested.\n", aIdentifier, it->second.Size, aResourceSize);
+		return nullptr;
+	}
+
+	/* zeroed, like a fresh file mapping */
+	Resource& resource = this->Resources[aIdentifier];
+	resource.Memory.reset(new unsigned char[aResourceSize]());
+	resource.Size = aResourceSize;
+
+	return resource.Memory.get();
+}
+
+bool CReplayHost::InterpolateMumble(long long aTime, MumbleSample* aOutSample)
+{
+	return CMumbleHistory::Interpolate((const MumbleHistory*)this->GetResource(DL_MUMBLE_HISTORY), aTime, aOutSample);
+}
+
+void CReplayHost::Deliver(ECombatStream aStream)
+{
+	CCombatBatchBuffer& batch = this->Batches[static_cast<int>(aStream)];
+
+	if (batch.GetBatch()->Count == 0) { return; }
+
+	if (aStream == ECombatStream::Squad)
+	{
+		this->Stats->Process(batch.GetBatch());
+	}
+
+	std::vector<EVENT_CONSUME_COMBATBATCH>& subscribers = this->BatchSubscribers[static_cast<int>(aStream)];
+
+	for (size_t i = 0; i < subscribers.size(); i++)
+	{
+		EVENT_CONSUME_COMBATBATCH callback = subscribers[i];
+
+		long long start = Now();
+		callback(batch.GetBatch());
+		this->Record((void*)callback, Now() - start);
+	}
+
+	batch.Clear();
+}
+
+void CReplayHost::Record(void* aCallback, long long aTime)
+{
+	CallbackTime& timing = this->Timings[aCallback];
+	timing.Callback = aCallback;
+	timing.Calls++;
+	timing.TotalTime += aTime;
+
+	if (aTime > timing.MaxTime)
+	{
+		timing.MaxTime = aTime;
+	}
+}
+
+bool CReplayHost::GetStream(const char* aIdentifier, ECombatStream* aOutStream)
+{
+	if (!aIdentifier) { return false; }
+
+	if (strcmp(aIdentifier, EV_ARCDPS_COMBATEVENT_LOCAL_RAW) == 0)
+	{
+		*aOutStream = ECombatStream::Local;
+		return true;
+	}
+
+	if (strcmp(aIdentifier, EV_ARCDPS_COMBATEVENT_SQUAD_RAW) == 0)
+	{
+		*aOutStream = ECombatStream::Squad;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,145 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ReplayHost.h
+/// Description  :  Hosts addon logic and feeds recorded events to it like Nexus does in game.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef REPLAYHOST_H
+#define REPLAYHOST_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ReplayAPI.h"
+
+#include "Events/CombatBatchApi.h"
+#include "Events/CombatBatchBuffer.h"
+#include "Services/CombatStats/CombatStats.h"
+#include "Services/Mumble/History.h"
+#include "Services/Recorder/Recording.h"
+
+///----------------------------------------------------------------------------------------------------
+/// CallbackTime Struct
+///----------------------------------------------------------------------------------------------------
+struct CallbackTime
+{
+	void*					Callback;
+	unsigned long long		Calls;
+	long long				TotalTime;		/* nanoseconds */
+	long long				MaxTime;		/* nanoseconds */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CReplayHost Class
+/// 	Mirrors the event and DataLink behaviour of Nexus on a single thread:
+/// 	- Combat events are raised to the per-event subscribers and appended to the batches.
+/// 	- Frames update DL_MUMBLE_LINK and DL_MUMBLE_HISTORY, then deliver the batches.
+/// 	- The squad batches feed DL_COMBAT_STATS before the subscribers get them.
+///----------------------------------------------------------------------------------------------------
+class CReplayHost
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CReplayHost();
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CReplayHost();
+
+	CReplayHost(const CReplayHost&) = delete;
+	CReplayHost& operator=(const CReplayHost&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// LoadAddon:
+	/// 	Loads the shared object and calls its ReplayLoad. Returns false if it can't be loaded.
+	///----------------------------------------------------------------------------------------------------
+	bool LoadAddon(const std::filesystem::path& aPath);
+
+	///----------------------------------------------------------------------------------------------------
+	/// UnloadAddons:
+	/// 	Calls ReplayUnload of every addon in reverse order and closes them.
+	///----------------------------------------------------------------------------------------------------
+	void UnloadAddons();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Replay:
+	/// 	Raises a combat event or advances a frame.
+	///----------------------------------------------------------------------------------------------------
+	void Replay(const RecordedEvent* aEvent);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Flush:
+	/// 	Delivers the pending batches.
+	///----------------------------------------------------------------------------------------------------
+	void Flush();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTimings:
+	/// 	Returns the time spent in every callback, most expensive first.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<CallbackTime> GetTimings() const;
+
+	void Raise(const char* aIdentifier, void* aEventData);
+	void Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback);
+	void Unsubscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback);
+	void SubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+	void UnsubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+	void* GetResource(const char* aIdentifier);
+	void* ShareResource(const char* aIdentifier, size_t aResourceSize);
+	bool InterpolateMumble(long long aTime, MumbleSample* aOutSample);
+
+private:
+	struct Resource
+	{
+		std::unique_ptr<unsigned char[]>			Memory;
+		size_t										Size;
+	};
+
+	struct Addon
+	{
+		std::filesystem::path						Path;
+		void*										Handle;
+		REPLAY_UNLOAD								Unload;
+	};
+
+	ReplayAPI										API{};
+	std::vector<Addon>								Addons;
+
+	std::unordered_map<std::string, std::vector<EVENT_CONSUME>>	Subscribers;
+	std::vector<EVENT_CONSUME_COMBATBATCH>			BatchSubscribers[static_cast<int>(ECombatStream::COUNT)];
+	CCombatBatchBuffer								Batches[static_cast<int>(ECombatStream::COUNT)];
+
+	std::unordered_map<std::string, Resource>		Resources;
+	Mumble::Data*									MumbleLink;
+	CMumbleHistory*									History;
+	CCombatStats*									Stats;
+
+	std::unordered_map<void*, CallbackTime>			Timings;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Deliver:
+	/// 	Calls the subscribers of the stream with its batch and clears it.
+	///----------------------------------------------------------------------------------------------------
+	void Deliver(ECombatStream aStream);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Record:
+	/// 	Adds the duration of one call.
+	///----------------------------------------------------------------------------------------------------
+	void Record(void* aCallback, long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStream:
+	/// 	Returns false if the identifier is not a batched combat event.
+	///----------------------------------------------------------------------------------------------------
+	static bool GetStream(const char* aIdentifier, ECombatStream* aOutStream);
+};
+
+#endif
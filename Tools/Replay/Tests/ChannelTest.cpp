@@ -0,0 +1,241 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ChannelTest.cpp
+/// Description  :  Checks channels across processes, dropped sequences and releasing consumers on unload.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Shared.h"
+#include "Services/DataLink/DataLink.h"
+
+#include "Test.h"
+
+namespace
+{
+	/* fake modules, owners are addresses within them */
+	unsigned char	ModuleA[64];
+	unsigned char	ModuleB[64];
+
+	struct Record
+	{
+		unsigned long long	Sequence;
+		unsigned long long	Check;
+	};
+
+	Record Make(unsigned long long aSequence)
+	{
+		return Record{ aSequence, ~aSequence };
+	}
+
+	std::atomic<unsigned long long>& StampOf(ChannelHeader* aChannel, unsigned long long aSequence)
+	{
+		unsigned char* slot = reinterpret_cast<unsigned char*>(aChannel) + sizeof(ChannelHeader) + (aSequence & (aChannel->Capacity - 1)) * aChannel->SlotSize;
+		return *reinterpret_cast<std::atomic<unsigned long long>*>(slot);
+	}
+
+	ChannelHeader* MapChannel(const std::string& aName, size_t aSize, bool aIsCreating)
+	{
+		int fd = shm_open(aName.c_str(), aIsCreating ? O_CREAT | O_RDWR : O_RDWR, 0600);
+		if (fd < 0) { return nullptr; }
+
+		if (aIsCreating && ftruncate(fd, aSize) != 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		void* view = mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+
+		return view == MAP_FAILED ? nullptr : static_cast<ChannelHeader*>(view);
+	}
+}
+
+int main()
+{
+	{
+		/* a producer in another process, the channel mapped at another address, before any thread exists */
+		const unsigned capacity = 64;
+		const unsigned long long count = 20000;
+
+		std::string name = "/nexus-channel-test-" + std::to_string(getpid());
+		size_t size = Channel::GetSize(sizeof(Record), capacity);
+
+		ChannelHeader* channel = MapChannel(name, size, true);
+		CHECK(channel != nullptr);
+		CHECK(Channel::Initialize(channel, sizeof(Record), capacity, false));
+
+		int consumer = Channel::Subscribe(channel);
+		CHECK(consumer == 0);
+
+		pid_t child = fork();
+
+		if (child == 0)
+		{
+			ChannelHeader* mapped = MapChannel(name, size, false);
+			if (!mapped) { _exit(1); }
+
+			std::atomic<unsigned long long>& cursor = reinterpret_cast<std::atomic<unsigned long long>&>(mapped->Consumers[0].Cursor);
+
+			for (unsigned long long i = 0; i < count; i++)
+			{
+				/* never laps the consumer, so every record arrives */
+				while (i - cursor.load(std::memory_order_acquire) >= capacity) { sched_yield(); }
+
+				Record record = Make(i);
+				if (!Channel::Write(mapped, &record)) { _exit(2); }
+			}
+
+			_exit(0);
+		}
+
+		unsigned long long expected = 0;
+		int mismatches = 0;
+
+		while (expected < count)
+		{
+			Record record{};
+
+			if (!Channel::Read(channel, consumer, &record))
+			{
+				sched_yield();
+				continue;
+			}
+
+			if (record.Sequence != expected || record.Check != ~expected) { mismatches++; }
+			expected = record.Sequence + 1;
+		}
+
+		int status = -1;
+		waitpid(child, &status, 0);
+
+		CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		CHECK(mismatches == 0);
+		CHECK(channel->Consumers[consumer].Overflows == 0);
+		CHECK(channel->Dropped == 0);
+
+		munmap(channel, size);
+		shm_unlink(name.c_str());
+	}
+
+	{
+		/* a producer stalls mid write, the next lap skips its slot instead of waiting for it */
+		const unsigned capacity = 4;
+
+		std::vector<unsigned long long> memory(Channel::GetSize(sizeof(Record), capacity) / sizeof(unsigned long long) + 8);
+		ChannelHeader* channel = reinterpret_cast<ChannelHeader*>((reinterpret_cast<uintptr_t>(memory.data()) + 63) & ~static_cast<uintptr_t>(63));
+		CHECK(Channel::Initialize(channel, sizeof(Record), capacity, true));
+
+		int consumer = Channel::Subscribe(channel);
+		Record record{};
+
+		record = Make(0);
+		CHECK(Channel::Write(channel, &record));
+		CHECK(Channel::Read(channel, consumer, &record) && record.Sequence == 0);
+
+		/* sequence 1 claimed and never finished */
+		reinterpret_cast<std::atomic<unsigned long long>&>(channel->Head).fetch_add(1);
+		StampOf(channel, 1).store(1 * 2 + 1);
+
+		for (unsigned long long i = 2; i <= 4; i++)
+		{
+			record = Make(i);
+			CHECK(Channel::Write(channel, &record));
+		}
+
+		/* sequence 5 shares the slot of 1, it is dropped and marked instead of blocking the slot */
+		record = Make(5);
+		CHECK(!Channel::Write(channel, &record));
+		CHECK(channel->Dropped == 1);
+		CHECK(StampOf(channel, 5).load() == ((5 * 2 + 2) | DLC_STAMP_SKIPPED));
+
+		/* the stalled write cannot complete over the marker */
+		unsigned long long stalled = 1 * 2 + 1;
+		CHECK(!StampOf(channel, 1).compare_exchange_strong(stalled, 1 * 2 + 2));
+
+		std::vector<unsigned long long> read;
+		while (Channel::Read(channel, consumer, &record)) { read.push_back(record.Sequence); }
+
+		CHECK((read == std::vector<unsigned long long>{ 2, 3, 4 }));
+		CHECK(channel->Consumers[consumer].Overflows == 1);
+
+		/* the next lap writes the slot again, the consumer stepped over the dropped sequence */
+		for (unsigned long long i = 6; i <= 9; i++)
+		{
+			record = Make(i);
+			CHECK(Channel::Write(channel, &record));
+		}
+
+		read.clear();
+		while (Channel::Read(channel, consumer, &record)) { read.push_back(record.Sequence); }
+
+		CHECK((read == std::vector<unsigned long long>{ 6, 7, 8, 9 }));
+		CHECK(channel->Consumers[consumer].Overflows == 1);
+	}
+
+	{
+		CDataLink dataLink;
+		DataLinkService = &dataLink;
+
+		ChannelHeader* channel = dataLink.ShareChannel("CHANNEL_TEST", sizeof(Record), 16, true, true);
+		CHECK(channel != nullptr);
+
+		/* another module maps the same public channel */
+		CDataLink other;
+		ChannelHeader* mapped = other.ShareChannel("CHANNEL_TEST", sizeof(Record), 16, true, true);
+		CHECK(mapped != nullptr && mapped != channel);
+		CHECK(other.ShareChannel("CHANNEL_TEST", sizeof(Record) * 2, 16, true, true) == nullptr);
+
+		Record record = Make(7);
+		CHECK(Channel::Write(mapped, &record));
+
+		/* an addon reloaded more often than there are consumers, never unsubscribing */
+		for (int reload = 0; reload < 100; reload++)
+		{
+			int first = dataLink.SubscribeChannel(channel, ModuleA + 8);
+			int second = dataLink.SubscribeChannel(channel, ModuleA + 16);
+			CHECK(first >= 0 && second >= 0);
+
+			CHECK(dataLink.Verify(ModuleA, ModuleA + sizeof(ModuleA)) == 2);
+		}
+
+		/* all taken, released by the unload of their module only */
+		for (unsigned i = 0; i < DLC_MAX_CONSUMERS; i++)
+		{
+			CHECK(dataLink.SubscribeChannel(channel, ModuleA + 1 + i) >= 0);
+		}
+
+		CHECK(dataLink.SubscribeChannel(channel, ModuleB + 1) == -1);
+		CHECK(dataLink.Verify(ModuleB, ModuleB + sizeof(ModuleB)) == 0);
+		CHECK(dataLink.Verify(ModuleA, ModuleA + sizeof(ModuleA)) == DLC_MAX_CONSUMERS);
+
+		/* unsubscribed consumers are not released again */
+		int consumer = dataLink.SubscribeChannel(channel, ModuleB + 1);
+		CHECK(consumer >= 0);
+		dataLink.UnsubscribeChannel(channel, consumer);
+		CHECK(dataLink.Verify(ModuleB, ModuleB + sizeof(ModuleB)) == 0);
+
+		/* through the addon api the caller is the owner */
+		consumer = DataLink::ADDONAPI_ChannelSubscribe(channel);
+		CHECK(consumer >= 0);
+		CHECK(dataLink.Verify(ModuleA, ModuleA + sizeof(ModuleA)) == 0);
+		CHECK(dataLink.Verify(ModuleB, ModuleB + sizeof(ModuleB)) == 0);
+		CHECK(dataLink.Verify(nullptr, reinterpret_cast<void*>(UINTPTR_MAX)) == 1);
+
+		DataLinkService = nullptr;
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,92 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  DataLinkTest.cpp
+/// Description  :  Checks handles, versioned reads and resources provided on their first lookup.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "Shared.h"
+#include "Services/DataLink/DataLink.h"
+
+#include "Test.h"
+
+namespace
+{
+	int Accesses = 0;
+
+	struct Versioned
+	{
+		unsigned	Version;
+		int			Value;
+	};
+}
+
+int main()
+{
+	{
+		CDataLink dataLink;
+
+		/* a handle before the resource exists */
+		DataLinkEntry* handle = dataLink.GetHandle("DL_TEST");
+		CHECK(handle != nullptr);
+		CHECK(dataLink.GetResource(handle) == nullptr);
+		CHECK(dataLink.GetResource("DL_TEST") == nullptr);
+
+		int* value = (int*)dataLink.ShareResource("DL_TEST", sizeof(int), false);
+		CHECK(value != nullptr && *value == 0);
+		CHECK(dataLink.GetResource(handle) == value);
+		CHECK(dataLink.GetHandle("DL_TEST") == handle);
+		CHECK(dataLink.ShareResource("DL_TEST", sizeof(int) * 2, false) == nullptr);
+
+		/* versioned reads copy the resource */
+		Versioned* versioned = (Versioned*)dataLink.ShareVersionedResource("DL_VERSIONED", sizeof(Versioned), offsetof(Versioned, Version), false);
+		CHECK(versioned != nullptr);
+		versioned->Value = 42;
+		versioned->Version = 2;
+
+		Versioned copy{};
+		unsigned version = 0;
+		CHECK(dataLink.ReadResource("DL_VERSIONED", &copy, sizeof(copy), &version));
+		CHECK(copy.Value == 42 && version == 2);
+		CHECK(!dataLink.ReadResource("DL_MISSING", &copy, sizeof(copy), &version));
+
+		/* the snapshot is sorted */
+		const DataLinkSnapshot* snapshot = dataLink.GetSnapshot();
+		CHECK(snapshot->Entries.size() == 2);
+		CHECK(strcmp(snapshot->Entries[0]->Identifier.c_str(), "DL_TEST") == 0);
+	}
+
+	{
+		CDataLink dataLink;
+
+		/* provided once an addon asks, sharing it does not count */
+		dataLink.ShareResource("DL_LAZY", sizeof(int), false);
+		dataLink.SetOnAccess("DL_LAZY", []() { Accesses++; });
+		dataLink.ShareResource("DL_LAZY", sizeof(int), false);
+		CHECK(Accesses == 0);
+
+		CHECK(dataLink.GetResource("DL_OTHER") == nullptr);
+		CHECK(Accesses == 0);
+
+		CHECK(dataLink.GetResource("DL_LAZY") != nullptr);
+		CHECK(Accesses == 1);
+		CHECK(dataLink.GetResource("DL_LAZY") != nullptr);
+		CHECK(dataLink.GetHandle("DL_LAZY") != nullptr);
+		CHECK(Accesses == 1);
+
+		/* by handle or by a read, before the resource exists */
+		dataLink.SetOnAccess("DL_LATER", []() { Accesses++; });
+		CHECK(dataLink.GetHandle("DL_LATER") != nullptr);
+		CHECK(Accesses == 2);
+
+		int read = 0;
+		dataLink.SetOnAccess("DL_READ", []() { Accesses++; });
+		CHECK(!dataLink.ReadResource("DL_READ", &read, sizeof(read), nullptr));
+		CHECK(Accesses == 3);
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventMetricsTest.cpp
+/// Description  :  Checks the event counters, their owners, the rates and the export.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Shared.h"
+#include "Loader/Loader.h"
+
+#include "Test.h"
+
+namespace
+{
+	void SubA(void*) {}
+	void SubB(void*) {}
+
+	/* a fake module around both callbacks */
+	void*			ModuleStart		= (void*)SubA < (void*)SubB ? (void*)SubA : (void*)SubB;
+	void*			ModuleEnd		= (void*)SubA < (void*)SubB ? (void*)SubB : (void*)SubA;
+
+	AddonDefinition	DefinitionA{ 1234, "Addon A" };
+	AddonDefinition	DefinitionB{ 5678, "Addon B" };
+
+	Addon			AddonA{ (HMODULE)ModuleStart, (size_t)((char*)ModuleEnd - (char*)ModuleStart), &DefinitionA };
+	Addon			AddonB{ (HMODULE)ModuleStart, (size_t)((char*)ModuleEnd - (char*)ModuleStart), &DefinitionB };
+
+	const EventMetrics* FindEvent(const std::vector<EventMetrics>& aMetrics, const char* aIdentifier)
+	{
+		for (const EventMetrics& ev : aMetrics)
+		{
+			if (ev.Identifier == aIdentifier) { return &ev; }
+		}
+
+		return nullptr;
+	}
+
+	const SubscriberMetrics* FindSubscriber(const EventMetrics* aEvent, EVENT_CONSUME aCallback, const char* aOwner)
+	{
+		if (!aEvent) { return nullptr; }
+
+		for (const SubscriberMetrics& sub : aEvent->Subscribers)
+		{
+			if (sub.Callback == aCallback && sub.Owner == aOwner) { return &sub; }
+		}
+
+		return nullptr;
+	}
+}
+
+int main()
+{
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	{
+		CEventApi events;
+		EventApi = &events;
+
+		Loader::Addons = { &AddonA };
+
+		events.Subscribe("EV_A", SubA);
+		events.Subscribe("EV_A", SubB);
+		events.Subscribe("EV_B", SubB, true);
+
+		/* counted from several threads */
+		std::vector<std::thread> raisers;
+
+		for (int t = 0; t < 4; t++)
+		{
+			raisers.emplace_back([&events]()
+			{
+				for (int i = 0; i < 25000; i++)
+				{
+					events.Raise("EV_B", nullptr);
+					if (i % 100 == 0) { events.Raise("EV_A", nullptr); }
+				}
+			});
+		}
+
+		for (std::thread& raiser : raisers) { raiser.join(); }
+
+		events.Raise("EV_NONE", nullptr);
+
+		std::vector<EventMetrics> metrics = events.GetMetrics();
+		CHECK(metrics.size() == 3);
+
+		const EventMetrics* evA = FindEvent(metrics, "EV_A");
+		const EventMetrics* evB = FindEvent(metrics, "EV_B");
+		const EventMetrics* evNone = FindEvent(metrics, "EV_NONE");
+		CHECK(evA && evA->Raises == 1000 && evA->Subscribers.size() == 2);
+		CHECK(evB && evB->Raises == 100000);
+		CHECK(evNone && evNone->Raises == 1 && evNone->Subscribers.empty());
+
+		const SubscriberMetrics* subA = FindSubscriber(evA, SubA, "Addon A");
+		CHECK(subA && subA->Calls == 1000 && subA->Signature == 1234 && subA->IsSubscribed);
+		CHECK(FindSubscriber(evB, SubB, "Addon A") && FindSubscriber(evB, SubB, "Addon A")->Calls == 100000);
+
+		/* kept once unsubscribed */
+		events.Unsubscribe("EV_A", SubB);
+		metrics = events.GetMetrics();
+		evA = FindEvent(metrics, "EV_A");
+		CHECK(FindSubscriber(evA, SubB, "Addon A") && !FindSubscriber(evA, SubB, "Addon A")->IsSubscribed);
+		CHECK(FindSubscriber(evA, SubA, "Addon A") && FindSubscriber(evA, SubA, "Addon A")->IsSubscribed);
+
+		/* another addon loaded where the unloaded one was does not continue its counters */
+		CHECK(events.Verify(ModuleStart, ModuleEnd) == 2);
+		Loader::Addons = { &AddonB };
+
+		events.Subscribe("EV_A", SubA);
+		events.Raise("EV_A", nullptr);
+
+		metrics = events.GetMetrics();
+		evA = FindEvent(metrics, "EV_A");
+		CHECK(evA && evA->Subscribers.size() == 3);
+		CHECK(FindSubscriber(evA, SubA, "Addon A") && FindSubscriber(evA, SubA, "Addon A")->Calls == 1000);
+		CHECK(FindSubscriber(evA, SubA, "Addon A") && !FindSubscriber(evA, SubA, "Addon A")->IsSubscribed);
+		CHECK(FindSubscriber(evA, SubA, "Addon B") && FindSubscriber(evA, SubA, "Addon B")->Calls == 1);
+
+		/* the export */
+		std::filesystem::path dir = std::filesystem::temp_directory_path() / ("nexus-metrics-" + std::to_string(getpid()));
+
+		CHECK(events.ExportMetrics(dir / "events.csv"));
+		CHECK(events.ExportMetrics(dir / "events.json"));
+
+		std::ifstream csv(dir / "events.csv");
+		std::string header;
+		std::getline(csv, header);
+		CHECK(header.rfind("Event,Raises,", 0) == 0);
+
+		/* a header and a row per subscriber, or one for an event without */
+		int rows = 0;
+		for (std::string line; std::getline(csv, line);) { rows++; }
+		CHECK(rows == 3 + 1 + 1);
+
+		CHECK(std::filesystem::file_size(dir / "events.json") > 0);
+
+		std::filesystem::remove_all(dir);
+
+		Loader::Addons.clear();
+		events.Shutdown();
+		EventApi = nullptr;
+	}
+
+	{
+		CEventMetrics metrics;
+
+		/* the same callback of the same owner continues, of another owner it does not */
+		CSubscriberCounters* nexus = metrics.GetSubscriber("EV_X", SubA, 0, "Nexus");
+		metrics.SetSubscribed(nexus, false);
+		CHECK(metrics.GetSubscriber("EV_X", SubA, 0, "Nexus") == nexus);
+		CHECK(metrics.GetSubscriber("EV_X", SubA, 0, "Addon A") != nexus);
+	}
+
+	{
+		CEventMetrics metrics;
+		CEventCounters* ev = metrics.GetEvent("EV_RATE");
+		CSubscriberCounters* sub = metrics.GetSubscriber("EV_RATE", SubB, 0, "Nexus");
+
+		/* 100 seconds of 10 raises, then 20 of 70 */
+		long long time = 1000;
+
+		for (int s = 0; s < 120; s++)
+		{
+			int raises = s < 100 ? 10 : 70;
+
+			for (int i = 0; i < raises; i++)
+			{
+				ev->Raise();
+				sub->Record(1000);
+			}
+
+			metrics.Sample(time);
+			time += EV_METRICS_INTERVAL;
+		}
+
+		/* a sample before the interval passed is not taken */
+		ev->Raise();
+		metrics.Sample(time - EV_METRICS_INTERVAL / 2);
+
+		std::vector<EventMetrics> rates = metrics.GetMetrics();
+		CHECK(rates.size() == 1 && rates[0].Subscribers.size() == 1);
+		CHECK(rates[0].RaiseRate == 70.0);
+		CHECK(rates[0].RaiseRateWindow == (40 * 10 + 20 * 70) / 60.0);
+		CHECK(rates[0].Subscribers[0].TimeRate == 70000.0);
+		CHECK(rates[0].Subscribers[0].MaxTime == 1000);
+	}
+
+	CallbackWatchdog = nullptr;
+
+	TEST_RESULT();
+}
@@ -0,0 +1,278 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventsTest.cpp
+/// Description  :  Checks re-entrant subscribers, the order of queued events and unloading during raises.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Shared.h"
+
+#include "Test.h"
+
+namespace
+{
+	/* re-entrancy */
+	std::atomic<int>		NestedCalls{ 0 };
+	std::atomic<int>		AddedCalls{ 0 };
+
+	void Added(void*) { AddedCalls++; }
+	void Nested(void*) { NestedCalls++; }
+
+	/* used to deadlock on the registry mutex */
+	void Reentrant(void*)
+	{
+		EventApi->Raise("EV_NESTED", nullptr);
+		EventApi->Subscribe("EV_OUTER", Added, true);
+		EventApi->Unsubscribe("EV_OUTER", Reentrant);
+		EventApi->RaiseQueued("EV_NESTED", nullptr, 0);
+	}
+
+	/* ordering */
+	constexpr const int SOURCES = 4;
+	constexpr const int PER_SOURCE = 5000;
+
+	struct Message
+	{
+		int		Source;
+		int		Sequence;
+		char	Pad[40];
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Order Struct
+	/// 	The last sequence a subscriber got of every source.
+	///----------------------------------------------------------------------------------------------------
+	struct Order
+	{
+		int						Last[SOURCES];
+		std::atomic<long long>	Count{ 0 };
+		std::atomic<int>		OutOfOrder{ 0 };
+		std::atomic<int>		Running{ 0 };
+		std::atomic<int>		Concurrent{ 0 };
+
+		void Receive(void* aEventArgs)
+		{
+			if (this->Running.fetch_add(1)) { this->Concurrent++; }
+
+			const Message* message = (const Message*)aEventArgs;
+			if (message->Sequence != this->Last[message->Source] + 1) { this->OutOfOrder++; }
+			this->Last[message->Source] = message->Sequence;
+			this->Count++;
+
+			this->Running--;
+		}
+	};
+
+	Order	OrderA;
+	Order	OrderB;
+	Order	OrderRender;
+
+	void ReceiveA(void* aEventArgs) { OrderA.Receive(aEventArgs); }
+	void ReceiveB(void* aEventArgs) { OrderB.Receive(aEventArgs); }
+	void ReceiveRender(void* aEventArgs) { OrderRender.Receive(aEventArgs); }
+
+	/* unload */
+	std::atomic<bool>		IsUnloaded{ false };
+	std::atomic<int>		InFlight{ 0 };
+	std::atomic<int>		LateCalls{ 0 };
+	std::atomic<long long>	ModuleCalls{ 0 };
+
+	void ModuleCallback(long long aMicroseconds)
+	{
+		InFlight++;
+		if (IsUnloaded) { LateCalls++; }
+		std::this_thread::sleep_for(std::chrono::microseconds(aMicroseconds));
+		if (IsUnloaded) { LateCalls++; }
+		ModuleCalls++;
+		InFlight--;
+	}
+
+	void ModuleA(void*) { ModuleCallback(50); }
+	void ModuleB(void*) { ModuleCallback(30); }
+}
+
+int main()
+{
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	/* a deadlock fails the test instead of hanging it */
+	std::atomic<bool> isDone{ false };
+	std::thread deadline([&]()
+	{
+		for (int i = 0; i < 6000 && !isDone; i++) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+		if (!isDone) { printf("deadlocked\n"); fflush(stdout); _exit(1); }
+	});
+
+	{
+		CEventApi events;
+		EventApi = &events;
+
+		/* a subscriber raises, subscribes and unsubscribes from within its call */
+		events.Subscribe("EV_OUTER", Reentrant, true);
+		events.Subscribe("EV_NESTED", Nested, true);
+
+		events.Raise("EV_OUTER", nullptr);
+		CHECK(NestedCalls >= 1);
+		CHECK(AddedCalls == 0);
+
+		/* only the subscriber added from within is left */
+		events.Raise("EV_OUTER", nullptr);
+		CHECK(AddedCalls == 1);
+
+		for (int i = 0; i < 1000 && NestedCalls < 2; i++) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+		CHECK(NestedCalls == 2);
+
+		events.Shutdown();
+		EventApi = nullptr;
+	}
+
+	{
+		CEventApi events;
+		EventApi = &events;
+
+		for (int s = 0; s < SOURCES; s++)
+		{
+			OrderA.Last[s] = OrderB.Last[s] = OrderRender.Last[s] = -1;
+		}
+
+		events.Subscribe("EV_ORDER", ReceiveA, true);
+		events.Subscribe("EV_ORDER", ReceiveB, true);
+		events.Subscribe("EV_ORDER", ReceiveRender, true);
+		events.SetExecution("EV_ORDER", ReceiveRender, EEventExecution::RenderThread);
+
+		std::atomic<bool> isRendering{ true };
+		std::thread render([&]()
+		{
+			while (isRendering)
+			{
+				events.ProcessRenderQueue();
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+
+			events.ProcessRenderQueue();
+		});
+
+		/* every source raises from its own thread, the order is per raiser */
+		std::vector<std::thread> raisers;
+
+		for (int s = 0; s < SOURCES; s++)
+		{
+			raisers.emplace_back([&, s]()
+			{
+				for (int i = 0; i < PER_SOURCE; i++)
+				{
+					Message message{ s, i, {} };
+					events.RaiseQueued("EV_ORDER", &message, sizeof(message));
+				}
+			});
+		}
+
+		for (std::thread& raiser : raisers) { raiser.join(); }
+
+		while (OrderA.Count < SOURCES * PER_SOURCE || OrderB.Count < SOURCES * PER_SOURCE)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		isRendering = false;
+		render.join();
+
+		for (Order* order : { &OrderA, &OrderB, &OrderRender })
+		{
+			CHECK(order->Count == SOURCES * PER_SOURCE);
+			CHECK(order->OutOfOrder == 0);
+			CHECK(order->Concurrent == 0);
+		}
+
+		EventExecutorStats stats = events.GetExecutorStats();
+		CHECK(stats.Pending == 0);
+		CHECK(stats.Executed == 3ull * SOURCES * PER_SOURCE);
+
+		events.Shutdown();
+		EventApi = nullptr;
+	}
+
+	{
+		CEventApi events;
+		EventApi = &events;
+
+		/* the module is unloaded while it is called synchronously and queued on both threads */
+		events.Subscribe("EV_SYNC", ModuleA, true);
+		events.Subscribe("EV_SYNC", ModuleB, true);
+		events.Subscribe("EV_QUEUED", ModuleA, true);
+		events.Subscribe("EV_QUEUED", ModuleB, true);
+		events.SetExecution("EV_QUEUED", ModuleB, EEventExecution::RenderThread);
+
+		std::atomic<bool> isRendering{ true };
+		std::thread render([&]()
+		{
+			while (isRendering)
+			{
+				events.ProcessRenderQueue();
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+		});
+
+		std::atomic<bool> isRaising{ true };
+		std::vector<std::thread> raisers;
+
+		for (int r = 0; r < 3; r++)
+		{
+			raisers.emplace_back([&, r]()
+			{
+				while (isRaising)
+				{
+					if (r == 0)
+					{
+						events.RaiseQueued("EV_QUEUED", &r, sizeof(r));
+					}
+					else
+					{
+						events.Raise("EV_SYNC", nullptr);
+					}
+				}
+			});
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+		void* start = (void*)ModuleA < (void*)ModuleB ? (void*)ModuleA : (void*)ModuleB;
+		void* end = (void*)ModuleA < (void*)ModuleB ? (void*)ModuleB : (void*)ModuleA;
+
+		int refs = events.Verify(start, end);
+		IsUnloaded = true;
+		int inFlight = InFlight;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		isRaising = false;
+		for (std::thread& raiser : raisers) { raiser.join(); }
+
+		isRendering = false;
+		render.join();
+
+		CHECK(ModuleCalls > 0);
+		CHECK(refs >= 4);
+		CHECK(inFlight == 0);
+		CHECK(LateCalls == 0);
+
+		events.Shutdown();
+		EventApi = nullptr;
+	}
+
+	isDone = true;
+	deadline.join();
+
+	CallbackWatchdog = nullptr;
+
+	TEST_RESULT();
+}
@@ -0,0 +1,225 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindsTest.cpp
+/// Description  :  Checks the window messages game bind presses, releases and macros send to the game.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+#include "Hooks.h"
+#include "Index.h"
+#include "Util/Inputs.h"
+
+#include "Test.h"
+
+namespace
+{
+	///----------------------------------------------------------------------------------------------------
+	/// SentMessage Struct
+	///----------------------------------------------------------------------------------------------------
+	struct SentMessage
+	{
+		UINT		Msg;
+		WPARAM		WParam;
+		unsigned	LParam;		/* the upper bits of a packed key LPARAM are not set */
+
+		bool operator==(const SentMessage& aOther) const
+		{
+			return Msg == aOther.Msg && WParam == aOther.WParam && LParam == aOther.LParam;
+		}
+	};
+
+	std::mutex					SentMutex;
+	std::vector<SentMessage>	Sent;
+
+	LRESULT GameWndProc(HWND, UINT uMsg, WPARAM wParam, LPARAM lParam)
+	{
+		const std::lock_guard<std::mutex> lock(SentMutex);
+		Sent.push_back(SentMessage{ uMsg, wParam, static_cast<unsigned>(lParam) });
+		return 0;
+	}
+
+	std::vector<SentMessage> TakeSent()
+	{
+		const std::lock_guard<std::mutex> lock(SentMutex);
+		std::vector<SentMessage> sent;
+		sent.swap(Sent);
+		return sent;
+	}
+
+	size_t SentCount()
+	{
+		const std::lock_guard<std::mutex> lock(SentMutex);
+		return Sent.size();
+	}
+
+	template <typename Pred>
+	bool WaitUntil(Pred aPredicate)
+	{
+		for (int i = 0; i < 5000 && !aPredicate(); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return aPredicate();
+	}
+
+	unsigned MakeKeyLParam(unsigned short aScanCode, bool aIsDown)
+	{
+		unsigned lp = 1;
+		lp |= (aScanCode & 0xFFu) << 16;
+		lp |= aIsDown ? 0 : 3u << 30;
+		return lp;
+	}
+
+	/* the stub maps virtual keys to the same scan code */
+	unsigned ModifierLParam(unsigned aVKey, bool aIsDown, bool aIsSystem)
+	{
+		return MakeKeyLParam(static_cast<unsigned short>(aVKey), aIsDown) | (aIsSystem ? 1u << 29 : 0);
+	}
+}
+
+int main()
+{
+	std::filesystem::remove(Index::F_GAMEBINDS);
+
+	Hooks::GW2::WndProc = GameWndProc;
+
+	CEventApi events;
+	CRawInputApi rawInput;
+	EventApi = &events;
+	RawInputApi = &rawInput;
+
+	{
+		CGameBindsApi api(&rawInput, Logger, &events);
+		GameBindsApi = &api;
+
+		api.Set(EGameBinds::SkillWeapon1, InputBind(false, true, true, EInputBindType::Keyboard, 0x02));
+		api.Set(EGameBinds::SkillWeapon2, InputBind(false, false, false, EInputBindType::Keyboard, 0x03));
+		api.Set(EGameBinds::MoveJump, InputBind(true, false, false, EInputBindType::Mouse, (unsigned short)EMouseButtons::RMB));
+		TakeSent();
+
+		/* modifiers are pressed before and released after the key */
+		api.Press(EGameBinds::SkillWeapon1);
+		api.Release(EGameBinds::SkillWeapon1);
+
+		std::vector<SentMessage> expected = {
+			{ WM_KEYDOWN,	VK_CONTROL,	ModifierLParam(VK_CONTROL, true, false) },
+			{ WM_KEYDOWN,	VK_SHIFT,	ModifierLParam(VK_SHIFT, true, false) },
+			{ WM_KEYDOWN,	0x02,		MakeKeyLParam(0x02, true) },
+			{ WM_KEYUP,		0x02,		MakeKeyLParam(0x02, false) },
+			{ WM_KEYUP,		VK_CONTROL,	ModifierLParam(VK_CONTROL, false, false) },
+			{ WM_KEYUP,		VK_SHIFT,	ModifierLParam(VK_SHIFT, false, false) }
+		};
+		CHECK(TakeSent() == expected);
+		CHECK(!api.IsHeld(EGameBinds::SkillWeapon1));
+
+		/* mouse binds carry the button state and the cursor */
+		api.Press(EGameBinds::MoveJump);
+		CHECK(api.IsHeld(EGameBinds::MoveJump));
+		api.Release(EGameBinds::MoveJump);
+
+		expected = {
+			{ WM_SYSKEYDOWN,	VK_MENU,						ModifierLParam(VK_MENU, true, true) },
+			{ WM_RBUTTONDOWN,	GetMouseMessageWPARAM(EMouseButtons::RMB, false, false, true),	0 },
+			{ WM_RBUTTONUP,		GetMouseMessageWPARAM(EMouseButtons::RMB, false, false, false),	0 },
+			{ WM_SYSKEYUP,		VK_MENU,						ModifierLParam(VK_MENU, false, true) }
+		};
+		CHECK(TakeSent() == expected);
+		CHECK(!api.IsHeld(EGameBinds::MoveJump));
+
+		/* a macro sends exactly what pressing and releasing its steps does */
+		std::vector<GameBindMacroStep> steps = {
+			{ EGameBinds::SkillWeapon1,	EGameBindMacroAction::Invoke,	0 },
+			{ EGameBinds::SkillWeapon2,	EGameBindMacroAction::Press,	5 },
+			{ EGameBinds::MoveJump,		EGameBindMacroAction::Invoke,	0 },
+			{ EGameBinds::SkillWeapon2,	EGameBindMacroAction::Release,	10 }
+		};
+
+		api.Press(EGameBinds::SkillWeapon1);
+		api.Release(EGameBinds::SkillWeapon1);
+		api.Press(EGameBinds::SkillWeapon2);
+		api.Press(EGameBinds::MoveJump);
+		api.Release(EGameBinds::MoveJump);
+		api.Release(EGameBinds::SkillWeapon2);
+		expected = TakeSent();
+
+		int owner = 0;
+		unsigned macro = api.CreateMacro(steps.data(), static_cast<unsigned>(steps.size()), &owner);
+		CHECK(macro != 0);
+
+		api.InvokeMacro(macro);
+		CHECK(WaitUntil([&]() { return SentCount() >= expected.size(); }));
+		CHECK(TakeSent() == expected);
+
+		api.InvokeSequence(steps.data(), static_cast<unsigned>(steps.size()));
+		CHECK(WaitUntil([&]() { return SentCount() >= expected.size(); }));
+		CHECK(TakeSent() == expected);
+
+		/* a macro is recompiled after a rebind */
+		api.Set(EGameBinds::SkillWeapon2, InputBind(false, false, false, EInputBindType::Keyboard, 0x04));
+		api.InvokeMacro(macro);
+		CHECK(WaitUntil([&]() { return SentCount() >= expected.size(); }));
+		std::vector<SentMessage> rebound = TakeSent();
+		SentMessage reboundPress{ WM_KEYDOWN, 0x04, MakeKeyLParam(0x04, true) };
+		CHECK(rebound.size() == expected.size());
+		CHECK(rebound.size() > 6 && rebound[6] == reboundPress);
+
+		/* cancelling a pending release releases the held bind */
+		std::vector<GameBindMacroStep> hold = {
+			{ EGameBinds::SkillWeapon2,	EGameBindMacroAction::Press,	0 },
+			{ EGameBinds::SkillWeapon2,	EGameBindMacroAction::Release,	500 }
+		};
+		api.InvokeSequence(hold.data(), static_cast<unsigned>(hold.size()));
+		CHECK(WaitUntil([&]() { return api.IsHeld(EGameBinds::SkillWeapon2); }));
+		api.Cancel(EGameBinds::SkillWeapon2);
+		CHECK(!api.IsHeld(EGameBinds::SkillWeapon2));
+
+		expected = {
+			{ WM_KEYDOWN,	0x04,	MakeKeyLParam(0x04, true) },
+			{ WM_KEYUP,		0x04,	MakeKeyLParam(0x04, false) }
+		};
+		CHECK(TakeSent() == expected);
+
+		/* macros of an unloaded module are destroyed, others are kept */
+		int otherOwner = 0;
+		unsigned other = api.CreateMacro(steps.data(), static_cast<unsigned>(steps.size()), &otherOwner);
+		CHECK(api.Verify(&owner, &owner) == 1);
+		CHECK(api.Verify(&owner, &owner) == 0);
+
+		api.InvokeMacro(macro);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(SentCount() == 0);
+
+		api.InvokeMacro(other);
+		CHECK(WaitUntil([&]() { return SentCount() >= rebound.size(); }));
+		CHECK(TakeSent() == rebound);
+		api.DestroyMacro(other);
+
+		/* held binds are released on shutdown */
+		api.Press(EGameBinds::SkillWeapon2);
+		TakeSent();
+
+		GameBindsApi = nullptr;
+	}
+
+	std::vector<SentMessage> expected = {
+		{ WM_KEYUP,	0x04,	MakeKeyLParam(0x04, false) }
+	};
+	CHECK(TakeSent() == expected);
+
+	RawInputApi = nullptr;
+	EventApi = nullptr;
+	Hooks::GW2::WndProc = nullptr;
+
+	std::filesystem::remove(Index::F_GAMEBINDS);
+
+	TEST_RESULT();
+}
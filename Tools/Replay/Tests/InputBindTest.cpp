@@ -0,0 +1,196 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  InputBindTest.cpp
+/// Description  :  Checks matching, handler ordering and purging of the input binds.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+#include "Index.h"
+#include "Inputs/InputBinds/InputBindHandler.h"
+
+#include "Test.h"
+
+namespace
+{
+	constexpr const int TEST_PRESSES = 2000;
+
+	std::mutex					EventMutex;
+	std::vector<std::string>	BindEvents;		/* "<identifier> down/up" in call order */
+
+	std::atomic<bool>			IsSlowRunning{ false };
+	std::atomic<bool>			IsSlowDone{ false };
+	std::atomic<int>			SelfPurges{ 0 };
+
+	void OnBind(const char* aIdentifier, bool aIsRelease)
+	{
+		const std::lock_guard<std::mutex> lock(EventMutex);
+		BindEvents.push_back(std::string(aIdentifier) + (aIsRelease ? " up" : " down"));
+	}
+
+	void OnSlowBind(const char*)
+	{
+		IsSlowRunning = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		IsSlowDone = true;
+	}
+
+	void OnSelfPurgeBind(const char*)
+	{
+		/* an addon unloading itself from its own handler must not wait for that handler */
+		InputBindApi->Verify((void*)OnSelfPurgeBind, (void*)OnSelfPurgeBind);
+		SelfPurges++;
+	}
+
+	LPARAM MakeKeyLParam(unsigned short aScanCode, bool aIsDown)
+	{
+		LPARAM lp = 1;
+		lp |= static_cast<LPARAM>(aScanCode & 0xFF) << 16;
+		lp |= static_cast<LPARAM>(aScanCode & 0xE000 ? 1 : 0) << 24;
+		lp |= static_cast<LPARAM>(aIsDown ? 0 : 3) << 30;
+		return lp;
+	}
+
+	/* true if the press was consumed */
+	bool Press(CInputBindApi& aApi, unsigned short aScanCode)
+	{
+		return aApi.WndProc(nullptr, WM_KEYDOWN, 0x41, MakeKeyLParam(aScanCode, true)) == 0;
+	}
+
+	void Release(CInputBindApi& aApi, unsigned short aScanCode)
+	{
+		aApi.WndProc(nullptr, WM_KEYUP, 0x41, MakeKeyLParam(aScanCode, false));
+	}
+
+	template <typename Pred>
+	bool WaitUntil(Pred aPredicate)
+	{
+		for (int i = 0; i < 5000 && !aPredicate(); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return aPredicate();
+	}
+
+	size_t EventCount()
+	{
+		const std::lock_guard<std::mutex> lock(EventMutex);
+		return BindEvents.size();
+	}
+}
+
+int main()
+{
+	std::filesystem::remove(Index::F_INPUTBINDS);
+
+	{
+		CInputBindApi api(Logger);
+		InputBindApi = &api;
+
+		api.Register("TEST_A", EInputBindHandlerType::DownAndRelease, (void*)OnBind, InputBind(false, false, false, EInputBindType::Keyboard, 0x1E));
+		api.Register("TEST_B", EInputBindHandlerType::DownAndRelease, (void*)OnBind, InputBind(false, false, false, EInputBindType::Keyboard, 0xE01E));
+		api.Register("TEST_SLOW", EInputBindHandlerType::DownOnly, (void*)OnSlowBind, InputBind(false, false, false, EInputBindType::Keyboard, 0x20));
+		api.Register("TEST_SELF", EInputBindHandlerType::DownOnly, (void*)OnSelfPurgeBind, InputBind(false, false, false, EInputBindType::Keyboard, 0x21));
+
+		/* unbound keys pass through, the extended flag is part of the code */
+		CHECK(!Press(api, 0x1F));
+		Release(api, 0x1F);
+		CHECK(Press(api, 0x1E));
+		Release(api, 0x1E);
+		CHECK(Press(api, 0xE01E));
+		Release(api, 0xE01E);
+
+		CHECK(WaitUntil([]() { return EventCount() == 4; }));
+
+		/* press and release of a bind are called in order, binds run independently */
+		{
+			const std::lock_guard<std::mutex> lock(EventMutex);
+			BindEvents.clear();
+		}
+
+		for (int i = 0; i < TEST_PRESSES; i++)
+		{
+			Press(api, 0x1E);
+			Press(api, 0xE01E);
+			Release(api, 0x1E);
+			Release(api, 0xE01E);
+		}
+
+		CHECK(WaitUntil([]() { return EventCount() == TEST_PRESSES * 4; }));
+
+		{
+			const std::lock_guard<std::mutex> lock(EventMutex);
+
+			int next[2] = { 0, 0 };
+			int outOfOrder = 0;
+
+			for (const std::string& ev : BindEvents)
+			{
+				int bind = ev.compare(0, 6, "TEST_A") == 0 ? 0 : 1;
+				bool isDown = ev.back() == 'n';
+
+				if (isDown != (next[bind] % 2 == 0)) { outOfOrder++; }
+				next[bind]++;
+			}
+
+			CHECK(outOfOrder == 0);
+			CHECK(next[0] == TEST_PRESSES * 2 && next[1] == TEST_PRESSES * 2);
+		}
+
+		/* setting the execution of an unknown identifier does not register it */
+		size_t registered = api.GetRegistry().size();
+		api.SetExecution("TEST_UNKNOWN", EInputBindExecution::RenderThread);
+		CHECK(api.GetRegistry().size() == registered);
+
+		/* render thread handlers run on the next frame */
+		api.SetExecution("TEST_A", EInputBindExecution::RenderThread);
+		size_t before = EventCount();
+		Press(api, 0x1E);
+		Release(api, 0x1E);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(EventCount() == before);
+		api.ProcessRenderQueue();
+		CHECK(EventCount() == before + 2);
+
+		/* Verify returns only once a running handler in the range returned */
+		CHECK(Press(api, 0x20));
+		Release(api, 0x20);
+		CHECK(WaitUntil([]() { return IsSlowRunning.load(); }));
+		CHECK(api.Verify((void*)OnSlowBind, (void*)OnSlowBind) == 1);
+		CHECK(IsSlowDone);
+
+		/* and the bind is gone */
+		CHECK(!Press(api, 0x20));
+		Release(api, 0x20);
+
+		/* pending calls are dropped */
+		api.SetExecution("TEST_B", EInputBindExecution::RenderThread);
+		Press(api, 0xE01E);
+		Release(api, 0xE01E);
+		before = EventCount();
+		CHECK(api.Verify((void*)OnBind, (void*)OnBind) == 2);
+		api.ProcessRenderQueue();
+		CHECK(EventCount() == before);
+
+		/* a handler verifying its own range does not wait for itself */
+		CHECK(Press(api, 0x21));
+		Release(api, 0x21);
+		CHECK(WaitUntil([]() { return SelfPurges.load() == 1; }));
+
+		InputBindApi = nullptr;
+	}
+
+	std::filesystem::remove(Index::F_INPUTBINDS);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,251 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  LocalizationTest.cpp
+/// Description  :  Checks the translation fallbacks, handles across language changes and Set racing against Translate.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Shared.h"
+#include "Services/Localization/Localization.h"
+
+#include "Test.h"
+
+namespace
+{
+	constexpr const int TEST_TEXTS		= 200;		/* texts per language */
+	constexpr const int TEST_DYNAMIC	= 50;		/* identifiers set at runtime */
+	constexpr const int TEST_SETS		= 20000;	/* Set and Advance calls of the writer */
+	constexpr const int TEST_READERS	= 3;
+	constexpr const int TEST_SWAPS		= 2000;		/* language changes while handles are translated */
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteLocale:
+	/// 	Writes a locale source with aCount texts, every aStep-th identifier is left out.
+	///----------------------------------------------------------------------------------------------------
+	void WriteLocale(const std::filesystem::path& aPath, const char* aIdentifier, const char* aDisplayName, int aCount, int aStep)
+	{
+		std::ofstream file(aPath);
+
+		file << "{ \"Identifier\": \"" << aIdentifier << "\", \"DisplayName\": \"" << aDisplayName << "\", \"Texts\": {";
+
+		bool isFirst = true;
+
+		for (int i = 0; i < aCount; i++)
+		{
+			if (aStep && i % aStep == 0) { continue; }
+
+			file << (isFirst ? "" : ",") << "\"((" << i << "))\": \"" << aIdentifier << " " << i << "\"";
+			isFirst = false;
+		}
+
+		file << "} }";
+	}
+
+	std::string Identifier(int aIndex)
+	{
+		return "((" + std::to_string(aIndex) + "))";
+	}
+}
+
+int main()
+{
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / ("nexus-localization-test-" + std::to_string(getpid()));
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	WriteLocale(dir / "en.json", "en", "English", TEST_TEXTS, 0);
+	WriteLocale(dir / "de.json", "de", "Deutsch", TEST_TEXTS, 10);
+	WriteLocale(dir / "fr.json", "fr", "Francais", TEST_TEXTS, 2);
+
+	{
+		CLocalization loc;
+
+		/* nothing to translate with until the atlas is built */
+		CHECK(strcmp(loc.Translate("((1))"), "((1))") == 0);
+
+		loc.SetLocaleDirectory(dir);
+		CHECK(loc.Advance());
+		loc.SetLanguage("Deutsch");
+		loc.Advance();
+
+		CHECK(loc.GetLanguages().size() == 3);
+		CHECK(loc.GetActiveLanguage() == "Deutsch");
+
+		/* active language, english fallback, identifier */
+		CHECK(strcmp(loc.Translate("((1))"), "de 1") == 0);
+		CHECK(strcmp(loc.Translate("((10))"), "en 10") == 0);
+		CHECK(strcmp(loc.Translate("((unknown))"), "((unknown))") == 0);
+
+		/* a language that is not loaded yet falls back to the active one until the next Advance */
+		CHECK(strcmp(loc.Translate("((1))", "fr"), "de 1") == 0);
+		CHECK(strcmp(loc.Translate("((1))", "fr"), "de 1") == 0);
+		CHECK(loc.Advance());
+		CHECK(strcmp(loc.Translate("((1))", "fr"), "fr 1") == 0);
+		CHECK(!loc.Advance());
+
+		/* a specific language falls back to the active one */
+		CHECK(strcmp(loc.Translate("((1))", "en"), "en 1") == 0);
+		CHECK(strcmp(loc.Translate("((2))", "fr"), "de 2") == 0);
+		CHECK(strcmp(loc.Translate("((1))", "xx"), "de 1") == 0);
+
+		/* runtime strings take precedence once advanced */
+		loc.Set("((1))", "de", "runtime");
+		CHECK(strcmp(loc.Translate("((1))"), "de 1") == 0);
+		loc.Advance();
+		CHECK(strcmp(loc.Translate("((1))"), "runtime") == 0);
+		CHECK(strcmp(loc.Translate("((1))", "en"), "en 1") == 0);
+
+		/* readers translate while the writer keeps replacing the table */
+		std::atomic<bool> isDone = false;
+		std::atomic<int> mismatches = 0;
+		std::atomic<long long> lookups = 0;
+
+		std::vector<std::thread> readers;
+
+		for (int r = 0; r < TEST_READERS; r++)
+		{
+			readers.emplace_back([&, r]()
+			{
+				int i = r;
+				long long count = 0;
+
+				while (!isDone.load(std::memory_order_relaxed))
+				{
+					i = (i + 7) % TEST_TEXTS;
+
+					/* static texts never change */
+					std::string expected = (i % 10 == 0 ? "en " : "de ") + std::to_string(i);
+					if (i != 1 && expected != loc.Translate(Identifier(i).c_str())) { mismatches++; }
+
+					/* dynamic texts are either not published yet or one of the written values */
+					std::string dynamic = Identifier(TEST_TEXTS + i % TEST_DYNAMIC);
+					const char* str = loc.Translate(dynamic.c_str());
+					if (dynamic != str && strncmp(str, "set ", 4) != 0) { mismatches++; }
+
+					count += 2;
+				}
+
+				lookups += count;
+			});
+		}
+
+		for (int i = 0; i < TEST_SETS; i++)
+		{
+			std::string text = "set " + std::to_string(i);
+			loc.Set(Identifier(TEST_TEXTS + i % TEST_DYNAMIC).c_str(), "de", text.c_str());
+
+			if (i % 4 == 3)
+			{
+				loc.Advance();
+			}
+		}
+
+		isDone = true;
+
+		for (std::thread& reader : readers)
+		{
+			reader.join();
+		}
+
+		CHECK(mismatches == 0);
+		CHECK(lookups > 0);
+
+		/* the last value of every identifier is published */
+		loc.Advance();
+
+		for (int i = TEST_SETS - TEST_DYNAMIC; i < TEST_SETS; i++)
+		{
+			CHECK(("set " + std::to_string(i)) == loc.Translate(Identifier(TEST_TEXTS + i % TEST_DYNAMIC).c_str()));
+		}
+
+		/* replaced tables are freed once no reader is left */
+		CHECK(loc.GetRetiredCount() == 0);
+
+		/* handles resolve in every table published after them */
+		unsigned handle = loc.GetHandle("((5))");
+		unsigned fallback = loc.GetHandle("((10))");
+		unsigned added = loc.GetHandle("((handle))");
+
+		CHECK(handle != 0 && handle == loc.GetHandle("((5))"));
+		CHECK(strcmp(loc.Translate(handle), "de 5") == 0);
+		CHECK(strcmp(loc.Translate(fallback), "en 10") == 0);
+		CHECK(strcmp(loc.Translate(added), "((handle))") == 0);
+		CHECK(strcmp(loc.Translate(handle, "fr"), "fr 5") == 0);
+
+		loc.SetLanguage("English");
+		CHECK(strcmp(loc.Translate(handle), "en 5") == 0);
+		CHECK(strcmp(loc.Translate(handle, "de"), "de 5") == 0);
+
+		loc.Set("((handle))", "en", "added");
+		loc.Advance();
+		CHECK(strcmp(loc.Translate(added), "added") == 0);
+
+		loc.SetLanguage("Deutsch");
+		CHECK(strcmp(loc.Translate(handle), "de 5") == 0);
+		CHECK(strcmp(loc.Translate(added), "added") == 0);
+
+		/* readers translate handles while the language keeps changing */
+		std::vector<unsigned> handles;
+
+		for (int i = 2; i < TEST_TEXTS; i++)
+		{
+			handles.push_back(loc.GetHandle(Identifier(i).c_str()));
+		}
+
+		isDone = false;
+		readers.clear();
+
+		for (int r = 0; r < TEST_READERS; r++)
+		{
+			readers.emplace_back([&, r]()
+			{
+				size_t i = r;
+
+				while (!isDone.load(std::memory_order_relaxed))
+				{
+					i = (i + 7) % handles.size();
+
+					/* either language, never another text or none */
+					std::string index = std::to_string(i + 2);
+					const char* str = loc.Translate(handles[i]);
+
+					if (!str || (("en " + index) != str && (i + 2) % 10 != 0 && ("de " + index) != str)) { mismatches++; }
+				}
+			});
+		}
+
+		for (int i = 0; i < TEST_SWAPS; i++)
+		{
+			loc.SetLanguage(i % 2 ? "Deutsch" : "English");
+			loc.Advance();
+		}
+
+		isDone = true;
+
+		for (std::thread& reader : readers)
+		{
+			reader.join();
+		}
+
+		CHECK(mismatches == 0);
+
+		/* the tables replaced during the last swaps are freed on the next Advance */
+		loc.Advance();
+		CHECK(loc.GetRetiredCount() == 0);
+	}
+
+	std::filesystem::remove_all(dir);
+
+	TEST_RESULT();
+}
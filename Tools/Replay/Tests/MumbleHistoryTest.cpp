@@ -0,0 +1,205 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  MumbleHistoryTest.cpp
+/// Description  :  Checks sampling, interpolation and extrapolation of the MumbleLink history.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "Services/Mumble/History.h"
+
+#include "Test.h"
+
+namespace
+{
+	bool Near(float aValue, float aExpected, float aTolerance = 0.001f)
+	{
+		return fabsf(aValue - aExpected) < aTolerance;
+	}
+
+	/* moves one meter per second along all axes, so every coordinate tells the time */
+	float Pos(long long aTime)
+	{
+		return static_cast<float>(aTime / 1000000.0);
+	}
+
+	MumbleSample At(long long aTime, unsigned aTick)
+	{
+		float pos = Pos(aTime);
+
+		MumbleSample sample{};
+		sample.Time = aTime;
+		sample.UITick = aTick;
+		sample.AvatarPosition = Vector3{ pos, pos, pos };
+		sample.CameraPosition = Vector3{ pos, pos, pos + 2.0f };
+		sample.CameraFront = Vector3{ 1.0f, 0.0f, 0.0f };
+		return sample;
+	}
+}
+
+int main()
+{
+	{
+		Mumble::Data link{};
+		MumbleHistory history{};
+		CMumbleHistory sampler(&link, &history);
+
+		MumbleSample out{};
+
+		/* nothing to interpolate */
+		CHECK(!CMumbleHistory::Interpolate(&history, 1000, &out));
+		CHECK(!CMumbleHistory::Interpolate(nullptr, 1000, &out));
+
+		/* a sample per game update, not per frame */
+		link.UITick = 1;
+		link.AvatarPosition = Vector3{ 1.0f, 2.0f, 3.0f };
+		CHECK(sampler.Sample(10000, &out));
+		CHECK(out.UITick == 1 && out.Time == 10000 && Near(out.AvatarPosition.Y, 2.0f));
+		CHECK(!sampler.Sample(20000));
+		CHECK(history.FrameTime == 20000);
+		CHECK(history.Count == 1);
+
+		link.UITick = 2;
+		link.AvatarPosition = Vector3{ 3.0f, 2.0f, 3.0f };
+		CHECK(sampler.Sample(30000));
+		CHECK(history.Count == 2);
+		CHECK(history.Interval == 20000);
+
+		/* between the two samples */
+		CHECK(CMumbleHistory::Interpolate(&history, 20000, &out));
+		CHECK(Near(out.AvatarPosition.X, 2.0f));
+		CHECK(out.Time == 20000);
+
+		/* past the newest, extrapolated but not further than MH_MAX_EXTRAPOLATION */
+		CHECK(CMumbleHistory::Interpolate(&history, 40000, &out));
+		CHECK(Near(out.AvatarPosition.X, 4.0f));
+		CHECK(CMumbleHistory::Interpolate(&history, 30000 + MH_MAX_EXTRAPOLATION * 10, &out));
+		CHECK(out.Time == 30000 + MH_MAX_EXTRAPOLATION);
+		CHECK(Near(out.AvatarPosition.X, 3.0f + 2.0f * MH_MAX_EXTRAPOLATION / 20000.0f));
+
+		/* before the oldest, clamped */
+		CHECK(CMumbleHistory::Interpolate(&history, 0, &out));
+		CHECK(out.Time == 10000);
+		CHECK(Near(out.AvatarPosition.X, 1.0f));
+	}
+
+	{
+		MumbleHistory history{};
+		CMumbleHistory sampler(nullptr, &history);
+		MumbleSample out{};
+
+		/* a waypoint is not interpolated or extrapolated */
+		sampler.Push(At(10000, 1));
+		MumbleSample teleported = At(20000, 2);
+		teleported.AvatarPosition.X += MH_TELEPORT_DISTANCE * 2;
+		sampler.Push(teleported);
+
+		CHECK(CMumbleHistory::Interpolate(&history, 15000, &out));
+		CHECK(Near(out.AvatarPosition.X, Pos(10000)));
+		CHECK(CMumbleHistory::Interpolate(&history, 30000, &out));
+		CHECK(Near(out.AvatarPosition.X, teleported.AvatarPosition.X));
+		CHECK(out.Time == 20000);
+	}
+
+	{
+		MumbleHistory history{};
+		CMumbleHistory sampler(nullptr, &history);
+		MumbleSample out{};
+
+		/* the ring wraps, only the last MH_SAMPLES are kept */
+		for (unsigned i = 1; i <= MH_SAMPLES * 3; i++)
+		{
+			sampler.Push(At(i * 10000LL, i));
+		}
+
+		long long oldest = (MH_SAMPLES * 2 + 1) * 10000LL;
+
+		CHECK(CMumbleHistory::Interpolate(&history, 0, &out));
+		CHECK(out.Time == oldest);
+		CHECK(CMumbleHistory::Interpolate(&history, oldest + 5000, &out));
+		CHECK(Near(out.AvatarPosition.X, Pos(oldest + 5000)));
+		CHECK(CMumbleHistory::Interpolate(&history, MH_SAMPLES * 30000LL - 2500, &out));
+		CHECK(Near(out.AvatarPosition.Z, Pos(MH_SAMPLES * 30000LL - 2500)));
+		CHECK(Near(out.CameraPosition.Z, Pos(MH_SAMPLES * 30000LL - 2500) + 2.0f));
+		CHECK(Near(out.CameraFront.X, 1.0f));
+	}
+
+	{
+		MumbleHistory history{};
+		CMumbleHistory sampler(nullptr, &history);
+
+		/* readers interpolating while the writer laps the ring never see a mix of two samples */
+		std::atomic<bool> isWriting{ true };
+		std::atomic<int> inconsistent{ 0 };
+		std::atomic<unsigned long long> reads{ 0 };
+		std::atomic<int> started{ 0 };
+		std::atomic<long long> newest{ 0 };
+
+		std::thread writer([&]()
+		{
+			while (started < 4) { std::this_thread::yield(); }
+
+			for (unsigned i = 1; i <= 200000; i++)
+			{
+				sampler.Push(At(i * 10000LL, i));
+				newest = i * 10000LL;
+
+				/* lets the readers in on a single core */
+				if (i % 256 == 0) { std::this_thread::yield(); }
+			}
+
+			isWriting = false;
+		});
+
+		std::vector<std::thread> readers;
+
+		for (int r = 0; r < 4; r++)
+		{
+			readers.emplace_back([&, r]()
+			{
+				MumbleSample out{};
+				long long offset = 0;
+
+				started++;
+
+				while (isWriting)
+				{
+					/* anywhere from extrapolated to clamped at the oldest sample */
+					offset = (offset + 3333 * (r + 1)) % (MH_SAMPLES * 12000LL);
+					long long time = newest + 20000 - offset;
+
+					if (!CMumbleHistory::Interpolate(&history, time, &out)) { continue; }
+
+					reads++;
+
+					/* float precision at these positions, a slot of the previous lap is off by MH_SAMPLES / 100 */
+					float pos = out.AvatarPosition.X;
+
+					if (!Near(out.AvatarPosition.Y, pos, 0.01f) || !Near(out.AvatarPosition.Z, pos, 0.01f) ||
+						!Near(out.CameraPosition.Z, pos + 2.0f, 0.01f) || !Near(out.CameraFront.X, 1.0f, 0.01f) ||
+						!Near(pos, Pos(out.Time), 0.01f))
+					{
+						inconsistent++;
+					}
+				}
+			});
+		}
+
+		writer.join();
+
+		for (std::thread& reader : readers)
+		{
+			reader.join();
+		}
+
+		CHECK(inconsistent == 0);
+		CHECK(reads > 0);
+	}
+
+	TEST_RESULT();
+}
@@ -0,0 +1,144 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  MumbleIdentityTest.cpp
+/// Description  :  Feeds recorded MumbleLink identity strings to the identity parser.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <string>
+
+#include "Services/Mumble/IdentityParser.h"
+
+#include "Test.h"
+
+using namespace Mumble;
+
+namespace
+{
+	///----------------------------------------------------------------------------------------------------
+	/// Parse:
+	/// 	Parses a recorded identity on top of aPrevious, like the reader does.
+	///----------------------------------------------------------------------------------------------------
+	bool Parse(const std::wstring& aIdentity, Identity* aOutIdentity, const Identity& aPrevious = Identity{})
+	{
+		*aOutIdentity = aPrevious;
+		return ParseIdentity(aIdentity.c_str(), aIdentity.size() + 1, aOutIdentity);
+	}
+
+	std::wstring WithName(const std::wstring& aName)
+	{
+		return L"{\"name\":\"" + aName + L"\",\"profession\":4,\"spec\":55,\"race\":3,\"map_id\":1206,\"world_id\":2001,"
+			L"\"team_color_id\":0,\"commander\":false,\"map\":1206,\"fov\":0.873,\"uisz\":1}";
+	}
+
+	std::string ParseName(const std::wstring& aName)
+	{
+		Identity identity{};
+		if (!Parse(WithName(aName), &identity)) { return "<malformed>"; }
+		return identity.Name;
+	}
+}
+
+int main()
+{
+	Identity identity{};
+
+	/* as written by the game */
+	CHECK(Parse(L"{\"name\":\"Zojja Mistwalker\",\"profession\":6,\"spec\":48,\"race\":0,\"map_id\":1206,\"world_id\":268435458,"
+		L"\"team_color_id\":9,\"commander\":true,\"map\":1206,\"fov\":0.873,\"uisz\":2}", &identity));
+	CHECK(strcmp(identity.Name, "Zojja Mistwalker") == 0);
+	CHECK(identity.Profession == EProfession::Elementalist);
+	CHECK(identity.Specialization == 48);
+	CHECK(identity.Race == ERace::Asura);
+	CHECK(identity.MapID == 1206);
+	CHECK(identity.WorldID == 268435458);
+	CHECK(identity.TeamColorID == 9);
+	CHECK(identity.IsCommander);
+	CHECK(identity.FOV == 0.873f);
+	CHECK(identity.UISize == EUIScale::Large);
+
+	/* keys in another order, whitespace and unknown nested values */
+	CHECK(Parse(L" {\n\t\"uisz\" : 0, \"extra\": {\"a\": [1, 2.5e3, {\"b\": null}], \"c\": \"}\"},"
+		L" \"fov\": 1.2, \"name\": \"Rytlock\", \"race\": 1, \"commander\": false } ", &identity));
+	CHECK(strcmp(identity.Name, "Rytlock") == 0);
+	CHECK(identity.Race == ERace::Charr);
+	CHECK(!identity.IsCommander);
+	CHECK(identity.FOV == 1.2f);
+	CHECK(identity.UISize == EUIScale::Small);
+
+	/* missing keys keep their previous value */
+	Identity previous = identity;
+	previous.MapID = 15;
+	CHECK(Parse(L"{\"name\":\"Caithe\"}", &identity, previous));
+	CHECK(strcmp(identity.Name, "Caithe") == 0);
+	CHECK(identity.MapID == 15);
+	CHECK(identity.FOV == 1.2f);
+
+	/* accents, escapes and astral characters, raw and escaped, as UTF-8 */
+	CHECK(ParseName(L"F\u00EBanor \u00C9lan") == "F\xC3\xAB" "anor \xC3\x89lan");
+	CHECK(ParseName(L"\\u00c9clair\\t\\\"\\\\\\/") == "\xC3\x89" "clair\t\"\\/");
+	CHECK(ParseName(L"\\ud83d\\ude00 Smile") == "\xF0\x9F\x98\x80 Smile");
+	CHECK(ParseName(std::wstring(L"Raw ") + wchar_t(0xD83D) + wchar_t(0xDE00)) == "Raw \xF0\x9F\x98\x80");
+	CHECK(ParseName(std::wstring(L"Raw ") + wchar_t(0x1F600)) == "Raw \xF0\x9F\x98\x80");
+
+	/* 15 characters but 22 bytes, the old parser overflowed the name, truncated without splitting a character */
+	CHECK(ParseName(L"\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6abcdefgh") ==
+		"\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86" "abcde");
+	CHECK(ParseName(L"ab\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6\u00C6") ==
+		"ab\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86\xC3\x86");
+
+	/* malformed identities are rejected as a whole */
+	const wchar_t* malformed[] = {
+		L"",
+		L"{",
+		L"{\"name\":\"Logan\"",
+		L"{\"name\":\"Logan\"} trailing",
+		L"{\"name\":\"Logan}",
+		L"{\"name\":\"Lo\\qgan\"}",
+		L"{\"name\":\"\\udc00\"}",
+		L"{\"name\":\"\\ud83d\"}",
+		L"{\"name\":\"Logan\",}",
+		L"{\"fov\":1.}",
+		L"{\"commander\":tru}",
+		L"{\"extra\":[[[[[[[[[[1]]]]]]]]]]}",
+		L"[\"name\"]"
+	};
+
+	for (const wchar_t* identityString : malformed)
+	{
+		bool isValid = Parse(identityString, &identity);
+		CHECK(!isValid);
+		if (isValid) { printf("  accepted: %ls\n", identityString); }
+	}
+
+	/* the buffer is not necessarily terminated */
+	std::wstring unterminated = L"{\"uisz\":3}xxxx";
+	CHECK(ParseIdentity(unterminated.c_str(), 10, &identity));
+	CHECK(identity.UISize == EUIScale::Larger);
+	CHECK(!ParseIdentity(unterminated.c_str(), 9, &identity));
+
+	/* every FOV the game writes, as the old parser read it through strtod */
+	int mismatches = 0;
+
+	for (int i = 0; i < 100000; i++)
+	{
+		char fov[16];
+		snprintf(fov, sizeof(fov), "%d.%04d", i / 10000, i % 10000);
+
+		std::wstring fovIdentity = L"{\"fov\":" + std::wstring(fov, fov + strlen(fov)) + L"}";
+
+		if (!Parse(fovIdentity, &identity) || identity.FOV != static_cast<float>(strtod(fov, nullptr)))
+		{
+			mismatches++;
+		}
+	}
+
+	CHECK(mismatches == 0);
+
+	TEST_RESULT();
+}
@@ -0,0 +1,135 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RawInputTest.cpp
+/// Description  :  Checks filtering and that deregistering waits for a running message dispatch.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Shared.h"
+
+#include "Test.h"
+
+namespace
+{
+	constexpr const UINT WM_TEST_SLOW	= WM_USER + 1;
+	constexpr const UINT WM_TEST_NESTED	= WM_USER + 2;
+	constexpr const UINT WM_TEST_SELF	= WM_USER + 3;
+
+	std::atomic<int>	KeyCalls{ 0 };
+	std::atomic<int>	AnyCalls{ 0 };
+
+	std::atomic<bool>	IsSlowRunning{ false };
+	std::atomic<bool>	IsSlowDone{ false };
+	std::atomic<int>	SelfDeregisters{ 0 };
+
+	UINT OnKey(HWND, UINT, WPARAM, LPARAM)
+	{
+		KeyCalls++;
+		return 1;
+	}
+
+	UINT OnAny(HWND, UINT, WPARAM, LPARAM)
+	{
+		AnyCalls++;
+		return 1;
+	}
+
+	/* a nested message first, like a SendMessage from within the callback, then the slow part */
+	UINT OnSlow(HWND hWnd, UINT uMsg, WPARAM, LPARAM)
+	{
+		if (uMsg != WM_TEST_SLOW) { return 1; }
+
+		RawInputApi->WndProc(hWnd, WM_TEST_NESTED, 0, 0);
+
+		IsSlowRunning = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		IsSlowDone = true;
+
+		return 1;
+	}
+
+	/* an addon deregistering from its own callback must not wait for that dispatch */
+	UINT OnSelf(HWND, UINT, WPARAM, LPARAM)
+	{
+		RawInputApi->Deregister(OnSelf);
+		SelfDeregisters++;
+		return 1;
+	}
+
+	template <typename Pred>
+	bool WaitUntil(Pred aPredicate)
+	{
+		for (int i = 0; i < 5000 && !aPredicate(); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return aPredicate();
+	}
+}
+
+int main()
+{
+	CCallbackWatchdog watchdog(Logger);
+	CallbackWatchdog = &watchdog;
+
+	{
+		CRawInputApi api;
+		RawInputApi = &api;
+
+		/* filtered callbacks are only called within their range */
+		api.Register(OnKey, WM_KEYFIRST, WM_KEYLAST);
+		api.Register(OnAny);
+
+		CHECK(api.WndProc(nullptr, WM_MOUSEMOVE, 0, 0) != 0);
+		CHECK(api.WndProc(nullptr, WM_KEYDOWN, 0x41, 0) != 0);
+		CHECK(KeyCalls == 1);
+		CHECK(AnyCalls == 2);
+
+		api.Deregister(OnKey);
+		api.Deregister(OnAny);
+
+		/* Deregister returns only once the dispatch calling it has ended, a nested one ending does not count */
+		api.Register(OnSlow, WM_TEST_SLOW, WM_TEST_NESTED);
+
+		std::thread window([&api]() { api.WndProc(nullptr, WM_TEST_SLOW, 0, 0); });
+		CHECK(WaitUntil([]() { return IsSlowRunning.load(); }));
+		api.Deregister(OnSlow);
+		CHECK(IsSlowDone);
+		window.join();
+
+		/* the same for Verify */
+		IsSlowRunning = false;
+		IsSlowDone = false;
+		api.Register(OnSlow, WM_TEST_SLOW, WM_TEST_NESTED);
+
+		window = std::thread([&api]() { api.WndProc(nullptr, WM_TEST_SLOW, 0, 0); });
+		CHECK(WaitUntil([]() { return IsSlowRunning.load(); }));
+		CHECK(api.Verify((void*)OnSlow, (void*)OnSlow) == 1);
+		CHECK(IsSlowDone);
+		window.join();
+
+		CHECK(api.Verify((void*)OnSlow, (void*)OnSlow) == 0);
+		CHECK(api.GetCallbacks().empty());
+
+		/* deregistering from within does not wait for itself */
+		api.Register(OnSelf, WM_TEST_SELF, WM_TEST_SELF);
+
+		window = std::thread([&api]() { api.WndProc(nullptr, WM_TEST_SELF, 0, 0); });
+		CHECK(WaitUntil([]() { return SelfDeregisters.load() == 1; }));
+		window.join();
+
+		CHECK(api.GetCallbacks().empty());
+
+		RawInputApi = nullptr;
+	}
+
+	CallbackWatchdog = nullptr;
+
+	TEST_RESULT();
+}
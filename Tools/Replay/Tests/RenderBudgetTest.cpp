@@ -0,0 +1,109 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderBudgetTest.cpp
+/// Description  :  Checks the render intervals of addons over budget and that they keep being rendered.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "GUI/RenderBudget.h"
+#include "Loader/Loader.h"
+
+#include "Test.h"
+
+namespace
+{
+	/* fake modules, callbacks are addresses within them */
+	unsigned char	ModuleA[64];
+	unsigned char	ModuleB[64];
+
+	AddonDefinition	DefinitionA{ 1, "A" };
+	AddonDefinition	DefinitionB{ 2, "B" };
+
+	Addon			AddonA{ (HMODULE)ModuleA, sizeof(ModuleA), &DefinitionA };
+	Addon			AddonB{ (HMODULE)ModuleB, sizeof(ModuleB), &DefinitionB };
+
+	///----------------------------------------------------------------------------------------------------
+	/// RunFrames:
+	/// 	Renders aFrames frames, each rendered callback costing its milliseconds.
+	/// 	Returns how often the callback of A was rendered.
+	///----------------------------------------------------------------------------------------------------
+	int RunFrames(CRenderBudget& aBudget, int aFrames, double aCostA, double aCostB)
+	{
+		int renderedA = 0;
+
+		for (int i = 0; i < aFrames; i++)
+		{
+			if (aBudget.ShouldRender(ModuleA))
+			{
+				aBudget.Record(ModuleA, static_cast<long long>(aCostA * 1000000.0));
+				renderedA++;
+			}
+
+			if (aBudget.ShouldRender(ModuleB))
+			{
+				aBudget.Record(ModuleB, static_cast<long long>(aCostB * 1000000.0));
+			}
+
+			aBudget.EndFrame();
+		}
+
+		return renderedA;
+	}
+
+	unsigned GetInterval(const CRenderBudget& aBudget, signed int aSignature)
+	{
+		for (const RenderCostInfo& cost : aBudget.GetCosts())
+		{
+			if (cost.Signature == aSignature) { return cost.Interval; }
+		}
+
+		return 0;
+	}
+}
+
+int main()
+{
+	Loader::Addons = { &AddonA, &AddonB };
+
+	{
+		CRenderBudget budget;
+
+		/* nothing is tracked or throttled while not enforced */
+		CHECK(RunFrames(budget, RB_EVALUATE_FRAMES * 2, 50.0, 0.1) == RB_EVALUATE_FRAMES * 2);
+		CHECK(budget.GetCosts().empty());
+
+		/* far over budget: rendered at the longest interval, not dropped */
+		budget.SetBudgets(1.0f, 0.0f);
+		budget.SetEnabled(true);
+
+		RunFrames(budget, RB_EVALUATE_FRAMES + 1, 50.0, 0.1);
+		CHECK(GetInterval(budget, 1) == RB_MAX_INTERVAL);
+		CHECK(GetInterval(budget, 2) == 1);
+
+		int rendered = RunFrames(budget, RB_MAX_INTERVAL * 10, 50.0, 0.1);
+		CHECK(rendered == 10);
+
+		/* its cost keeps being measured, so it recovers once it is cheap again */
+		RunFrames(budget, RB_EVALUATE_FRAMES * 20, 0.5, 0.1);
+		CHECK(GetInterval(budget, 1) == 1);
+
+		/* a total budget nothing fits in ends with everything at the longest interval */
+		budget.SetBudgets(0.0f, 0.001f);
+		RunFrames(budget, RB_EVALUATE_FRAMES * 2, 4.0, 2.0);
+		CHECK(GetInterval(budget, 1) == RB_MAX_INTERVAL);
+		CHECK(GetInterval(budget, 2) == RB_MAX_INTERVAL);
+		CHECK(RunFrames(budget, RB_MAX_INTERVAL * 10, 4.0, 2.0) == 10);
+
+		/* everything is rendered every frame again once disabled */
+		budget.SetEnabled(false);
+		RunFrames(budget, 1, 4.0, 2.0);
+		CHECK(GetInterval(budget, 1) == 1);
+		CHECK(GetInterval(budget, 2) == 1);
+		CHECK(RunFrames(budget, 100, 4.0, 2.0) == 100);
+	}
+
+	Loader::Addons.clear();
+
+	TEST_RESULT();
+}
@@ -0,0 +1,168 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderRegistryTest.cpp
+/// Description  :  Checks registering and deregistering render callbacks while frames are rendered.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "GUI/RenderRegistry.h"
+
+#include "Test.h"
+
+namespace
+{
+	constexpr const int TEST_WRITERS		= 4;
+	constexpr const int TEST_PER_WRITER		= 4;	/* callbacks every writer registers and deregisters */
+	constexpr const int TEST_CYCLES			= 300;	/* registrations per callback */
+
+	enum ECallbackState
+	{
+		Unregistered,
+		Registered,
+		Deregistered
+	};
+
+	CRenderRegistry*			Registry	= nullptr;
+	std::atomic<int>			States[TEST_WRITERS * TEST_PER_WRITER];
+	std::atomic<long long>		Calls{ 0 };
+	std::atomic<int>			LateCalls{ 0 };		/* calls after Deregister returned */
+
+	template <int N>
+	void Callback()
+	{
+		if (States[N].load() == Deregistered) { LateCalls++; }
+
+		/* the writers run in the middle of the frame, also on a single core */
+		std::this_thread::yield();
+
+		if (States[N].load() == Deregistered) { LateCalls++; }
+
+		Calls++;
+	}
+
+	template <int... N>
+	std::vector<GUI_RENDER> MakeCallbacks(std::integer_sequence<int, N...>)
+	{
+		return { Callback<N>... };
+	}
+
+	/* deregisters itself from within the frame, which must not wait for the frame */
+	std::atomic<int> SelfCalls{ 0 };
+
+	void SelfDeregistering()
+	{
+		SelfCalls++;
+		Registry->Deregister(SelfDeregistering);
+	}
+
+	void RenderFrame(CRenderRegistry& aRegistry)
+	{
+		const RenderCallbacks* frame = aRegistry.BeginFrame();
+
+		for (const std::vector<GUI_RENDER>* callbacks : { &frame->PreRender, &frame->Render, &frame->PostRender, &frame->OptionsRender })
+		{
+			for (GUI_RENDER callback : *callbacks)
+			{
+				callback();
+			}
+		}
+
+		aRegistry.EndFrame();
+	}
+}
+
+int main()
+{
+	CRenderRegistry registry;
+	Registry = &registry;
+
+	std::vector<GUI_RENDER> callbacks = MakeCallbacks(std::make_integer_sequence<int, TEST_WRITERS * TEST_PER_WRITER>());
+
+	/* registered and deregistered within one frame */
+	registry.Register(ERenderType::Render, SelfDeregistering);
+	RenderFrame(registry);
+	RenderFrame(registry);
+	CHECK(SelfCalls == 1);
+
+	/* a snapshot replaced during a frame is kept until the frame ended */
+	const RenderCallbacks* frame = registry.BeginFrame();
+	registry.Register(ERenderType::Render, callbacks[0]);
+	CHECK(registry.GetRetiredCount() == 1);
+	CHECK(frame->Render.empty());
+	registry.EndFrame();
+	CHECK(registry.GetRetiredCount() == 0);
+	registry.Deregister(callbacks[0]);
+
+	std::atomic<bool> isDone{ false };
+	std::atomic<long long> frames{ 0 };
+
+	std::thread renderer([&]()
+	{
+		while (!isDone.load())
+		{
+			RenderFrame(registry);
+			frames++;
+
+			std::this_thread::yield();
+		}
+	});
+
+	std::vector<std::thread> writers;
+
+	for (int w = 0; w < TEST_WRITERS; w++)
+	{
+		writers.emplace_back([&, w]()
+		{
+			for (int cycle = 0; cycle < TEST_CYCLES; cycle++)
+			{
+				for (int i = 0; i < TEST_PER_WRITER; i++)
+				{
+					int index = w * TEST_PER_WRITER + i;
+
+					States[index] = Registered;
+					registry.Register(static_cast<ERenderType>((cycle + i) % 4), callbacks[index]);
+				}
+
+				std::this_thread::yield();
+
+				for (int i = 0; i < TEST_PER_WRITER; i++)
+				{
+					int index = w * TEST_PER_WRITER + i;
+
+					registry.Deregister(callbacks[index]);
+					States[index] = Deregistered;
+				}
+			}
+		});
+	}
+
+	for (std::thread& writer : writers)
+	{
+		writer.join();
+	}
+
+	isDone = true;
+	renderer.join();
+
+	CHECK(LateCalls == 0);
+	CHECK(Calls > 0);
+	CHECK(frames > 0);
+
+	/* every snapshot replaced while frames were rendered is freed once a frame ended without writers */
+	RenderFrame(registry);
+	CHECK(registry.GetRetiredCount() == 0);
+
+	frame = registry.BeginFrame();
+	CHECK(frame->PreRender.empty() && frame->Render.empty() && frame->PostRender.empty() && frame->OptionsRender.empty());
+	registry.EndFrame();
+
+	Registry = nullptr;
+
+	TEST_RESULT();
+}
@@ -0,0 +1,149 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  SeqLockTest.cpp
+/// Description  :  Checks that versioned resources are only ever read whole while writers keep changing them.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "Shared.h"
+#include "Services/DataLink/DataLink.h"
+
+#include "Test.h"
+
+namespace
+{
+	constexpr const int TEST_WRITERS	= 2;
+	constexpr const int TEST_READERS	= 3;
+	constexpr const int TEST_WRITES		= 100000;	/* per writer */
+	constexpr const int TEST_WORDS		= 254;		/* a kilobyte, long enough to be torn */
+
+	///----------------------------------------------------------------------------------------------------
+	/// Pattern Struct
+	/// 	Every word is derived from the sequence, a copy with any other word is mixed.
+	///----------------------------------------------------------------------------------------------------
+	struct Pattern
+	{
+		unsigned	Version;
+		unsigned	Sequence;
+		unsigned	Words[TEST_WORDS];
+	};
+
+	unsigned Word(unsigned aSequence, int aIndex)
+	{
+		return aSequence * 2654435761u + static_cast<unsigned>(aIndex);
+	}
+
+	bool IsWhole(const Pattern& aPattern)
+	{
+		for (int i = 0; i < TEST_WORDS; i++)
+		{
+			if (aPattern.Words[i] != Word(aPattern.Sequence, i)) { return false; }
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	CDataLink dataLink;
+
+	Pattern* shared = (Pattern*)dataLink.ShareVersionedResource("DL_PATTERN", sizeof(Pattern), offsetof(Pattern, Version), false);
+	CHECK(shared != nullptr);
+
+	if (!shared) { TEST_RESULT(); }
+
+	/* the initial zeroed resource is a whole pattern of sequence 0 */
+	for (int i = 0; i < TEST_WORDS; i++) { shared->Words[i] = Word(0, i); }
+
+	std::atomic<int> writing{ TEST_WRITERS };
+	std::atomic<int> mixed{ 0 };
+	std::atomic<int> oddVersions{ 0 };
+	std::atomic<int> reversed{ 0 };
+	std::atomic<long long> reads{ 0 };
+
+	std::vector<std::thread> threads;
+
+	for (int r = 0; r < TEST_READERS; r++)
+	{
+		threads.emplace_back([&]()
+		{
+			Pattern copy;
+			unsigned last = 0;
+
+			while (writing.load() > 0)
+			{
+				unsigned version = 0;
+
+				/* no consistent copy within the retries is a valid outcome, a mixed one is not */
+				if (!dataLink.ReadResource("DL_PATTERN", &copy, sizeof(copy), &version)) { continue; }
+
+				if (!IsWhole(copy)) { mixed++; }
+				if (version & 1) { oddVersions++; }
+				if (version < last) { reversed++; }
+
+				last = version;
+				reads++;
+			}
+		});
+	}
+
+	/* writers wait for each other, every write is a whole pattern of its own sequence */
+	for (int w = 0; w < TEST_WRITERS; w++)
+	{
+		threads.emplace_back([&, w]()
+		{
+			for (int n = 1; n <= TEST_WRITES; n++)
+			{
+				unsigned sequence = (static_cast<unsigned>(w) << 24) | static_cast<unsigned>(n);
+
+				SeqLock::BeginWrite(&shared->Version);
+
+				shared->Sequence = sequence;
+
+				for (int i = 0; i < TEST_WORDS; i++)
+				{
+					shared->Words[i] = Word(sequence, i);
+				}
+
+				SeqLock::EndWrite(&shared->Version);
+
+				/* let the readers in on a single core */
+				if (n % 64 == 0) { std::this_thread::yield(); }
+			}
+
+			writing--;
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(mixed == 0);
+	CHECK(oddVersions == 0);
+	CHECK(reversed == 0);
+	CHECK(reads > 0);
+	CHECK(SeqLock::GetVersion(&shared->Version) == 2u * TEST_WRITERS * TEST_WRITES);
+
+	/* a copy after the writers is the last write of one of them */
+	Pattern copy;
+	unsigned version = 0;
+	CHECK(dataLink.ReadResource("DL_PATTERN", &copy, sizeof(copy), &version));
+	CHECK(IsWhole(copy) && (copy.Sequence & 0xFFFFFF) == TEST_WRITES && version == 2u * TEST_WRITERS * TEST_WRITES);
+
+	/* a writer that never finished fails the read instead of hanging it */
+	SeqLock::BeginWrite(&shared->Version);
+	CHECK(!dataLink.ReadResource("DL_PATTERN", &copy, sizeof(copy), &version));
+	SeqLock::EndWrite(&shared->Version);
+	CHECK(dataLink.ReadResource("DL_PATTERN", &copy, sizeof(copy), &version));
+
+	TEST_RESULT();
+}
@@ -0,0 +1,22 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Hooks.h
+/// Description  :  The hooked game functions. A test sets the game WndProc to observe what is sent to it.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef HOOKS_H
+#define HOOKS_H
+
+#include <Windows.h>
+
+namespace Hooks
+{
+	namespace GW2
+	{
+		extern WNDPROC			WndProc;
+	}
+}
+
+#endif
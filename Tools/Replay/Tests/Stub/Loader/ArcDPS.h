@@ -0,0 +1,19 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ArcDPS.h
+/// Description  :  ArcDPS is never loaded.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef ARCDPS_H
+#define ARCDPS_H
+
+namespace ArcDPS
+{
+	inline bool							IsLoaded = false;
+
+	inline void Detect() {}
+}
+
+#endif
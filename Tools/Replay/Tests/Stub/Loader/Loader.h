@@ -0,0 +1,46 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Loader.h
+/// Description  :  The loaded addons as seen by the tested cores. A test adds the modules it fakes.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <Windows.h>
+#include <string>
+#include <vector>
+
+///----------------------------------------------------------------------------------------------------
+/// AddonDefinition Struct
+///----------------------------------------------------------------------------------------------------
+struct AddonDefinition
+{
+	signed int					Signature;
+	const char*					Name;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// Addon Struct
+///----------------------------------------------------------------------------------------------------
+struct Addon
+{
+	HMODULE						Module;
+	DWORD						ModuleSize;
+	AddonDefinition*			Definitions;
+};
+
+namespace Loader
+{
+	extern std::vector<Addon*>	Addons;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetOwner:
+	/// 	Returns the name of the addon the address belongs to.
+	///----------------------------------------------------------------------------------------------------
+	std::string GetOwner(void* aAddress);
+}
+
+#endif
@@ -0,0 +1,19 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Renderer.h
+/// Description  :  The renderer variables used by the tested cores. There is no window.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <Windows.h>
+
+namespace Renderer
+{
+	extern HWND						WindowHandle;
+}
+
+#endif
@@ -0,0 +1,39 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Shared.h
+/// Description  :  The globals used by the tested cores. Stub.cpp defines them, a test creates the ones it uses.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef SHARED_H
+#define SHARED_H
+
+#include <Windows.h>
+
+#include "Services/Logging/LogHandler.h"
+#include "Services/Localization/Localization.h"
+#include "Services/CombatStats/CombatStats.h"
+#include "Services/DataLink/DataLink.h"
+#include "Services/Recorder/Recorder.h"
+#include "Services/Watchdog/CallbackWatchdog.h"
+#include "Events/EventHandler.h"
+#include "Events/CombatBatchApi.h"
+#include "Inputs/RawInput/RawInputApi.h"
+#include "Inputs/InputBinds/InputBindHandler.h"
+#include "Inputs/GameBinds/GameBindsHandler.h"
+
+extern HMODULE						NexusHandle;
+extern CLogHandler*					Logger;
+extern CLocalization*				Language;
+extern CEventApi*					EventApi;
+extern CCombatBatchApi*				CombatBatchApi;
+extern CCombatRecorder*				CombatRecorder;
+extern CCombatStats*				CombatStatsEngine;
+extern CDataLink*					DataLinkService;
+extern CRawInputApi*				RawInputApi;
+extern CInputBindApi*				InputBindApi;
+extern CGameBindsApi*				GameBindsApi;
+extern CCallbackWatchdog*			CallbackWatchdog;
+
+#endif
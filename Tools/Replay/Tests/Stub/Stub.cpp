@@ -0,0 +1,95 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Stub.cpp
+/// Description  :  Definitions the tested cores link against, in place of the Windows only sources.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+
+#include "Consts.h"
+#include "Shared.h"
+#include "Hooks.h"
+#include "Index.h"
+#include "Renderer.h"
+#include "Loader/Loader.h"
+#include "Util/Paths.h"
+#include "Util/Resources.h"
+#include "Util/Strings.h"
+
+/* log messages are dropped */
+void CLogHandler::Critical(const std::string&, const char*, ...) {}
+void CLogHandler::Warning(const std::string&, const char*, ...) {}
+void CLogHandler::Info(const std::string&, const char*, ...) {}
+void CLogHandler::Debug(const std::string&, const char*, ...) {}
+void CLogHandler::Trace(const std::string&, const char*, ...) {}
+
+HMODULE						NexusHandle			= nullptr;
+
+CLogHandler					NullLogger;
+CLogHandler*				Logger				= &NullLogger;
+
+/* a test creates the cores it uses */
+CLocalization*				Language			= nullptr;
+CEventApi*					EventApi			= nullptr;
+CCombatBatchApi*			CombatBatchApi		= nullptr;
+CCombatRecorder*			CombatRecorder		= nullptr;
+CCombatStats*				CombatStatsEngine	= nullptr;
+CDataLink*					DataLinkService		= nullptr;
+CRawInputApi*				RawInputApi			= nullptr;
+CInputBindApi*				InputBindApi		= nullptr;
+CGameBindsApi*				GameBindsApi		= nullptr;
+CCallbackWatchdog*			CallbackWatchdog	= nullptr;
+
+WNDPROC						Hooks::GW2::WndProc		= nullptr;
+HWND						Renderer::WindowHandle	= nullptr;
+
+std::vector<Addon*>			Loader::Addons;
+
+/* per process, so parallel runs don't share state */
+std::filesystem::path		Index::F_INPUTBINDS = std::filesystem::temp_directory_path() / ("nexus-stub-" + std::to_string(getpid()) + "-InputBinds.json");
+std::filesystem::path		Index::F_GAMEBINDS = std::filesystem::temp_directory_path() / ("nexus-stub-" + std::to_string(getpid()) + "-GameBinds.json");
+std::filesystem::path		Index::F_FONTATLASCACHE = std::filesystem::temp_directory_path() / ("nexus-stub-" + std::to_string(getpid()) + "-FontAtlas.bin");
+
+std::string Loader::GetOwner(void* aAddress)
+{
+	for (Addon* addon : Loader::Addons)
+	{
+		void* startAddress = addon->Module;
+		void* endAddress = ((PBYTE)addon->Module) + addon->ModuleSize;
+
+		if (aAddress >= startAddress && aAddress <= endAddress)
+		{
+			return addon->Definitions && addon->Definitions->Name ? addon->Definitions->Name : NULLSTR;
+		}
+	}
+
+	return NULLSTR;
+}
+
+/* there are no embedded resources, fonts are added from memory */
+bool Resources::Get(HMODULE, LPCSTR, LPCSTR, LPVOID*, DWORD*)
+{
+	return false;
+}
+
+void Path::CreateDir(const std::filesystem::path& aDirectory)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(aDirectory, ec);
+}
+
+std::string String::ToUpper(std::string aString)
+{
+	std::transform(aString.begin(), aString.end(), aString.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+	return aString;
+}
+
+std::string String::ConvertMBToUTF8(std::string aString)
+{
+	return aString;
+}
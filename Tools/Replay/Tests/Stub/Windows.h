@@ -0,0 +1,297 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Windows.h
+/// Description  :  The parts of the Win32 API and the MSVC runtime used by the tested cores, on POSIX.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STUB_WINDOWS_H
+#define STUB_WINDOWS_H
+
+#include <climits>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef void*				HANDLE;
+typedef void*				LPVOID;
+typedef void*				HMODULE;
+typedef void*				HWND;
+typedef unsigned long		DWORD;
+typedef long				LONG;
+typedef long long			LONGLONG;
+typedef unsigned int		UINT;
+typedef unsigned long long	WPARAM;
+typedef long long			LPARAM;
+typedef long long			LRESULT;
+typedef unsigned char		BYTE;
+typedef BYTE*				PBYTE;
+typedef const char*			LPCSTR;
+
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+struct POINT
+{
+	LONG x;
+	LONG y;
+};
+
+union LARGE_INTEGER
+{
+	LONGLONG QuadPart;
+};
+
+#define INVALID_HANDLE_VALUE	((HANDLE)(intptr_t)-1)
+#define GENERIC_READ			0x80000000UL
+#define FILE_SHARE_READ			0x00000001UL
+#define FILE_SHARE_DELETE		0x00000004UL
+#define OPEN_EXISTING			3
+#define FILE_ATTRIBUTE_NORMAL	0x00000080UL
+#define PAGE_READONLY			0x02
+#define PAGE_READWRITE			0x04
+#define FILE_MAP_READ			0x0004
+#define FILE_MAP_ALL_ACCESS		0x000F001FUL
+#define FALSE					0
+
+#define RT_FONT					((LPCSTR)(uintptr_t)8)
+#define MAKEINTRESOURCE(i)		((LPCSTR)(uintptr_t)(unsigned short)(i))
+
+#define WM_ACTIVATEAPP			0x001C
+#define WM_KEYFIRST				0x0100
+#define WM_KEYDOWN				0x0100
+#define WM_KEYUP				0x0101
+#define WM_CHAR					0x0102
+#define WM_SYSKEYDOWN			0x0104
+#define WM_SYSKEYUP				0x0105
+#define WM_KEYLAST				0x0109
+#define WM_MOUSEFIRST			0x0200
+#define WM_MOUSEMOVE			0x0200
+#define WM_LBUTTONDOWN			0x0201
+#define WM_LBUTTONUP			0x0202
+#define WM_RBUTTONDOWN			0x0204
+#define WM_RBUTTONUP			0x0205
+#define WM_MBUTTONDOWN			0x0207
+#define WM_MBUTTONUP			0x0208
+#define WM_MOUSEWHEEL			0x020A
+#define WM_XBUTTONDOWN			0x020B
+#define WM_XBUTTONUP			0x020C
+#define WM_MOUSELAST			0x020E
+#define WM_USER					0x0400
+
+#define VK_SHIFT				0x10
+#define VK_CONTROL				0x11
+#define VK_MENU					0x12
+
+#define MK_LBUTTON				0x0001
+#define MK_RBUTTON				0x0002
+#define MK_SHIFT				0x0004
+#define MK_CONTROL				0x0008
+#define MK_MBUTTON				0x0010
+#define MK_XBUTTON1				0x0020
+#define MK_XBUTTON2				0x0040
+#define XBUTTON1				0x0001
+#define XBUTTON2				0x0002
+
+#define MAPVK_VK_TO_VSC			0
+#define MAPVK_VSC_TO_VK			1
+
+#define LOWORD(l)				((unsigned short)(((unsigned long long)(l)) & 0xFFFF))
+#define HIWORD(l)				((unsigned short)((((unsigned long long)(l)) >> 16) & 0xFFFF))
+#define MAKEWPARAM(l, h)		((WPARAM)(((unsigned)(unsigned short)(l)) | (((unsigned)(unsigned short)(h)) << 16)))
+#define MAKELPARAM(l, h)		((LPARAM)(((unsigned)(unsigned short)(l)) | (((unsigned)(unsigned short)(h)) << 16)))
+
+namespace Stub
+{
+	///----------------------------------------------------------------------------------------------------
+	/// Handle data struct
+	/// 	Files and mappings are both backed by a file descriptor.
+	///----------------------------------------------------------------------------------------------------
+	struct Handle
+	{
+		int			Fd;
+		size_t		Size;
+		std::string	Name;		/* of a named mapping, POSIX shared memory */
+	};
+
+	inline std::mutex						ViewMutex;
+	inline std::map<const void*, size_t>	Views;		/* munmap needs the size */
+	inline std::map<std::string, int>		Names;		/* open handles, the object is removed with the last */
+
+	inline std::string ShmName(const char* aName)
+	{
+		return std::string("/") + aName;
+	}
+}
+
+inline HANDLE CreateFileW(const char* aPath, DWORD, DWORD, void*, DWORD, DWORD, HANDLE)
+{
+	int fd = open(aPath, O_RDONLY);
+	if (fd < 0) { return INVALID_HANDLE_VALUE; }
+
+	struct stat st{};
+	fstat(fd, &st);
+
+	return new Stub::Handle{ fd, static_cast<size_t>(st.st_size), {} };
+}
+
+inline bool GetFileSizeEx(HANDLE aFile, LARGE_INTEGER* aOutSize)
+{
+	aOutSize->QuadPart = static_cast<LONGLONG>(static_cast<Stub::Handle*>(aFile)->Size);
+	return true;
+}
+
+inline HANDLE CreateFileMappingW(HANDLE aFile, void*, DWORD, DWORD, DWORD, const char*)
+{
+	Stub::Handle* file = static_cast<Stub::Handle*>(aFile);
+	return new Stub::Handle{ dup(file->Fd), file->Size, {} };
+}
+
+/* only named mappings backed by the paging file */
+inline HANDLE CreateFileMappingA(HANDLE, void*, DWORD, DWORD, DWORD aSizeLow, const char* aName)
+{
+	std::string name = Stub::ShmName(aName);
+
+	int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+	if (fd < 0) { return nullptr; }
+
+	struct stat st{};
+	fstat(fd, &st);
+
+	if (static_cast<size_t>(st.st_size) < aSizeLow && ftruncate(fd, aSizeLow) != 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	const std::lock_guard<std::mutex> lock(Stub::ViewMutex);
+	Stub::Names[name]++;
+
+	return new Stub::Handle{ fd, static_cast<size_t>(st.st_size) < aSizeLow ? aSizeLow : static_cast<size_t>(st.st_size), name };
+}
+
+inline HANDLE OpenFileMappingA(DWORD, int, const char* aName)
+{
+	std::string name = Stub::ShmName(aName);
+
+	int fd = shm_open(name.c_str(), O_RDWR, 0600);
+	if (fd < 0) { return nullptr; }
+
+	struct stat st{};
+	fstat(fd, &st);
+
+	const std::lock_guard<std::mutex> lock(Stub::ViewMutex);
+	Stub::Names[name]++;
+
+	return new Stub::Handle{ fd, static_cast<size_t>(st.st_size), name };
+}
+
+inline void* MapViewOfFile(HANDLE aMapping, DWORD aAccess, DWORD, DWORD, size_t)
+{
+	Stub::Handle* mapping = static_cast<Stub::Handle*>(aMapping);
+
+	int protection = aAccess == FILE_MAP_READ ? PROT_READ : PROT_READ | PROT_WRITE;
+
+	void* view = mmap(nullptr, mapping->Size, protection, MAP_SHARED, mapping->Fd, 0);
+	if (view == MAP_FAILED) { return nullptr; }
+
+	const std::lock_guard<std::mutex> lock(Stub::ViewMutex);
+	Stub::Views[view] = mapping->Size;
+
+	return view;
+}
+
+inline bool UnmapViewOfFile(const void* aView)
+{
+	const std::lock_guard<std::mutex> lock(Stub::ViewMutex);
+
+	auto it = Stub::Views.find(aView);
+	if (it == Stub::Views.end()) { return false; }
+
+	munmap(const_cast<void*>(aView), it->second);
+	Stub::Views.erase(it);
+
+	return true;
+}
+
+inline bool CloseHandle(HANDLE aHandle)
+{
+	Stub::Handle* handle = static_cast<Stub::Handle*>(aHandle);
+	close(handle->Fd);
+
+	if (!handle->Name.empty())
+	{
+		const std::lock_guard<std::mutex> lock(Stub::ViewMutex);
+
+		if (--Stub::Names[handle->Name] == 0)
+		{
+			shm_unlink(handle->Name.c_str());
+			Stub::Names.erase(handle->Name);
+		}
+	}
+
+	delete handle;
+	return true;
+}
+
+inline DWORD GetCurrentProcessId()
+{
+	return static_cast<DWORD>(getpid());
+}
+
+/* there is no cursor, mouse messages carry 0, 0 */
+inline bool GetCursorPos(POINT* aPoint)
+{
+	aPoint->x = 0;
+	aPoint->y = 0;
+	return true;
+}
+
+inline LRESULT CallWindowProcA(WNDPROC aWndProc, HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	return aWndProc ? aWndProc(hWnd, uMsg, wParam, lParam) : 0;
+}
+
+/* scan codes and virtual keys are the same, key names are the scan code */
+inline UINT MapVirtualKeyA(UINT aCode, UINT)
+{
+	return aCode & 0xFF;
+}
+
+inline int GetKeyNameTextA(LONG aLParam, char* aBuffer, int aSize)
+{
+	return snprintf(aBuffer, aSize, "SC%02lX", (aLParam >> 16) & 0x1FF);
+}
+
+template <size_t N>
+inline int sprintf_s(char (&aBuffer)[N], const char* aFormat, ...)
+{
+	va_list args;
+	va_start(args, aFormat);
+	int result = vsnprintf(aBuffer, N, aFormat, args);
+	va_end(args);
+	return result;
+}
+
+inline int memcpy_s(void* aDestination, size_t aDestinationSize, const void* aSource, size_t aCount)
+{
+	if (aCount > aDestinationSize) { return 34; /* ERANGE */ }
+	memcpy(aDestination, aSource, aCount);
+	return 0;
+}
+
+inline char* _strdup(const char* aString)
+{
+	return strdup(aString);
+}
+
+#endif
@@ -0,0 +1,14 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  intrin.h
+/// Description  :  The MSVC intrinsics used by the tested cores, on GCC and Clang.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STUB_INTRIN_H
+#define STUB_INTRIN_H
+
+#define _ReturnAddress()		__builtin_return_address(0)
+
+#endif
@@ -0,0 +1,44 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Test.h
+/// Description  :  Minimal checks for the tests run by ctest.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdio>
+
+namespace Test
+{
+	inline int Failures = 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CHECK:
+/// 	Reports the failed condition and continues, so one run shows every failure.
+///----------------------------------------------------------------------------------------------------
+#define CHECK(aCondition) \
+	do \
+	{ \
+		if (!(aCondition)) \
+		{ \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #aCondition); \
+			Test::Failures++; \
+		} \
+	} while (0)
+
+///----------------------------------------------------------------------------------------------------
+/// TEST_RESULT:
+/// 	Returns from main with the amount of failed checks.
+///----------------------------------------------------------------------------------------------------
+#define TEST_RESULT() \
+	do \
+	{ \
+		printf("%s (%d failed checks)\n", Test::Failures ? "FAILED" : "OK", Test::Failures); \
+		return Test::Failures == 0 ? 0 : 1; \
+	} while (0)
+
+#endif
@@ -0,0 +1,175 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureProcessorTest.cpp
+/// Description  :  Checks mip generation and BC3 encoding against reference results.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Services/Textures/TextureProcessor.h"
+
+#include "Test.h"
+
+namespace
+{
+	///----------------------------------------------------------------------------------------------------
+	/// MakeLevel:
+	/// 	Returns an uncompressed level filled with deterministic noise.
+	///----------------------------------------------------------------------------------------------------
+	TextureLevel MakeLevel(unsigned aWidth, unsigned aHeight, unsigned aSeed)
+	{
+		TextureLevel level{ aWidth, aHeight, aWidth * 4, std::vector<unsigned char>((size_t)aWidth * aHeight * 4) };
+
+		for (unsigned char& value : level.Data)
+		{
+			aSeed = aSeed * 1103515245 + 12345;
+			value = static_cast<unsigned char>(aSeed >> 16);
+		}
+
+		return level;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReferenceDownsample:
+	/// 	Scalar box filter with clamped edges, what the SIMD path has to match exactly.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<unsigned char> ReferenceDownsample(const TextureLevel& aLevel)
+	{
+		unsigned w = aLevel.Width / 2 ? aLevel.Width / 2 : 1;
+		unsigned h = aLevel.Height / 2 ? aLevel.Height / 2 : 1;
+		std::vector<unsigned char> out((size_t)w * h * 4);
+
+		auto at = [&](unsigned x, unsigned y, unsigned c)
+		{
+			x = x < aLevel.Width ? x : aLevel.Width - 1;
+			y = y < aLevel.Height ? y : aLevel.Height - 1;
+			return (unsigned)aLevel.Data[(size_t)y * aLevel.Pitch + x * 4 + c];
+		};
+
+		for (unsigned y = 0; y < h; y++)
+		{
+			for (unsigned x = 0; x < w; x++)
+			{
+				for (unsigned c = 0; c < 4; c++)
+				{
+					unsigned sum = at(x * 2, y * 2, c) + at(x * 2 + 1, y * 2, c) + at(x * 2, y * 2 + 1, c) + at(x * 2 + 1, y * 2 + 1, c);
+					out[((size_t)y * w + x) * 4 + c] = static_cast<unsigned char>((sum + 2) >> 2);
+				}
+			}
+		}
+
+		return out;
+	}
+}
+
+int main()
+{
+	/* mip counts */
+	CHECK(TextureProcessor::GetMipCount(1, 1) == 1);
+	CHECK(TextureProcessor::GetMipCount(256, 256) == 9);
+	CHECK(TextureProcessor::GetMipCount(256, 1) == 9);
+	CHECK(TextureProcessor::GetMipCount(300, 17) == 9);
+
+	/* the SIMD path, its remainder and the clamped edges match the scalar filter */
+	for (auto [w, h] : { std::pair{ 64u, 64u }, { 33u, 17u }, { 7u, 1u }, { 1u, 9u }, { 2u, 2u }, { 130u, 3u } })
+	{
+		TextureLevel level = MakeLevel(w, h, w * 31 + h);
+		std::vector<unsigned char> expected = ReferenceDownsample(level);
+		std::vector<unsigned char> actual(expected.size());
+
+		TextureProcessor::Downsample(level.Data.data(), w, h, actual.data());
+		CHECK(actual == expected);
+	}
+
+	/* chain dimensions, the limit and the base level copy */
+	{
+		TextureLevel level = MakeLevel(100, 20, 1);
+		std::vector<TextureLevel> mips = TextureProcessor::GenerateMips(level.Data.data(), 100, 20, 0);
+
+		CHECK(mips.size() == 7);
+		CHECK(mips[0].Data == level.Data);
+		CHECK(mips[1].Width == 50 && mips[1].Height == 10 && mips[1].Pitch == 200);
+		CHECK(mips[5].Width == 3 && mips[5].Height == 1);
+		CHECK(mips[6].Width == 1 && mips[6].Height == 1 && mips[6].Data.size() == 4);
+		CHECK(TextureProcessor::GenerateMips(level.Data.data(), 100, 20, 3).size() == 3);
+		CHECK(TextureProcessor::GenerateMips(nullptr, 100, 20, 0).empty());
+	}
+
+	/* a constant image averages to itself */
+	{
+		TextureLevel level{ 16, 16, 64, std::vector<unsigned char>(16 * 16 * 4) };
+
+		for (size_t i = 0; i < level.Data.size(); i++) { level.Data[i] = static_cast<unsigned char>(40 + (i % 4) * 50); }
+
+		std::vector<TextureLevel> mips = TextureProcessor::GenerateMips(level.Data.data(), 16, 16, 0);
+		CHECK(mips.back().Data == std::vector<unsigned char>({ 40, 90, 140, 190 }));
+	}
+
+	/* BC3 layout and round trips */
+	CHECK(TextureProcessor::CanCompress(64, 32));
+	CHECK(!TextureProcessor::CanCompress(64, 30));
+	CHECK(!TextureProcessor::CanCompress(0, 4));
+
+	{
+		/* blocks of one color on the RGB565 grid and one alpha are exact */
+		TextureLevel level{ 8, 8, 32, std::vector<unsigned char>(8 * 8 * 4) };
+
+		for (unsigned y = 0; y < 8; y++)
+		{
+			for (unsigned x = 0; x < 8; x++)
+			{
+				unsigned block = (y / 4) * 2 + x / 4;
+				unsigned char* px = &level.Data[(size_t)y * 32 + x * 4];
+				unsigned r = block * 9;
+				unsigned g = 63 - block * 13;
+				unsigned b = block & 1 ? 31 : 0;
+				px[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+				px[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+				px[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+				px[3] = static_cast<unsigned char>(60 * block);
+			}
+		}
+
+		TextureLevel bc3 = TextureProcessor::CompressBC3(level);
+		CHECK(bc3.Pitch == 32 && bc3.Data.size() == 64);
+
+		TextureLevel decoded = TextureProcessor::DecompressBC3(bc3);
+		CHECK(std::isinf(TextureProcessor::GetPSNR(level, decoded)));
+	}
+
+	{
+		/* smooth gradients, what UI textures mostly are, keep a usable quality */
+		TextureLevel level{ 64, 64, 256, std::vector<unsigned char>(64 * 64 * 4) };
+
+		for (unsigned y = 0; y < 64; y++)
+		{
+			for (unsigned x = 0; x < 64; x++)
+			{
+				unsigned char* px = &level.Data[(size_t)y * 256 + x * 4];
+				px[0] = static_cast<unsigned char>(x * 4);
+				px[1] = static_cast<unsigned char>(y * 4);
+				px[2] = static_cast<unsigned char>(255 - x * 2);
+				px[3] = static_cast<unsigned char>((x + y) * 2);
+			}
+		}
+
+		TextureLevel decoded = TextureProcessor::DecompressBC3(TextureProcessor::CompressBC3(level));
+		double psnr = TextureProcessor::GetPSNR(level, decoded);
+		printf("gradient PSNR %.2f dB\n", psnr);
+		CHECK(psnr > 38.0);
+	}
+
+	{
+		/* mip levels smaller than a block are padded by clamping */
+		TextureLevel level = MakeLevel(2, 1, 7);
+		TextureLevel bc3 = TextureProcessor::CompressBC3(level);
+		CHECK(bc3.Pitch == 16 && bc3.Data.size() == 16);
+		CHECK(TextureProcessor::DecompressBC3(bc3).Data.size() == 8);
+	}
+
+	TEST_RESULT();
+}
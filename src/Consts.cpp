@@ -43,6 +43,9 @@ const char* EV_MUMBLE_IDENTITY_UPDATED	= "EV_MUMBLE_IDENTITY_UPDATED";
 const char* EV_ADDON_LOADED				= "EV_ADDON_LOADED";
 const char* EV_ADDON_UNLOADED			= "EV_ADDON_UNLOADED";
 const char* EV_VOLATILE_ADDON_DISABLED	= "EV_VOLATILE_ADDON_DISABLED";
+const char* EV_RENDER_THROTTLED			= "EV_RENDER_THROTTLED";
+const char* EV_ARCDPS_COMBATEVENT_LOCAL_RAW	= "EV_ARCDPS_COMBATEVENT_LOCAL_RAW";
+const char* EV_ARCDPS_COMBATEVENT_SQUAD_RAW	= "EV_ARCDPS_COMBATEVENT_SQUAD_RAW";
 
 /* Loader */
 const UINT WM_ADDONDIRUPDATE			= WM_USER + 101;
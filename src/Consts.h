@@ -47,10 +47,15 @@ extern const char* EV_MUMBLE_IDENTITY_UPDATED;
 extern const char* EV_ADDON_LOADED;
 extern const char* EV_ADDON_UNLOADED;
 extern const char* EV_VOLATILE_ADDON_DISABLED;
+extern const char* EV_RENDER_THROTTLED;
+extern const char* EV_ARCDPS_COMBATEVENT_LOCAL_RAW;
+extern const char* EV_ARCDPS_COMBATEVENT_SQUAD_RAW;
 
 /* DataLink */
 constexpr const char* DL_MUMBLE_LINK = "DL_MUMBLE_LINK";
 constexpr const char* DL_NEXUS_LINK = "DL_NEXUS_LINK";
+constexpr const char* DL_MUMBLE_HISTORY = "DL_MUMBLE_HISTORY";
+constexpr const char* DL_COMBAT_STATS = "DL_COMBAT_STATS";
 
 /* Loader */
 extern const UINT WM_ADDONDIRUPDATE;
@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatch.h
+/// Description  :  Contains the ArcDPS combat event payloads and the CombatBatch data struct definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef COMBATBATCH_H
+#define COMBATBATCH_H
+
+#include <cstdint>
+
+///----------------------------------------------------------------------------------------------------
+/// ArcDPS Namespace
+///----------------------------------------------------------------------------------------------------
+namespace ArcDPS
+{
+	///----------------------------------------------------------------------------------------------------
+	/// CombatEvent data struct
+	/// 	Layout of the arcdps cbtevent.
+	///----------------------------------------------------------------------------------------------------
+	struct CombatEvent
+	{
+		uint64_t	Time;
+		uint64_t	SrcAgent;
+		uint64_t	DstAgent;
+		int32_t		Value;
+		int32_t		BuffDmg;
+		uint32_t	OverstackValue;
+		uint32_t	SkillID;
+		uint16_t	SrcInstID;
+		uint16_t	DstInstID;
+		uint16_t	SrcMasterInstID;
+		uint16_t	DstMasterInstID;
+		uint8_t		IFF;
+		uint8_t		Buff;
+		uint8_t		Result;
+		uint8_t		IsActivation;
+		uint8_t		IsBuffRemove;
+		uint8_t		IsNinety;
+		uint8_t		IsFifty;
+		uint8_t		IsMoving;
+		uint8_t		IsStateChange;
+		uint8_t		IsFlanking;
+		uint8_t		IsShields;
+		uint8_t		IsOffCycle;
+		uint8_t		Pad61;
+		uint8_t		Pad62;
+		uint8_t		Pad63;
+		uint8_t		Pad64;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// AgentShort data struct
+	/// 	Layout of the arcdps ag.
+	///----------------------------------------------------------------------------------------------------
+	struct AgentShort
+	{
+		char*		Name;
+		uintptr_t	ID;
+		uint32_t	Profession;
+		uint32_t	Specialization;
+		uint32_t	IsSelf;
+		uint16_t	Team;
+	};
+}
+
+///----------------------------------------------------------------------------------------------------
+/// EvCombatData data struct
+/// 	Payload of EV_ARCDPS_COMBATEVENT_LOCAL_RAW and EV_ARCDPS_COMBATEVENT_SQUAD_RAW.
+///----------------------------------------------------------------------------------------------------
+struct EvCombatData
+{
+	ArcDPS::CombatEvent*	Event;
+	ArcDPS::AgentShort*		Source;
+	ArcDPS::AgentShort*		Destination;
+	char*					SkillName;
+	uint64_t				ID;
+	uint64_t				Revision;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CombatBatch data struct
+/// 	Struct of arrays, element i of every array belongs to the same combat event, in arrival order.
+/// 	Only valid during the callback. Notifications without a combat event (agent tracking) are not batched.
+///----------------------------------------------------------------------------------------------------
+struct CombatBatch
+{
+	uint32_t				Count;
+
+	const uint64_t*			ID;
+	const uint64_t*			Time;
+	const uint64_t*			SrcAgent;
+	const uint64_t*			DstAgent;
+	const int32_t*			Value;
+	const int32_t*			BuffDmg;
+	const uint32_t*			OverstackValue;
+	const uint32_t*			SkillID;
+	const uint16_t*			SrcInstID;
+	const uint16_t*			DstInstID;
+	const uint16_t*			SrcMasterInstID;
+	const uint16_t*			DstMasterInstID;
+	const uint8_t*			IFF;
+	const uint8_t*			Buff;
+	const uint8_t*			Result;
+	const uint8_t*			IsActivation;
+	const uint8_t*			IsBuffRemove;
+	const uint8_t*			IsNinety;
+	const uint8_t*			IsFifty;
+	const uint8_t*			IsMoving;
+	const uint8_t*			IsStateChange;
+	const uint8_t*			IsFlanking;
+	const uint8_t*			IsShields;
+	const uint8_t*			IsOffCycle;
+};
+
+#endif
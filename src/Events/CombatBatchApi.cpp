@@ -0,0 +1,216 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatchApi.cpp
+/// Description  :  Delivers ArcDPS combat events in batches instead of one event at a time.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "CombatBatchApi.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Consts.h"
+#include "Shared.h"
+
+#include "Loader/ArcDPS.h"
+
+namespace Events
+{
+	void ADDONAPI_SubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+	{
+		CombatBatchApi->Subscribe(aIdentifier, aConsumeBatchCallback);
+	}
+
+	void ADDONAPI_UnsubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+	{
+		CombatBatchApi->Unsubscribe(aIdentifier, aConsumeBatchCallback);
+	}
+}
+
+CCombatBatchApi::~CCombatBatchApi()
+{
+	for (Stream& stream : this->Streams)
+	{
+		delete stream.Pending;
+		delete stream.Delivering;
+	}
+}
+
+void CCombatBatchApi::Subscribe(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+{
+	ECombatStream type;
+
+	if (!aConsumeBatchCallback || !GetStream(aIdentifier, &type))
+	{
+		Logger->Warning(CH_EVENTS, "Combat batches can only be subscribed to for %s and %s.", EV_ARCDPS_COMBATEVENT_LOCAL_RAW, EV_ARCDPS_COMBATEVENT_SQUAD_RAW);
+		return;
+	}
+
+	Stream& stream = this->Streams[static_cast<int>(type)];
+
+	{
+		const std::lock_guard<std::mutex> lock(stream.Mutex);
+
+		if (!stream.Pending)
+		{
+			stream.Pending = new CCombatBatchBuffer();
+			stream.Delivering = new CCombatBatchBuffer();
+		}
+
+		stream.Subscribers.push_back(aConsumeBatchCallback);
+	}
+
+	/* the bridge raises the combat events, same as for per-event subscribers */
+	if (!ArcDPS::IsLoaded)
+	{
+		ArcDPS::Detect();
+	}
+}
+
+void CCombatBatchApi::Unsubscribe(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback)
+{
+	ECombatStream type;
+
+	if (!GetStream(aIdentifier, &type)) { return; }
+
+	Stream& stream = this->Streams[static_cast<int>(type)];
+
+	{
+		const std::lock_guard<std::mutex> lock(stream.Mutex);
+
+		stream.Subscribers.erase(std::remove(stream.Subscribers.begin(), stream.Subscribers.end(), aConsumeBatchCallback), stream.Subscribers.end());
+	}
+
+	this->WaitForDelivery(stream);
+}
+
+void CCombatBatchApi::Push(ECombatStream aStream, const EvCombatData* aCombatData)
+{
+	/* notifications without a combat event only carry agent information */
+	if (!aCombatData || !aCombatData->Event) { return; }
+
+	Stream& stream = this->Streams[static_cast<int>(aStream)];
+
+	bool isAppended = false;
+
+	for (;;)
+	{
+		bool isFull;
+
+		{
+			const std::lock_guard<std::mutex> lock(stream.Mutex);
+
+			if (!stream.Pending) { return; }
+
+			if (!isAppended)
+			{
+				isAppended = stream.Pending->Append(aCombatData);
+			}
+
+			isFull = stream.Pending->IsFull();
+		}
+
+		if (!isFull) { return; }
+
+		/* full, deliver now instead of waiting for the frame */
+		this->Deliver(stream);
+
+		if (isAppended) { return; }
+	}
+}
+
+void CCombatBatchApi::Flush()
+{
+	for (Stream& stream : this->Streams)
+	{
+		this->Deliver(stream);
+	}
+}
+
+int CCombatBatchApi::Verify(void* aStartAddress, void* aEndAddress)
+{
+	int refCounter = 0;
+
+	for (Stream& stream : this->Streams)
+	{
+		int streamRefs = 0;
+
+		{
+			const std::lock_guard<std::mutex> lock(stream.Mutex);
+
+			auto it = std::remove_if(stream.Subscribers.begin(), stream.Subscribers.end(), [aStartAddress, aEndAddress](EVENT_CONSUME_COMBATBATCH aCallback)
+			{
+				return aCallback >= aStartAddress && aCallback <= aEndAddress;
+			});
+
+			streamRefs = static_cast<int>(std::distance(it, stream.Subscribers.end()));
+			stream.Subscribers.erase(it, stream.Subscribers.end());
+		}
+
+		if (streamRefs > 0)
+		{
+			this->WaitForDelivery(stream);
+		}
+
+		refCounter += streamRefs;
+	}
+
+	return refCounter;
+}
+
+bool CCombatBatchApi::GetStream(const char* aIdentifier, ECombatStream* aOutStream)
+{
+	if (!aIdentifier) { return false; }
+
+	if (strcmp(aIdentifier, EV_ARCDPS_COMBATEVENT_LOCAL_RAW) == 0)
+	{
+		*aOutStream = ECombatStream::Local;
+		return true;
+	}
+
+	if (strcmp(aIdentifier, EV_ARCDPS_COMBATEVENT_SQUAD_RAW) == 0)
+	{
+		*aOutStream = ECombatStream::Squad;
+		return true;
+	}
+
+	return false;
+}
+
+void CCombatBatchApi::Deliver(Stream& aStream)
+{
+	const std::lock_guard<std::mutex> deliveryLock(aStream.DeliveryMutex);
+
+	{
+		const std::lock_guard<std::mutex> lock(aStream.Mutex);
+
+		if (!aStream.Pending || aStream.Pending->GetBatch()->Count == 0) { return; }
+
+		/* the producer keeps appending to the other buffer while this one is delivered */
+		std::swap(aStream.Pending, aStream.Delivering);
+		aStream.DeliverySubscribers = aStream.Subscribers;
+	}
+
+	aStream.DeliveryThread = std::this_thread::get_id();
+
+	for (EVENT_CONSUME_COMBATBATCH callback : aStream.DeliverySubscribers)
+	{
+		long long start = CCallbackWatchdog::Now();
+		callback(aStream.Delivering->GetBatch());
+		CallbackWatchdog->Record(ECallbackType::Event, (void*)callback, CCallbackWatchdog::Now() - start);
+	}
+
+	aStream.DeliveryThread = std::thread::id();
+
+	aStream.Delivering->Clear();
+}
+
+void CCombatBatchApi::WaitForDelivery(Stream& aStream)
+{
+	/* the delivery would wait for itself */
+	if (aStream.DeliveryThread.load() == std::this_thread::get_id()) { return; }
+
+	const std::lock_guard<std::mutex> deliveryLock(aStream.DeliveryMutex);
+}
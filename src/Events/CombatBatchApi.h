@@ -0,0 +1,137 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatchApi.h
+/// Description  :  Delivers ArcDPS combat events in batches instead of one event at a time.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef COMBATBATCHAPI_H
+#define COMBATBATCHAPI_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CombatBatch.h"
+#include "CombatBatchBuffer.h"
+#include "FuncDefs.h"
+
+///----------------------------------------------------------------------------------------------------
+/// ECombatStream Enum
+///----------------------------------------------------------------------------------------------------
+enum class ECombatStream
+{
+	Local,
+	Squad,
+	COUNT
+};
+
+///----------------------------------------------------------------------------------------------------
+/// Events Namespace
+///----------------------------------------------------------------------------------------------------
+namespace Events
+{
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_SubscribeCombatBatch:
+	/// 	Addon API wrapper function for subscribing to combat event batches.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_SubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_UnsubscribeCombatBatch:
+	/// 	Addon API wrapper function for unsubscribing from combat event batches.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_UnsubscribeCombatBatch(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CCombatBatchApi Class
+/// 	Collects the combat events of EV_ARCDPS_COMBATEVENT_LOCAL_RAW and EV_ARCDPS_COMBATEVENT_SQUAD_RAW.
+/// 	Batches are delivered once per frame on the render thread, or on the ArcDPS thread if one fills up.
+///----------------------------------------------------------------------------------------------------
+class CCombatBatchApi
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CCombatBatchApi() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CCombatBatchApi();
+
+	CCombatBatchApi(const CCombatBatchApi&) = delete;
+	CCombatBatchApi& operator=(const CCombatBatchApi&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Subscribe:
+	/// 	Subscribes the callback to batches of the provided combat event.
+	///----------------------------------------------------------------------------------------------------
+	void Subscribe(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Unsubscribe:
+	/// 	Unsubscribes the callback. It is not called anymore once this returns, unless called from within it.
+	///----------------------------------------------------------------------------------------------------
+	void Unsubscribe(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Push:
+	/// 	Appends the combat event to the pending batch of the stream. Called by CEventApi::Raise.
+	///----------------------------------------------------------------------------------------------------
+	void Push(ECombatStream aStream, const EvCombatData* aCombatData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Flush:
+	/// 	Delivers the pending batches of all streams.
+	///----------------------------------------------------------------------------------------------------
+	void Flush();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Verify:
+	/// 	Removes all callbacks that are within the provided address space.
+	/// 	Returns the amount of removed callbacks.
+	///----------------------------------------------------------------------------------------------------
+	int Verify(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStream:
+	/// 	Returns false if the identifier is not a batched combat event.
+	///----------------------------------------------------------------------------------------------------
+	static bool GetStream(const char* aIdentifier, ECombatStream* aOutStream);
+
+private:
+	///----------------------------------------------------------------------------------------------------
+	/// Stream data struct
+	///----------------------------------------------------------------------------------------------------
+	struct Stream
+	{
+		std::mutex								Mutex;			/* pending buffer and subscribers, never held while delivering */
+		std::mutex								DeliveryMutex;	/* one delivery at a time */
+		std::atomic<std::thread::id>			DeliveryThread{ std::thread::id() };
+
+		CCombatBatchBuffer*						Pending			= nullptr;	/* only streams with subscribers cost memory */
+		CCombatBatchBuffer*						Delivering		= nullptr;
+		std::vector<EVENT_CONSUME_COMBATBATCH>	Subscribers;
+		std::vector<EVENT_CONSUME_COMBATBATCH>	DeliverySubscribers;
+	};
+
+	Stream										Streams[static_cast<int>(ECombatStream::COUNT)];
+
+	///----------------------------------------------------------------------------------------------------
+	/// Deliver:
+	/// 	Swaps the pending buffer of the stream and calls every subscriber with it.
+	///----------------------------------------------------------------------------------------------------
+	void Deliver(Stream& aStream);
+
+	///----------------------------------------------------------------------------------------------------
+	/// WaitForDelivery:
+	/// 	Waits until a running delivery has ended. Returns immediately if called from within it.
+	///----------------------------------------------------------------------------------------------------
+	void WaitForDelivery(Stream& aStream);
+};
+
+#endif
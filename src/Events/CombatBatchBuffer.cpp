@@ -0,0 +1,127 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatchBuffer.cpp
+/// Description  :  Contains the columns of a CombatBatch.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "CombatBatchBuffer.h"
+
+namespace
+{
+	/* columns are a power of two apart otherwise, element i of every column would compete for the same cache set */
+	constexpr const uint32_t CB_COLUMN_PADDING	= 64;
+	constexpr const uint32_t CB_COLUMNS			= 24;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Carve:
+	/// 	Returns the next column of the allocation. Columns are carved from the widest to the narrowest type.
+	///----------------------------------------------------------------------------------------------------
+	template <typename T>
+	const T* Carve(unsigned char*& aCursor)
+	{
+		const T* column = reinterpret_cast<const T*>(aCursor);
+		aCursor += sizeof(T) * CB_CAPACITY + CB_COLUMN_PADDING;
+		return column;
+	}
+
+	template <typename T>
+	void Set(const T* aColumn, uint32_t aIndex, T aValue)
+	{
+		/* the columns are owned by the buffer, they are only const towards the subscribers */
+		const_cast<T*>(aColumn)[aIndex] = aValue;
+	}
+}
+
+CCombatBatchBuffer::CCombatBatchBuffer()
+{
+	this->Memory = new unsigned char[CB_CAPACITY * (sizeof(uint64_t) * 4 + sizeof(uint32_t) * 4 + sizeof(uint16_t) * 4 + sizeof(uint8_t) * 12) + CB_COLUMN_PADDING * CB_COLUMNS];
+
+	unsigned char* cursor = this->Memory;
+
+	CombatBatch& batch = this->Batch;
+	batch.Count				= 0;
+	batch.ID				= Carve<uint64_t>(cursor);
+	batch.Time				= Carve<uint64_t>(cursor);
+	batch.SrcAgent			= Carve<uint64_t>(cursor);
+	batch.DstAgent			= Carve<uint64_t>(cursor);
+	batch.Value				= Carve<int32_t>(cursor);
+	batch.BuffDmg			= Carve<int32_t>(cursor);
+	batch.OverstackValue	= Carve<uint32_t>(cursor);
+	batch.SkillID			= Carve<uint32_t>(cursor);
+	batch.SrcInstID			= Carve<uint16_t>(cursor);
+	batch.DstInstID			= Carve<uint16_t>(cursor);
+	batch.SrcMasterInstID	= Carve<uint16_t>(cursor);
+	batch.DstMasterInstID	= Carve<uint16_t>(cursor);
+	batch.IFF				= Carve<uint8_t>(cursor);
+	batch.Buff				= Carve<uint8_t>(cursor);
+	batch.Result			= Carve<uint8_t>(cursor);
+	batch.IsActivation		= Carve<uint8_t>(cursor);
+	batch.IsBuffRemove		= Carve<uint8_t>(cursor);
+	batch.IsNinety			= Carve<uint8_t>(cursor);
+	batch.IsFifty			= Carve<uint8_t>(cursor);
+	batch.IsMoving			= Carve<uint8_t>(cursor);
+	batch.IsStateChange		= Carve<uint8_t>(cursor);
+	batch.IsFlanking		= Carve<uint8_t>(cursor);
+	batch.IsShields			= Carve<uint8_t>(cursor);
+	batch.IsOffCycle		= Carve<uint8_t>(cursor);
+}
+
+CCombatBatchBuffer::~CCombatBatchBuffer()
+{
+	delete[] this->Memory;
+}
+
+bool CCombatBatchBuffer::Append(const EvCombatData* aCombatData)
+{
+	if (this->IsFull()) { return false; }
+
+	CombatBatch& batch = this->Batch;
+	const ArcDPS::CombatEvent* ev = aCombatData->Event;
+	uint32_t i = batch.Count;
+
+	Set(batch.ID, i, aCombatData->ID);
+	Set(batch.Time, i, ev->Time);
+	Set(batch.SrcAgent, i, ev->SrcAgent);
+	Set(batch.DstAgent, i, ev->DstAgent);
+	Set(batch.Value, i, ev->Value);
+	Set(batch.BuffDmg, i, ev->BuffDmg);
+	Set(batch.OverstackValue, i, ev->OverstackValue);
+	Set(batch.SkillID, i, ev->SkillID);
+	Set(batch.SrcInstID, i, ev->SrcInstID);
+	Set(batch.DstInstID, i, ev->DstInstID);
+	Set(batch.SrcMasterInstID, i, ev->SrcMasterInstID);
+	Set(batch.DstMasterInstID, i, ev->DstMasterInstID);
+	Set(batch.IFF, i, ev->IFF);
+	Set(batch.Buff, i, ev->Buff);
+	Set(batch.Result, i, ev->Result);
+	Set(batch.IsActivation, i, ev->IsActivation);
+	Set(batch.IsBuffRemove, i, ev->IsBuffRemove);
+	Set(batch.IsNinety, i, ev->IsNinety);
+	Set(batch.IsFifty, i, ev->IsFifty);
+	Set(batch.IsMoving, i, ev->IsMoving);
+	Set(batch.IsStateChange, i, ev->IsStateChange);
+	Set(batch.IsFlanking, i, ev->IsFlanking);
+	Set(batch.IsShields, i, ev->IsShields);
+	Set(batch.IsOffCycle, i, ev->IsOffCycle);
+
+	batch.Count = i + 1;
+
+	return true;
+}
+
+void CCombatBatchBuffer::Clear()
+{
+	this->Batch.Count = 0;
+}
+
+bool CCombatBatchBuffer::IsFull() const
+{
+	return this->Batch.Count >= CB_CAPACITY;
+}
+
+const CombatBatch* CCombatBatchBuffer::GetBatch() const
+{
+	return &this->Batch;
+}
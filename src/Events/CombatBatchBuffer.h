@@ -0,0 +1,64 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatBatchBuffer.h
+/// Description  :  Contains the columns of a CombatBatch.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef COMBATBATCHBUFFER_H
+#define COMBATBATCHBUFFER_H
+
+#include "CombatBatch.h"
+
+constexpr const uint32_t CB_CAPACITY = 4096; /* events per batch, a full batch is delivered before the frame ends */
+
+///----------------------------------------------------------------------------------------------------
+/// CCombatBatchBuffer Class
+/// 	The columns of the batch point into one allocation of CB_CAPACITY events. Not thread-safe.
+///----------------------------------------------------------------------------------------------------
+class CCombatBatchBuffer
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CCombatBatchBuffer();
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CCombatBatchBuffer();
+
+	CCombatBatchBuffer(const CCombatBatchBuffer&) = delete;
+	CCombatBatchBuffer& operator=(const CCombatBatchBuffer&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Append:
+	/// 	Appends the combat event to the columns. Returns false if the buffer is full.
+	///----------------------------------------------------------------------------------------------------
+	bool Append(const EvCombatData* aCombatData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Clear:
+	/// 	Removes all events.
+	///----------------------------------------------------------------------------------------------------
+	void Clear();
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsFull:
+	/// 	Returns true if no more events can be appended.
+	///----------------------------------------------------------------------------------------------------
+	bool IsFull() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetBatch:
+	/// 	Returns the batch of the appended events.
+	///----------------------------------------------------------------------------------------------------
+	const CombatBatch* GetBatch() const;
+
+private:
+	unsigned char*	Memory;
+	CombatBatch		Batch;
+};
+
+#endif
@@ -0,0 +1,23 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EEventExecution.h
+/// Description  :  EEventExecution enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef EVENTEXECUTION_H
+#define EVENTEXECUTION_H
+
+///----------------------------------------------------------------------------------------------------
+/// EEventExecution Enum
+/// 	Only applies to queued raises. Raise calls every subscriber on the raising thread,
+/// 	its payload is only valid during the call.
+///----------------------------------------------------------------------------------------------------
+enum class EEventExecution
+{
+	Any,			/* run on the event thread pool */
+	RenderThread	/* run on the render thread at the next frame, ImGui may be used */
+};
+
+#endif
@@ -0,0 +1,369 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventExecutor.cpp
+/// Description  :  Delivers queued events on a worker pool or the render thread.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "EventExecutor.h"
+
+#include <algorithm>
+
+#include "Shared.h"
+
+#include "EventMetrics.h"
+
+CEventExecutor::~CEventExecutor()
+{
+	this->Shutdown();
+}
+
+void CEventExecutor::Enqueue(const std::string& aIdentifier, const void* aEventData, size_t aSize, const std::vector<EventSubscriber>& aSubscribers)
+{
+	if (aSubscribers.empty()) { return; }
+
+	long long timestamp = CCallbackWatchdog::Now();
+	size_t readied = 0;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		if (!this->IsRunning) { return; }
+
+		PayloadPool& pool = this->Pools[aIdentifier];
+
+		EventPayload* payload;
+
+		if (pool.Free.empty())
+		{
+			pool.Identifier = aIdentifier;
+			payload = new EventPayload{ &pool };
+		}
+		else
+		{
+			payload = pool.Free.back();
+			pool.Free.pop_back();
+		}
+
+		/* a pooled payload keeps its capacity, so this only allocates if the event grew */
+		const unsigned char* data = (const unsigned char*)aEventData;
+		payload->Data.assign(data, aEventData ? data + aSize : data);
+		payload->Refs = static_cast<unsigned>(aSubscribers.size());
+		payload->Timestamp = timestamp;
+
+		this->Stats.Raised++;
+
+		for (const EventSubscriber& sub : aSubscribers)
+		{
+			if (sub.Execution == EEventExecution::RenderThread)
+			{
+				this->RenderQueue.push_back(Task{ sub.Callback, payload, sub.Counters });
+				continue;
+			}
+
+			Strand& strand = this->Strands[sub.Callback];
+			strand.Tasks.push_back(Task{ sub.Callback, payload, sub.Counters });
+
+			/* an active strand is re-queued by the worker running it */
+			if (strand.IsActive) { continue; }
+
+			strand.IsActive = true;
+			this->Ready.push_back(sub.Callback);
+			readied++;
+		}
+
+		if (readied > 0 && this->Workers.empty())
+		{
+			for (size_t i = 0; i < EV_EXECUTOR_WORKERS; i++)
+			{
+				this->Workers.emplace_back(&CEventExecutor::ProcessQueues, this);
+			}
+		}
+	}
+
+	/* busy workers pick up the strands without being woken */
+	if (readied == 1)
+	{
+		this->ConVar.notify_one();
+	}
+	else if (readied > 1)
+	{
+		this->ConVar.notify_all();
+	}
+}
+
+void CEventExecutor::ProcessRenderQueue()
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	if (this->RenderQueue.empty()) { return; }
+
+	/* swapped out, so subscribers raising again from the render thread are called on the next frame */
+	this->RenderTasks.swap(this->RenderQueue);
+
+	for (size_t i = 0; i < this->RenderTasks.size(); i++)
+	{
+		Task task = this->RenderTasks[i];
+
+		/* purged while an earlier one ran */
+		if (!task.Callback) { continue; }
+
+		this->RenderTasks[i].Callback = nullptr;
+		this->Execute(lock, task);
+	}
+
+	this->RenderTasks.clear();
+}
+
+int CEventExecutor::Purge(const std::string& aIdentifier, EVENT_CONSUME aConsumeEventCallback)
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	auto it = this->Pools.find(aIdentifier);
+
+	if (it == this->Pools.end()) { return 0; }
+
+	const PayloadPool* pool = &it->second;
+
+	size_t purged = this->Drop([pool, aConsumeEventCallback](const Task& aTask)
+	{
+		return aTask.Callback == aConsumeEventCallback && aTask.Payload->Pool == pool;
+	});
+
+	this->WaitForRuns(lock, [aConsumeEventCallback](EVENT_CONSUME aCallback)
+	{
+		return aCallback == aConsumeEventCallback;
+	});
+
+	return static_cast<int>(purged);
+}
+
+int CEventExecutor::Purge(void* aStartAddress, void* aEndAddress)
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	auto inRange = [aStartAddress, aEndAddress](EVENT_CONSUME aCallback)
+	{
+		return aCallback >= aStartAddress && aCallback <= aEndAddress;
+	};
+
+	size_t purged = this->Drop([inRange](const Task& aTask) { return inRange(aTask.Callback); });
+
+	this->WaitForRuns(lock, inRange);
+
+	return static_cast<int>(purged);
+}
+
+void CEventExecutor::Shutdown()
+{
+	std::vector<std::thread> workers;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		if (!this->IsRunning) { return; }
+
+		this->IsRunning = false;
+		workers.swap(this->Workers);
+	}
+
+	this->ConVar.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->Drop([](const Task&) { return true; });
+
+	for (auto& [identifier, pool] : this->Pools)
+	{
+		for (EventPayload* payload : pool.Free)
+		{
+			delete payload;
+		}
+
+		pool.Free.clear();
+	}
+}
+
+EventExecutorStats CEventExecutor::GetStats() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	EventExecutorStats stats = this->Stats;
+	stats.Pending = this->RenderQueue.size();
+
+	for (const auto& [callback, strand] : this->Strands)
+	{
+		stats.Pending += strand.Tasks.size();
+	}
+
+	return stats;
+}
+
+void CEventExecutor::ProcessQueues()
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	while (this->IsRunning)
+	{
+		if (this->Ready.empty())
+		{
+			this->ConVar.wait(lock, [this] { return !this->IsRunning || !this->Ready.empty(); });
+			continue;
+		}
+
+		EVENT_CONSUME callback = this->Ready.front();
+		this->Ready.pop_front();
+
+		Strand& strand = this->Strands[callback];
+
+		/* tasks could have been purged */
+		if (strand.Tasks.empty())
+		{
+			this->Strands.erase(callback);
+			continue;
+		}
+
+		/* the strand stays active while running, so no other worker calls this subscriber */
+		Task task = strand.Tasks.front();
+		strand.Tasks.pop_front();
+
+		this->Execute(lock, task);
+
+		/* the map might have been rehashed, look the strand up again */
+		auto it = this->Strands.find(callback);
+
+		if (it->second.Tasks.empty())
+		{
+			this->Strands.erase(it);
+		}
+		else
+		{
+			this->Ready.push_back(callback);
+		}
+	}
+}
+
+void CEventExecutor::Execute(std::unique_lock<std::mutex>& aLock, const Task& aTask)
+{
+	long long start = CCallbackWatchdog::Now();
+	long long latency = start - aTask.Payload->Timestamp;
+
+	this->Stats.Executed++;
+	this->Stats.LastLatency = latency;
+	this->Stats.MaxLatency = (std::max)(this->Stats.MaxLatency, latency);
+	this->Stats.TotalLatency += latency;
+
+	this->Runs.push_back(Running{ std::this_thread::get_id(), aTask.Callback });
+
+	/* the payload stays referenced until the call returned, a purge cannot release it */
+	void* data = aTask.Payload->Data.empty() ? nullptr : aTask.Payload->Data.data();
+
+	aLock.unlock();
+	aTask.Callback(data);
+	long long time = CCallbackWatchdog::Now() - start;
+	CallbackWatchdog->Record(ECallbackType::Event, (void*)aTask.Callback, time);
+	aTask.Counters->Record(time);
+	aLock.lock();
+
+	auto it = std::find_if(this->Runs.begin(), this->Runs.end(), [](const Running& aRun)
+	{
+		return aRun.Thread == std::this_thread::get_id();
+	});
+
+	if (it != this->Runs.end())
+	{
+		this->Runs.erase(it);
+	}
+
+	this->Release(aTask.Payload);
+
+	if (this->PurgeWaiters > 0)
+	{
+		this->Idle.notify_all();
+	}
+}
+
+void CEventExecutor::Release(EventPayload* aPayload)
+{
+	if (--aPayload->Refs > 0) { return; }
+
+	PayloadPool* pool = aPayload->Pool;
+
+	if (pool->Free.size() < EV_PAYLOAD_POOL_SIZE && aPayload->Data.capacity() <= EV_PAYLOAD_POOL_BYTES)
+	{
+		pool->Free.push_back(aPayload);
+	}
+	else
+	{
+		delete aPayload;
+	}
+}
+
+template<typename Pred>
+size_t CEventExecutor::Drop(Pred aPredicate)
+{
+	size_t purged = 0;
+
+	/* compacted in one pass, erasing one at a time is quadratic in a long backlog */
+	auto drop = [this, &aPredicate, &purged](const Task& aTask)
+	{
+		if (!aPredicate(aTask)) { return false; }
+
+		this->Release(aTask.Payload);
+		purged++;
+		return true;
+	};
+
+	for (auto& [callback, strand] : this->Strands)
+	{
+		strand.Tasks.erase(std::remove_if(strand.Tasks.begin(), strand.Tasks.end(), drop), strand.Tasks.end());
+	}
+
+	this->RenderQueue.erase(std::remove_if(this->RenderQueue.begin(), this->RenderQueue.end(), drop), this->RenderQueue.end());
+
+	/* the rest of the frame that is being processed */
+	for (Task& task : this->RenderTasks)
+	{
+		if (task.Callback && aPredicate(task))
+		{
+			this->Release(task.Payload);
+			task.Callback = nullptr;
+			purged++;
+		}
+	}
+
+	this->Stats.Purged += purged;
+
+	return purged;
+}
+
+template<typename Pred>
+void CEventExecutor::WaitForRuns(std::unique_lock<std::mutex>& aLock, Pred aPredicate)
+{
+	auto isRunning = [this, &aPredicate]()
+	{
+		for (const Running& run : this->Runs)
+		{
+			/* the call would wait for itself */
+			if (run.Thread != std::this_thread::get_id() && aPredicate(run.Callback))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+	this->PurgeWaiters++;
+	this->Idle.wait(aLock, [&isRunning] { return !isRunning(); });
+	this->PurgeWaiters--;
+}
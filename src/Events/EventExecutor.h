@@ -0,0 +1,203 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventExecutor.h
+/// Description  :  Delivers queued events on a worker pool or the render thread.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef EVENTEXECUTOR_H
+#define EVENTEXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "EventSubscriber.h"
+
+constexpr const size_t EV_EXECUTOR_WORKERS		= 2;
+constexpr const size_t EV_PAYLOAD_POOL_SIZE		= 16;		/* free payloads kept per event */
+constexpr const size_t EV_PAYLOAD_POOL_BYTES	= 65536;	/* larger payloads are freed instead of pooled */
+
+///----------------------------------------------------------------------------------------------------
+/// EventExecutorStats Struct
+/// 	Latencies are measured from raising until the subscriber is called, in nanoseconds.
+///----------------------------------------------------------------------------------------------------
+struct EventExecutorStats
+{
+	unsigned long long		Raised;
+	unsigned long long		Executed;
+	unsigned long long		Purged;
+	size_t					Pending;
+	long long				LastLatency;
+	long long				MaxLatency;
+	long long				TotalLatency;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CEventExecutor Class
+/// 	Each subscriber has a serial queue: it receives queued events in the order they were raised
+/// 	and is never called concurrently with itself. Different subscribers run in parallel on the workers.
+/// 	The payload of a raise is copied once into a pooled buffer of its event and shared by all subscribers.
+///----------------------------------------------------------------------------------------------------
+class CEventExecutor
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CEventExecutor() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CEventExecutor();
+
+	CEventExecutor(const CEventExecutor&) = delete;
+	CEventExecutor& operator=(const CEventExecutor&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Enqueue:
+	/// 	Copies the payload and queues a call of every subscriber on its thread.
+	/// 	The workers are started with the first raise.
+	///----------------------------------------------------------------------------------------------------
+	void Enqueue(const std::string& aIdentifier, const void* aEventData, size_t aSize, const std::vector<EventSubscriber>& aSubscribers);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessRenderQueue:
+	/// 	Calls the subscribers queued for the render thread. Called once per frame from the render thread.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessRenderQueue();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Purge:
+	/// 	Drops all pending calls of the subscriber for the event.
+	/// 	Waits for a running call of it, unless called from within that call.
+	///----------------------------------------------------------------------------------------------------
+	int Purge(const std::string& aIdentifier, EVENT_CONSUME aConsumeEventCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Purge:
+	/// 	Drops all pending calls whose subscriber is within the provided address space.
+	/// 	Waits for running calls into it, unless called from within one of them.
+	/// 	Returns the amount of dropped calls.
+	///----------------------------------------------------------------------------------------------------
+	int Purge(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Shutdown:
+	/// 	Stops the workers, pending calls are dropped. Later raises are ignored.
+	///----------------------------------------------------------------------------------------------------
+	void Shutdown();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStats:
+	/// 	Returns the execution statistics.
+	///----------------------------------------------------------------------------------------------------
+	EventExecutorStats GetStats() const;
+
+private:
+	struct PayloadPool;
+
+	///----------------------------------------------------------------------------------------------------
+	/// EventPayload Struct
+	/// 	Shared by the calls of one raise, returned to its pool after the last one.
+	///----------------------------------------------------------------------------------------------------
+	struct EventPayload
+	{
+		PayloadPool*				Pool;
+		std::vector<unsigned char>	Data;
+		unsigned					Refs;
+		long long					Timestamp;	/* time of raising */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// PayloadPool Struct
+	///----------------------------------------------------------------------------------------------------
+	struct PayloadPool
+	{
+		std::string					Identifier;
+		std::vector<EventPayload*>	Free;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Task Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Task
+	{
+		EVENT_CONSUME				Callback;
+		EventPayload*				Payload;
+		CSubscriberCounters*		Counters;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Strand Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Strand
+	{
+		std::deque<Task>			Tasks;
+		bool						IsActive;	/* queued in Ready or currently running */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Running Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Running
+	{
+		std::thread::id				Thread;
+		EVENT_CONSUME				Callback;
+	};
+
+	mutable std::mutex								Mutex;
+	std::condition_variable							ConVar;
+	std::condition_variable							Idle;			/* signaled after a call, while a purge waits */
+	bool											IsRunning		= true;
+	int												PurgeWaiters	= 0;
+	std::vector<std::thread>						Workers;
+
+	std::unordered_map<std::string, PayloadPool>	Pools;
+	std::unordered_map<EVENT_CONSUME, Strand>		Strands;
+	std::deque<EVENT_CONSUME>						Ready;
+	std::vector<Task>								RenderQueue;
+	std::vector<Task>								RenderTasks;	/* the frame being processed */
+	std::vector<Running>							Runs;
+
+	EventExecutorStats								Stats{};
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessQueues:
+	/// 	Worker loop.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessQueues();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Execute:
+	/// 	Calls the subscriber of a task and releases its payload. Called with the lock held, unlocks for the call.
+	///----------------------------------------------------------------------------------------------------
+	void Execute(std::unique_lock<std::mutex>& aLock, const Task& aTask);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Release:
+	/// 	Returns the payload to its pool after the last call.
+	///----------------------------------------------------------------------------------------------------
+	void Release(EventPayload* aPayload);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Drop:
+	/// 	Removes the matching pending calls. Returns the amount of dropped calls.
+	///----------------------------------------------------------------------------------------------------
+	template<typename Pred>
+	size_t Drop(Pred aPredicate);
+
+	///----------------------------------------------------------------------------------------------------
+	/// WaitForRuns:
+	/// 	Waits until no matching call is running on another thread.
+	///----------------------------------------------------------------------------------------------------
+	template<typename Pred>
+	void WaitForRuns(std::unique_lock<std::mutex>& aLock, Pred aPredicate);
+};
+
+#endif
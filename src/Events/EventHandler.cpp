@@ -18,6 +18,9 @@
 #include "Loader/Loader.h"
 #include "Loader/ArcDPS.h"
 
+/* raises running on this thread, only the outermost one holds the delivery lock */
+static thread_local int DeliveryDepth = 0;
+
 namespace Events
 {
 
@@ -50,44 +53,90 @@ namespace Events
 	{
 		EventApi->Raise(aSignature, aIdentifier, nullptr);
 	}
+
+	void ADDONAPI_RaiseEventQueued(const char* aIdentifier, const void* aEventData, size_t aSize)
+	{
+		EventApi->RaiseQueued(aIdentifier, aEventData, aSize);
+	}
+
+	void ADDONAPI_SetExecution(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, EEventExecution aExecution)
+	{
+		EventApi->SetExecution(aIdentifier, aConsumeEventCallback, aExecution);
+	}
 }
 
 void CEventApi::Raise(const char* aIdentifier, void* aEventData)
 {
-	this->Registry[aIdentifier].AmountRaises++;
+	ECombatStream combatStream;
 
-	//auto start_time = std::chrono::high_resolution_clock::now();
+	/* batched directly instead of through an internal subscriber, batches do not need the event lock */
+	if (CCombatBatchApi::GetStream(aIdentifier, &combatStream))
+	{
+		CombatRecorder->RecordCombat(combatStream, (const EvCombatData*)aEventData);
 
-	std::string str = aIdentifier;
+		/* the squad notifications are not batched, the stats need them to know the agents */
+		if (CombatStatsEngine && combatStream == ECombatStream::Squad)
+		{
+			CombatStatsEngine->Track((const EvCombatData*)aEventData);
+		}
+
+		CombatBatchApi->Push(combatStream, (const EvCombatData*)aEventData);
+	}
+
+	std::shared_lock<std::shared_mutex> deliveryLock = this->BeginDelivery();
+	std::vector<EventSubscriber> subscribers;
+	CEventCounters* counters;
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
-	
-	for (EventSubscriber sub : this->Registry[str].Subscribers)
 	{
-		sub.Callback(aEventData);
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		EventData& ev = this->Registry[aIdentifier];
+
+		if (!ev.Counters)
+		{
+			ev.Counters = this->Metrics.GetEvent(aIdentifier);
+		}
+
+		counters = ev.Counters;
+		subscribers = ev.Subscribers;
 	}
 
-	//auto end_time = std::chrono::high_resolution_clock::now();
-	//auto time = end_time - start_time;
-	//Logger->Debug(CH_EVENTS, u8"Executed event (%s) in %uµs.", aIdentifier, time / std::chrono::microseconds(1));
+	counters->Raise();
+
+	this->Deliver(subscribers, aEventData);
 }
 
 void CEventApi::Raise(signed int aSignature, const char* aIdentifier, void* aEventData)
 {
-	this->Registry[aIdentifier].AmountRaises++;
+	std::shared_lock<std::shared_mutex> deliveryLock = this->BeginDelivery();
+	std::vector<EventSubscriber> subscribers;
+	CEventCounters* counters;
 
-	std::string str = aIdentifier;
-
-	const std::lock_guard<std::mutex> lock(this->Mutex);
-	
-	for (EventSubscriber sub : this->Registry[str].Subscribers)
 	{
-		if (sub.Signature == aSignature)
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		EventData& ev = this->Registry[aIdentifier];
+
+		if (!ev.Counters)
 		{
-			sub.Callback(aEventData);
-			break;
+			ev.Counters = this->Metrics.GetEvent(aIdentifier);
+		}
+
+		counters = ev.Counters;
+
+		for (const EventSubscriber& sub : ev.Subscribers)
+		{
+			if (sub.Signature == aSignature)
+			{
+				subscribers.push_back(sub);
+				break;
+			}
 		}
 	}
+
+	counters->Raise();
+
+	this->Deliver(subscribers, aEventData);
 }
 
 void CEventApi::Raise(const char* aIdentifier)
@@ -100,15 +149,81 @@ void CEventApi::Raise(signed int aSignature, const char* aIdentifier)
 	this->Raise(aSignature, aIdentifier, nullptr);
 }
 
+void CEventApi::RaiseQueued(const char* aIdentifier, const void* aEventData, size_t aSize)
+{
+	std::string str = aIdentifier;
+
+	/* held until the calls are queued, so Verify purges them */
+	std::shared_lock<std::shared_mutex> deliveryLock = this->BeginDelivery();
+	std::vector<EventSubscriber> subscribers;
+	CEventCounters* counters;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		EventData& ev = this->Registry[str];
+
+		if (!ev.Counters)
+		{
+			ev.Counters = this->Metrics.GetEvent(str);
+		}
+
+		counters = ev.Counters;
+		subscribers = ev.Subscribers;
+	}
+
+	counters->Raise();
+
+	this->Executor.Enqueue(str, aEventData, aSize, subscribers);
+}
+
+void CEventApi::RaiseQueued(signed int aSignature, const char* aIdentifier, const void* aEventData, size_t aSize)
+{
+	std::string str = aIdentifier;
+
+	/* held until the calls are queued, so Verify purges them */
+	std::shared_lock<std::shared_mutex> deliveryLock = this->BeginDelivery();
+	std::vector<EventSubscriber> subscribers;
+	CEventCounters* counters;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		EventData& ev = this->Registry[str];
+
+		if (!ev.Counters)
+		{
+			ev.Counters = this->Metrics.GetEvent(str);
+		}
+
+		counters = ev.Counters;
+
+		for (const EventSubscriber& sub : ev.Subscribers)
+		{
+			if (sub.Signature == aSignature)
+			{
+				subscribers.push_back(sub);
+				break;
+			}
+		}
+	}
+
+	counters->Raise();
+
+	this->Executor.Enqueue(str, aEventData, aSize, subscribers);
+}
+
 void CEventApi::Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, bool aIsInternal)
 {
 	std::string str = aIdentifier;
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+	std::unique_lock<std::mutex> lock(this->Mutex);
 	
 	EventSubscriber sub{};
 	sub.Callback = aConsumeEventCallback;
 
+	std::string owner = aIsInternal ? "Nexus" : NULLSTR;
+
 	for (auto addon : Loader::Addons)
 	{
 		if (addon->Module == nullptr ||
@@ -125,10 +240,14 @@ void CEventApi::Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCa
 		if (aConsumeEventCallback >= startAddress && aConsumeEventCallback <= endAddress)
 		{
 			sub.Signature = addon->Definitions->Signature;
+			owner = addon->Definitions->Name ? addon->Definitions->Name : NULLSTR;
 			break;
 		}
 	}
 
+	/* resolved now, the address space is gone once the addon is unloaded */
+	sub.Counters = this->Metrics.GetSubscriber(str, aConsumeEventCallback, sub.Signature, owner);
+
 	this->Registry[str].Subscribers.push_back(sub);
 
 	if (sub.Signature == 0 && !aIsInternal)
@@ -136,6 +255,8 @@ void CEventApi::Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCa
 		Logger->Warning(CH_EVENTS, "Event registered but no addon address space matches function pointer. %p", aConsumeEventCallback);
 	}
 
+	lock.unlock();
+
 	/* dirty hack for arcdps (I hate my life) */
 	if ((str == "EV_ARCDPS_COMBATEVENT_LOCAL_RAW" || str == "EV_ARCDPS_COMBATEVENT_SQUAD_RAW") && !ArcDPS::IsLoaded)
 	{
@@ -146,48 +267,172 @@ void CEventApi::Subscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCa
 void CEventApi::Unsubscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback)
 {
 	std::string str = aIdentifier;
+	CSubscriberCounters* counters;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		auto it = this->Registry.find(str);
+
+		if (it == this->Registry.end())
+		{
+			return;
+		}
+
+		std::vector<EventSubscriber>& subscribers = it->second.Subscribers;
+
+		auto sub = std::find_if(subscribers.begin(), subscribers.end(), [aConsumeEventCallback](const EventSubscriber& aSubscriber)
+		{
+			return aSubscriber.Callback == aConsumeEventCallback;
+		});
+
+		if (sub == subscribers.end())
+		{
+			return;
+		}
+
+		counters = sub->Counters;
+		subscribers.erase(sub);
+	}
+
+	this->Metrics.SetSubscribed(counters, false);
+
+	this->WaitForDelivery();
 
+	/* queued events that were not delivered yet */
+	this->Executor.Purge(str, aConsumeEventCallback);
+}
+
+void CEventApi::SetExecution(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, EEventExecution aExecution)
+{
 	const std::lock_guard<std::mutex> lock(this->Mutex);
-	
-	if (this->Registry.find(str) == this->Registry.end())
+
+	auto it = this->Registry.find(aIdentifier);
+
+	if (it == this->Registry.end())
 	{
+		Logger->Warning(CH_EVENTS, "Execution set for an event that is not subscribed to: %s", aIdentifier);
 		return;
 	}
 
-	for (EventSubscriber evSub : this->Registry[str].Subscribers)
+	for (EventSubscriber& sub : it->second.Subscribers)
 	{
-		if (evSub.Callback == aConsumeEventCallback)
+		if (sub.Callback == aConsumeEventCallback)
 		{
-			this->Registry[str].Subscribers.erase(std::remove(this->Registry[str].Subscribers.begin(), this->Registry[str].Subscribers.end(), evSub), this->Registry[str].Subscribers.end());
-			break;
+			sub.Execution = aExecution;
+			return;
 		}
 	}
+
+	Logger->Warning(CH_EVENTS, "Execution set for a callback that is not subscribed to %s: %p", aIdentifier, aConsumeEventCallback);
 }
 
 int CEventApi::Verify(void* aStartAddress, void* aEndAddress)
 {
 	int refCounter = 0;
+	std::vector<CSubscriberCounters*> removed;
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
-	
-	for (auto& [identifier, ev] : this->Registry)
 	{
-		for (EventSubscriber evSub : ev.Subscribers)
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (auto& [identifier, ev] : this->Registry)
 		{
-			if (evSub.Callback >= aStartAddress && evSub.Callback <= aEndAddress)
+			auto it = std::remove_if(ev.Subscribers.begin(), ev.Subscribers.end(), [aStartAddress, aEndAddress](const EventSubscriber& aSubscriber)
 			{
-				ev.Subscribers.erase(std::remove(ev.Subscribers.begin(), ev.Subscribers.end(), evSub), ev.Subscribers.end());
-				refCounter++;
+				return aSubscriber.Callback >= aStartAddress && aSubscriber.Callback <= aEndAddress;
+			});
+
+			for (auto sub = it; sub != ev.Subscribers.end(); ++sub)
+			{
+				removed.push_back(sub->Counters);
 			}
+
+			refCounter += static_cast<int>(std::distance(it, ev.Subscribers.end()));
+			ev.Subscribers.erase(it, ev.Subscribers.end());
 		}
 	}
 
+	for (CSubscriberCounters* counters : removed)
+	{
+		this->Metrics.SetSubscribed(counters, false);
+	}
+
+	this->WaitForDelivery();
+
+	this->Executor.Purge(aStartAddress, aEndAddress);
+
 	return refCounter;
 }
 
+void CEventApi::ProcessRenderQueue()
+{
+	this->Executor.ProcessRenderQueue();
+}
+
+EventExecutorStats CEventApi::GetExecutorStats() const
+{
+	return this->Executor.GetStats();
+}
+
+void CEventApi::SampleMetrics()
+{
+	this->Metrics.Sample(CCallbackWatchdog::Now());
+}
+
+std::vector<EventMetrics> CEventApi::GetMetrics() const
+{
+	return this->Metrics.GetMetrics();
+}
+
+bool CEventApi::ExportMetrics(const std::filesystem::path& aPath) const
+{
+	return this->Metrics.Export(aPath);
+}
+
+void CEventApi::Shutdown()
+{
+	this->Executor.Shutdown();
+}
+
 std::unordered_map<std::string, EventData> CEventApi::GetRegistry() const
 {
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
 	return this->Registry;
 }
+
+std::shared_lock<std::shared_mutex> CEventApi::BeginDelivery()
+{
+	/* a nested shared lock could wait behind a Verify that waits for the outer one */
+	if (DeliveryDepth > 0)
+	{
+		return std::shared_lock<std::shared_mutex>();
+	}
+
+	return std::shared_lock<std::shared_mutex>(this->DeliveryMutex);
+}
+
+void CEventApi::Deliver(const std::vector<EventSubscriber>& aSubscribers, void* aEventData)
+{
+	DeliveryDepth++;
+
+	for (const EventSubscriber& sub : aSubscribers)
+	{
+		long long start = CCallbackWatchdog::Now();
+		sub.Callback(aEventData);
+		long long time = CCallbackWatchdog::Now() - start;
+		CallbackWatchdog->Record(ECallbackType::Event, (void*)sub.Callback, time);
+		sub.Counters->Record(time);
+	}
+
+	DeliveryDepth--;
+}
+
+void CEventApi::WaitForDelivery()
+{
+	/* the delivery would wait for itself */
+	if (DeliveryDepth > 0) { return; }
+
+	/* raises that took their snapshot before the removal, or are queueing calls from it */
+	const std::unique_lock<std::shared_mutex> deliveryLock(this->DeliveryMutex);
+}
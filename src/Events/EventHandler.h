@@ -10,12 +10,15 @@
 #define EVENTHANDLER_H
 
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 #include <string>
 
 #include "FuncDefs.h"
 #include "EventSubscriber.h"
+#include "EventExecutor.h"
+#include "EventMetrics.h"
 
 constexpr const char* CH_EVENTS = "Events";
 
@@ -59,6 +62,18 @@ namespace Events
 	/// 	Addon API wrapper function for raising notifications targeted at a specific subscriber.
 	///----------------------------------------------------------------------------------------------------
 	void ADDONAPI_RaiseNotificationTargeted(signed int aSignature, const char* aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_RaiseEventQueued:
+	/// 	Addon API wrapper function for raising events that are delivered later.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_RaiseEventQueued(const char* aIdentifier, const void* aEventData, size_t aSize);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_SetExecution:
+	/// 	Addon API wrapper function for choosing the thread queued events are delivered on.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_SetExecution(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, EEventExecution aExecution);
 }
 
 ///----------------------------------------------------------------------------------------------------
@@ -67,11 +82,12 @@ namespace Events
 struct EventData
 {
 	std::vector<EventSubscriber>	Subscribers;
-	unsigned long long				AmountRaises = 0;
+	CEventCounters*					Counters = nullptr;	/* owned by the metrics */
 };
 
 ///----------------------------------------------------------------------------------------------------
 /// CEventApi Class
+/// 	Subscribers are called without holding the registry lock, so they may raise, subscribe and unsubscribe.
 ///----------------------------------------------------------------------------------------------------
 class CEventApi
 {
@@ -109,6 +125,19 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	void Raise(signed int aSignature, const char* aIdentifier);
 
+	///----------------------------------------------------------------------------------------------------
+	/// RaiseQueued:
+	/// 	Copies the payload and returns, the subscribers are called on the thread of their execution.
+	/// 	Every subscriber receives the queued events in the order they were raised.
+	///----------------------------------------------------------------------------------------------------
+	void RaiseQueued(const char* aIdentifier, const void* aEventData, size_t aSize);
+
+	///----------------------------------------------------------------------------------------------------
+	/// RaiseQueued:
+	/// 	Copies the payload and returns, queued for only a specific subscriber.
+	///----------------------------------------------------------------------------------------------------
+	void RaiseQueued(signed int aSignature, const char* aIdentifier, const void* aEventData, size_t aSize);
+
 	///----------------------------------------------------------------------------------------------------
 	/// Subscribe:
 	/// 	Subscribes the provided ConsumeEventCallback function, to the provided event name.
@@ -118,15 +147,59 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	/// Unsubscribe:
 	/// 	Unsubscribes the provided ConsumeEventCallback function from the provided event name.
+	/// 	Waits for running calls of it, unless called from within a raise.
 	///----------------------------------------------------------------------------------------------------
 	void Unsubscribe(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback);
 
+	///----------------------------------------------------------------------------------------------------
+	/// SetExecution:
+	/// 	Sets the thread the subscriber receives queued events on.
+	///----------------------------------------------------------------------------------------------------
+	void SetExecution(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, EEventExecution aExecution);
+
 	///----------------------------------------------------------------------------------------------------
 	/// Verify:
 	/// 	Removes any elements within the provided address space from the Registry.
+	/// 	Waits for running calls into it, so the module can be freed once this returns.
 	///----------------------------------------------------------------------------------------------------
 	int Verify(void* aStartAddress, void* aEndAddress);
 
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessRenderQueue:
+	/// 	Calls the subscribers of queued events that run on the render thread.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessRenderQueue();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetExecutorStats:
+	/// 	Returns the statistics of queued events.
+	///----------------------------------------------------------------------------------------------------
+	EventExecutorStats GetExecutorStats() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// SampleMetrics:
+	/// 	Samples the counters for the rates, at most once per EV_METRICS_INTERVAL. Called once per frame.
+	///----------------------------------------------------------------------------------------------------
+	void SampleMetrics();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetMetrics:
+	/// 	Returns the raise and subscriber metrics of all events, the most expensive first.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<EventMetrics> GetMetrics() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// ExportMetrics:
+	/// 	Writes the metrics to a CSV file if the extension is .csv, to a JSON file otherwise.
+	///----------------------------------------------------------------------------------------------------
+	bool ExportMetrics(const std::filesystem::path& aPath) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Shutdown:
+	/// 	Stops the delivery of queued events.
+	///----------------------------------------------------------------------------------------------------
+	void Shutdown();
+
 	///----------------------------------------------------------------------------------------------------
 	/// GetRegistry:
 	/// 	Returns a copy of the registry.
@@ -136,6 +209,28 @@ public:
 private:
 	mutable std::mutex							Mutex;
 	std::unordered_map<std::string, EventData>	Registry;
+
+	std::shared_mutex							DeliveryMutex;	/* shared from the snapshot until the subscribers were called or queued */
+	CEventMetrics								Metrics;		/* before the executor, its workers record into it */
+	CEventExecutor								Executor;
+
+	///----------------------------------------------------------------------------------------------------
+	/// BeginDelivery:
+	/// 	Locks the delivery before the snapshot is taken. Not locked when raised from within a delivery.
+	///----------------------------------------------------------------------------------------------------
+	std::shared_lock<std::shared_mutex> BeginDelivery();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Deliver:
+	/// 	Calls the subscribers of a snapshot of the registry.
+	///----------------------------------------------------------------------------------------------------
+	void Deliver(const std::vector<EventSubscriber>& aSubscribers, void* aEventData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// WaitForDelivery:
+	/// 	Waits until the raises that are running have ended. Returns immediately if called from within one.
+	///----------------------------------------------------------------------------------------------------
+	void WaitForDelivery();
 };
 
 #endif
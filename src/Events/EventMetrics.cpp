@@ -0,0 +1,358 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventMetrics.cpp
+/// Description  :  Counts raises and the time spent in subscribers of every event.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "EventMetrics.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "Consts.h"
+#include "Shared.h"
+
+#include "Util/Paths.h"
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+
+namespace
+{
+	std::atomic<unsigned> NextShard{ 0 };
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetShard:
+	/// 	Returns the shard of the calling thread, assigned round robin on its first use.
+	///----------------------------------------------------------------------------------------------------
+	unsigned GetShard()
+	{
+		static thread_local unsigned shard = NextShard.fetch_add(1, std::memory_order_relaxed) & (EV_METRICS_SHARDS - 1);
+		return shard;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsMoreExpensive:
+	/// 	Orders by the time spent over the window, then by the total time.
+	///----------------------------------------------------------------------------------------------------
+	template<typename T>
+	bool IsMoreExpensive(const T& aLeft, const T& aRight)
+	{
+		if (aLeft.TimeRateWindow != aRight.TimeRateWindow) { return aLeft.TimeRateWindow > aRight.TimeRateWindow; }
+
+		return aLeft.TotalTime > aRight.TotalTime;
+	}
+}
+
+void CEventCounters::Raise()
+{
+	this->Shards[GetShard()].Raises.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned long long CEventCounters::GetRaises() const
+{
+	unsigned long long raises = 0;
+
+	for (const Shard& shard : this->Shards)
+	{
+		raises += shard.Raises.load(std::memory_order_relaxed);
+	}
+
+	return raises;
+}
+
+void CSubscriberCounters::Record(long long aTime)
+{
+	Shard& shard = this->Shards[GetShard()];
+
+	shard.Calls.fetch_add(1, std::memory_order_relaxed);
+	shard.Time.fetch_add(aTime, std::memory_order_relaxed);
+
+	/* a new maximum is rare, the load alone is enough for most calls */
+	long long max = shard.MaxTime.load(std::memory_order_relaxed);
+
+	while (aTime > max && !shard.MaxTime.compare_exchange_weak(max, aTime, std::memory_order_relaxed)) {}
+}
+
+void CSubscriberCounters::Get(unsigned long long* aOutCalls, long long* aOutTime, long long* aOutMaxTime) const
+{
+	*aOutCalls = 0;
+	*aOutTime = 0;
+	*aOutMaxTime = 0;
+
+	for (const Shard& shard : this->Shards)
+	{
+		*aOutCalls += shard.Calls.load(std::memory_order_relaxed);
+		*aOutTime += shard.Time.load(std::memory_order_relaxed);
+		*aOutMaxTime = (std::max)(*aOutMaxTime, shard.MaxTime.load(std::memory_order_relaxed));
+	}
+}
+
+CEventMetrics::~CEventMetrics()
+{
+	for (auto& [identifier, ev] : this->Events)
+	{
+		delete ev.Counters;
+
+		for (Subscriber& sub : ev.Subscribers)
+		{
+			delete sub.Counters;
+		}
+	}
+}
+
+CEventCounters* CEventMetrics::GetEvent(const std::string& aIdentifier)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	Event& ev = this->Events[aIdentifier];
+
+	if (!ev.Counters)
+	{
+		ev.Counters = new CEventCounters();
+	}
+
+	return ev.Counters;
+}
+
+CSubscriberCounters* CEventMetrics::GetSubscriber(const std::string& aIdentifier, EVENT_CONSUME aConsumeEventCallback, signed int aSignature, const std::string& aOwner)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	Event& ev = this->Events[aIdentifier];
+
+	if (!ev.Counters)
+	{
+		ev.Counters = new CEventCounters();
+	}
+
+	/* an addon loaded where an unloaded one was can subscribe at the same address */
+	for (Subscriber& sub : ev.Subscribers)
+	{
+		if (sub.Callback == aConsumeEventCallback && sub.Signature == aSignature && sub.Owner == aOwner)
+		{
+			sub.IsSubscribed = true;
+			return sub.Counters;
+		}
+	}
+
+	ev.Subscribers.push_back(Subscriber{ new CSubscriberCounters(), aOwner, aSignature, aConsumeEventCallback, true, {} });
+
+	return ev.Subscribers.back().Counters;
+}
+
+void CEventMetrics::SetSubscribed(CSubscriberCounters* aCounters, bool aIsSubscribed)
+{
+	if (!aCounters) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (auto& [identifier, ev] : this->Events)
+	{
+		for (Subscriber& sub : ev.Subscribers)
+		{
+			if (sub.Counters == aCounters)
+			{
+				sub.IsSubscribed = aIsSubscribed;
+				return;
+			}
+		}
+	}
+}
+
+void CEventMetrics::Sample(long long aTime)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	if (this->SampleCount > 0 && aTime - this->SampleTime < EV_METRICS_INTERVAL) { return; }
+
+	/* the samples are taken on time, the rates assume EV_METRICS_INTERVAL between them */
+	this->SampleTime = this->SampleCount > 0 ? this->SampleTime + EV_METRICS_INTERVAL : aTime;
+
+	if (aTime - this->SampleTime >= EV_METRICS_INTERVAL)
+	{
+		/* no frame for a while, the rates of the gap are spread over the next interval */
+		this->SampleTime = aTime;
+	}
+
+	unsigned slot = this->SampleCount % (EV_METRICS_WINDOW + 1);
+
+	for (auto& [identifier, ev] : this->Events)
+	{
+		long long eventTime = 0;
+
+		for (Subscriber& sub : ev.Subscribers)
+		{
+			long long maxTime;
+			sub.Counters->Get(&sub.Samples.Counts[slot], &sub.Samples.Times[slot], &maxTime);
+			eventTime += sub.Samples.Times[slot];
+		}
+
+		ev.Samples.Counts[slot] = ev.Counters->GetRaises();
+		ev.Samples.Times[slot] = eventTime;
+	}
+
+	this->SampleCount++;
+}
+
+std::vector<EventMetrics> CEventMetrics::GetMetrics() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	std::vector<EventMetrics> metrics;
+	metrics.reserve(this->Events.size());
+
+	for (const auto& [identifier, ev] : this->Events)
+	{
+		EventMetrics evMetrics{};
+		evMetrics.Identifier = identifier;
+		evMetrics.Raises = ev.Counters->GetRaises();
+		this->GetRates(ev.Samples, &evMetrics.RaiseRate, &evMetrics.RaiseRateWindow, &evMetrics.TimeRate, &evMetrics.TimeRateWindow);
+
+		for (const Subscriber& sub : ev.Subscribers)
+		{
+			SubscriberMetrics subMetrics{};
+			subMetrics.Owner = sub.Owner;
+			subMetrics.Signature = sub.Signature;
+			subMetrics.Callback = sub.Callback;
+			subMetrics.IsSubscribed = sub.IsSubscribed;
+			sub.Counters->Get(&subMetrics.Calls, &subMetrics.TotalTime, &subMetrics.MaxTime);
+			this->GetRates(sub.Samples, &subMetrics.CallRate, &subMetrics.CallRateWindow, &subMetrics.TimeRate, &subMetrics.TimeRateWindow);
+
+			evMetrics.TotalTime += subMetrics.TotalTime;
+			evMetrics.MaxTime = (std::max)(evMetrics.MaxTime, subMetrics.MaxTime);
+			evMetrics.Subscribers.push_back(subMetrics);
+		}
+
+		std::sort(evMetrics.Subscribers.begin(), evMetrics.Subscribers.end(), IsMoreExpensive<SubscriberMetrics>);
+
+		metrics.push_back(std::move(evMetrics));
+	}
+
+	std::sort(metrics.begin(), metrics.end(), IsMoreExpensive<EventMetrics>);
+
+	return metrics;
+}
+
+bool CEventMetrics::Export(const std::filesystem::path& aPath) const
+{
+	std::vector<EventMetrics> metrics = this->GetMetrics();
+
+	Path::CreateDir(aPath.parent_path());
+
+	std::ofstream file(aPath, std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		Logger->Warning(CH_EVENTS, "Could not export the event metrics to \"%s\".", aPath.string().c_str());
+		return false;
+	}
+
+	if (aPath.extension() == ".csv")
+	{
+		/* one row per subscriber, events without subscribers have one row without a subscriber */
+		file << "Event,Raises,RaisesPerSecond,RaisesPerSecondWindow,Owner,Signature,Subscribed,Calls,TotalTimeNs,MaxTimeNs,AverageTimeNs,CallsPerSecond,CallsPerSecondWindow,TimeNsPerSecond,TimeNsPerSecondWindow\n";
+
+		for (const EventMetrics& ev : metrics)
+		{
+			char eventColumns[512];
+			snprintf(eventColumns, sizeof(eventColumns), "\"%s\",%llu,%.2f,%.2f", ev.Identifier.c_str(), ev.Raises, ev.RaiseRate, ev.RaiseRateWindow);
+
+			if (ev.Subscribers.empty())
+			{
+				file << eventColumns << ",,,,,,,,,,\n";
+				continue;
+			}
+
+			for (const SubscriberMetrics& sub : ev.Subscribers)
+			{
+				char subColumns[512];
+				snprintf(subColumns, sizeof(subColumns), "\"%s\",%d,%d,%llu,%lld,%lld,%.0f,%.2f,%.2f,%.0f,%.0f",
+					sub.Owner.c_str(), sub.Signature, sub.IsSubscribed ? 1 : 0, sub.Calls, sub.TotalTime, sub.MaxTime,
+					sub.Calls ? static_cast<double>(sub.TotalTime) / sub.Calls : 0.0,
+					sub.CallRate, sub.CallRateWindow, sub.TimeRate, sub.TimeRateWindow);
+
+				file << eventColumns << "," << subColumns << "\n";
+			}
+		}
+	}
+	else
+	{
+		json events = json::array();
+
+		for (const EventMetrics& ev : metrics)
+		{
+			json subscribers = json::array();
+
+			for (const SubscriberMetrics& sub : ev.Subscribers)
+			{
+				subscribers.push_back(
+					{
+						{"Owner", sub.Owner},
+						{"Signature", sub.Signature},
+						{"IsSubscribed", sub.IsSubscribed},
+						{"Calls", sub.Calls},
+						{"TotalTimeNs", sub.TotalTime},
+						{"MaxTimeNs", sub.MaxTime},
+						{"CallsPerSecond", sub.CallRate},
+						{"CallsPerSecondWindow", sub.CallRateWindow},
+						{"TimeNsPerSecond", sub.TimeRate},
+						{"TimeNsPerSecondWindow", sub.TimeRateWindow}
+					}
+				);
+			}
+
+			events.push_back(
+				{
+					{"Identifier", ev.Identifier},
+					{"Raises", ev.Raises},
+					{"TotalTimeNs", ev.TotalTime},
+					{"MaxTimeNs", ev.MaxTime},
+					{"RaisesPerSecond", ev.RaiseRate},
+					{"RaisesPerSecondWindow", ev.RaiseRateWindow},
+					{"TimeNsPerSecond", ev.TimeRate},
+					{"TimeNsPerSecondWindow", ev.TimeRateWindow},
+					{"Subscribers", subscribers}
+				}
+			);
+		}
+
+		json root =
+		{
+			{"WindowSeconds", EV_METRICS_WINDOW},
+			{"Events", events}
+		};
+
+		file << root.dump(1, '\t') << std::endl;
+	}
+
+	file.close();
+
+	Logger->Info(CH_EVENTS, "Exported the metrics of %zu events to \"%s\".", metrics.size(), aPath.string().c_str());
+
+	return true;
+}
+
+void CEventMetrics::GetRates(const History& aSamples, double* aOutCountRate, double* aOutCountRateWindow, double* aOutTimeRate, double* aOutTimeRateWindow) const
+{
+	*aOutCountRate = *aOutCountRateWindow = *aOutTimeRate = *aOutTimeRateWindow = 0.0;
+
+	if (this->SampleCount < 2) { return; }
+
+	const unsigned size = EV_METRICS_WINDOW + 1;
+	unsigned newest = (this->SampleCount - 1) % size;
+	unsigned previous = (this->SampleCount - 2) % size;
+
+	/* fewer intervals until the window is full */
+	unsigned intervals = (std::min)(this->SampleCount - 1, EV_METRICS_WINDOW);
+	unsigned oldest = (this->SampleCount - 1 - intervals) % size;
+
+	const double seconds = EV_METRICS_INTERVAL / 1000000000.0;
+
+	*aOutCountRate = (aSamples.Counts[newest] - aSamples.Counts[previous]) / seconds;
+	*aOutTimeRate = (aSamples.Times[newest] - aSamples.Times[previous]) / seconds;
+	*aOutCountRateWindow = (aSamples.Counts[newest] - aSamples.Counts[oldest]) / (seconds * intervals);
+	*aOutTimeRateWindow = (aSamples.Times[newest] - aSamples.Times[oldest]) / (seconds * intervals);
+}
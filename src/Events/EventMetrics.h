@@ -0,0 +1,220 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EventMetrics.h
+/// Description  :  Counts raises and the time spent in subscribers of every event.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef EVENTMETRICS_H
+#define EVENTMETRICS_H
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FuncDefs.h"
+
+constexpr const unsigned	EV_METRICS_SHARDS		= 8;			/* power of two, threads are spread over them */
+constexpr const unsigned	EV_METRICS_WINDOW		= 60;			/* seconds of the long rate */
+constexpr const long long	EV_METRICS_INTERVAL		= 1000000000;	/* nanoseconds between two samples */
+
+///----------------------------------------------------------------------------------------------------
+/// SubscriberMetrics Struct
+/// 	Times are in nanoseconds. Rates are per second, over the last second and the last EV_METRICS_WINDOW.
+///----------------------------------------------------------------------------------------------------
+struct SubscriberMetrics
+{
+	std::string					Owner;
+	signed int					Signature;
+	EVENT_CONSUME				Callback;
+	bool						IsSubscribed;
+
+	unsigned long long			Calls;
+	long long					TotalTime;
+	long long					MaxTime;
+	double						CallRate;
+	double						CallRateWindow;
+	double						TimeRate;		/* nanoseconds spent per second */
+	double						TimeRateWindow;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// EventMetrics Struct
+/// 	The times are the sums of all subscribers.
+///----------------------------------------------------------------------------------------------------
+struct EventMetrics
+{
+	std::string						Identifier;
+
+	unsigned long long				Raises;
+	long long						TotalTime;
+	long long						MaxTime;
+	double							RaiseRate;
+	double							RaiseRateWindow;
+	double							TimeRate;
+	double							TimeRateWindow;
+
+	std::vector<SubscriberMetrics>	Subscribers;	/* most expensive first */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CEventCounters Class
+/// 	Raises of one event. Counting is lock-free, every thread increments its own shard.
+///----------------------------------------------------------------------------------------------------
+class CEventCounters
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// Raise:
+	/// 	Counts one raise.
+	///----------------------------------------------------------------------------------------------------
+	void Raise();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetRaises:
+	/// 	Returns the sum of the shards.
+	///----------------------------------------------------------------------------------------------------
+	unsigned long long GetRaises() const;
+
+private:
+	struct alignas(64) Shard
+	{
+		std::atomic<unsigned long long>	Raises{ 0 };
+	};
+
+	Shard								Shards[EV_METRICS_SHARDS];
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CSubscriberCounters Class
+/// 	Calls of one subscriber of one event. Counting is lock-free, every thread increments its own shard.
+///----------------------------------------------------------------------------------------------------
+class CSubscriberCounters
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// Record:
+	/// 	Counts one call that took aTime nanoseconds.
+	///----------------------------------------------------------------------------------------------------
+	void Record(long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Get:
+	/// 	Returns the sums of the shards.
+	///----------------------------------------------------------------------------------------------------
+	void Get(unsigned long long* aOutCalls, long long* aOutTime, long long* aOutMaxTime) const;
+
+private:
+	struct alignas(64) Shard
+	{
+		std::atomic<unsigned long long>	Calls{ 0 };
+		std::atomic<long long>			Time{ 0 };
+		std::atomic<long long>			MaxTime{ 0 };
+	};
+
+	Shard								Shards[EV_METRICS_SHARDS];
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CEventMetrics Class
+/// 	Owns the counters of all events and subscribers, they live as long as this.
+/// 	The rates are computed from samples of the counters taken once per EV_METRICS_INTERVAL.
+///----------------------------------------------------------------------------------------------------
+class CEventMetrics
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CEventMetrics() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CEventMetrics();
+
+	CEventMetrics(const CEventMetrics&) = delete;
+	CEventMetrics& operator=(const CEventMetrics&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetEvent:
+	/// 	Returns the counters of the event, creates them on first use.
+	///----------------------------------------------------------------------------------------------------
+	CEventCounters* GetEvent(const std::string& aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetSubscriber:
+	/// 	Returns the counters of the subscriber, creates them on first use.
+	/// 	Subscribing the same callback of the same owner again continues its counters.
+	///----------------------------------------------------------------------------------------------------
+	CSubscriberCounters* GetSubscriber(const std::string& aIdentifier, EVENT_CONSUME aConsumeEventCallback, signed int aSignature, const std::string& aOwner);
+
+	///----------------------------------------------------------------------------------------------------
+	/// SetSubscribed:
+	/// 	Marks the counters of a subscriber as (un)subscribed, they are kept for the statistics.
+	///----------------------------------------------------------------------------------------------------
+	void SetSubscribed(CSubscriberCounters* aCounters, bool aIsSubscribed);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Sample:
+	/// 	Takes a sample of all counters, if EV_METRICS_INTERVAL passed since the last one.
+	///----------------------------------------------------------------------------------------------------
+	void Sample(long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetMetrics:
+	/// 	Returns the metrics of all events, the most expensive first.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<EventMetrics> GetMetrics() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Export:
+	/// 	Writes the metrics to a file, as CSV if the extension is .csv, as JSON otherwise.
+	///----------------------------------------------------------------------------------------------------
+	bool Export(const std::filesystem::path& aPath) const;
+
+private:
+	///----------------------------------------------------------------------------------------------------
+	/// History Struct
+	/// 	Ring of the counter values at the last samples.
+	///----------------------------------------------------------------------------------------------------
+	struct History
+	{
+		unsigned long long			Counts[EV_METRICS_WINDOW + 1];
+		long long					Times[EV_METRICS_WINDOW + 1];
+	};
+
+	struct Subscriber
+	{
+		CSubscriberCounters*		Counters;
+		std::string					Owner;
+		signed int					Signature;
+		EVENT_CONSUME				Callback;
+		bool						IsSubscribed;
+		History						Samples;
+	};
+
+	struct Event
+	{
+		CEventCounters*				Counters;
+		History						Samples;
+		std::vector<Subscriber>		Subscribers;
+	};
+
+	mutable std::mutex							Mutex;
+	std::unordered_map<std::string, Event>		Events;
+
+	long long									SampleTime		= 0;
+	unsigned									SampleCount		= 0;	/* samples taken, the newest is at SampleCount % size */
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetRates:
+	/// 	Returns the rates per second over the last sample interval and the window.
+	///----------------------------------------------------------------------------------------------------
+	void GetRates(const History& aSamples, double* aOutCountRate, double* aOutCountRateWindow, double* aOutTimeRate, double* aOutTimeRateWindow) const;
+};
+
+#endif
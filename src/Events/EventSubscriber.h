@@ -10,6 +10,9 @@
 #define EVENTSUBSCRIBER_H
 
 #include "FuncDefs.h"
+#include "EEventExecution.h"
+
+class CSubscriberCounters;
 
 ///----------------------------------------------------------------------------------------------------
 /// EventSubscriber data struct
@@ -18,6 +21,8 @@ struct EventSubscriber
 {
 	signed int Signature;
 	EVENT_CONSUME Callback;
+	EEventExecution Execution;
+	CSubscriberCounters* Counters;
 };
 
 bool operator==(const EventSubscriber& lhs, const EventSubscriber& rhs);
@@ -1,11 +1,22 @@
 #ifndef EVENTS_FUNCDEFS_H
 #define EVENTS_FUNCDEFS_H
 
+#include <cstddef>
+
+#include "EEventExecution.h"
+
+struct CombatBatch;
+
 typedef void (*EVENT_CONSUME)(void* aEventArgs);
 typedef void (*EVENTS_RAISE)(const char* aIdentifier, void* aEventData);
 typedef void (*EVENTS_RAISENOTIFICATION)(const char* aIdentifier);
 typedef void (*EVENTS_RAISE_TARGETED)(signed int aSignature, const char* aIdentifier, void* aEventData);
 typedef void (*EVENTS_RAISENOTIFICATION_TARGETED)(signed int aSignature, const char* aIdentifier);
 typedef void (*EVENTS_SUBSCRIBE)(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback);
+typedef void (*EVENTS_RAISE_QUEUED)(const char* aIdentifier, const void* aEventData, size_t aSize);
+typedef void (*EVENTS_SETEXECUTION)(const char* aIdentifier, EVENT_CONSUME aConsumeEventCallback, EEventExecution aExecution);
+
+typedef void (*EVENT_CONSUME_COMBATBATCH)(const CombatBatch* aBatch);
+typedef void (*EVENTS_SUBSCRIBE_COMBATBATCH)(const char* aIdentifier, EVENT_CONSUME_COMBATBATCH aConsumeBatchCallback);
 
 #endif
\ No newline at end of file
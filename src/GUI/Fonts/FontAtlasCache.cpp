@@ -0,0 +1,366 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  FontAtlasCache.cpp
+/// Description  :  Serializes built font atlases to disk to skip rasterization on the next start.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "FontAtlasCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "imgui/imgui_internal.h"
+
+namespace FontAtlasCache
+{
+	constexpr unsigned	MAGIC	= 0x4146584E; /* "NXFA" */
+	constexpr unsigned	VERSION	= 1;
+
+	///----------------------------------------------------------------------------------------------------
+	/// CachedFont Struct
+	///----------------------------------------------------------------------------------------------------
+	struct CachedFont
+	{
+		bool						IsLoaded;
+		float						FontSize;
+		float						Ascent;
+		float						Descent;
+		int							ConfigIndex;
+		short						ConfigDataCount;
+		ImWchar						FallbackChar;
+		ImWchar						EllipsisChar;
+		int							MetricsTotalSurface;
+		std::vector<ImFontGlyph>	Glyphs;
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Writer Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Writer
+	{
+		std::vector<unsigned char> Buffer;
+
+		void Write(const void* aData, size_t aSize)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(aData);
+			this->Buffer.insert(this->Buffer.end(), bytes, bytes + aSize);
+		}
+
+		template <typename T>
+		void Write(const T& aValue)
+		{
+			this->Write(&aValue, sizeof(T));
+		}
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Reader Struct
+	/// 	Bounds checked, IsValid turns false on the first out of range read.
+	///----------------------------------------------------------------------------------------------------
+	struct Reader
+	{
+		const unsigned char*	Data;
+		size_t					Size;
+		size_t					Offset;
+		bool					IsValid;
+
+		bool Read(void* aOutData, size_t aSize)
+		{
+			if (!this->IsValid || aSize > this->Size - this->Offset)
+			{
+				this->IsValid = false;
+				return false;
+			}
+
+			memcpy(aOutData, this->Data + this->Offset, aSize);
+			this->Offset += aSize;
+			return true;
+		}
+
+		template <typename T>
+		T Read()
+		{
+			T value{};
+			this->Read(&value, sizeof(T));
+			return value;
+		}
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// EncodePixels:
+	/// 	Run length encodes zero runs, atlases are mostly empty.
+	/// 	Layout: repeated [u32 zeros][u32 literals][literal bytes].
+	///----------------------------------------------------------------------------------------------------
+	static void EncodePixels(Writer& aWriter, const unsigned char* aPixels, size_t aSize)
+	{
+		size_t i = 0;
+		while (i < aSize)
+		{
+			size_t zeroStart = i;
+			while (i < aSize && aPixels[i] == 0) { i++; }
+			unsigned zeros = static_cast<unsigned>(i - zeroStart);
+
+			/* literals run until at least 8 zeros follow */
+			size_t literalStart = i;
+			while (i < aSize)
+			{
+				if (aPixels[i] == 0)
+				{
+					size_t run = 0;
+					while (i + run < aSize && aPixels[i + run] == 0 && run < 8) { run++; }
+					if (run == 8 || i + run == aSize) { break; }
+					i += run;
+					continue;
+				}
+				i++;
+			}
+			unsigned literals = static_cast<unsigned>(i - literalStart);
+
+			aWriter.Write(zeros);
+			aWriter.Write(literals);
+			aWriter.Write(aPixels + literalStart, literals);
+		}
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// DecodePixels:
+	/// 	Returns false if the encoded data does not exactly fill aSize bytes.
+	///----------------------------------------------------------------------------------------------------
+	static bool DecodePixels(Reader& aReader, unsigned char* aOutPixels, size_t aSize)
+	{
+		size_t i = 0;
+		while (i < aSize)
+		{
+			unsigned zeros = aReader.Read<unsigned>();
+			unsigned literals = aReader.Read<unsigned>();
+
+			if (!aReader.IsValid) { return false; }
+			if (zeros > aSize - i) { return false; }
+			memset(aOutPixels + i, 0, zeros);
+			i += zeros;
+
+			if (literals > aSize - i) { return false; }
+			if (!aReader.Read(aOutPixels + i, literals)) { return false; }
+			i += literals;
+		}
+
+		return true;
+	}
+
+	bool Load(const std::filesystem::path& aPath, unsigned long long aSignature, ImFontAtlas* aAtlas)
+	{
+		if (!aAtlas) { return false; }
+		if (aAtlas->IsBuilt()) { return false; }
+
+		std::vector<unsigned char> data;
+
+		try
+		{
+			if (!std::filesystem::exists(aPath)) { return false; }
+
+			std::ifstream file(aPath, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) { return false; }
+
+			std::streamsize size = file.tellg();
+			if (size <= 0) { return false; }
+
+			data.resize(static_cast<size_t>(size));
+			file.seekg(0, std::ios::beg);
+			if (!file.read(reinterpret_cast<char*>(data.data()), size)) { return false; }
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		Reader reader{ data.data(), data.size(), 0, true };
+
+		/* header */
+		if (reader.Read<unsigned>() != MAGIC) { return false; }
+		if (reader.Read<unsigned>() != VERSION) { return false; }
+		if (reader.Read<int>() != IMGUI_VERSION_NUM) { return false; }
+		if (reader.Read<unsigned>() != sizeof(ImFontGlyph)) { return false; }
+		if (reader.Read<unsigned long long>() != aSignature) { return false; }
+		if (reader.Read<int>() != aAtlas->ConfigData.Size) { return false; }
+		if (reader.Read<int>() != aAtlas->Fonts.Size) { return false; }
+		if (reader.Read<int>() != aAtlas->Flags) { return false; }
+
+		int width = reader.Read<int>();
+		int height = reader.Read<int>();
+		ImVec2 uvWhitePixel = reader.Read<ImVec2>();
+		ImVec4 uvLines[IM_ARRAYSIZE(aAtlas->TexUvLines)];
+		reader.Read(uvLines, sizeof(uvLines));
+
+		if (!reader.IsValid) { return false; }
+		if (width <= 0 || height <= 0 || width > 0x4000 || height > 0x8000) { return false; }
+
+		/* custom rects, registered by the builder itself, only their packed position is stored */
+		int rectCount = reader.Read<int>();
+		if (!reader.IsValid || rectCount < 0 || rectCount > 0xFFFF) { return false; }
+		std::vector<unsigned short> rectPositions(static_cast<size_t>(rectCount) * 2);
+		reader.Read(rectPositions.data(), rectPositions.size() * sizeof(unsigned short));
+
+		/* fonts */
+		std::vector<CachedFont> fonts(aAtlas->Fonts.Size);
+		for (CachedFont& font : fonts)
+		{
+			font.IsLoaded = reader.Read<bool>();
+			if (!font.IsLoaded) { continue; }
+
+			font.FontSize = reader.Read<float>();
+			font.Ascent = reader.Read<float>();
+			font.Descent = reader.Read<float>();
+			font.ConfigIndex = reader.Read<int>();
+			font.ConfigDataCount = reader.Read<short>();
+			font.FallbackChar = reader.Read<ImWchar>();
+			font.EllipsisChar = reader.Read<ImWchar>();
+			font.MetricsTotalSurface = reader.Read<int>();
+
+			int glyphCount = reader.Read<int>();
+			if (!reader.IsValid) { return false; }
+			if (font.ConfigIndex < 0 || font.ConfigIndex >= aAtlas->ConfigData.Size) { return false; }
+			if (glyphCount < 0 || glyphCount >= 0xFFFF) { return false; }
+
+			font.Glyphs.resize(glyphCount);
+			reader.Read(font.Glyphs.data(), font.Glyphs.size() * sizeof(ImFontGlyph));
+		}
+
+		if (!reader.IsValid) { return false; }
+
+		unsigned char* pixels = (unsigned char*)IM_ALLOC(static_cast<size_t>(width) * height);
+		if (!DecodePixels(reader, pixels, static_cast<size_t>(width) * height) || reader.Offset != reader.Size)
+		{
+			IM_FREE(pixels);
+			return false;
+		}
+
+		/* register the custom rects the same way the builder does and check they match */
+		ImFontAtlasBuildInit(aAtlas);
+		if (aAtlas->CustomRects.Size != rectCount)
+		{
+			IM_FREE(pixels);
+			return false;
+		}
+
+		/* everything was read, apply */
+		aAtlas->ClearTexData();
+		aAtlas->TexID = (ImTextureID)NULL;
+		aAtlas->TexPixelsAlpha8 = pixels;
+		aAtlas->TexWidth = width;
+		aAtlas->TexHeight = height;
+		aAtlas->TexUvScale = ImVec2(1.0f / width, 1.0f / height);
+		aAtlas->TexUvWhitePixel = uvWhitePixel;
+		memcpy(aAtlas->TexUvLines, uvLines, sizeof(uvLines));
+
+		for (int i = 0; i < rectCount; i++)
+		{
+			aAtlas->CustomRects[i].X = rectPositions[i * 2];
+			aAtlas->CustomRects[i].Y = rectPositions[i * 2 + 1];
+		}
+
+		for (int i = 0; i < aAtlas->Fonts.Size; i++)
+		{
+			CachedFont& cached = fonts[i];
+			if (!cached.IsLoaded) { continue; }
+
+			ImFont* font = aAtlas->Fonts[i];
+			font->ClearOutputData();
+			font->FontSize = cached.FontSize;
+			font->Ascent = cached.Ascent;
+			font->Descent = cached.Descent;
+			font->ConfigData = &aAtlas->ConfigData[cached.ConfigIndex];
+			font->ConfigDataCount = cached.ConfigDataCount;
+			font->ContainerAtlas = aAtlas;
+			font->FallbackChar = cached.FallbackChar;
+			font->EllipsisChar = cached.EllipsisChar;
+			font->MetricsTotalSurface = cached.MetricsTotalSurface;
+			font->Glyphs.resize(static_cast<int>(cached.Glyphs.size()));
+			if (!cached.Glyphs.empty())
+			{
+				memcpy(font->Glyphs.Data, cached.Glyphs.data(), cached.Glyphs.size() * sizeof(ImFontGlyph));
+			}
+			font->BuildLookupTable();
+		}
+
+		return true;
+	}
+
+	bool Save(const std::filesystem::path& aPath, unsigned long long aSignature, ImFontAtlas* aAtlas)
+	{
+		if (!aAtlas) { return false; }
+		if (!aAtlas->TexPixelsAlpha8) { return false; }
+
+		Writer writer{};
+
+		/* header */
+		writer.Write(MAGIC);
+		writer.Write(VERSION);
+		writer.Write(static_cast<int>(IMGUI_VERSION_NUM));
+		writer.Write(static_cast<unsigned>(sizeof(ImFontGlyph)));
+		writer.Write(aSignature);
+		writer.Write(aAtlas->ConfigData.Size);
+		writer.Write(aAtlas->Fonts.Size);
+		writer.Write(aAtlas->Flags);
+
+		writer.Write(aAtlas->TexWidth);
+		writer.Write(aAtlas->TexHeight);
+		writer.Write(aAtlas->TexUvWhitePixel);
+		writer.Write(aAtlas->TexUvLines, sizeof(aAtlas->TexUvLines));
+
+		/* custom rects */
+		writer.Write(aAtlas->CustomRects.Size);
+		for (const ImFontAtlasCustomRect& rect : aAtlas->CustomRects)
+		{
+			writer.Write(rect.X);
+			writer.Write(rect.Y);
+		}
+
+		/* fonts */
+		for (const ImFont* font : aAtlas->Fonts)
+		{
+			bool isLoaded = font->IsLoaded() && font->ConfigData;
+			writer.Write(isLoaded);
+			if (!isLoaded) { continue; }
+
+			writer.Write(font->FontSize);
+			writer.Write(font->Ascent);
+			writer.Write(font->Descent);
+			writer.Write(static_cast<int>(font->ConfigData - aAtlas->ConfigData.Data));
+			writer.Write(font->ConfigDataCount);
+			writer.Write(font->FallbackChar);
+			writer.Write(font->EllipsisChar);
+			writer.Write(font->MetricsTotalSurface);
+			writer.Write(font->Glyphs.Size);
+			writer.Write(font->Glyphs.Data, font->Glyphs.size_in_bytes());
+		}
+
+		/* pixels */
+		EncodePixels(writer, aAtlas->TexPixelsAlpha8, static_cast<size_t>(aAtlas->TexWidth) * aAtlas->TexHeight);
+
+		/* write to a temporary file first, so a crash never leaves a truncated cache behind */
+		try
+		{
+			std::filesystem::path tmpPath = aPath;
+			tmpPath += ".tmp";
+
+			{
+				std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+				if (!file.is_open()) { return false; }
+
+				file.write(reinterpret_cast<const char*>(writer.Buffer.data()), writer.Buffer.size());
+				if (!file.good()) { return false; }
+			}
+
+			std::filesystem::rename(tmpPath, aPath);
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,39 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  FontAtlasCache.h
+/// Description  :  Serializes built font atlases to disk to skip rasterization on the next start.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef FONTATLASCACHE_H
+#define FONTATLASCACHE_H
+
+#include <filesystem>
+
+#include "imgui/imgui.h"
+
+///----------------------------------------------------------------------------------------------------
+/// FontAtlasCache Namespace
+/// 	The cache holds the pixels and glyph metrics of a single atlas, keyed by the signature of
+/// 	its inputs (font data, sizes, configs and glyph ranges).
+///----------------------------------------------------------------------------------------------------
+namespace FontAtlasCache
+{
+	///----------------------------------------------------------------------------------------------------
+	/// Load:
+	/// 	Restores a built atlas from aPath, if the cache was written for aSignature.
+	/// 	aAtlas has to contain the same fonts and configs in the same order as when it was saved,
+	/// 	but must not be built yet.
+	/// 	Returns true on success, on failure aAtlas is left unbuilt.
+	///----------------------------------------------------------------------------------------------------
+	bool Load(const std::filesystem::path& aPath, unsigned long long aSignature, ImFontAtlas* aAtlas);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Save:
+	/// 	Writes a built atlas to aPath. Returns true on success.
+	///----------------------------------------------------------------------------------------------------
+	bool Save(const std::filesystem::path& aPath, unsigned long long aSignature, ImFontAtlas* aAtlas);
+}
+
+#endif
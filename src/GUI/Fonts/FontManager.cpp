@@ -9,7 +9,11 @@
 #include "FontManager.h"
 
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
+#include "FontAtlasCache.h"
+#include "Index.h"
 #include "resource.h"
 #include "Shared.h"
 
@@ -17,9 +21,31 @@
 
 #include "Util/Resources.h"
 #include "Util/Strings.h"
+#include "Util/Time.h"
 
 const char* GetDefaultCompressedFontDataTTFBase85();
 
+static void HashBytes(unsigned long long& aHash, const void* aData, size_t aSize)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(aData);
+	for (size_t i = 0; i < aSize; i++)
+	{
+		aHash ^= bytes[i];
+		aHash *= 1099511628211ULL;
+	}
+}
+
+template <typename T>
+static void HashValue(unsigned long long& aHash, const T& aValue)
+{
+	HashBytes(aHash, &aValue, sizeof(T));
+}
+
+static long long GetMilliseconds()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 namespace FontManager
 {
 	void ADDONAPI_Get(const char* aIdentifier, FONTS_RECEIVECALLBACK aCallback)
@@ -73,6 +99,12 @@ namespace FontManager
 		CFontManager& inst = CFontManager::GetInstance();
 		inst.ResizeFont(aIdentifier, aFontSize);
 	}
+
+	void ADDONAPI_RequestGlyphs(const char* aText)
+	{
+		CFontManager& inst = CFontManager::GetInstance();
+		inst.RequestGlyphs(aText);
+	}
 }
 
 CFontManager& CFontManager::GetInstance()
@@ -81,6 +113,11 @@ CFontManager& CFontManager::GetInstance()
 	return Instance;
 }
 
+CFontManager::~CFontManager()
+{
+	this->Shutdown();
+}
+
 void CFontManager::Reload()
 {
 	this->IsFontAtlasBuilt = false;
@@ -88,50 +125,117 @@ void CFontManager::Reload()
 
 bool CFontManager::Advance()
 {
-	if (this->IsFontAtlasBuilt) { return false; }
+	/* a build is in flight, swap it in once it is done */
+	if (this->PendingBuild)
+	{
+		if (!this->PendingBuild->IsDone.load(std::memory_order_acquire)) { return false; }
 
-	this->NotifyCallbacks(true);
+		this->SwapAtlas();
+		return true;
+	}
 
-	ImGuiIO& io = ImGui::GetIO();
+	if (this->IsFontAtlasBuilt)
+	{
+		if (!this->AreGlyphsMissing.load(std::memory_order_acquire)) { return false; }
+
+		/* collect the glyphs of a few frames, e.g. of typed text, into one rebuild */
+		if (GetMilliseconds() - this->GlyphsMissingSince.load(std::memory_order_relaxed) < FONT_GLYPH_BATCH_DELAY) { return false; }
+	}
+
+	/* set state, further changes invalidate it again */
+	this->IsFontAtlasBuilt = true;
+
+	/* reset before the requests are folded in, later ones start a new batch */
+	this->AreGlyphsMissing.store(false, std::memory_order_relaxed);
 
-	/* add default ranges */
 	ImVector<ImWchar> ranges;
-	ImFontGlyphRangesBuilder rb{};
-	ImWchar rangesLatinExt[] =
+	this->BuildGlyphRanges(ranges);
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	unsigned long long signature = this->ComputeSignature(ranges);
+
+	/* same fonts, sizes and glyphs as the active atlas, nothing to do */
+	if (signature == this->Signature)
 	{
-		0x0100, 0x017F,
-		0x0180, 0x024F,
-		0,
-	};
-	rb.AddRanges(io.Fonts->GetGlyphRangesDefault());
-	rb.AddRanges(rangesLatinExt);
+		/* fonts added again since, e.g. released and re-added, still have to point into the active atlas */
+		if (this->ActiveBuild)
+		{
+			this->ResolveFonts(*this->ActiveBuild, true);
+		}
 
-	/* add ranges on demand*/
-	for (const char* str : Language->GetAllTexts())
+		this->Stats.Skipped++;
+		Logger->Trace(CH_FONTMANAGER, "Skipped font atlas rebuild, fonts and glyph ranges are unchanged.");
+		return false;
+	}
+
+	std::shared_ptr<FontAtlasBuild> build = std::make_shared<FontAtlasBuild>();
+	build->Atlas = IM_NEW(ImFontAtlas)();
+	build->Ranges.swap(ranges);
+	build->Signature = signature;
+	build->Duration = 0;
+	build->IsFromCache = false;
+	build->HasDynamicGlyphs = !this->DynamicGlyphs.empty();
+	build->IsDone.store(false, std::memory_order_relaxed);
+
+	for (auto& font : this->Registry)
 	{
-		rb.AddText(str);
+		/* released fonts without data */
+		if (!font.Data) { continue; }
+
+		/* copy the data, the atlas owns it and the registry may free its buffer while building */
+		void* data = IM_ALLOC(font.DataSize);
+		memcpy_s(data, font.DataSize, font.Data, font.DataSize);
+
+		ImFontConfig config = *font.Config;
+		config.FontData = data;
+		config.FontDataSize = static_cast<int>(font.DataSize);
+		config.FontDataOwnedByAtlas = true;
+		config.SizePixels = font.Size;
+		config.GlyphRanges = build->Ranges.Data;
+
+		build->Identifiers.push_back(font.Identifier);
+		build->Fonts.push_back(build->Atlas->AddFont(&config));
 	}
 
-	/* build ranges */
-	rb.BuildRanges(&ranges);
+	this->Signature = signature;
+	this->PendingBuild = build;
 
-	io.Fonts->Clear();
+	/* the previous build is done, it was swapped in before this one could start */
+	if (this->BuildThread.joinable())
+	{
+		this->BuildThread.join();
+	}
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
-	for (auto& font : this->Registry)
+	this->BuildThread = std::thread(CFontManager::BuildAtlas, build);
+
+	return false;
+}
+
+bool CFontManager::IsBuilding()
+{
+	return this->PendingBuild != nullptr;
+}
+
+void CFontManager::Shutdown()
+{
+	if (this->BuildThread.joinable())
 	{
-		font.Pointer = io.Fonts->AddFontFromMemoryTTF(font.Data, static_cast<int>(font.DataSize), font.Size, font.Config, ranges.Data);
+		this->BuildThread.join();
 	}
 
-	/* finally build atlas */
-	io.Fonts->Build();
+	if (this->PendingBuild)
+	{
+		IM_DELETE(this->PendingBuild->Atlas);
+		this->PendingBuild = nullptr;
+	}
+}
 
-	/* set state */
-	this->IsFontAtlasBuilt = true;
+FontAtlasStats CFontManager::GetStats()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
 
-	/* finally notify all callbacks with the new fonts */
-	this->NotifyCallbacks();
-	return true;
+	return this->Stats;
 }
 
 ManagedFont* CFontManager::Get(const char* aIdentifier)
@@ -321,6 +425,9 @@ void CFontManager::ReplaceFont(const char* aIdentifier, float aFontSize, const c
 		ManagedFont font = this->CreateManagedFont(aIdentifier, aFontSize, buffer, size, aConfig);
 		font.Subscribers = oldFont.Subscribers;
 
+		/* keeps pointing into the active atlas until the rebuilt one is swapped in, or if the rebuild is skipped */
+		font.Pointer = oldFont.Pointer;
+
 		*it = font;
 
 		this->IsFontAtlasBuilt = false;
@@ -377,6 +484,9 @@ void CFontManager::ReplaceFont(const char* aIdentifier, float aFontSize, unsigne
 		ManagedFont font = this->CreateManagedFont(aIdentifier, aFontSize, buffer, size, aConfig);
 		font.Subscribers = oldFont.Subscribers;
 
+		/* keeps pointing into the active atlas until the rebuilt one is swapped in, or if the rebuild is skipped */
+		font.Pointer = oldFont.Pointer;
+
 		*it = font;
 
 		this->IsFontAtlasBuilt = false;
@@ -423,6 +533,9 @@ void CFontManager::ReplaceFont(const char* aIdentifier, float aFontSize, void* a
 		ManagedFont font = this->CreateManagedFont(aIdentifier, aFontSize, aData, aSize, aConfig);
 		font.Subscribers = oldFont.Subscribers;
 
+		/* keeps pointing into the active atlas until the rebuilt one is swapped in, or if the rebuild is skipped */
+		font.Pointer = oldFont.Pointer;
+
 		*it = font;
 
 		this->IsFontAtlasBuilt = false;
@@ -544,6 +657,296 @@ void CFontManager::AddFontInternal(const char* aIdentifier, float aFontSize, voi
 	this->IsFontAtlasBuilt = false;
 }
 
+void CFontManager::BuildGlyphRanges(ImVector<ImWchar>& aOutRanges)
+{
+	ImGuiIO& io = ImGui::GetIO();
+
+	/* add default ranges */
+	ImFontGlyphRangesBuilder rb{};
+	ImWchar rangesLatinExt[] =
+	{
+		0x0100, 0x017F,
+		0x0180, 0x024F,
+		0,
+	};
+	rb.AddRanges(io.Fonts->GetGlyphRangesDefault());
+	rb.AddRanges(rangesLatinExt);
+
+	/* add ranges of the active locale, other locales are only baked once used */
+	for (const char* str : Language->GetActiveTexts())
+	{
+		rb.AddText(str);
+	}
+
+	/* fold the glyphs requested since the last build into the on-demand set */
+	long long now = Time::GetTimestamp();
+	for (size_t i = 0; i < FONT_GLYPH_WORDS; i++)
+	{
+		unsigned bits = this->RequestedGlyphs[i].exchange(0, std::memory_order_relaxed);
+
+		for (unsigned bit = 0; bits != 0; bit++, bits >>= 1)
+		{
+			if (!(bits & 1)) { continue; }
+
+			ImWchar codepoint = static_cast<ImWchar>(i * 32 + bit);
+
+			/* already part of the fixed ranges */
+			if (rb.GetBit(codepoint)) { continue; }
+
+			this->DynamicGlyphs[codepoint] = now;
+		}
+	}
+
+	/* evict glyphs that were not requested for a while */
+	unsigned evicted = 0;
+	for (auto it = this->DynamicGlyphs.begin(); it != this->DynamicGlyphs.end();)
+	{
+		if (now - it->second > FONT_GLYPH_EVICT_AFTER)
+		{
+			it = this->DynamicGlyphs.erase(it);
+			evicted++;
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	/* still too many, drop the least recently used ones */
+	if (this->DynamicGlyphs.size() > FONT_GLYPH_DYNAMIC_MAX)
+	{
+		std::vector<std::pair<long long, ImWchar>> byAge;
+		byAge.reserve(this->DynamicGlyphs.size());
+		for (auto& [codepoint, lastUse] : this->DynamicGlyphs)
+		{
+			byAge.push_back({ lastUse, codepoint });
+		}
+
+		size_t excess = this->DynamicGlyphs.size() - FONT_GLYPH_DYNAMIC_MAX;
+		std::nth_element(byAge.begin(), byAge.begin() + excess, byAge.end());
+
+		for (size_t i = 0; i < excess; i++)
+		{
+			this->DynamicGlyphs.erase(byAge[i].second);
+			evicted++;
+		}
+	}
+
+	for (auto& [codepoint, lastUse] : this->DynamicGlyphs)
+	{
+		rb.AddChar(codepoint);
+	}
+
+	/* build ranges */
+	rb.BuildRanges(&aOutRanges);
+
+	/* publish the baked codepoints, so requests only flag missing ones */
+	for (size_t i = 0; i < FONT_GLYPH_WORDS; i++)
+	{
+		this->AtlasGlyphs[i].store(rb.UsedChars[static_cast<int>(i)], std::memory_order_relaxed);
+	}
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+	this->Stats.DynamicGlyphs = static_cast<unsigned>(this->DynamicGlyphs.size());
+	this->Stats.EvictedGlyphs += evicted;
+}
+
+void CFontManager::RequestGlyphs(const char* aText)
+{
+	if (!aText) { return; }
+
+	bool isMissing = false;
+
+	const char* end = aText + strlen(aText);
+	for (const char* p = aText; p < end;)
+	{
+		unsigned int codepoint = 0;
+		p += ImTextCharFromUtf8(&codepoint, p, end);
+
+		isMissing |= this->MarkGlyph(codepoint);
+	}
+
+	if (isMissing)
+	{
+		this->OnGlyphsMissing();
+	}
+}
+
+void CFontManager::RequestGlyphs(const ImWchar* aCodepoints, int aCount)
+{
+	if (!aCodepoints) { return; }
+
+	bool isMissing = false;
+
+	for (int i = 0; i < aCount; i++)
+	{
+		isMissing |= this->MarkGlyph(aCodepoints[i]);
+	}
+
+	if (isMissing)
+	{
+		this->OnGlyphsMissing();
+	}
+}
+
+unsigned long long CFontManager::ComputeSignature(const ImVector<ImWchar>& aRanges)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (auto& font : this->Registry)
+	{
+		if (!font.Data) { continue; }
+
+		HashBytes(hash, font.Identifier.c_str(), font.Identifier.length() + 1);
+		HashValue(hash, font.Size);
+		HashValue(hash, font.DataSize);
+		HashValue(hash, font.DataHash);
+
+		/* only the members affecting rasterization, the rest are pointers or set by the atlas */
+		const ImFontConfig* config = font.Config;
+		HashValue(hash, config->FontNo);
+		HashValue(hash, config->OversampleH);
+		HashValue(hash, config->OversampleV);
+		HashValue(hash, config->PixelSnapH);
+		HashValue(hash, config->GlyphExtraSpacing.x);
+		HashValue(hash, config->GlyphExtraSpacing.y);
+		HashValue(hash, config->GlyphOffset.x);
+		HashValue(hash, config->GlyphOffset.y);
+		HashValue(hash, config->GlyphMinAdvanceX);
+		HashValue(hash, config->GlyphMaxAdvanceX);
+		HashValue(hash, config->MergeMode);
+		HashValue(hash, config->RasterizerFlags);
+		HashValue(hash, config->RasterizerMultiply);
+		HashValue(hash, config->EllipsisChar);
+	}
+
+	HashBytes(hash, aRanges.Data, aRanges.size_in_bytes());
+
+	return hash;
+}
+
+void CFontManager::SwapAtlas()
+{
+	std::shared_ptr<FontAtlasBuild> build = this->PendingBuild;
+	this->PendingBuild = nullptr;
+
+	ImGuiIO& io = ImGui::GetIO();
+
+	/* the context owns io.Fonts and deletes whatever atlas is set on destruction */
+	ImFontAtlas* previous = io.Fonts;
+	io.Fonts = build->Atlas;
+	build->Atlas = nullptr;
+
+	/* the default font pointed into the previous atlas, receivers set it again */
+	io.FontDefault = nullptr;
+
+	IM_DELETE(previous);
+
+	/* keep the ranges alive with the atlas, the previous ones are released with the build */
+	this->Ranges.swap(build->Ranges);
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->ResolveFonts(*build, false);
+	this->ActiveBuild = build;
+
+	this->Stats.Builds++;
+	if (build->IsFromCache) { this->Stats.CacheHits++; }
+	this->Stats.LastDuration = build->Duration;
+	this->Stats.TotalDuration += build->Duration;
+
+	Logger->Debug(CH_FONTMANAGER, "%s font atlas with %u fonts and %d glyph ranges. (Took %lldms.)",
+		build->IsFromCache ? "Loaded cached" : "Built",
+		static_cast<unsigned>(build->Fonts.size()), this->Ranges.Size / 2, build->Duration / 1000);
+
+	/* finally notify all callbacks with the new fonts */
+	this->NotifyCallbacks();
+}
+
+void CFontManager::ResolveFonts(const FontAtlasBuild& aBuild, bool aOnlyMissing)
+{
+	for (auto& font : this->Registry)
+	{
+		if (aOnlyMissing && font.Pointer) { continue; }
+
+		font.Pointer = nullptr;
+
+		for (size_t i = 0; i < aBuild.Identifiers.size(); i++)
+		{
+			if (aBuild.Identifiers[i] == font.Identifier)
+			{
+				font.Pointer = aBuild.Fonts[i];
+				break;
+			}
+		}
+
+		if (!aOnlyMissing || !font.Pointer) { continue; }
+
+		for (FONTS_RECEIVECALLBACK callback : font.Subscribers)
+		{
+			callback(font.Identifier.c_str(), font.Pointer);
+		}
+	}
+}
+
+void CFontManager::BuildAtlas(std::shared_ptr<FontAtlasBuild> aBuild)
+{
+	auto start_time = std::chrono::high_resolution_clock::now();
+
+	/* an empty atlas gets the default font added, which would never match the cache */
+	bool isCacheable = aBuild->Atlas->ConfigData.Size > 0 && !aBuild->HasDynamicGlyphs;
+
+	if (isCacheable)
+	{
+		aBuild->IsFromCache = FontAtlasCache::Load(Index::F_FONTATLASCACHE, aBuild->Signature, aBuild->Atlas);
+	}
+
+	/* builds the atlas and converts it to RGBA here, otherwise the renderer does it when creating the texture */
+	unsigned char* pixels = nullptr;
+	int width = 0;
+	int height = 0;
+	aBuild->Atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+	if (isCacheable && !aBuild->IsFromCache)
+	{
+		if (!FontAtlasCache::Save(Index::F_FONTATLASCACHE, aBuild->Signature, aBuild->Atlas))
+		{
+			Logger->Warning(CH_FONTMANAGER, "Failed to write font atlas cache.");
+		}
+	}
+
+	auto end_time = std::chrono::high_resolution_clock::now();
+	aBuild->Duration = (end_time - start_time) / std::chrono::microseconds(1);
+
+	aBuild->IsDone.store(true, std::memory_order_release);
+}
+
+bool CFontManager::MarkGlyph(unsigned aCodepoint)
+{
+	if (aCodepoint == 0 || aCodepoint > IM_UNICODE_CODEPOINT_MAX) { return false; }
+
+	size_t word = aCodepoint >> 5;
+	unsigned mask = 1u << (aCodepoint & 31);
+
+	/* mark as used, this keeps it from being evicted */
+	if (!(this->RequestedGlyphs[word].load(std::memory_order_relaxed) & mask))
+	{
+		this->RequestedGlyphs[word].fetch_or(mask, std::memory_order_relaxed);
+	}
+
+	return !(this->AtlasGlyphs[word].load(std::memory_order_relaxed) & mask);
+}
+
+void CFontManager::OnGlyphsMissing()
+{
+	/* the first missing glyph starts the batch */
+	if (!this->AreGlyphsMissing.load(std::memory_order_relaxed))
+	{
+		this->GlyphsMissingSince.store(GetMilliseconds(), std::memory_order_relaxed);
+		this->AreGlyphsMissing.store(true, std::memory_order_release);
+	}
+}
+
 void CFontManager::NotifyCallbacks(bool aNotifyNull)
 {
 	for (auto const& font : this->Registry)
@@ -568,6 +971,10 @@ ManagedFont CFontManager::CreateManagedFont(std::string aIdentifier, float aFont
 	font.Data = buffer;
 	font.DataSize = aSize;
 
+	/* hash the data once, so atlas signatures are cheap */
+	font.DataHash = 14695981039346656037ULL;
+	HashBytes(font.DataHash, buffer, aSize);
+
 	/* allocate font config */
 	ImFontConfig* config = new ImFontConfig();
 	if (aConfig)
@@ -10,8 +10,12 @@
 #define FONTMANAGER_H
 
 #include <Windows.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "FuncDefs.h"
@@ -20,6 +24,11 @@
 
 constexpr const char* CH_FONTMANAGER = "CFontManager";
 
+constexpr size_t	FONT_GLYPH_WORDS		= (IM_UNICODE_CODEPOINT_MAX + 1) / 32;	/* one bit per codepoint */
+constexpr long long	FONT_GLYPH_EVICT_AFTER	= 300;									/* seconds an unused on-demand glyph is kept */
+constexpr size_t	FONT_GLYPH_DYNAMIC_MAX	= 4096;									/* most on-demand glyphs baked at once */
+constexpr long long	FONT_GLYPH_BATCH_DELAY	= 250;									/* milliseconds missing glyphs are collected before a rebuild */
+
 ///----------------------------------------------------------------------------------------------------
 /// ManagedFont Struct
 ///----------------------------------------------------------------------------------------------------
@@ -31,9 +40,41 @@ struct ManagedFont
 	float								Size;
 	void*								Data;
 	size_t								DataSize;
+	unsigned long long					DataHash;
 	ImFontConfig*						Config;
 };
 
+///----------------------------------------------------------------------------------------------------
+/// FontAtlasBuild Struct
+/// 	A font atlas built off the render thread. Owns copies of the font data.
+///----------------------------------------------------------------------------------------------------
+struct FontAtlasBuild
+{
+	ImFontAtlas*						Atlas;
+	ImVector<ImWchar>					Ranges;
+	std::vector<std::string>			Identifiers;
+	std::vector<ImFont*>				Fonts;
+	unsigned long long					Signature;
+	long long							Duration;
+	bool								IsFromCache;
+	bool								HasDynamicGlyphs;	/* not cached, they are not requested again at startup */
+	std::atomic<bool>					IsDone;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// FontAtlasStats Struct
+///----------------------------------------------------------------------------------------------------
+struct FontAtlasStats
+{
+	unsigned							Builds;
+	unsigned							Skipped;
+	unsigned							CacheHits;
+	unsigned							DynamicGlyphs;
+	unsigned							EvictedGlyphs;
+	long long							LastDuration;	/* in microseconds */
+	long long							TotalDuration;	/* in microseconds */
+};
+
 ///----------------------------------------------------------------------------------------------------
 /// FontManager Namespace
 ///----------------------------------------------------------------------------------------------------
@@ -80,6 +121,12 @@ namespace FontManager
 	/// 	Changes the size of a given font.
 	///----------------------------------------------------------------------------------------------------
 	void ADDONAPI_ResizeFont(const char* aIdentifier, float aFontSize);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_RequestGlyphs:
+	/// 	Addon API wrapper to make sure the glyphs of a UTF-8 string are baked into the atlas.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_RequestGlyphs(const char* aText);
 }
 
 ///----------------------------------------------------------------------------------------------------
@@ -102,10 +149,29 @@ public:
 
 	///----------------------------------------------------------------------------------------------------
 	/// Advance:
-	/// 	Processes fonts and notifies callbacks.
+	/// 	Starts a background atlas build if the fonts changed and swaps in a finished one.
+	/// 	Returns true if a new atlas was swapped in and callbacks were notified.
 	///----------------------------------------------------------------------------------------------------
 	bool Advance();
 
+	///----------------------------------------------------------------------------------------------------
+	/// IsBuilding:
+	/// 	Returns true if an atlas is currently being built in the background.
+	///----------------------------------------------------------------------------------------------------
+	bool IsBuilding();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Shutdown:
+	/// 	Waits for a background atlas build and discards it.
+	///----------------------------------------------------------------------------------------------------
+	void Shutdown();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStats:
+	/// 	Returns the atlas build statistics.
+	///----------------------------------------------------------------------------------------------------
+	FontAtlasStats GetStats();
+
 	///----------------------------------------------------------------------------------------------------
 	/// Get:
 	/// 	Returns a font if it exists or nullptr.
@@ -166,6 +232,20 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	void ResizeFont(const char* aIdentifier, float aFontSize);
 
+	///----------------------------------------------------------------------------------------------------
+	/// RequestGlyphs:
+	/// 	Marks the codepoints of a UTF-8 string as used. Missing ones are collected for FONT_GLYPH_BATCH_DELAY
+	/// 	and then baked with one atlas build, glyphs that are not requested anymore are evicted on later builds.
+	/// 	Lock-free unless a glyph is missing.
+	///----------------------------------------------------------------------------------------------------
+	void RequestGlyphs(const char* aText);
+
+	///----------------------------------------------------------------------------------------------------
+	/// RequestGlyphs:
+	/// 	Marks the given codepoints as used.
+	///----------------------------------------------------------------------------------------------------
+	void RequestGlyphs(const ImWchar* aCodepoints, int aCount);
+
 	///----------------------------------------------------------------------------------------------------
 	/// Verify:
 	/// 	Removes all unreleased references in the given address space.
@@ -178,7 +258,20 @@ public:
 private:
 	std::mutex					Mutex;
 	std::vector<ManagedFont>	Registry;
-	bool						IsFontAtlasBuilt = false;
+	std::atomic<bool>			IsFontAtlasBuilt{ false };
+
+	std::shared_ptr<FontAtlasBuild>	PendingBuild;
+	std::shared_ptr<FontAtlasBuild>	ActiveBuild;		/* fonts of the active atlas, its atlas is owned by ImGui */
+	std::thread						BuildThread;
+	ImVector<ImWchar>				Ranges;				/* glyph ranges of the active atlas, have to outlive it */
+	unsigned long long				Signature = 0;		/* signature of the active or pending atlas */
+	FontAtlasStats					Stats{};
+
+	std::atomic<unsigned>					AtlasGlyphs[FONT_GLYPH_WORDS]{};		/* codepoints of the active or pending atlas */
+	std::atomic<unsigned>					RequestedGlyphs[FONT_GLYPH_WORDS]{};	/* codepoints requested since the last build */
+	std::atomic<bool>						AreGlyphsMissing{ false };				/* requested glyphs wait for a rebuild */
+	std::atomic<long long>					GlyphsMissingSince{ 0 };				/* milliseconds, time of the first missing glyph */
+	std::unordered_map<ImWchar, long long>	DynamicGlyphs;							/* on-demand codepoint to last use */
 
 	///----------------------------------------------------------------------------------------------------
 	/// ctor
@@ -187,7 +280,7 @@ private:
 	///----------------------------------------------------------------------------------------------------
 	/// dtor
 	///----------------------------------------------------------------------------------------------------
-	~CFontManager() = default;
+	~CFontManager();
 
 	///----------------------------------------------------------------------------------------------------
 	/// AddFontInternal:
@@ -195,6 +288,51 @@ private:
 	///----------------------------------------------------------------------------------------------------
 	void AddFontInternal(const char* aIdentifier, float aFontSize, void* aData, size_t aSize, FONTS_RECEIVECALLBACK aCallback, ImFontConfig* aConfig);
 
+	///----------------------------------------------------------------------------------------------------
+	/// BuildGlyphRanges:
+	/// 	Builds the glyph ranges for the default ranges, the texts of the active locale and the
+	/// 	on-demand glyphs. Evicts on-demand glyphs that were not requested for a while.
+	///----------------------------------------------------------------------------------------------------
+	void BuildGlyphRanges(ImVector<ImWchar>& aOutRanges);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ComputeSignature:
+	/// 	Hashes the registered fonts, their sizes and configs as well as the glyph ranges.
+	/// 	Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	unsigned long long ComputeSignature(const ImVector<ImWchar>& aRanges);
+
+	///----------------------------------------------------------------------------------------------------
+	/// SwapAtlas:
+	/// 	Replaces the active atlas with the finished pending build.
+	///----------------------------------------------------------------------------------------------------
+	void SwapAtlas();
+
+	///----------------------------------------------------------------------------------------------------
+	/// ResolveFonts:
+	/// 	Points the registered fonts into the atlas of the build. Has to be called while holding the Mutex.
+	/// 	aOnlyMissing keeps the resolved fonts and notifies the subscribers of the newly resolved ones.
+	///----------------------------------------------------------------------------------------------------
+	void ResolveFonts(const FontAtlasBuild& aBuild, bool aOnlyMissing);
+
+	///----------------------------------------------------------------------------------------------------
+	/// BuildAtlas:
+	/// 	Rasterizes the atlas of a build. Runs on a worker thread.
+	///----------------------------------------------------------------------------------------------------
+	static void BuildAtlas(std::shared_ptr<FontAtlasBuild> aBuild);
+
+	///----------------------------------------------------------------------------------------------------
+	/// MarkGlyph:
+	/// 	Marks a codepoint as requested. Returns true if it is not part of the atlas.
+	///----------------------------------------------------------------------------------------------------
+	bool MarkGlyph(unsigned aCodepoint);
+
+	///----------------------------------------------------------------------------------------------------
+	/// OnGlyphsMissing:
+	/// 	Schedules a rebuild for the missing glyphs, after FONT_GLYPH_BATCH_DELAY.
+	///----------------------------------------------------------------------------------------------------
+	void OnGlyphsMissing();
+
 	///----------------------------------------------------------------------------------------------------
 	/// NotifyCallbacks:
 	/// 	Notifies all callbacks with the new font.
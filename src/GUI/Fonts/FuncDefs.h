@@ -11,5 +11,6 @@ typedef void (*FONTS_ADDFROMFILE)(const char* aIdentifier, float aFontSize, cons
 typedef void (*FONTS_ADDFROMRESOURCE)(const char* aIdentifier, float aFontSize, unsigned aResourceID, HMODULE aModule, FONTS_RECEIVECALLBACK aCallback, ImFontConfig* aConfig);
 typedef void (*FONTS_ADDFROMMEMORY)(const char* aIdentifier, float aFontSize, void* aData, size_t aSize, FONTS_RECEIVECALLBACK aCallback, ImFontConfig* aConfig);
 typedef void (*FONTS_RESIZE)(const char* aIdentifier, float aFontSize);
+typedef void (*FONTS_REQUESTGLYPHS)(const char* aText);
 
 #endif
@@ -36,6 +36,7 @@
 #include "Util/Base64.h"
 #include "Util/Inputs.h"
 #include "Util/Resources.h"
+#include "Util/Strings.h"
 #include "Util/Time.h"
 
 #ifndef STRINGIFY
@@ -70,12 +71,11 @@ namespace GUI
 	NexusLinkData*							NexusLink					= nullptr;
 
 	std::mutex								Mutex;
-	std::vector<GUI_RENDER>					RegistryPreRender;
-	std::vector<GUI_RENDER>					RegistryRender;
-	std::vector<GUI_RENDER>					RegistryPostRender;
-	std::vector<GUI_RENDER>					RegistryOptionsRender;
+	CRenderRegistry							RenderRegistry;
 	std::unordered_map<std::string, bool*>	RegistryCloseOnEscape;
 
+	CRenderBudget							RenderBudget;
+
 	std::map<EFont, ImFont*>				FontIndex;
 	std::string								FontFile;
 	float									FontSize					= 16.0f;
@@ -267,6 +267,36 @@ namespace GUI
 		return 1;
 	}
 
+	void RunRenderCallbacks(const std::vector<GUI_RENDER>& aRegistry, ECallbackType aType)
+	{
+		for (GUI_RENDER callback : aRegistry)
+		{
+			if (!callback || !RenderBudget.ShouldRender((void*)callback)) { continue; }
+
+			long long start = CCallbackWatchdog::Now();
+			callback();
+			long long time = CCallbackWatchdog::Now() - start;
+
+			CallbackWatchdog->Record(aType, (void*)callback, time);
+			RenderBudget.Record((void*)callback, time);
+		}
+	}
+
+	void OnRenderThrottled(const RenderThrottleData& aChange)
+	{
+		std::string name = RenderBudget.GetOwnerName(aChange.Signature);
+
+		Logger->Info(CH_CORE, "Render interval of \"%s\" changed to %d (%.2fms per frame).", name.c_str(), aChange.Interval, aChange.Cost);
+
+		if (aChange.Interval > 1)
+		{
+			Alerts::Notify(String::Format("\"%s\" exceeded its render budget and is rendered every %d frames.", name.c_str(), aChange.Interval).c_str());
+		}
+
+		/* queued, subscribers might call back into the GUI which is locked while rendering */
+		EventApi->RaiseQueued(aChange.Signature, EV_RENDER_THROTTLED, &aChange, sizeof(aChange));
+	}
+
 	void Render()
 	{
 		const std::lock_guard<std::mutex> lock(GUI::Mutex);
@@ -282,28 +312,39 @@ namespace GUI
 		}
 
 		/* pre-render callbacks */
-		for (GUI_RENDER callback : RegistryPreRender)
-		{
-			if (callback) { callback(); }
-		}
+		/* the registry is not locked, callbacks may register or deregister from within */
+		const RenderCallbacks* callbacks = RenderRegistry.BeginFrame();
+
+		RunRenderCallbacks(callbacks->PreRender, ECallbackType::PreRender);
 		/* pre-render callbacks end*/
 
 		if (State::IsImGuiInitialized)
 		{
+			/* typed characters, e.g. from an IME, might not be part of the atlas yet */
+			ImGuiIO& io = ImGui::GetIO();
+			if (!io.InputQueueCharacters.empty())
+			{
+				FontManager.RequestGlyphs(io.InputQueueCharacters.Data, io.InputQueueCharacters.Size);
+			}
+
 			/* new frame */
 			ImGui_ImplWin32_NewFrame();
 			ImGui_ImplDX11_NewFrame();
 			ImGui::NewFrame();
 			/* new frame end */
 
+			/* InputBind handlers that need ImGui */
+			InputBindApi->ProcessRenderQueue();
+
+			/* queued events for subscribers on the render thread */
+			EventApi->ProcessRenderQueue();
+			EventApi->SampleMetrics();
+
 			/* draw overlay */
 			if (IsUIVisible)
 			{
 				/* draw addons*/
-				for (GUI_RENDER callback : RegistryRender)
-				{
-					if (callback) { callback(); }
-				}
+				RunRenderCallbacks(callbacks->Render, ECallbackType::Render);
 				/* draw addons end*/
 
 				/* draw nexus windows */
@@ -350,11 +391,15 @@ namespace GUI
 		}
 
 		/* post-render callbacks */
-		for (GUI_RENDER callback : RegistryPostRender)
+		RunRenderCallbacks(callbacks->PostRender, ECallbackType::PostRender);
+		/* post-render callbacks end*/
+
+		RenderRegistry.EndFrame();
+
+		for (const RenderThrottleData& change : RenderBudget.EndFrame())
 		{
-			if (callback) { callback(); }
+			OnRenderThrottled(change);
 		}
-		/* post-render callbacks end*/
 	}
 
 	void ImportArcDPSStyle()
@@ -885,6 +930,40 @@ namespace GUI
 				Settings::Settings[OPT_SHOWADDONSWINDOWAFTERDUU] = false;
 			}
 
+			bool renderBudget = false;
+			float renderBudgetAddon = 0.0f;
+			float renderBudgetTotal = 0.0f;
+
+			if (!Settings::Settings[OPT_RENDERBUDGET].is_null())
+			{
+				Settings::Settings[OPT_RENDERBUDGET].get_to(renderBudget);
+			}
+			else
+			{
+				Settings::Settings[OPT_RENDERBUDGET] = false;
+			}
+
+			if (!Settings::Settings[OPT_RENDERBUDGETADDON].is_null())
+			{
+				Settings::Settings[OPT_RENDERBUDGETADDON].get_to(renderBudgetAddon);
+			}
+			else
+			{
+				Settings::Settings[OPT_RENDERBUDGETADDON] = 0.0f;
+			}
+
+			if (!Settings::Settings[OPT_RENDERBUDGETTOTAL].is_null())
+			{
+				Settings::Settings[OPT_RENDERBUDGETTOTAL].get_to(renderBudgetTotal);
+			}
+			else
+			{
+				Settings::Settings[OPT_RENDERBUDGETTOTAL] = 0.0f;
+			}
+
+			RenderBudget.SetEnabled(renderBudget);
+			RenderBudget.SetBudgets(renderBudgetAddon, renderBudgetTotal);
+
 			Renderer::Scaling = LastScaling * io.FontGlobalScale;
 		}
 
@@ -936,6 +1015,12 @@ namespace GUI
 		InputBindApi->Register(KB_MUMBLEOVERLAY, EIBHType::DownOnly, ProcessInputBind, NULLSTR);
 		InputBindApi->Register(KB_TOGGLEHIDEUI, EIBHType::DownOnly, ProcessInputBind, "CTRL+H");
 
+		/* the handlers toggle window states, keep them on the render thread */
+		for (const char* identifier : { KB_MENU, KB_ADDONS, KB_OPTIONS, KB_LOG, KB_DEBUG, KB_MUMBLEOVERLAY, KB_TOGGLEHIDEUI })
+		{
+			InputBindApi->SetExecution(identifier, EIBExecution::RenderThread);
+		}
+
 		/* load icons */
 		int month = Time::GetMonth();
 
@@ -976,34 +1061,11 @@ namespace GUI
 
 	void Register(ERenderType aRenderType, GUI_RENDER aRenderCallback)
 	{
-		if (!aRenderCallback) { return; }
-
-		const std::lock_guard<std::mutex> lock(Mutex);
-
-		switch (aRenderType)
-		{
-		case ERenderType::PreRender:
-			RegistryPreRender.push_back(aRenderCallback);
-			break;
-		case ERenderType::Render:
-			RegistryRender.push_back(aRenderCallback);
-			break;
-		case ERenderType::PostRender:
-			RegistryPostRender.push_back(aRenderCallback);
-			break;
-		case ERenderType::OptionsRender:
-			RegistryOptionsRender.push_back(aRenderCallback);
-			break;
-		}
+		RenderRegistry.Register(aRenderType, aRenderCallback);
 	}
 	void Deregister(GUI_RENDER aRenderCallback)
 	{
-		const std::lock_guard<std::mutex> lock(Mutex);
-
-		RegistryPreRender.erase(std::remove(RegistryPreRender.begin(), RegistryPreRender.end(), aRenderCallback), RegistryPreRender.end());
-		RegistryRender.erase(std::remove(RegistryRender.begin(), RegistryRender.end(), aRenderCallback), RegistryRender.end());
-		RegistryPostRender.erase(std::remove(RegistryPostRender.begin(), RegistryPostRender.end(), aRenderCallback), RegistryPostRender.end());
-		RegistryOptionsRender.erase(std::remove(RegistryOptionsRender.begin(), RegistryOptionsRender.end(), aRenderCallback), RegistryOptionsRender.end());
+		RenderRegistry.Deregister(aRenderCallback);
 	}
 
 	void RegisterCloseOnEscape(const char* aWindowName, bool* aIsVisible)
@@ -1023,39 +1085,10 @@ namespace GUI
 	{
 		int refCounter = 0;
 
+		/* waits for the current frame, so it has to happen before locking the GUI */
+		refCounter += RenderRegistry.Verify(aStartAddress, aEndAddress);
+
 		const std::lock_guard<std::mutex> lock(Mutex);
-		for (GUI_RENDER renderCb : RegistryPreRender)
-		{
-			if (renderCb >= aStartAddress && renderCb <= aEndAddress)
-			{
-				RegistryPreRender.erase(std::remove(RegistryPreRender.begin(), RegistryPreRender.end(), renderCb), RegistryPreRender.end());
-				refCounter++;
-			}
-		}
-		for (GUI_RENDER renderCb : RegistryRender)
-		{
-			if (renderCb >= aStartAddress && renderCb <= aEndAddress)
-			{
-				RegistryRender.erase(std::remove(RegistryRender.begin(), RegistryRender.end(), renderCb), RegistryRender.end());
-				refCounter++;
-			}
-		}
-		for (GUI_RENDER renderCb : RegistryPostRender)
-		{
-			if (renderCb >= aStartAddress && renderCb <= aEndAddress)
-			{
-				RegistryPostRender.erase(std::remove(RegistryPostRender.begin(), RegistryPostRender.end(), renderCb), RegistryPostRender.end());
-				refCounter++;
-			}
-		}
-		for (GUI_RENDER renderCb : RegistryOptionsRender)
-		{
-			if (renderCb >= aStartAddress && renderCb <= aEndAddress)
-			{
-				RegistryOptionsRender.erase(std::remove(RegistryOptionsRender.begin(), RegistryOptionsRender.end(), renderCb), RegistryOptionsRender.end());
-				refCounter++;
-			}
-		}
 		for (auto& [windowname, boolptr] : RegistryCloseOnEscape)
 		{
 			if (boolptr >= aStartAddress && boolptr <= aEndAddress)
@@ -1067,6 +1100,8 @@ namespace GUI
 
 		FontManager.Verify(aStartAddress, aEndAddress);
 
+		RenderBudget.Reset(aStartAddress, aEndAddress);
+
 		return refCounter;
 	}
 }
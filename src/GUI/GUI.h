@@ -12,6 +12,8 @@
 #include "IWindow.h"
 #include "EFontIdentifier.h"
 #include "Fonts/FontManager.h"
+#include "RenderBudget.h"
+#include "RenderRegistry.h"
 
 #include "imgui/imgui.h"
 
@@ -42,12 +44,11 @@ namespace GUI
 	extern NexusLinkData*							NexusLink;
 
 	extern std::mutex								Mutex;
-	extern std::vector<GUI_RENDER>					RegistryPreRender;
-	extern std::vector<GUI_RENDER>					RegistryRender;
-	extern std::vector<GUI_RENDER>					RegistryPostRender;
-	extern std::vector<GUI_RENDER>					RegistryOptionsRender;
+	extern CRenderRegistry							RenderRegistry;
 	extern std::unordered_map<std::string, bool*>	RegistryCloseOnEscape;
 
+	extern CRenderBudget							RenderBudget;
+
 	extern std::map<EFont, ImFont*>					FontIndex;
 	extern std::string								FontFile;
 	extern float									FontSize;
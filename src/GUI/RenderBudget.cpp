@@ -0,0 +1,287 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderBudget.cpp
+/// Description  :  Tracks the render cost per addon and throttles addons that exceed their budget.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "RenderBudget.h"
+
+#include <Windows.h>
+#include <algorithm>
+#include <cmath>
+
+#include "Consts.h"
+#include "Loader/Loader.h"
+
+void CRenderBudget::SetEnabled(bool aEnabled)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->IsEnforcing = aEnabled;
+	this->Frame = 0; /* evaluate on the next frame */
+}
+
+bool CRenderBudget::IsEnabled() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->IsEnforcing;
+}
+
+void CRenderBudget::SetBudgets(float aAddonBudget, float aTotalBudget)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->AddonBudget = aAddonBudget > 0 ? static_cast<long long>(aAddonBudget * 1000000.0f) : 0;
+	this->TotalBudget = aTotalBudget > 0 ? static_cast<long long>(aTotalBudget * 1000000.0f) : 0;
+	this->Frame = 0; /* evaluate on the next frame */
+}
+
+float CRenderBudget::GetAddonBudget() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->AddonBudget / 1000000.0f;
+}
+
+float CRenderBudget::GetTotalBudget() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->TotalBudget / 1000000.0f;
+}
+
+bool CRenderBudget::ShouldRender(void* aCallback)
+{
+	if (!this->IsThrottling.load(std::memory_order_relaxed)) { return true; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	int idx = this->GetOwner(aCallback);
+
+	if (idx < 0) { return true; }
+
+	Owner& owner = this->Owners[idx];
+
+	if (owner.Interval == 1) { return true; }
+
+	/* offset by the owner, so throttled addons don't all render on the same frame */
+	return (this->Frame + idx) % owner.Interval == 0;
+}
+
+void CRenderBudget::Record(void* aCallback, long long aTime)
+{
+	if (!this->IsEnforcing.load(std::memory_order_relaxed)) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	int idx = this->GetOwner(aCallback);
+
+	if (idx < 0) { return; }
+
+	this->Owners[idx].FrameCost += aTime;
+	this->Owners[idx].IsRendered = true;
+}
+
+std::vector<RenderThrottleData> CRenderBudget::EndFrame()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (Owner& owner : this->Owners)
+	{
+		if (owner.IsRendered)
+		{
+			owner.AverageCost = owner.RenderedFrames == 0
+				? owner.FrameCost
+				: owner.AverageCost + (owner.FrameCost - owner.AverageCost) * RB_SMOOTHING;
+			owner.MaxCost = (std::max)(owner.MaxCost, owner.FrameCost);
+			owner.RenderedFrames++;
+		}
+		else if (owner.Interval != 1)
+		{
+			owner.ThrottledFrames++;
+		}
+
+		owner.FrameCost = 0;
+		owner.IsRendered = false;
+	}
+
+	std::vector<RenderThrottleData> changes;
+
+	if (this->Frame % RB_EVALUATE_FRAMES == 0)
+	{
+		changes = this->Evaluate();
+	}
+
+	this->Frame++;
+
+	return changes;
+}
+
+void CRenderBudget::Reset(void* aStartAddress, void* aEndAddress)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->Owners.erase(std::remove_if(this->Owners.begin(), this->Owners.end(), [aStartAddress, aEndAddress](const Owner& owner)
+	{
+		return owner.StartAddress >= aStartAddress && owner.StartAddress <= aEndAddress;
+	}), this->Owners.end());
+
+	/* indices shifted, resolve again */
+	this->CallbackOwners.clear();
+}
+
+std::vector<RenderCostInfo> CRenderBudget::GetCosts() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	std::vector<RenderCostInfo> costs;
+	costs.reserve(this->Owners.size());
+
+	for (const Owner& owner : this->Owners)
+	{
+		costs.push_back(RenderCostInfo{
+			owner.Name,
+			owner.Signature,
+			owner.AverageCost,
+			owner.MaxCost,
+			owner.Interval,
+			owner.RenderedFrames,
+			owner.ThrottledFrames
+		});
+	}
+
+	return costs;
+}
+
+std::string CRenderBudget::GetOwnerName(signed int aSignature) const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (const Owner& owner : this->Owners)
+	{
+		if (owner.Signature == aSignature)
+		{
+			return owner.Name;
+		}
+	}
+
+	return NULLSTR;
+}
+
+int CRenderBudget::GetOwner(void* aCallback)
+{
+	auto it = this->CallbackOwners.find(aCallback);
+
+	if (it != this->CallbackOwners.end())
+	{
+		return it->second;
+	}
+
+	int idx = -1;
+
+	for (Addon* addon : Loader::Addons)
+	{
+		if (!addon->Module || !addon->Definitions) { continue; }
+
+		void* startAddress = addon->Module;
+		void* endAddress = ((PBYTE)addon->Module) + addon->ModuleSize;
+
+		if (aCallback < startAddress || aCallback > endAddress) { continue; }
+
+		auto ownerIt = std::find_if(this->Owners.begin(), this->Owners.end(), [addon](const Owner& owner)
+		{
+			return owner.Signature == addon->Definitions->Signature;
+		});
+
+		if (ownerIt == this->Owners.end())
+		{
+			Owner owner{};
+			owner.Name = addon->Definitions->Name ? addon->Definitions->Name : NULLSTR;
+			owner.Signature = addon->Definitions->Signature;
+			owner.StartAddress = startAddress;
+			owner.EndAddress = endAddress;
+			owner.Interval = 1;
+			this->Owners.push_back(owner);
+			ownerIt = this->Owners.end() - 1;
+		}
+
+		idx = static_cast<int>(ownerIt - this->Owners.begin());
+		break;
+	}
+
+	/* callbacks of nexus itself are never throttled */
+	this->CallbackOwners[aCallback] = idx;
+
+	return idx;
+}
+
+std::vector<RenderThrottleData> CRenderBudget::Evaluate()
+{
+	std::vector<unsigned> intervals(this->Owners.size(), 1);
+
+	if (this->IsEnforcing)
+	{
+		/* per addon: render every Nth frame, so the amortized cost fits the budget */
+		if (this->AddonBudget > 0)
+		{
+			for (size_t i = 0; i < this->Owners.size(); i++)
+			{
+				if (this->Owners[i].AverageCost <= this->AddonBudget) { continue; }
+
+				unsigned interval = static_cast<unsigned>(std::ceil(this->Owners[i].AverageCost / this->AddonBudget));
+				intervals[i] = (std::min)(interval, RB_MAX_INTERVAL);
+			}
+		}
+
+		/* total: throttle the most expensive addon further until everything fits or all are at the longest interval */
+		if (this->TotalBudget > 0)
+		{
+			while (true)
+			{
+				double total = 0;
+				int mostExpensive = -1;
+				double mostExpensiveCost = 0;
+
+				for (size_t i = 0; i < this->Owners.size(); i++)
+				{
+					double cost = this->Owners[i].AverageCost / intervals[i];
+					total += cost;
+
+					if (intervals[i] < RB_MAX_INTERVAL && cost > mostExpensiveCost)
+					{
+						mostExpensive = static_cast<int>(i);
+						mostExpensiveCost = cost;
+					}
+				}
+
+				if (total <= this->TotalBudget || mostExpensive < 0) { break; }
+
+				intervals[mostExpensive] = (std::min)(intervals[mostExpensive] * 2, RB_MAX_INTERVAL);
+			}
+		}
+	}
+
+	std::vector<RenderThrottleData> changes;
+	bool isThrottling = false;
+
+	for (size_t i = 0; i < this->Owners.size(); i++)
+	{
+		isThrottling |= intervals[i] != 1;
+
+		if (this->Owners[i].Interval == intervals[i]) { continue; }
+
+		this->Owners[i].Interval = intervals[i];
+		changes.push_back(RenderThrottleData{
+			this->Owners[i].Signature,
+			static_cast<int>(intervals[i]),
+			static_cast<float>(this->Owners[i].AverageCost / 1000000.0)
+		});
+	}
+
+	this->IsThrottling = isThrottling;
+
+	return changes;
+}
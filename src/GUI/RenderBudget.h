@@ -0,0 +1,167 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderBudget.h
+/// Description  :  Tracks the render cost per addon and throttles addons that exceed their budget.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RENDERBUDGET_H
+#define RENDERBUDGET_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "RenderThrottleData.h"
+
+constexpr unsigned RB_MAX_INTERVAL		= 8;	/* addons that need a longer interval are rendered at it */
+constexpr unsigned RB_EVALUATE_FRAMES	= 60;	/* frames between two budget evaluations */
+constexpr double   RB_SMOOTHING			= 0.1;	/* weight of the newest frame in the average cost */
+
+///----------------------------------------------------------------------------------------------------
+/// RenderCostInfo Struct
+///----------------------------------------------------------------------------------------------------
+struct RenderCostInfo
+{
+	std::string				Name;
+	signed int				Signature;
+	double					AverageCost;	/* nanoseconds per rendered frame */
+	long long				MaxCost;		/* nanoseconds */
+	unsigned				Interval;		/* rendered every Nth frame */
+	unsigned long long		RenderedFrames;
+	unsigned long long		ThrottledFrames;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CRenderBudget Class
+/// 	Costs are tracked per addon, all its pre-render, render and post-render callbacks combined.
+/// 	Budgets are compared against the cost amortized over the render interval.
+///----------------------------------------------------------------------------------------------------
+class CRenderBudget
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CRenderBudget() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CRenderBudget() = default;
+
+	///----------------------------------------------------------------------------------------------------
+	/// SetEnabled:
+	/// 	Enables or disables the enforcement. Costs are only tracked while enforced.
+	///----------------------------------------------------------------------------------------------------
+	void SetEnabled(bool aEnabled);
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsEnabled:
+	/// 	Returns true if budgets are enforced.
+	///----------------------------------------------------------------------------------------------------
+	bool IsEnabled() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// SetBudgets:
+	/// 	Sets the per addon and the total budget in milliseconds per frame, 0 for none.
+	///----------------------------------------------------------------------------------------------------
+	void SetBudgets(float aAddonBudget, float aTotalBudget);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetAddonBudget:
+	/// 	Returns the per addon budget in milliseconds per frame.
+	///----------------------------------------------------------------------------------------------------
+	float GetAddonBudget() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTotalBudget:
+	/// 	Returns the total budget in milliseconds per frame.
+	///----------------------------------------------------------------------------------------------------
+	float GetTotalBudget() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// ShouldRender:
+	/// 	Returns false if the owner of the callback is throttled on the current frame.
+	/// 	Does not lock while no addon is throttled.
+	///----------------------------------------------------------------------------------------------------
+	bool ShouldRender(void* aCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Record:
+	/// 	Adds aTime nanoseconds to the current frame cost of the owner of the callback.
+	/// 	Does not lock while budgets are not enforced.
+	///----------------------------------------------------------------------------------------------------
+	void Record(void* aCallback, long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// EndFrame:
+	/// 	Updates the average costs and re-evaluates the budgets periodically.
+	/// 	Returns the addons whose render interval changed.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<RenderThrottleData> EndFrame();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Reset:
+	/// 	Forgets all callbacks within the provided address space and the costs of their owners.
+	///----------------------------------------------------------------------------------------------------
+	void Reset(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetCosts:
+	/// 	Returns a copy of the tracked costs.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<RenderCostInfo> GetCosts() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetOwnerName:
+	/// 	Returns the name of a tracked addon.
+	///----------------------------------------------------------------------------------------------------
+	std::string GetOwnerName(signed int aSignature) const;
+
+private:
+	///----------------------------------------------------------------------------------------------------
+	/// Owner Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Owner
+	{
+		std::string				Name;
+		signed int				Signature;
+		void*					StartAddress;
+		void*					EndAddress;
+		long long				FrameCost;			/* nanoseconds, current frame */
+		bool					IsRendered;			/* rendered on the current frame */
+		double					AverageCost;		/* nanoseconds per rendered frame */
+		long long				MaxCost;
+		unsigned				Interval;			/* rendered every Nth frame */
+		unsigned long long		RenderedFrames;
+		unsigned long long		ThrottledFrames;
+	};
+
+	mutable std::mutex						Mutex;
+	std::atomic<bool>						IsEnforcing{ false };
+	std::atomic<bool>						IsThrottling{ false };	/* any owner is rendered less than every frame */
+	long long								AddonBudget = 0;	/* nanoseconds */
+	long long								TotalBudget = 0;	/* nanoseconds */
+
+	unsigned long long						Frame = 0;
+	std::vector<Owner>						Owners;
+	std::unordered_map<void*, int>			CallbackOwners;		/* index into Owners, -1 if not owned by an addon */
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetOwner:
+	/// 	Returns the index of the owner of a callback, -1 if not owned by an addon.
+	/// 	Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	int GetOwner(void* aCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Evaluate:
+	/// 	Computes the render interval of every owner. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<RenderThrottleData> Evaluate();
+};
+
+#endif
@@ -0,0 +1,176 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderRegistry.cpp
+/// Description  :  Registry of render callbacks, read by the render thread without locking.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "RenderRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+
+CRenderRegistry::CRenderRegistry()
+{
+	this->Snapshot = new RenderCallbacks();
+}
+
+CRenderRegistry::~CRenderRegistry()
+{
+	for (RenderCallbacks* retired : this->RetiredSnapshots)
+	{
+		delete retired;
+	}
+
+	delete this->Snapshot.load();
+}
+
+void CRenderRegistry::Register(ERenderType aRenderType, GUI_RENDER aRenderCallback)
+{
+	if (!aRenderCallback) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	switch (aRenderType)
+	{
+	case ERenderType::PreRender:
+		this->Registry.PreRender.push_back(aRenderCallback);
+		break;
+	case ERenderType::Render:
+		this->Registry.Render.push_back(aRenderCallback);
+		break;
+	case ERenderType::PostRender:
+		this->Registry.PostRender.push_back(aRenderCallback);
+		break;
+	case ERenderType::OptionsRender:
+		this->Registry.OptionsRender.push_back(aRenderCallback);
+		break;
+	default:
+		return;
+	}
+
+	this->Publish();
+}
+
+void CRenderRegistry::Deregister(GUI_RENDER aRenderCallback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (std::vector<GUI_RENDER>* callbacks : { &this->Registry.PreRender, &this->Registry.Render, &this->Registry.PostRender, &this->Registry.OptionsRender })
+		{
+			callbacks->erase(std::remove(callbacks->begin(), callbacks->end(), aRenderCallback), callbacks->end());
+		}
+
+		this->Publish();
+	}
+
+	this->WaitForFrame();
+}
+
+int CRenderRegistry::Verify(void* aStartAddress, void* aEndAddress)
+{
+	int refCounter = 0;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (std::vector<GUI_RENDER>* callbacks : { &this->Registry.PreRender, &this->Registry.Render, &this->Registry.PostRender, &this->Registry.OptionsRender })
+		{
+			auto it = std::remove_if(callbacks->begin(), callbacks->end(), [aStartAddress, aEndAddress](GUI_RENDER aCallback)
+			{
+				return aCallback >= aStartAddress && aCallback <= aEndAddress;
+			});
+
+			refCounter += static_cast<int>(std::distance(it, callbacks->end()));
+			callbacks->erase(it, callbacks->end());
+		}
+
+		if (refCounter == 0) { return 0; }
+
+		this->Publish();
+	}
+
+	this->WaitForFrame();
+
+	return refCounter;
+}
+
+const RenderCallbacks* CRenderRegistry::BeginFrame()
+{
+	this->FrameThread = std::this_thread::get_id();
+
+	/* a snapshot published after this point is not freed while the frame is running */
+	this->SnapshotReaders++;
+	this->FrameSnapshot = this->Snapshot.load();
+
+	return this->FrameSnapshot;
+}
+
+void CRenderRegistry::EndFrame()
+{
+	this->FrameSnapshot = nullptr;
+	this->FrameThread = std::thread::id();
+
+	this->SnapshotReaders--;
+	this->FramesCompleted++;
+
+	/* never wait for a writer, the snapshots are freed on a later frame instead */
+	std::unique_lock<std::mutex> lock(this->Mutex, std::try_to_lock);
+
+	if (lock.owns_lock())
+	{
+		this->FreeRetired();
+	}
+}
+
+const RenderCallbacks* CRenderRegistry::GetFrame() const
+{
+	return this->FrameSnapshot;
+}
+
+size_t CRenderRegistry::GetRetiredCount() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->RetiredSnapshots.size();
+}
+
+void CRenderRegistry::Publish()
+{
+	RenderCallbacks* snapshot = new RenderCallbacks(this->Registry);
+
+	this->RetiredSnapshots.push_back(this->Snapshot.exchange(snapshot));
+
+	this->FreeRetired();
+}
+
+void CRenderRegistry::FreeRetired()
+{
+	if (this->RetiredSnapshots.empty()) { return; }
+
+	/* a frame that begins after this point can only see the current snapshot */
+	if (this->SnapshotReaders.load() != 0) { return; }
+
+	for (RenderCallbacks* retired : this->RetiredSnapshots)
+	{
+		delete retired;
+	}
+
+	this->RetiredSnapshots.clear();
+}
+
+void CRenderRegistry::WaitForFrame() const
+{
+	/* the frame would wait for itself */
+	if (this->FrameThread.load() == std::this_thread::get_id()) { return; }
+
+	/* only a frame that was running before the new snapshot was published can render the old one */
+	unsigned long long frame = this->FramesCompleted.load();
+
+	while (this->SnapshotReaders.load() != 0 && this->FramesCompleted.load() == frame)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+}
@@ -0,0 +1,128 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderRegistry.h
+/// Description  :  Registry of render callbacks, read by the render thread without locking.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RENDERREGISTRY_H
+#define RENDERREGISTRY_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FuncDefs.h"
+
+///----------------------------------------------------------------------------------------------------
+/// RenderCallbacks Struct
+/// 	Immutable once published. Callbacks are in registration order.
+///----------------------------------------------------------------------------------------------------
+struct RenderCallbacks
+{
+	std::vector<GUI_RENDER>					PreRender;
+	std::vector<GUI_RENDER>					Render;
+	std::vector<GUI_RENDER>					PostRender;
+	std::vector<GUI_RENDER>					OptionsRender;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CRenderRegistry Class
+/// 	A frame renders the snapshot it started with, changes take effect on the next frame.
+/// 	Registering never waits for the frame. Deregistering waits for the current frame to end,
+/// 	so the callback is not called anymore once it returns, unless called from within the frame.
+///----------------------------------------------------------------------------------------------------
+class CRenderRegistry
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CRenderRegistry();
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CRenderRegistry();
+
+	CRenderRegistry(const CRenderRegistry&) = delete;
+	CRenderRegistry& operator=(const CRenderRegistry&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Register:
+	/// 	Registers the provided render callback.
+	///----------------------------------------------------------------------------------------------------
+	void Register(ERenderType aRenderType, GUI_RENDER aRenderCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Deregister:
+	/// 	Deregisters the provided render callback from all render types.
+	///----------------------------------------------------------------------------------------------------
+	void Deregister(GUI_RENDER aRenderCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Verify:
+	/// 	Removes all callbacks that are within the provided address space.
+	/// 	Returns the amount of removed callbacks.
+	///----------------------------------------------------------------------------------------------------
+	int Verify(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// BeginFrame:
+	/// 	Returns the snapshot to render. It stays valid until EndFrame.
+	///----------------------------------------------------------------------------------------------------
+	const RenderCallbacks* BeginFrame();
+
+	///----------------------------------------------------------------------------------------------------
+	/// EndFrame:
+	/// 	Releases the snapshot of the frame and frees retired snapshots if possible.
+	///----------------------------------------------------------------------------------------------------
+	void EndFrame();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetFrame:
+	/// 	Returns the snapshot of the current frame, nullptr outside of a frame.
+	/// 	Only valid on the render thread.
+	///----------------------------------------------------------------------------------------------------
+	const RenderCallbacks* GetFrame() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetRetiredCount:
+	/// 	Returns the amount of snapshots waiting to be freed.
+	///----------------------------------------------------------------------------------------------------
+	size_t GetRetiredCount() const;
+
+private:
+	mutable std::mutex						Mutex;				/* writers only */
+	RenderCallbacks							Registry;
+
+	std::atomic<RenderCallbacks*>			Snapshot;
+	std::atomic<int>						SnapshotReaders{ 0 };
+	std::atomic<unsigned long long>			FramesCompleted{ 0 };
+	std::atomic<std::thread::id>			FrameThread;
+	std::vector<RenderCallbacks*>			RetiredSnapshots;
+
+	const RenderCallbacks*					FrameSnapshot = nullptr;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Publish:
+	/// 	Publishes a copy of the registry. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void Publish();
+
+	///----------------------------------------------------------------------------------------------------
+	/// FreeRetired:
+	/// 	Frees the retired snapshots if no frame is reading. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void FreeRetired();
+
+	///----------------------------------------------------------------------------------------------------
+	/// WaitForFrame:
+	/// 	Waits until a frame that might still render a retired snapshot has ended.
+	/// 	Returns immediately if called from within the frame. Must not be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void WaitForFrame() const;
+};
+
+#endif
@@ -0,0 +1,23 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  RenderThrottleData.h
+/// Description  :  Payload of EV_RENDER_THROTTLED.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RENDERTHROTTLEDATA_H
+#define RENDERTHROTTLEDATA_H
+
+///----------------------------------------------------------------------------------------------------
+/// RenderThrottleData Struct
+/// 	Part of the addon API, the layout must not change.
+///----------------------------------------------------------------------------------------------------
+struct RenderThrottleData
+{
+	signed int				Signature;
+	int						Interval;		/* render callbacks run every Nth frame */
+	float					Cost;			/* average milliseconds per rendered frame */
+};
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "Util/Strings.h"
 
+#include "GUI/Fonts/FontManager.h"
 #include "GUI/Widgets/Alerts/Alerts.h"
 
 #include "imgui/imgui.h"
@@ -123,6 +124,12 @@ namespace GUI
 					}
 				}
 
+				/* names and descriptions may use glyphs no locale does */
+				CFontManager& fontManager = CFontManager::GetInstance();
+				fontManager.RequestGlyphs(aAddon->Definitions->Name);
+				fontManager.RequestGlyphs(aAddon->Definitions->Author);
+				fontManager.RequestGlyphs(aAddon->Definitions->Description);
+
 				ImGui::PushFont(Font);
 				ImGui::TextColored(ImVec4(1.0f, 0.933f, 0.733f, 1.0f), aAddon->Definitions->Name); ImGui::SameLine();
 				ImGui::PopFont();
@@ -429,6 +436,12 @@ namespace GUI
 					}
 				}
 
+				/* names and descriptions may use glyphs no locale does */
+				CFontManager& fontManager = CFontManager::GetInstance();
+				fontManager.RequestGlyphs(aAddon->Name.c_str());
+				fontManager.RequestGlyphs(aAddon->Author.c_str());
+				fontManager.RequestGlyphs(aAddon->Description.c_str());
+
 				ImGui::PushFont(Font);
 				ImGui::TextColored(ImVec4(1.0f, 0.933f, 0.733f, 1.0f), aAddon->Name.c_str());
 				ImGui::PopFont();
@@ -1,16 +1,30 @@
 #include "CDebugWindow.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <map>
+#include <vector>
+
 #include "Shared.h"
 #include "State.h"
 
+#include "Index.h"
+
 #include "Events/EventHandler.h"
+#include "GUI/GUI.h"
+#include "GUI/Fonts/FontManager.h"
 #include "GUI/Widgets/QuickAccess/QuickAccess.h"
 #include "Inputs/InputBinds/InputBindHandler.h"
+#include "Inputs/RawInput/RawInputApi.h"
 #include "Loader/Loader.h"
 #include "Services/DataLink/DataLink.h"
+#include "Services/Recorder/Recorder.h"
+#include "Services/Settings/Settings.h"
 #include "Services/Textures/TextureLoader.h"
 
 #include "Util/MD5.h"
+#include "Util/Time.h"
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_extensions.h"
@@ -57,7 +71,11 @@ namespace GUI
 			{
 				DbgEventsTab();
 				DbgInputBindsTab();
+				DbgWndProcTab();
+				DbgWatchdogTab();
+				DbgRenderBudgetTab();
 				DbgDataLinkTab();
+				DbgRecorderTab();
 				DbgTexturesTab();
 				DbgShortcutsTab();
 				DbgLoaderTab();
@@ -87,31 +105,109 @@ namespace GUI
 		{
 			ImGui::BeginChild("##EventsTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
 
-			std::unordered_map<std::string, EventData> EventRegistry = EventApi->GetRegistry();
+			EventExecutorStats stats = EventApi->GetExecutorStats();
+			double avgLatency = stats.Executed ? static_cast<double>(stats.TotalLatency) / stats.Executed / 1000.0 : 0.0;
+			ImGui::Text("Queued raises: %llu, calls executed: %llu (pending: %zu, dropped: %llu)", stats.Raised, stats.Executed, stats.Pending, stats.Purged);
+			ImGui::Text("Latency: last %.1fus, average %.1fus, max %.1fus", stats.LastLatency / 1000.0, avgLatency, stats.MaxLatency / 1000.0);
+			ImGui::Separator();
 
-			for (auto& [identifier, ev] : EventRegistry)
+			if (ImGui::Button("Export CSV"))
 			{
-				std::string header = identifier + " ";
-				header.append("(");
-				header.append(std::to_string(ev.AmountRaises));
-				header.append(")");
+				EventApi->ExportMetrics(Index::D_GW2_ADDONS_NEXUS_DIAGNOSTICS / ("Events-" + std::to_string(Time::GetTimestamp()) + ".csv"));
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Export JSON"))
+			{
+				EventApi->ExportMetrics(Index::D_GW2_ADDONS_NEXUS_DIAGNOSTICS / ("Events-" + std::to_string(Time::GetTimestamp()) + ".json"));
+			}
+			ImGui::SameLine();
+			ImGui::TextDisabled("Sorted by the time spent in subscribers over the last %us.", EV_METRICS_WINDOW);
+
+			std::unordered_map<std::string, EventData> EventRegistry = EventApi->GetRegistry();
 
-				if (ImGui::TreeNode(header.c_str()))
+			if (ImGui::BeginTable("##EventMetrics", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Event / Owner");
+				ImGui::TableSetupColumn("Raises / Calls");
+				ImGui::TableSetupColumn("Per second");
+				ImGui::TableSetupColumn("Per second (60s)");
+				ImGui::TableSetupColumn("Time per second (60s)");
+				ImGui::TableSetupColumn("Average");
+				ImGui::TableSetupColumn("Max");
+				ImGui::TableSetupColumn("Queued on");
+				ImGui::TableHeadersRow();
+
+				for (const EventMetrics& ev : EventApi->GetMetrics())
 				{
-					if (ev.Subscribers.size() == 0)
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					bool open = ImGui::TreeNode(ev.Identifier.c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", ev.Raises);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", ev.RaiseRate);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", ev.RaiseRateWindow);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1fus", ev.TimeRateWindow / 1000.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", ev.Raises ? ev.TotalTime / 1000.0 / ev.Raises : 0.0);
+					ImGui::TooltipGeneric("Per raise, all subscribers.");
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", ev.MaxTime / 1000.0);
+					ImGui::TableNextColumn();
+
+					if (!open) { continue; }
+
+					if (ev.Subscribers.empty())
 					{
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
 						ImGui::TextDisabled("This event has no subscribers.");
 					}
-					else
+
+					auto regIt = EventRegistry.find(ev.Identifier);
+
+					for (const SubscriberMetrics& sub : ev.Subscribers)
 					{
-						ImGui::TextDisabled("Subscribers:");
-						for (EventSubscriber sub : ev.Subscribers)
+						const char* execution = "-";
+
+						if (sub.IsSubscribed && regIt != EventRegistry.end())
 						{
-							ImGui::Text(""); ImGui::SameLine(); ImGui::TextDisabled("Owner: %d | Callback: %p", sub.Signature, sub.Callback);
+							for (const EventSubscriber& evSub : regIt->second.Subscribers)
+							{
+								if (evSub.Callback == sub.Callback)
+								{
+									execution = evSub.Execution == EEventExecution::RenderThread ? "render thread" : "worker";
+									break;
+								}
+							}
 						}
+
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%s%s", sub.Owner.c_str(), sub.IsSubscribed ? "" : " (unsubscribed)");
+						ImGui::TooltipGeneric("Signature: %d | Callback: %p", sub.Signature, sub.Callback);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%llu", sub.Calls);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.1f", sub.CallRate);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.1f", sub.CallRateWindow);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.1fus", sub.TimeRateWindow / 1000.0);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.2fus", sub.Calls ? sub.TotalTime / 1000.0 / sub.Calls : 0.0);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.2fus", sub.MaxTime / 1000.0);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%s", execution);
 					}
+
 					ImGui::TreePop();
 				}
+
+				ImGui::EndTable();
 			}
 
 			ImGui::EndChild();
@@ -125,6 +221,13 @@ namespace GUI
 		{
 			ImGui::BeginChild("##InputBindsTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
 
+			InputBindExecutorStats stats = InputBindApi->GetExecutorStats();
+			double avgLatency = stats.Executed ? static_cast<double>(stats.TotalLatency) / stats.Executed : 0.0;
+			double varLatency = stats.Executed ? stats.TotalLatencySq / stats.Executed - avgLatency * avgLatency : 0.0;
+			ImGui::Text("Handlers executed: %llu (dropped: %llu)", stats.Executed, stats.Purged);
+			ImGui::Text("Latency: last %lldus, average %.1fus, deviation %.1fus, max %lldus", stats.LastLatency, avgLatency, sqrtf(static_cast<float>(varLatency > 0.0 ? varLatency : 0.0)), stats.MaxLatency);
+			ImGui::Separator();
+
 			std::map<std::string, ManagedInputBind> InputBindRegistry = InputBindApi->GetRegistry();
 
 			for (auto& [identifier, inputBind] : InputBindRegistry)
@@ -145,29 +248,290 @@ namespace GUI
 			ImGui::EndTabItem();
 		}
 	}
+	void CDebugWindow::DbgWndProcTab()
+	{
+		if (ImGui::BeginTabItem("WndProc"))
+		{
+			ImGui::BeginChild("##WndProcTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
+
+			std::vector<WndProcCallbackInfo> callbacks = RawInputApi->GetCallbacks();
+
+			if (callbacks.size() == 0)
+			{
+				ImGui::TextDisabled("No WndProc callbacks registered.");
+			}
+			else if (ImGui::BeginTable("##WndProcCallbacks", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Owner");
+				ImGui::TableSetupColumn("Callback");
+				ImGui::TableSetupColumn("Messages");
+				ImGui::TableSetupColumn("Calls");
+				ImGui::TableSetupColumn("Average");
+				ImGui::TableSetupColumn("Max");
+				ImGui::TableHeadersRow();
+
+				for (const WndProcCallbackInfo& cb : callbacks)
+				{
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%s", Loader::GetOwner(cb.Callback).c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text("%p", cb.Callback);
+					ImGui::TableNextColumn();
+					if (cb.MsgFirst == 0 && cb.MsgLast == UINT_MAX)
+					{
+						ImGui::TextDisabled("all");
+					}
+					else
+					{
+						ImGui::Text("0x%04X - 0x%04X", cb.MsgFirst, cb.MsgLast);
+					}
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", cb.Calls);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", cb.Calls ? static_cast<double>(cb.TotalTime) / cb.Calls / 1000.0 : 0.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", static_cast<double>(cb.MaxTime) / 1000.0);
+				}
+
+				ImGui::EndTable();
+			}
+
+			ImGui::EndChild();
+
+			ImGui::EndTabItem();
+		}
+	}
+	void CDebugWindow::DbgWatchdogTab()
+	{
+		if (ImGui::BeginTabItem("Watchdog"))
+		{
+			ImGui::BeginChild("##WatchdogTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
+
+			float threshold = CallbackWatchdog->GetThreshold() / 1000000.0f;
+			if (ImGui::DragFloat("Threshold (ms)", &threshold, 0.1f, 0.1f, 1000.0f, "%.1f"))
+			{
+				CallbackWatchdog->SetThreshold(static_cast<long long>(threshold * 1000000.0f));
+				Settings::Settings[OPT_WATCHDOGTHRESHOLD] = threshold;
+				Settings::Save();
+			}
+			ImGui::TextDisabled("Calls that could not be recorded: %llu", CallbackWatchdog->GetDropped());
+
+			/* group by owner, most expensive first */
+			std::map<std::string, std::vector<CallbackTimingInfo>> owners;
+			for (const CallbackTimingInfo& timing : CallbackWatchdog->GetTimings())
+			{
+				owners[Loader::GetOwner(timing.Callback)].push_back(timing);
+			}
+
+			std::vector<std::pair<long long, std::string>> order;
+			for (auto& [owner, timings] : owners)
+			{
+				long long total = 0;
+				for (const CallbackTimingInfo& timing : timings) { total += timing.TotalTime; }
+				order.push_back({ total, owner });
+			}
+			std::sort(order.begin(), order.end(), std::greater<>());
+
+			if (ImGui::BeginTable("##WatchdogTimings", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Owner / Callback");
+				ImGui::TableSetupColumn("Type");
+				ImGui::TableSetupColumn("Calls");
+				ImGui::TableSetupColumn("Average");
+				ImGui::TableSetupColumn("Max");
+				ImGui::TableSetupColumn("Exceeded");
+				ImGui::TableSetupColumn("Histogram (log2 us)");
+				ImGui::TableHeadersRow();
+
+				for (auto& [total, owner] : order)
+				{
+					std::vector<CallbackTimingInfo>& timings = owners[owner];
+
+					/* per owner row: sum of all its callbacks */
+					unsigned long long calls = 0;
+					long long max = 0;
+					unsigned long long exceeded = 0;
+					float histogram[CW_HISTOGRAM_BUCKETS]{};
+					for (const CallbackTimingInfo& timing : timings)
+					{
+						calls += timing.Calls;
+						max = max > timing.MaxTime ? max : timing.MaxTime;
+						exceeded += timing.Exceeded;
+						for (unsigned i = 0; i < CW_HISTOGRAM_BUCKETS; i++) { histogram[i] += static_cast<float>(timing.Histogram[i]); }
+					}
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					bool open = ImGui::TreeNode(owner.c_str());
+					ImGui::TableNextColumn();
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", calls);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", calls ? total / 1000.0 / calls : 0.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2fus", max / 1000.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", exceeded);
+					ImGui::TableNextColumn();
+					ImGui::PlotHistogram(("##Histogram" + owner).c_str(), histogram, CW_HISTOGRAM_BUCKETS, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, ImGui::GetTextLineHeight()));
+
+					if (!open) { continue; }
+
+					for (const CallbackTimingInfo& timing : timings)
+					{
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%p", timing.Callback);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%s", CCallbackWatchdog::GetTypeName(timing.Type));
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%llu", timing.Calls);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.2fus", timing.TotalTime / 1000.0 / timing.Calls);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%.2fus", timing.MaxTime / 1000.0);
+						ImGui::TableNextColumn();
+						ImGui::TextDisabled("%llu", timing.Exceeded);
+						ImGui::TableNextColumn();
+					}
+
+					ImGui::TreePop();
+				}
+
+				ImGui::EndTable();
+			}
+
+			ImGui::EndChild();
+
+			ImGui::EndTabItem();
+		}
+	}
+	void CDebugWindow::DbgRenderBudgetTab()
+	{
+		if (ImGui::BeginTabItem("Render Budget"))
+		{
+			ImGui::BeginChild("##RenderBudgetTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
+
+			bool isEnabled = GUI::RenderBudget.IsEnabled();
+			float addonBudget = GUI::RenderBudget.GetAddonBudget();
+			float totalBudget = GUI::RenderBudget.GetTotalBudget();
+
+			if (ImGui::Checkbox("Enforce budgets", &isEnabled))
+			{
+				GUI::RenderBudget.SetEnabled(isEnabled);
+				Settings::Settings[OPT_RENDERBUDGET] = isEnabled;
+				Settings::Save();
+			}
+			bool budgetsChanged = false;
+			budgetsChanged |= ImGui::DragFloat("Per addon (ms)", &addonBudget, 0.05f, 0.0f, 100.0f, "%.2f");
+			budgetsChanged |= ImGui::DragFloat("Total (ms)", &totalBudget, 0.05f, 0.0f, 100.0f, "%.2f");
+			if (budgetsChanged)
+			{
+				GUI::RenderBudget.SetBudgets(addonBudget, totalBudget);
+				Settings::Settings[OPT_RENDERBUDGETADDON] = addonBudget;
+				Settings::Settings[OPT_RENDERBUDGETTOTAL] = totalBudget;
+				Settings::Save();
+			}
+			ImGui::TextDisabled("A budget of 0 is unlimited. Addons are rendered at least every %uth frame. Costs are tracked while enforced.", RB_MAX_INTERVAL);
+
+			std::vector<RenderCostInfo> costs = GUI::RenderBudget.GetCosts();
+			std::sort(costs.begin(), costs.end(), [](const RenderCostInfo& lhs, const RenderCostInfo& rhs)
+			{
+				return lhs.AverageCost > rhs.AverageCost;
+			});
+
+			if (ImGui::BeginTable("##RenderBudgetCosts", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Addon");
+				ImGui::TableSetupColumn("Average");
+				ImGui::TableSetupColumn("Max");
+				ImGui::TableSetupColumn("Interval");
+				ImGui::TableSetupColumn("Rendered");
+				ImGui::TableSetupColumn("Throttled");
+				ImGui::TableHeadersRow();
+
+				for (const RenderCostInfo& cost : costs)
+				{
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%s", cost.Name.c_str());
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3fms", cost.AverageCost / 1000000.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3fms", cost.MaxCost / 1000000.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", cost.Interval);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", cost.RenderedFrames);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", cost.ThrottledFrames);
+				}
+
+				ImGui::EndTable();
+			}
+
+			ImGui::EndChild();
+
+			ImGui::EndTabItem();
+		}
+	}
 	void CDebugWindow::DbgDataLinkTab()
 	{
 		if (ImGui::BeginTabItem("DataLink"))
 		{
 			ImGui::BeginChild("##DataLinkTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
 
-			std::unordered_map<std::string, LinkedResource>	DataLinkRegistry = DataLinkService->GetRegistry();
+			/* immutable and never freed, nothing is copied */
+			const DataLinkSnapshot* DataLinkRegistry = DataLinkService->GetSnapshot();
+
+			ImGui::TextDisabled("Generation: %llu", DataLinkRegistry->Generation);
+			ImGui::TooltipGeneric("Advances whenever a resource or handle is added.");
 
-			for (auto& [identifier, resource] : DataLinkRegistry)
+			for (const DataLinkEntry* entry : DataLinkRegistry->Entries)
 			{
-				if (ImGui::TreeNode(identifier.c_str()))
+				const LinkedResource* resource = entry->Resource.load();
+
+				if (!resource)
+				{
+					ImGui::TextDisabled("%s (handle only)", entry->Identifier.c_str());
+					continue;
+				}
+
+				if (ImGui::TreeNode(entry->Identifier.c_str()))
 				{
-					ImGui::TextDisabled("Handle: %p", resource.Handle);
-					ImGui::TextDisabled("Pointer: %p", resource.Pointer);
-					ImGui::TextDisabled("Size: %d", resource.Size);
-					ImGui::TextDisabled("Name: %s", resource.UnderlyingName.c_str());
+					ImGui::TextDisabled("Handle: %p", resource->Handle);
+					ImGui::TextDisabled("Pointer: %p", resource->Pointer);
+					ImGui::TextDisabled("Size: %d", resource->Size);
+					ImGui::TextDisabled("Name: %s", resource->UnderlyingName.c_str());
 					ImGui::TooltipGeneric("The real underlying name of the file.");
+					if (resource->IsVersioned)
+					{
+						ImGui::TextDisabled("Version: %u", SeqLock::GetVersion((const unsigned*)((const char*)resource->Pointer + resource->VersionOffset)));
+						ImGui::TooltipGeneric("Advances by two with every write, odd while being written.");
+					}
+					if (resource->IsChannel)
+					{
+						const ChannelHeader* channel = (const ChannelHeader*)resource->Pointer;
+
+						ImGui::TextDisabled("Records: %u x %u bytes (%s)", channel->Capacity, channel->RecordSize, channel->IsMultiProducer ? "multi producer" : "single producer");
+						ImGui::TextDisabled("Written: %llu, Dropped: %llu", channel->Head, channel->Dropped);
+
+						for (unsigned i = 0; i < DLC_MAX_CONSUMERS; i++)
+						{
+							const ChannelConsumer& consumer = channel->Consumers[i];
+
+							if (!consumer.IsSubscribed) { continue; }
+
+							ImGui::TextDisabled("Consumer %u: Behind: %llu, Overflows: %llu", i, channel->Head - consumer.Cursor, consumer.Overflows);
+						}
+					}
 
 					if (ImGui::SmallButton("Memory Viewer"))
 					{
 						MemoryViewer.Open = true;
-						memPtr = resource.Pointer;
-						memSz = resource.Size;
+						memPtr = resource->Pointer;
+						memSz = resource->Size;
 					}
 
 					ImGui::TreePop();
@@ -179,6 +543,41 @@ namespace GUI
 			ImGui::EndTabItem();
 		}
 	}
+	void CDebugWindow::DbgRecorderTab()
+	{
+		if (ImGui::BeginTabItem("Recorder"))
+		{
+			ImGui::BeginChild("##RecorderTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
+
+			RecorderStats stats = CombatRecorder->GetStats();
+
+			if (!stats.IsRecording)
+			{
+				if (ImGui::Button("Start recording"))
+				{
+					CombatRecorder->Start(Index::D_GW2_ADDONS_NEXUS_RECORDINGS / (std::to_string(Time::GetTimestamp()) + ".nxrec"));
+				}
+			}
+			else if (ImGui::Button("Stop recording"))
+			{
+				CombatRecorder->Stop();
+			}
+			ImGui::TextDisabled("Records the ArcDPS combat events and MumbleLink samples for the replay tool.");
+
+			if (!stats.Path.empty())
+			{
+				ImGui::TextDisabled("File: %s", stats.Path.string().c_str());
+				ImGui::TextDisabled("Duration: %.1fs", stats.Duration / 1000000.0);
+				ImGui::TextDisabled("Events: %llu, Frames: %llu", stats.Events, stats.Frames);
+				ImGui::TextDisabled("Written: %llu bytes of %llu", stats.WrittenBytes, stats.RawBytes);
+				ImGui::TooltipGeneric("Compressed bytes in the file and uncompressed bytes of the completed blocks.");
+			}
+
+			ImGui::EndChild();
+
+			ImGui::EndTabItem();
+		}
+	}
 	void CDebugWindow::DbgTexturesTab()
 	{
 		if (ImGui::BeginTabItem("Textures"))
@@ -238,6 +637,7 @@ namespace GUI
 					ImGui::TextDisabled("Dimensions: %dx%d", qtexture.Width, qtexture.Height);
 					ImGui::TextDisabled("ReceiveCallback: %p", qtexture.Callback);
 					ImGui::TextDisabled("Data: ", qtexture.Data);
+					ImGui::TextDisabled("Levels: %d%s", static_cast<int>(qtexture.Levels.size()), qtexture.IsCompressed ? " (BC3)" : "");
 
 					ImGui::TreePop();
 				}
@@ -426,6 +826,18 @@ namespace GUI
 		{
 			ImGui::BeginChild("##FontsTabScroll", ImVec2(ImGui::GetWindowContentRegionWidth(), 0.0f));
 
+			CFontManager& fontManager = CFontManager::GetInstance();
+			FontAtlasStats stats = fontManager.GetStats();
+			ImGui::Text("Atlas builds: %u (skipped: %u, cached: %u)", stats.Builds, stats.Skipped, stats.CacheHits);
+			ImGui::Text("Last build: %.2fms", stats.LastDuration / 1000.0f);
+			ImGui::Text("Average build: %.2fms", stats.Builds ? (stats.TotalDuration / stats.Builds) / 1000.0f : 0.0f);
+			ImGui::Text("On-demand glyphs: %u (evicted: %u)", stats.DynamicGlyphs, stats.EvictedGlyphs);
+			if (fontManager.IsBuilding())
+			{
+				ImGui::TextDisabled("Building...");
+			}
+			ImGui::Separator();
+
 			ImGuiIO& io = ImGui::GetIO();
 			ImFontAtlas* atlas = io.Fonts;
 			ImGui::PushItemWidth(120);
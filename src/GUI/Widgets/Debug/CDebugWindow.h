@@ -25,7 +25,11 @@ namespace GUI
 		private:
 		void DbgEventsTab();
 		void DbgInputBindsTab();
+		void DbgWndProcTab();
+		void DbgWatchdogTab();
+		void DbgRenderBudgetTab();
 		void DbgDataLinkTab();
+		void DbgRecorderTab();
 		void DbgTexturesTab();
 		void DbgShortcutsTab();
 		void DbgLoaderTab();
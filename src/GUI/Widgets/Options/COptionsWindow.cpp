@@ -594,8 +594,13 @@ namespace GUI
 
 			if (ImGui::BeginTabBar("AddonOptionsTabBar", ImGuiTabBarFlags_None))
 			{
-				for (GUI_RENDER renderCb : RegistryOptionsRender)
+				/* the options window is rendered within the frame */
+				const RenderCallbacks* callbacks = RenderRegistry.GetFrame();
+
+				for (size_t i = 0; callbacks && i < callbacks->OptionsRender.size(); i++)
 				{
+					GUI_RENDER renderCb = callbacks->OptionsRender[i];
+
 					std::string parent = Loader::GetOwner(renderCb);
 					if (ImGui::BeginTabItem((parent + "##AddonOptions").c_str()))
 					{
@@ -612,7 +617,9 @@ namespace GUI
 
 						if (ImGui::CollapsingHeader(Language->Translate("((000004))"), ImGuiTreeNodeFlags_DefaultOpen))
 						{
+							long long start = CCallbackWatchdog::Now();
 							renderCb();
+							CallbackWatchdog->Record(ECallbackType::OptionsRender, (void*)renderCb, CCallbackWatchdog::Now() - start);
 						}
 
 						ImGui::EndTabItem();
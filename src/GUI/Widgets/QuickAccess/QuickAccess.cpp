@@ -178,8 +178,8 @@ namespace GUI
 					}
 					else if (shortcut.TextureGetAttempts < 10)
 					{
-						shortcut.TextureNormal = TextureService->Get(shortcut.TextureNormalIdentifier.c_str());
-						shortcut.TextureHover = TextureService->Get(shortcut.TextureHoverIdentifier.c_str());
+						shortcut.TextureNormal = shortcut.TextureNormalHandle ? *shortcut.TextureNormalHandle : nullptr;
+						shortcut.TextureHover = shortcut.TextureHoverHandle ? *shortcut.TextureHoverHandle : nullptr;
 						shortcut.TextureGetAttempts++;
 					}
 					else
@@ -340,13 +340,15 @@ namespace GUI
 				const std::lock_guard<std::mutex> lock(QuickAccess::Mutex);
 				if (Registry.find(str) == Registry.end())
 				{
-					Texture* normal = TextureService->Get(strTexId.c_str());
-					Texture* hover = TextureService->Get(strTexHoverId.c_str());
+					Texture* const* normal = TextureService->GetHandle(strTexId.c_str());
+					Texture* const* hover = TextureService->GetHandle(strTexHoverId.c_str());
 					Shortcut sh{};
 					sh.TextureNormalIdentifier = aTextureIdentifier;
 					sh.TextureHoverIdentifier = aTextureHoverIdentifier;
-					sh.TextureNormal = normal;
-					sh.TextureHover = hover;
+					sh.TextureNormalHandle = normal;
+					sh.TextureHoverHandle = hover;
+					sh.TextureNormal = *normal;
+					sh.TextureHover = *hover;
 					sh.InputBind = aInputBindIdentifier;
 					sh.TooltipText = aTooltipText;
 					sh.TextureGetAttempts = 0;
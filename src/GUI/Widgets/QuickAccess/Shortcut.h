@@ -20,6 +20,8 @@ namespace GUI
 		int											TextureGetAttempts;
 		std::string									TextureNormalIdentifier;
 		std::string									TextureHoverIdentifier;
+		Texture* const*								TextureNormalHandle;	/* resolved once, read every frame */
+		Texture* const*								TextureHoverHandle;
 
 		Texture*									TextureNormal;
 		Texture*									TextureHover;
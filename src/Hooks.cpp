@@ -13,12 +13,14 @@
 #include "Inputs/InputBinds/InputBindHandler.h"
 #include "Loader/Loader.h"
 #include "Loader/NexusLinkData.h"
+#include "Services/DataLink/SeqLock.h"
 #include "Services/Textures/TextureLoader.h"
 #include "Inputs/RawInput/RawInputApi.h"
 
 namespace Hooks
 {
 	NexusLinkData* NexusLink = nullptr;
+	CMumbleHistory* MumbleHistory = nullptr;
 
 	namespace DXGI
 	{
@@ -100,17 +102,44 @@ namespace Hooks
 
 			if (NexusLink)
 			{
-				NexusLink->Scaling = Renderer::Scaling;
+				int qaIconsCount = static_cast<int>(GUI::QuickAccess::Registry.size());
+				int qaMode = (int)GUI::QuickAccess::Location;
+
+				/* only advance the version if something changed, so addons can skip their work */
+				if (NexusLink->Scaling != Renderer::Scaling ||
+					NexusLink->Font != Font ||
+					NexusLink->FontBig != FontBig ||
+					NexusLink->FontUI != FontUI ||
+					NexusLink->QuickAccessIconsCount != qaIconsCount ||
+					NexusLink->QuickAccessMode != qaMode ||
+					NexusLink->QuickAccessIsVertical != GUI::QuickAccess::VerticalLayout)
+				{
+					SeqLock::BeginWrite(&NexusLink->Version);
+
+					NexusLink->Scaling = Renderer::Scaling;
 
-				NexusLink->Font = Font;
-				NexusLink->FontBig = FontBig;
-				NexusLink->FontUI = FontUI;
+					NexusLink->Font = Font;
+					NexusLink->FontBig = FontBig;
+					NexusLink->FontUI = FontUI;
 
-				NexusLink->QuickAccessIconsCount = static_cast<int>(GUI::QuickAccess::Registry.size()); // write this only when adding/removing icons
-				NexusLink->QuickAccessMode = (int)GUI::QuickAccess::Location;
-				NexusLink->QuickAccessIsVertical = GUI::QuickAccess::VerticalLayout;
+					NexusLink->QuickAccessIconsCount = qaIconsCount;
+					NexusLink->QuickAccessMode = qaMode;
+					NexusLink->QuickAccessIsVertical = GUI::QuickAccess::VerticalLayout;
+
+					SeqLock::EndWrite(&NexusLink->Version);
+				}
 			}
 
+			/* sampled before rendering, so addons interpolate against this frame */
+			long long frameTime = CMumbleHistory::GetTime();
+			MumbleSample sample;
+			bool isSampled = MumbleHistory && MumbleHistory->Sample(frameTime, &sample);
+
+			CombatRecorder->RecordFrame(frameTime, isSampled ? &sample : nullptr);
+
+			/* combat events collected since the last frame */
+			CombatBatchApi->Flush();
+
 			GUI::Render();
 		}
 		
@@ -129,8 +158,10 @@ namespace Hooks
 		if (NexusLink)
 		{
 			/* Already write to nexus link, as addons depend on that and the next frame isn't called yet so no update to values */
+			SeqLock::BeginWrite(&NexusLink->Version);
 			NexusLink->Width = Width;
 			NexusLink->Height = Height;
+			SeqLock::EndWrite(&NexusLink->Version);
 		}
 
 		EventApi->Raise(EV_WINDOW_RESIZED);
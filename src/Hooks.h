@@ -5,6 +5,7 @@
 #include <Windows.h>
 
 #include "Loader/NexusLinkData.h"
+#include "Services/Mumble/History.h"
 
 typedef HRESULT (__stdcall*DXPRESENT)		(IDXGISwapChain* pChain, UINT SyncInterval, UINT Flags);
 typedef HRESULT (__stdcall*DXRESIZEBUFFERS)	(IDXGISwapChain* pChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT SwapChainFlags);
@@ -13,6 +14,7 @@ typedef HRESULT (__stdcall*DXRESIZEBUFFERS)	(IDXGISwapChain* pChain, UINT Buffer
 namespace Hooks
 {
 	extern NexusLinkData* NexusLink;
+	extern CMumbleHistory* MumbleHistory;
 
 	namespace DXGI
 	{
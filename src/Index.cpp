@@ -21,6 +21,8 @@ namespace Index
 	std::filesystem::path D_GW2_ADDONS_NEXUS{};
 	std::filesystem::path D_GW2_ADDONS_NEXUS_FONTS{};
 	std::filesystem::path D_GW2_ADDONS_NEXUS_LOCALES{};
+	std::filesystem::path D_GW2_ADDONS_NEXUS_RECORDINGS{};
+	std::filesystem::path D_GW2_ADDONS_NEXUS_DIAGNOSTICS{};
 
 	std::filesystem::path F_HOST_DLL{};
 	std::filesystem::path F_UPDATE_DLL{};
@@ -35,6 +37,7 @@ namespace Index
 	std::filesystem::path F_SETTINGS{};
 	std::filesystem::path F_ADDONCONFIG{};
 	std::filesystem::path F_APIKEYS{};
+	std::filesystem::path F_FONTATLASCACHE{};
 
 	std::filesystem::path F_LOCALE_EN{};
 	std::filesystem::path F_LOCALE_DE{};
@@ -64,6 +67,8 @@ namespace Index
 		D_GW2_ADDONS_NEXUS = D_GW2_ADDONS / "Nexus";									/* get addons/Nexus path */
 		D_GW2_ADDONS_NEXUS_FONTS = D_GW2_ADDONS_NEXUS / "Fonts";						/* get addons/Nexus/Fonts path */
 		D_GW2_ADDONS_NEXUS_LOCALES = D_GW2_ADDONS_NEXUS / "Locales";					/* get addons/Nexus/Locales path */
+		D_GW2_ADDONS_NEXUS_RECORDINGS = D_GW2_ADDONS_NEXUS / "Recordings";				/* get addons/Nexus/Recordings path, created when recording */
+		D_GW2_ADDONS_NEXUS_DIAGNOSTICS = D_GW2_ADDONS_NEXUS / "Diagnostics";			/* get addons/Nexus/Diagnostics path, created when exporting */
 
 		/* ensure folder tree*/
 		Path::CreateDir(D_GW2_ADDONS);
@@ -80,6 +85,7 @@ namespace Index
 		F_SETTINGS = D_GW2_ADDONS_NEXUS / "Settings.json";								/* get settings path */
 		F_ADDONCONFIG = D_GW2_ADDONS_NEXUS / "AddonConfig.json";						/* get addon config path */
 		F_APIKEYS = D_GW2_ADDONS_COMMON / "APIKeys.json";								/* get apikeys path */
+		F_FONTATLASCACHE = D_GW2_ADDONS_NEXUS / "FontAtlas.cache";						/* get font atlas cache path */
 			
 		/* static paths */
 		F_OLD_DLL = F_HOST_DLL.string() + ".old";										/* get old dll path */
@@ -28,6 +28,8 @@ namespace Index
 	extern std::filesystem::path D_GW2_ADDONS_NEXUS;
 	extern std::filesystem::path D_GW2_ADDONS_NEXUS_FONTS;
 	extern std::filesystem::path D_GW2_ADDONS_NEXUS_LOCALES;
+	extern std::filesystem::path D_GW2_ADDONS_NEXUS_RECORDINGS;
+	extern std::filesystem::path D_GW2_ADDONS_NEXUS_DIAGNOSTICS;
 
 	extern std::filesystem::path F_HOST_DLL;
 	extern std::filesystem::path F_UPDATE_DLL;
@@ -42,6 +44,7 @@ namespace Index
 	extern std::filesystem::path F_SETTINGS;
 	extern std::filesystem::path F_ADDONCONFIG;
 	extern std::filesystem::path F_APIKEYS;
+	extern std::filesystem::path F_FONTATLASCACHE;
 
 	extern std::filesystem::path F_LOCALE_EN;
 	extern std::filesystem::path F_LOCALE_DE;
@@ -0,0 +1,22 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EGameBindMacroAction.h
+/// Description  :  EGameBindMacroAction enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef EGAMEBINDMACROACTION_H
+#define EGAMEBINDMACROACTION_H
+
+///----------------------------------------------------------------------------------------------------
+/// EGameBindMacroAction Enum
+///----------------------------------------------------------------------------------------------------
+typedef enum class EGameBindMacroAction
+{
+	Press,
+	Release,
+	Invoke		/* press and release on the same tick */
+} EGBMacroAction;
+
+#endif
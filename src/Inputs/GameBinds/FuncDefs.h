@@ -2,6 +2,7 @@
 #define GAMEBINDS_FUNCDEFS_H
 
 #include "EGameBinds.h"
+#include "GameBindMacroStep.h"
 
 typedef void (*GAMEBINDS_PRESSASYNC)(EGameBinds aGameBind);
 typedef void (*GAMEBINDS_RELEASEASYNC)(EGameBinds aGameBind);
@@ -9,5 +10,11 @@ typedef void (*GAMEBINDS_INVOKEASYNC)(EGameBinds aGameBind, int aDuration);
 typedef void (*GAMEBINDS_PRESS)(EGameBinds aGameBind);
 typedef void (*GAMEBINDS_RELEASE)(EGameBinds aGameBind);
 typedef bool (*GAMEBINDS_ISBOUND)(EGameBinds aGameBind);
+typedef void (*GAMEBINDS_INVOKESEQUENCE)(const GameBindMacroStep* aSteps, unsigned aCount);
+typedef unsigned (*GAMEBINDS_CREATEMACRO)(const GameBindMacroStep* aSteps, unsigned aCount);
+typedef void (*GAMEBINDS_INVOKEMACRO)(unsigned aMacro);
+typedef void (*GAMEBINDS_DESTROYMACRO)(unsigned aMacro);
+typedef bool (*GAMEBINDS_ISHELD)(EGameBinds aGameBind);
+typedef void (*GAMEBINDS_CANCEL)(EGameBinds aGameBind);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindMacro.h
+/// Description  :  GameBindMessage and GameBindMacro struct definitions.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef GAMEBINDMACRO_H
+#define GAMEBINDMACRO_H
+
+#include <Windows.h>
+#include <vector>
+
+#include "EGameBinds.h"
+
+///----------------------------------------------------------------------------------------------------
+/// GameBindMessage Struct
+/// 	A precomputed window message of a game bind press or release.
+///----------------------------------------------------------------------------------------------------
+struct GameBindMessage
+{
+	unsigned				Offset;		/* milliseconds since the start of the macro */
+	UINT					Msg;
+	WPARAM					WParam;
+	LPARAM					LParam;		/* mouse messages get the cursor position at the time they are sent */
+	bool					IsMouse;
+	EGameBinds				GameBind;
+	bool					IsRelease;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// GameBindMacro Struct
+/// 	Immutable once compiled.
+///----------------------------------------------------------------------------------------------------
+struct GameBindMacro
+{
+	std::vector<GameBindMessage>	Messages;
+	unsigned long long				RegistryVersion;	/* registry version the messages were compiled from */
+};
+
+#endif
@@ -0,0 +1,26 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindMacroStep.h
+/// Description  :  GameBindMacroStep struct definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef GAMEBINDMACROSTEP_H
+#define GAMEBINDMACROSTEP_H
+
+#include "EGameBinds.h"
+#include "EGameBindMacroAction.h"
+
+///----------------------------------------------------------------------------------------------------
+/// GameBindMacroStep Struct
+/// 	Part of the addon API, the layout must not change.
+///----------------------------------------------------------------------------------------------------
+struct GameBindMacroStep
+{
+	EGameBinds				GameBind;
+	EGameBindMacroAction	Action;
+	unsigned				Delay;		/* milliseconds to wait after the previous step */
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "GameBindsHandler.h"
 
 #include <fstream>
+#include <intrin.h>
 
 #include "Index.h"
 #include "Util/Inputs.h"
@@ -50,6 +51,37 @@ namespace GameBinds
 	{
 		return GameBindsApi->IsBound(aGameBind);
 	}
+
+	void ADDONAPI_InvokeSequence(const GameBindMacroStep* aSteps, unsigned aCount)
+	{
+		GameBindsApi->InvokeSequence(aSteps, aCount);
+	}
+
+	unsigned ADDONAPI_CreateMacro(const GameBindMacroStep* aSteps, unsigned aCount)
+	{
+		/* the caller owns the macro, it is destroyed when its module unloads */
+		return GameBindsApi->CreateMacro(aSteps, aCount, _ReturnAddress());
+	}
+
+	void ADDONAPI_InvokeMacro(unsigned aMacro)
+	{
+		GameBindsApi->InvokeMacro(aMacro);
+	}
+
+	void ADDONAPI_DestroyMacro(unsigned aMacro)
+	{
+		GameBindsApi->DestroyMacro(aMacro);
+	}
+
+	bool ADDONAPI_IsHeld(EGameBinds aGameBind)
+	{
+		return GameBindsApi->IsHeld(aGameBind);
+	}
+
+	void ADDONAPI_Cancel(EGameBinds aGameBind)
+	{
+		GameBindsApi->Cancel(aGameBind);
+	}
 }
 
 std::string CGameBindsApi::ToString(EGameBinds aGameBind)
@@ -690,6 +722,43 @@ CGameBindsApi::CGameBindsApi(CRawInputApi* aRawInputApi, CLogHandler* aLogger, C
 	this->Load();
 	this->AddDefaultBinds();
 
+	this->Scheduler = new CGameBindsScheduler([this](const std::vector<ScheduledGameBind>& aDue)
+	{
+		size_t i = 0;
+
+		while (i < aDue.size())
+		{
+			const ScheduledGameBind& action = aDue[i];
+
+			if (!action.Macro)
+			{
+				if (action.IsRelease)
+				{
+					this->Release(action.GameBind);
+				}
+				else
+				{
+					this->Press(action.GameBind);
+				}
+
+				i++;
+				continue;
+			}
+
+			/* consecutive messages of the same macro are contiguous, send them as one sequence */
+			size_t count = 1;
+			while (i + count < aDue.size() &&
+				aDue[i + count].Macro == action.Macro &&
+				aDue[i + count].Message == action.Message + count)
+			{
+				count++;
+			}
+
+			this->Send(&action.Macro->Messages[action.Message], count);
+			i += count;
+		}
+	});
+
 	CGameBindsApi::EnableUEInputBindUpdates(this);
 	this->EventApi->Subscribe(EV_UE_KB_CH, CGameBindsApi::OnUEInputBindChanged, true);
 
@@ -699,6 +768,15 @@ CGameBindsApi::CGameBindsApi(CRawInputApi* aRawInputApi, CLogHandler* aLogger, C
 
 CGameBindsApi::~CGameBindsApi()
 {
+	/* stopped first, an action already due could press a bind again while they are released */
+	delete this->Scheduler;
+	this->Scheduler = nullptr;
+
+	for (EGameBinds gameBind : this->GetHeld())
+	{
+		this->Release(gameBind);
+	}
+
 	CGameBindsApi::DisableUEInputBindUpdates();
 	this->EventApi->Unsubscribe(EV_UE_KB_CH, CGameBindsApi::OnUEInputBindChanged);
 
@@ -709,25 +787,50 @@ CGameBindsApi::~CGameBindsApi()
 
 void CGameBindsApi::PressAsync(EGameBinds aGameBind)
 {
-	std::thread([this, aGameBind]() {
-		this->Press(aGameBind);
-	}).detach();
+	this->Scheduler->Schedule(aGameBind, false, 0);
 }
 
 void CGameBindsApi::ReleaseAsync(EGameBinds aGameBind)
 {
-	std::thread([this, aGameBind]() {
-		this->Release(aGameBind);
-	}).detach();
+	this->Scheduler->Schedule(aGameBind, true, 0);
 }
 
 void CGameBindsApi::InvokeAsync(EGameBinds aGameBind, int aDuration)
 {
-	std::thread([this, aGameBind, aDuration]() {
-		this->Press(aGameBind);
-		Sleep(aDuration);
+	this->Scheduler->Schedule(aGameBind, false, 0);
+	this->Scheduler->Schedule(aGameBind, true, aDuration > 0 ? static_cast<unsigned>(aDuration) : 0);
+}
+
+void CGameBindsApi::Cancel(EGameBinds aGameBind)
+{
+	if (this->Scheduler->Cancel(aGameBind) && this->IsHeld(aGameBind))
+	{
 		this->Release(aGameBind);
-	}).detach();
+	}
+}
+
+void CGameBindsApi::CancelAll()
+{
+	this->Scheduler->CancelAll();
+
+	for (EGameBinds gameBind : this->GetHeld())
+	{
+		this->Release(gameBind);
+	}
+}
+
+bool CGameBindsApi::IsHeld(EGameBinds aGameBind) const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->HeldBinds.find(aGameBind) != this->HeldBinds.end();
+}
+
+std::vector<EGameBinds> CGameBindsApi::GetHeld() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return std::vector<EGameBinds>(this->HeldBinds.begin(), this->HeldBinds.end());
 }
 
 void CGameBindsApi::Press(EGameBinds aGameBind)
@@ -739,158 +842,261 @@ void CGameBindsApi::Press(EGameBinds aGameBind)
 		return;
 	}
 
-	if (ib.Alt)
+	std::vector<GameBindMessage> messages;
+	CGameBindsApi::CompileMessages(aGameBind, ib, false, 0, messages);
+
+	this->Send(messages.data(), messages.size());
+}
+
+void CGameBindsApi::Release(EGameBinds aGameBind)
+{
+	InputBind ib = this->Get(aGameBind);
+
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_SYSKEYDOWN, VK_MENU, GetKeyMessageLPARAM(VK_MENU, true, true));
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		this->HeldBinds.erase(aGameBind);
 	}
-	if (ib.Ctrl)
+
+	if (!ib.IsBound())
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYDOWN, VK_CONTROL, GetKeyMessageLPARAM(VK_CONTROL, true, false));
+		return;
 	}
-	if (ib.Shift)
+
+	std::vector<GameBindMessage> messages;
+	CGameBindsApi::CompileMessages(aGameBind, ib, true, 0, messages);
+
+	this->Send(messages.data(), messages.size());
+}
+
+void CGameBindsApi::InvokeSequence(const GameBindMacroStep* aSteps, unsigned aCount)
+{
+	if (!aSteps || aCount == 0) { return; }
+
+	this->Scheduler->ScheduleMacro(this->CompileMacro(std::vector<GameBindMacroStep>(aSteps, aSteps + aCount)));
+}
+
+unsigned CGameBindsApi::CreateMacro(const GameBindMacroStep* aSteps, unsigned aCount, void* aOwner)
+{
+	if (!aSteps || aCount == 0) { return 0; }
+
+	MacroEntry entry{};
+	entry.Owner = aOwner;
+	entry.Steps = std::vector<GameBindMacroStep>(aSteps, aSteps + aCount);
+	entry.Compiled = this->CompileMacro(entry.Steps);
+
+	const std::lock_guard<std::mutex> lock(this->MacroMutex);
+
+	unsigned id = this->NextMacroID++;
+	this->Macros.emplace(id, std::move(entry));
+
+	return id;
+}
+
+void CGameBindsApi::InvokeMacro(unsigned aMacro)
+{
+	std::shared_ptr<const GameBindMacro> macro;
+
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYDOWN, VK_SHIFT, GetKeyMessageLPARAM(VK_SHIFT, true, false));
+		const std::lock_guard<std::mutex> lock(this->MacroMutex);
+
+		auto it = this->Macros.find(aMacro);
+
+		if (it == this->Macros.end())
+		{
+			return;
+		}
+
+		/* binds changed since the macro was compiled */
+		if (it->second.Compiled->RegistryVersion != this->RegistryVersion.load())
+		{
+			it->second.Compiled = this->CompileMacro(it->second.Steps);
+		}
+
+		macro = it->second.Compiled;
 	}
 
-	if (ib.Type == EInputBindType::Keyboard)
-	{
-		KeyLParam key{};
-		key.RepeatCount = 1;
-		key.ScanCode = ib.Code;
-		key.ExtendedFlag = (ib.Code & 0xE000) != 0;
-		key.Reserved = 0;
-		key.ContextCode = ib.Alt;
-		key.PreviousKeyState = 0;
-		key.TransitionState = 0;
+	this->Scheduler->ScheduleMacro(macro);
+}
+
+void CGameBindsApi::DestroyMacro(unsigned aMacro)
+{
+	const std::lock_guard<std::mutex> lock(this->MacroMutex);
+
+	/* already scheduled messages keep their own reference */
+	this->Macros.erase(aMacro);
+}
+
+int CGameBindsApi::Verify(void* aStartAddress, void* aEndAddress)
+{
+	const std::lock_guard<std::mutex> lock(this->MacroMutex);
 
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYDOWN, MapVirtualKeyA(ib.Code, MAPVK_VSC_TO_VK), KMFToLParam(key));
+	int refCounter = 0;
+
+	for (auto it = this->Macros.begin(); it != this->Macros.end();)
+	{
+		if (it->second.Owner >= aStartAddress && it->second.Owner <= aEndAddress)
+		{
+			it = this->Macros.erase(it);
+			refCounter++;
+		}
+		else
+		{
+			++it;
+		}
 	}
-	else if (ib.Type == EInputBindType::Mouse)
+
+	return refCounter;
+}
+
+std::shared_ptr<const GameBindMacro> CGameBindsApi::CompileMacro(const std::vector<GameBindMacroStep>& aSteps)
+{
+	std::shared_ptr<GameBindMacro> macro = std::make_shared<GameBindMacro>();
+	macro->Messages.reserve(aSteps.size() * 8);
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	macro->RegistryVersion = this->RegistryVersion.load();
+
+	unsigned offset = 0;
+
+	for (const GameBindMacroStep& step : aSteps)
 	{
-		/* get point for lparam */
-		POINT point{};
-		GetCursorPos(&point);
+		offset += step.Delay;
 
-		switch ((EMouseButtons)ib.Code)
+		auto it = this->Registry.find(step.GameBind);
+
+		if (it == this->Registry.end() || !it->second.IsBound())
 		{
-			case EMouseButtons::LMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_LBUTTONDOWN,
-													 GetMouseMessageWPARAM(EMouseButtons::LMB, ib.Ctrl, ib.Shift, true),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
-			case EMouseButtons::RMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_RBUTTONDOWN,
-													 GetMouseMessageWPARAM(EMouseButtons::RMB, ib.Ctrl, ib.Shift, true),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
-			case EMouseButtons::MMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_MBUTTONDOWN,
-													 GetMouseMessageWPARAM(EMouseButtons::MMB, ib.Ctrl, ib.Shift, true),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
-			case EMouseButtons::M4:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_XBUTTONDOWN,
-													 GetMouseMessageWPARAM(EMouseButtons::M4, ib.Ctrl, ib.Shift, true),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
-			case EMouseButtons::M5:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_XBUTTONDOWN,
-													 GetMouseMessageWPARAM(EMouseButtons::M5, ib.Ctrl, ib.Shift, true),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
+			continue;
+		}
+
+		if (step.Action == EGameBindMacroAction::Press || step.Action == EGameBindMacroAction::Invoke)
+		{
+			CGameBindsApi::CompileMessages(step.GameBind, it->second, false, offset, macro->Messages);
+		}
+		if (step.Action == EGameBindMacroAction::Release || step.Action == EGameBindMacroAction::Invoke)
+		{
+			CGameBindsApi::CompileMessages(step.GameBind, it->second, true, offset, macro->Messages);
 		}
 	}
+
+	macro->Messages.shrink_to_fit();
+
+	return macro;
 }
 
-void CGameBindsApi::Release(EGameBinds aGameBind)
+void CGameBindsApi::CompileMessages(EGameBinds aGameBind, const InputBind& aInputBind, bool aIsRelease, unsigned aOffset, std::vector<GameBindMessage>& aOutMessages)
 {
-	InputBind ib = this->Get(aGameBind);
+	auto push = [&](UINT aMsg, WPARAM aWParam, LPARAM aLParam, bool aIsMouse)
+	{
+		aOutMessages.push_back(GameBindMessage{ aOffset, aMsg, aWParam, aLParam, aIsMouse, aGameBind, aIsRelease });
+	};
 
-	if (!ib.IsBound())
+	/* modifiers are pressed before and released after the key */
+	if (!aIsRelease)
 	{
-		return;
+		if (aInputBind.Alt)
+		{
+			push(WM_SYSKEYDOWN, VK_MENU, GetKeyMessageLPARAM(VK_MENU, true, true), false);
+		}
+		if (aInputBind.Ctrl)
+		{
+			push(WM_KEYDOWN, VK_CONTROL, GetKeyMessageLPARAM(VK_CONTROL, true, false), false);
+		}
+		if (aInputBind.Shift)
+		{
+			push(WM_KEYDOWN, VK_SHIFT, GetKeyMessageLPARAM(VK_SHIFT, true, false), false);
+		}
 	}
 
-	if (ib.Type == EInputBindType::Keyboard)
+	if (aInputBind.Type == EInputBindType::Keyboard)
 	{
 		KeyLParam key{};
 		key.RepeatCount = 1;
-		key.ScanCode = ib.Code;
-		key.ExtendedFlag = (ib.Code & 0xE000) != 0;
+		key.ScanCode = aInputBind.Code;
+		key.ExtendedFlag = (aInputBind.Code & 0xE000) != 0;
 		key.Reserved = 0;
-		key.ContextCode = ib.Alt;
-		key.PreviousKeyState = 1;
-		key.TransitionState = 1;
+		key.ContextCode = aInputBind.Alt;
+		key.PreviousKeyState = aIsRelease;
+		key.TransitionState = aIsRelease;
 
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYUP, MapVirtualKeyA(ib.Code, MAPVK_VSC_TO_VK), KMFToLParam(key));
+		push(aIsRelease ? WM_KEYUP : WM_KEYDOWN, MapVirtualKeyA(aInputBind.Code, MAPVK_VSC_TO_VK), KMFToLParam(key), false);
 	}
-	else if (ib.Type == EInputBindType::Mouse)
+	else if (aInputBind.Type == EInputBindType::Mouse)
 	{
-		/* get point for lparam */
-		POINT point{};
-		GetCursorPos(&point);
+		EMouseButtons button = (EMouseButtons)aInputBind.Code;
+		WPARAM wParam = GetMouseMessageWPARAM(button, aInputBind.Ctrl, aInputBind.Shift, !aIsRelease);
 
-		switch ((EMouseButtons)ib.Code)
+		switch (button)
 		{
 			case EMouseButtons::LMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_LBUTTONUP,
-													 GetMouseMessageWPARAM(EMouseButtons::LMB, ib.Ctrl, ib.Shift, false),
-													 MAKELPARAM(point.x, point.y));
+				push(aIsRelease ? WM_LBUTTONUP : WM_LBUTTONDOWN, wParam, 0, true);
 				break;
-			}
 			case EMouseButtons::RMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_RBUTTONUP,
-													 GetMouseMessageWPARAM(EMouseButtons::RMB, ib.Ctrl, ib.Shift, false),
-													 MAKELPARAM(point.x, point.y));
+				push(aIsRelease ? WM_RBUTTONUP : WM_RBUTTONDOWN, wParam, 0, true);
 				break;
-			}
 			case EMouseButtons::MMB:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_MBUTTONUP,
-													 GetMouseMessageWPARAM(EMouseButtons::MMB, ib.Ctrl, ib.Shift, false),
-													 MAKELPARAM(point.x, point.y));
+				push(aIsRelease ? WM_MBUTTONUP : WM_MBUTTONDOWN, wParam, 0, true);
 				break;
-			}
 			case EMouseButtons::M4:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_XBUTTONUP,
-													 GetMouseMessageWPARAM(EMouseButtons::M4, ib.Ctrl, ib.Shift, false),
-													 MAKELPARAM(point.x, point.y));
-				break;
-			}
 			case EMouseButtons::M5:
-			{
-				this->RawInputApi->SendWndProcToGame(0, WM_XBUTTONUP,
-													 GetMouseMessageWPARAM(EMouseButtons::M5, ib.Ctrl, ib.Shift, false),
-													 MAKELPARAM(point.x, point.y));
+				push(aIsRelease ? WM_XBUTTONUP : WM_XBUTTONDOWN, wParam, 0, true);
 				break;
-			}
 		}
 	}
 
-	if (ib.Alt)
+	if (aIsRelease)
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_SYSKEYUP, VK_MENU, GetKeyMessageLPARAM(VK_MENU, false, true));
+		if (aInputBind.Alt)
+		{
+			push(WM_SYSKEYUP, VK_MENU, GetKeyMessageLPARAM(VK_MENU, false, true), false);
+		}
+		if (aInputBind.Ctrl)
+		{
+			push(WM_KEYUP, VK_CONTROL, GetKeyMessageLPARAM(VK_CONTROL, false, false), false);
+		}
+		if (aInputBind.Shift)
+		{
+			push(WM_KEYUP, VK_SHIFT, GetKeyMessageLPARAM(VK_SHIFT, false, false), false);
+		}
 	}
-	if (ib.Ctrl)
+}
+
+void CGameBindsApi::Send(const GameBindMessage* aMessages, size_t aCount)
+{
+	if (aCount == 0) { return; }
+
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYUP, VK_CONTROL, GetKeyMessageLPARAM(VK_CONTROL, false, false));
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (size_t i = 0; i < aCount; i++)
+		{
+			if (aMessages[i].IsRelease)
+			{
+				this->HeldBinds.erase(aMessages[i].GameBind);
+			}
+			else
+			{
+				this->HeldBinds.insert(aMessages[i].GameBind);
+			}
+		}
 	}
-	if (ib.Shift)
+
+	for (size_t i = 0; i < aCount; i++)
 	{
-		this->RawInputApi->SendWndProcToGame(0, WM_KEYUP, VK_SHIFT, GetKeyMessageLPARAM(VK_SHIFT, false, false));
+		const GameBindMessage& msg = aMessages[i];
+
+		LPARAM lParam = msg.LParam;
+
+		if (msg.IsMouse)
+		{
+			/* get point for lparam */
+			POINT point{};
+			GetCursorPos(&point);
+			lParam = MAKELPARAM(point.x, point.y);
+		}
+
+		this->RawInputApi->SendWndProcToGame(0, msg.Msg, msg.WParam, lParam);
 	}
 }
 
@@ -919,6 +1125,7 @@ void CGameBindsApi::Set(EGameBinds aGameBind, InputBind aInputBind, bool aIsRunt
 		const std::lock_guard<std::mutex> lock(this->Mutex);
 
 		this->Registry[aGameBind] = aInputBind;
+		this->RegistryVersion++;
 
 		if (aIsRuntimeBind)
 		{
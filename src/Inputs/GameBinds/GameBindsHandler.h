@@ -10,11 +10,19 @@
 #define GAMEBINDSHANDLER_H
 
 #include <filesystem>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "EGameBinds.h"
+#include "GameBindMacro.h"
+#include "GameBindMacroStep.h"
+#include "GameBindsScheduler.h"
 
 #include "Events/EventHandler.h"
 #include "Inputs/InputBinds/InputBind.h"
@@ -65,6 +73,44 @@ namespace GameBinds
 	/// 	Returns whether a game bind has a InputBind set or not.
 	///----------------------------------------------------------------------------------------------------
 	bool ADDONAPI_IsBound(EGameBinds aGameBind);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_InvokeSequence:
+	/// 	Compiles and schedules a sequence of game bind presses and releases.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_InvokeSequence(const GameBindMacroStep* aSteps, unsigned aCount);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_CreateMacro:
+	/// 	Compiles a sequence of game bind presses and releases for repeated use.
+	/// 	The macro is destroyed when the calling addon unloads.
+	/// 	Returns the macro handle or 0 if the sequence is empty.
+	///----------------------------------------------------------------------------------------------------
+	unsigned ADDONAPI_CreateMacro(const GameBindMacroStep* aSteps, unsigned aCount);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_InvokeMacro:
+	/// 	Schedules a macro created with CreateMacro.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_InvokeMacro(unsigned aMacro);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_DestroyMacro:
+	/// 	Destroys a macro created with CreateMacro. Already scheduled messages are still sent.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_DestroyMacro(unsigned aMacro);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_IsHeld:
+	/// 	Returns whether a game bind is currently pressed.
+	///----------------------------------------------------------------------------------------------------
+	bool ADDONAPI_IsHeld(EGameBinds aGameBind);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_Cancel:
+	/// 	Cancels the pending async presses and releases of a game bind.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_Cancel(EGameBinds aGameBind);
 }
 
 class CGameBindsApi
@@ -135,6 +181,64 @@ class CGameBindsApi
 	///----------------------------------------------------------------------------------------------------
 	void InvokeAsync(EGameBinds aGameBind, int aDuration);
 
+	///----------------------------------------------------------------------------------------------------
+	/// InvokeSequence:
+	/// 	Compiles and schedules a sequence of game bind presses and releases.
+	///----------------------------------------------------------------------------------------------------
+	void InvokeSequence(const GameBindMacroStep* aSteps, unsigned aCount);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CreateMacro:
+	/// 	Compiles a sequence of game bind presses and releases for repeated use.
+	/// 	aOwner is an address in the module of the creator, see Verify.
+	/// 	Returns the macro handle or 0 if the sequence is empty.
+	///----------------------------------------------------------------------------------------------------
+	unsigned CreateMacro(const GameBindMacroStep* aSteps, unsigned aCount, void* aOwner = nullptr);
+
+	///----------------------------------------------------------------------------------------------------
+	/// InvokeMacro:
+	/// 	Schedules a macro. It is recompiled first, if the game binds changed since.
+	///----------------------------------------------------------------------------------------------------
+	void InvokeMacro(unsigned aMacro);
+
+	///----------------------------------------------------------------------------------------------------
+	/// DestroyMacro:
+	/// 	Destroys a macro. Already scheduled messages are still sent.
+	///----------------------------------------------------------------------------------------------------
+	void DestroyMacro(unsigned aMacro);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Verify:
+	/// 	Destroys all macros created from within the provided address space.
+	/// 	Returns the amount of destroyed macros.
+	///----------------------------------------------------------------------------------------------------
+	int Verify(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Cancel:
+	/// 	Cancels the pending async presses and releases of a game bind.
+	/// 	If its release was pending, the game bind is released immediately.
+	///----------------------------------------------------------------------------------------------------
+	void Cancel(EGameBinds aGameBind);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CancelAll:
+	/// 	Cancels all pending async presses and releases and releases every held game bind.
+	///----------------------------------------------------------------------------------------------------
+	void CancelAll();
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsHeld:
+	/// 	Returns whether a game bind is currently pressed.
+	///----------------------------------------------------------------------------------------------------
+	bool IsHeld(EGameBinds aGameBind) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetHeld:
+	/// 	Returns all currently pressed game binds.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<EGameBinds> GetHeld() const;
+
 	///----------------------------------------------------------------------------------------------------
 	/// Press:
 	/// 	Presses the keys of a game bind.
@@ -184,9 +288,45 @@ class CGameBindsApi
 
 	mutable std::mutex				Mutex;
 	std::map<EGameBinds, InputBind>	Registry;
+	std::set<EGameBinds>			HeldBinds;
+	std::atomic<unsigned long long>	RegistryVersion{ 0 };	/* incremented on every change, invalidates compiled macros */
+
+	CGameBindsScheduler*			Scheduler;
+
+	///----------------------------------------------------------------------------------------------------
+	/// MacroEntry Struct
+	///----------------------------------------------------------------------------------------------------
+	struct MacroEntry
+	{
+		void*									Owner;
+		std::vector<GameBindMacroStep>			Steps;
+		std::shared_ptr<const GameBindMacro>	Compiled;
+	};
+
+	std::mutex								MacroMutex;
+	unsigned								NextMacroID = 1;
+	std::unordered_map<unsigned, MacroEntry>	Macros;
 
 	bool							IsReceivingRuntimeBinds;
 
+	///----------------------------------------------------------------------------------------------------
+	/// CompileMacro:
+	/// 	Compiles macro steps into window messages from the current game binds.
+	///----------------------------------------------------------------------------------------------------
+	std::shared_ptr<const GameBindMacro> CompileMacro(const std::vector<GameBindMacroStep>& aSteps);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CompileMessages:
+	/// 	Appends the window messages of a game bind press or release.
+	///----------------------------------------------------------------------------------------------------
+	static void CompileMessages(EGameBinds aGameBind, const InputBind& aInputBind, bool aIsRelease, unsigned aOffset, std::vector<GameBindMessage>& aOutMessages);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Send:
+	/// 	Sends a sequence of compiled window messages to the game and tracks the held state.
+	///----------------------------------------------------------------------------------------------------
+	void Send(const GameBindMessage* aMessages, size_t aCount);
+
 	///----------------------------------------------------------------------------------------------------
 	/// AddDefaultBinds:
 	/// 	Adds the default binds, if they don't already exist.
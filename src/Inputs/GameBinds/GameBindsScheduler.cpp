@@ -0,0 +1,247 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindsScheduler.cpp
+/// Description  :  Timer wheel for timed game bind presses and releases.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "GameBindsScheduler.h"
+
+#include <algorithm>
+
+CGameBindsScheduler::CGameBindsScheduler(std::function<void(const std::vector<ScheduledGameBind>& aDue)> aSink)
+{
+	this->Sink = aSink;
+	this->IsRunning = true;
+	this->Start = std::chrono::steady_clock::now();
+	this->CurrentTick = 0;
+	this->Wheel.resize(GB_WHEEL_SLOTS);
+	this->Pending = 0;
+
+	this->Thread = std::thread(&CGameBindsScheduler::ProcessWheel, this);
+}
+
+CGameBindsScheduler::~CGameBindsScheduler()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		this->IsRunning = false;
+	}
+
+	this->ConVar.notify_all();
+
+	if (this->Thread.joinable())
+	{
+		this->Thread.join();
+	}
+}
+
+void CGameBindsScheduler::Schedule(EGameBinds aGameBind, bool aIsRelease, unsigned aDelay)
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		unsigned long long due = this->GetFirstFreeTick() + aDelay;
+
+		this->Wheel[due % GB_WHEEL_SLOTS].push_back(ScheduledGameBind{ due, aGameBind, aIsRelease, nullptr, 0 });
+		this->Pending++;
+	}
+
+	this->ConVar.notify_one();
+}
+
+void CGameBindsScheduler::ScheduleMacro(const std::shared_ptr<const GameBindMacro>& aMacro)
+{
+	if (!aMacro || aMacro->Messages.empty()) { return; }
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		unsigned long long start = this->GetFirstFreeTick();
+
+		for (size_t i = 0; i < aMacro->Messages.size(); i++)
+		{
+			const GameBindMessage& msg = aMacro->Messages[i];
+			unsigned long long due = start + msg.Offset;
+
+			this->Wheel[due % GB_WHEEL_SLOTS].push_back(ScheduledGameBind{ due, msg.GameBind, msg.IsRelease, aMacro, i });
+		}
+
+		this->Pending += aMacro->Messages.size();
+	}
+
+	this->ConVar.notify_one();
+}
+
+bool CGameBindsScheduler::Cancel(EGameBinds aGameBind)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	bool droppedRelease = false;
+
+	for (std::vector<ScheduledGameBind>& slot : this->Wheel)
+	{
+		auto it = std::remove_if(slot.begin(), slot.end(), [aGameBind, &droppedRelease](const ScheduledGameBind& action)
+		{
+			if (action.GameBind != aGameBind) { return false; }
+
+			droppedRelease |= action.IsRelease;
+			return true;
+		});
+
+		this->Pending -= std::distance(it, slot.end());
+		slot.erase(it, slot.end());
+	}
+
+	return droppedRelease;
+}
+
+std::vector<EGameBinds> CGameBindsScheduler::CancelAll()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	std::vector<EGameBinds> droppedReleases;
+
+	for (std::vector<ScheduledGameBind>& slot : this->Wheel)
+	{
+		for (const ScheduledGameBind& action : slot)
+		{
+			if (action.IsRelease && std::find(droppedReleases.begin(), droppedReleases.end(), action.GameBind) == droppedReleases.end())
+			{
+				droppedReleases.push_back(action.GameBind);
+			}
+		}
+
+		slot.clear();
+	}
+
+	this->Pending = 0;
+
+	return droppedReleases;
+}
+
+bool CGameBindsScheduler::IsPending(EGameBinds aGameBind) const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (const std::vector<ScheduledGameBind>& slot : this->Wheel)
+	{
+		for (const ScheduledGameBind& action : slot)
+		{
+			if (action.GameBind == aGameBind)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+size_t CGameBindsScheduler::GetPendingCount() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->Pending;
+}
+
+unsigned long long CGameBindsScheduler::GetTick() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->Start).count();
+}
+
+unsigned long long CGameBindsScheduler::GetFirstFreeTick()
+{
+	unsigned long long now = this->GetTick();
+
+	/* the wheel was idle, skip the ticks in between */
+	if (this->Pending == 0 && now > this->CurrentTick)
+	{
+		this->CurrentTick = now - 1;
+	}
+
+	/* never schedule into a tick that was already processed */
+	return (std::max)(now, this->CurrentTick + 1);
+}
+
+void CGameBindsScheduler::ProcessWheel()
+{
+	std::vector<ScheduledGameBind> due;
+
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	while (this->IsRunning)
+	{
+		if (this->Pending == 0)
+		{
+			this->ConVar.wait(lock, [this] { return !this->IsRunning || this->Pending > 0; });
+			continue;
+		}
+
+		unsigned long long now = this->GetTick();
+
+		if (now > this->CurrentTick)
+		{
+			this->CollectDue(now, due);
+		}
+
+		if (!due.empty())
+		{
+			lock.unlock();
+
+			this->Sink(due);
+
+			due.clear();
+
+			lock.lock();
+			continue;
+		}
+
+		/* wake up on the next tick or when something is scheduled */
+		this->ConVar.wait_until(lock, this->Start + std::chrono::milliseconds(this->CurrentTick + 1));
+	}
+}
+
+void CGameBindsScheduler::CollectDue(unsigned long long aTick, std::vector<ScheduledGameBind>& aOutDue)
+{
+	auto collect = [this, aTick, &aOutDue](std::vector<ScheduledGameBind>& aSlot)
+	{
+		auto it = std::stable_partition(aSlot.begin(), aSlot.end(), [aTick](const ScheduledGameBind& action)
+		{
+			return action.Due > aTick;
+		});
+
+		aOutDue.insert(aOutDue.end(), it, aSlot.end());
+		this->Pending -= std::distance(it, aSlot.end());
+		aSlot.erase(it, aSlot.end());
+	};
+
+	if (aTick - this->CurrentTick >= GB_WHEEL_SLOTS)
+	{
+		/* fell behind by more than a revolution, sweep every slot once */
+		for (std::vector<ScheduledGameBind>& slot : this->Wheel)
+		{
+			collect(slot);
+		}
+
+		std::stable_sort(aOutDue.begin(), aOutDue.end(), [](const ScheduledGameBind& lhs, const ScheduledGameBind& rhs)
+		{
+			return lhs.Due < rhs.Due;
+		});
+	}
+	else
+	{
+		for (unsigned long long tick = this->CurrentTick + 1; tick <= aTick; tick++)
+		{
+			std::vector<ScheduledGameBind>& slot = this->Wheel[tick % GB_WHEEL_SLOTS];
+
+			if (!slot.empty())
+			{
+				collect(slot);
+			}
+		}
+	}
+
+	this->CurrentTick = aTick;
+}
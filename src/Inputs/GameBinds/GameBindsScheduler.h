@@ -0,0 +1,135 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  GameBindsScheduler.h
+/// Description  :  Timer wheel for timed game bind presses and releases.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef GAMEBINDSSCHEDULER_H
+#define GAMEBINDSSCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "EGameBinds.h"
+#include "GameBindMacro.h"
+
+constexpr unsigned GB_WHEEL_SLOTS = 1024; /* one slot per millisecond */
+
+///----------------------------------------------------------------------------------------------------
+/// ScheduledGameBind Struct
+///----------------------------------------------------------------------------------------------------
+struct ScheduledGameBind
+{
+	unsigned long long						Due;		/* tick, in milliseconds since the scheduler started */
+	EGameBinds								GameBind;
+	bool									IsRelease;
+	std::shared_ptr<const GameBindMacro>	Macro;		/* set if this is a message of a macro */
+	size_t									Message;	/* index into the macro messages */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CGameBindsScheduler Class
+/// 	Runs presses and releases on a single thread at millisecond resolution.
+/// 	Actions due on the same tick run in the order they were scheduled.
+///----------------------------------------------------------------------------------------------------
+class CGameBindsScheduler
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	/// 	aSink is called from the scheduler thread with the due actions, in order.
+	///----------------------------------------------------------------------------------------------------
+	CGameBindsScheduler(std::function<void(const std::vector<ScheduledGameBind>& aDue)> aSink);
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	/// 	Stops the scheduler, pending actions are dropped.
+	///----------------------------------------------------------------------------------------------------
+	~CGameBindsScheduler();
+
+	CGameBindsScheduler(const CGameBindsScheduler&) = delete;
+	CGameBindsScheduler& operator=(const CGameBindsScheduler&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Schedule:
+	/// 	Schedules a press or release aDelay milliseconds from now.
+	///----------------------------------------------------------------------------------------------------
+	void Schedule(EGameBinds aGameBind, bool aIsRelease, unsigned aDelay);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ScheduleMacro:
+	/// 	Schedules every message of a macro relative to now.
+	///----------------------------------------------------------------------------------------------------
+	void ScheduleMacro(const std::shared_ptr<const GameBindMacro>& aMacro);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Cancel:
+	/// 	Drops all pending actions of a game bind.
+	/// 	Returns true if a pending release was dropped.
+	///----------------------------------------------------------------------------------------------------
+	bool Cancel(EGameBinds aGameBind);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CancelAll:
+	/// 	Drops all pending actions.
+	/// 	Returns the game binds whose pending release was dropped.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<EGameBinds> CancelAll();
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsPending:
+	/// 	Returns true if a game bind has pending actions.
+	///----------------------------------------------------------------------------------------------------
+	bool IsPending(EGameBinds aGameBind) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetPendingCount:
+	/// 	Returns the amount of pending actions.
+	///----------------------------------------------------------------------------------------------------
+	size_t GetPendingCount() const;
+
+private:
+	std::function<void(const std::vector<ScheduledGameBind>&)>	Sink;
+
+	mutable std::mutex								Mutex;
+	std::condition_variable							ConVar;
+	bool											IsRunning;
+	std::thread										Thread;
+
+	std::chrono::steady_clock::time_point			Start;
+	unsigned long long								CurrentTick;	/* last processed tick */
+	std::vector<std::vector<ScheduledGameBind>>		Wheel;
+	size_t											Pending;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTick:
+	/// 	Returns the current tick.
+	///----------------------------------------------------------------------------------------------------
+	unsigned long long GetTick() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetFirstFreeTick:
+	/// 	Returns the first tick that can still be scheduled into. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	unsigned long long GetFirstFreeTick();
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessWheel:
+	/// 	Scheduler loop.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessWheel();
+
+	///----------------------------------------------------------------------------------------------------
+	/// CollectDue:
+	/// 	Moves all actions due up to aTick into aOutDue, in order. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void CollectDue(unsigned long long aTick, std::vector<ScheduledGameBind>& aOutDue);
+};
+
+#endif
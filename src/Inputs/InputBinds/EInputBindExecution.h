@@ -0,0 +1,21 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  EInputBindExecution.h
+/// Description  :  EInputBindExecution enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef INPUTBINDEXECUTION_H
+#define INPUTBINDEXECUTION_H
+
+///----------------------------------------------------------------------------------------------------
+/// EInputBindExecution Enum
+///----------------------------------------------------------------------------------------------------
+typedef enum class EInputBindExecution
+{
+	Worker,			/* run on the handler thread pool */
+	RenderThread	/* run on the render thread at the next frame, ImGui may be used */
+} EIBExecution;
+
+#endif
@@ -2,6 +2,7 @@
 #define INPUTBINDS_FUNCDEFS_H
 
 #include "InputBind.h"
+#include "EInputBindExecution.h"
 
 typedef void (*INPUTBINDS_PROCESS)(const char* aIdentifier);
 typedef void (*INPUTBINDS_REGISTERWITHSTRING)(const char* aIdentifier, INPUTBINDS_PROCESS aInputBindHandler, const char* aInputBind);
@@ -15,4 +16,6 @@ typedef void (*INPUTBINDS_INVOKE)(const char* aIdentifier, bool aIsRelease);
 
 typedef void (*INPUTBINDS_DEREGISTER)(const char* aIdentifier);
 
+typedef void (*INPUTBINDS_SETEXECUTION)(const char* aIdentifier, EInputBindExecution aExecution);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,251 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  InputBindExecutor.cpp
+/// Description  :  Runs InputBind handlers on a worker pool or the render thread.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "InputBindExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "FuncDefs.h"
+
+CInputBindExecutor::CInputBindExecutor(size_t aWorkerCount)
+{
+	this->IsRunning = true;
+
+	for (size_t i = 0; i < std::max<size_t>(aWorkerCount, 1); i++)
+	{
+		this->Workers.emplace_back(&CInputBindExecutor::ProcessQueues, this);
+	}
+}
+
+CInputBindExecutor::~CInputBindExecutor()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		this->IsRunning = false;
+	}
+
+	this->ConVar.notify_all();
+
+	for (std::thread& worker : this->Workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+void CInputBindExecutor::Enqueue(InputBindTask&& aTask, EInputBindExecution aExecution)
+{
+	aTask.Timestamp = std::chrono::high_resolution_clock::now().time_since_epoch() / std::chrono::microseconds(1);
+
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		if (aExecution == EInputBindExecution::RenderThread)
+		{
+			this->RenderQueue.push_back(std::move(aTask));
+			return;
+		}
+
+		Strand& strand = this->Strands[aTask.ID];
+		strand.Tasks.push_back(std::move(aTask));
+
+		/* an active strand is re-queued by the worker running it */
+		if (strand.IsActive)
+		{
+			return;
+		}
+
+		strand.IsActive = true;
+		this->Ready.push_back(strand.Tasks.back().ID);
+	}
+
+	this->ConVar.notify_one();
+}
+
+void CInputBindExecutor::ProcessRenderQueue()
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	if (this->RenderQueue.empty())
+	{
+		return;
+	}
+
+	/* swapped out, so binds pressed while the handlers run are processed on the next frame */
+	this->RenderTasks.swap(this->RenderQueue);
+
+	for (size_t i = 0; i < this->RenderTasks.size(); i++)
+	{
+		InputBindTask task = std::move(this->RenderTasks[i]);
+
+		/* purged while an earlier one ran */
+		if (!task.Handler) { continue; }
+
+		this->RenderTasks[i].Handler = nullptr;
+		this->Execute(lock, task);
+	}
+
+	this->RenderTasks.clear();
+}
+
+int CInputBindExecutor::Purge(void* aStartAddress, void* aEndAddress)
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	auto isInRange = [aStartAddress, aEndAddress](void* aHandler)
+	{
+		return aHandler >= aStartAddress && aHandler <= aEndAddress;
+	};
+
+	auto inRange = [&isInRange](const InputBindTask& aTask)
+	{
+		return isInRange(aTask.Handler);
+	};
+
+	size_t purged = 0;
+
+	for (auto& [id, strand] : this->Strands)
+	{
+		size_t before = strand.Tasks.size();
+		strand.Tasks.erase(std::remove_if(strand.Tasks.begin(), strand.Tasks.end(), inRange), strand.Tasks.end());
+		purged += before - strand.Tasks.size();
+	}
+
+	size_t before = this->RenderQueue.size();
+	this->RenderQueue.erase(std::remove_if(this->RenderQueue.begin(), this->RenderQueue.end(), inRange), this->RenderQueue.end());
+	purged += before - this->RenderQueue.size();
+
+	/* the rest of the frame that is being processed */
+	for (InputBindTask& task : this->RenderTasks)
+	{
+		if (task.Handler && inRange(task))
+		{
+			task.Handler = nullptr;
+			purged++;
+		}
+	}
+
+	this->Stats.Purged += purged;
+
+	auto isRunning = [this, &isInRange]()
+	{
+		for (const Running& run : this->Runs)
+		{
+			/* the handler would wait for itself */
+			if (run.Thread != std::this_thread::get_id() && isInRange(run.Handler))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	};
+
+	this->PurgeWaiters++;
+	this->Idle.wait(lock, [&isRunning] { return !isRunning(); });
+	this->PurgeWaiters--;
+
+	return static_cast<int>(purged);
+}
+
+InputBindExecutorStats CInputBindExecutor::GetStats() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->Stats;
+}
+
+void CInputBindExecutor::ProcessQueues()
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	while (this->IsRunning)
+	{
+		if (this->Ready.empty())
+		{
+			this->ConVar.wait(lock, [this] { return !this->IsRunning || !this->Ready.empty(); });
+			continue;
+		}
+
+		unsigned id = this->Ready.front();
+		this->Ready.pop_front();
+
+		Strand& strand = this->Strands[id];
+
+		/* tasks could have been purged */
+		if (strand.Tasks.empty())
+		{
+			this->Strands.erase(id);
+			continue;
+		}
+
+		/* the strand stays active while running, so no other worker picks up this bind */
+		InputBindTask task = std::move(strand.Tasks.front());
+		strand.Tasks.pop_front();
+
+		this->Execute(lock, task);
+
+		/* the map might have been rehashed, look the strand up again */
+		auto it = this->Strands.find(id);
+
+		if (it->second.Tasks.empty())
+		{
+			this->Strands.erase(it);
+		}
+		else
+		{
+			this->Ready.push_back(id);
+		}
+	}
+}
+
+void CInputBindExecutor::Execute(std::unique_lock<std::mutex>& aLock, const InputBindTask& aTask)
+{
+	long long now = std::chrono::high_resolution_clock::now().time_since_epoch() / std::chrono::microseconds(1);
+	long long latency = now - aTask.Timestamp;
+
+	this->Stats.Executed++;
+	this->Stats.LastLatency = latency;
+	this->Stats.MaxLatency = (std::max)(this->Stats.MaxLatency, latency);
+	this->Stats.TotalLatency += latency;
+	this->Stats.TotalLatencySq += static_cast<double>(latency) * latency;
+
+	this->Runs.push_back(Running{ std::this_thread::get_id(), aTask.Handler });
+
+	aLock.unlock();
+
+	switch (aTask.HandlerType)
+	{
+		case EInputBindHandlerType::DownOnly:
+			((INPUTBINDS_PROCESS)aTask.Handler)(aTask.Identifier.c_str());
+			break;
+		case EInputBindHandlerType::DownAndRelease:
+			((INPUTBINDS_PROCESS2)aTask.Handler)(aTask.Identifier.c_str(), aTask.IsRelease);
+			break;
+	}
+
+	aLock.lock();
+
+	auto it = std::find_if(this->Runs.begin(), this->Runs.end(), [](const Running& aRun)
+	{
+		return aRun.Thread == std::this_thread::get_id();
+	});
+
+	if (it != this->Runs.end())
+	{
+		this->Runs.erase(it);
+	}
+
+	if (this->PurgeWaiters > 0)
+	{
+		this->Idle.notify_all();
+	}
+}
@@ -0,0 +1,144 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  InputBindExecutor.h
+/// Description  :  Runs InputBind handlers on a worker pool or the render thread.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef INPUTBINDEXECUTOR_H
+#define INPUTBINDEXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "EInputBindExecution.h"
+#include "EInputBindHandlerType.h"
+
+///----------------------------------------------------------------------------------------------------
+/// InputBindTask Struct
+///----------------------------------------------------------------------------------------------------
+struct InputBindTask
+{
+	unsigned				ID;				/* bind ID, tasks with the same ID run in order */
+	std::string				Identifier;
+	EInputBindHandlerType	HandlerType;
+	void*					Handler;
+	bool					IsRelease;
+	long long				Timestamp;		/* time of queueing, in microseconds */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// InputBindExecutorStats Struct
+/// 	Latencies are measured from queueing until the handler is called, in microseconds.
+///----------------------------------------------------------------------------------------------------
+struct InputBindExecutorStats
+{
+	unsigned long long		Executed;
+	unsigned long long		Purged;
+	long long				LastLatency;
+	long long				MaxLatency;
+	long long				TotalLatency;
+	double					TotalLatencySq;	/* sum of squares, for the deviation */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CInputBindExecutor Class
+/// 	Each bind has a serial queue: its press and release are never run concurrently or out of order.
+/// 	Different binds run in parallel on the workers.
+///----------------------------------------------------------------------------------------------------
+class CInputBindExecutor
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CInputBindExecutor(size_t aWorkerCount);
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	/// 	Stops the workers, pending tasks are dropped.
+	///----------------------------------------------------------------------------------------------------
+	~CInputBindExecutor();
+
+	CInputBindExecutor(const CInputBindExecutor&) = delete;
+	CInputBindExecutor& operator=(const CInputBindExecutor&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Enqueue:
+	/// 	Queues a handler call.
+	///----------------------------------------------------------------------------------------------------
+	void Enqueue(InputBindTask&& aTask, EInputBindExecution aExecution);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessRenderQueue:
+	/// 	Runs the handlers queued for the render thread. Called once per frame from the render thread.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessRenderQueue();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Purge:
+	/// 	Drops all pending tasks whose handler is within the provided address space and waits for
+	/// 	running ones to return, unless called from within one of them.
+	/// 	Returns the amount of dropped tasks.
+	///----------------------------------------------------------------------------------------------------
+	int Purge(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStats:
+	/// 	Returns the execution statistics.
+	///----------------------------------------------------------------------------------------------------
+	InputBindExecutorStats GetStats() const;
+
+private:
+	///----------------------------------------------------------------------------------------------------
+	/// Strand Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Strand
+	{
+		std::deque<InputBindTask>	Tasks;
+		bool						IsActive;	/* queued in Ready or currently running */
+	};
+
+	///----------------------------------------------------------------------------------------------------
+	/// Running Struct
+	///----------------------------------------------------------------------------------------------------
+	struct Running
+	{
+		std::thread::id				Thread;
+		void*						Handler;
+	};
+
+	mutable std::mutex							Mutex;
+	std::condition_variable						ConVar;
+	std::condition_variable						Idle;			/* signaled after a call, while a purge waits */
+	bool										IsRunning;
+	int											PurgeWaiters	= 0;
+	std::vector<std::thread>					Workers;
+
+	std::unordered_map<unsigned, Strand>		Strands;
+	std::deque<unsigned>						Ready;
+	std::vector<InputBindTask>					RenderQueue;
+	std::vector<InputBindTask>					RenderTasks;	/* the frame being processed */
+	std::vector<Running>						Runs;
+
+	InputBindExecutorStats						Stats{};
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessQueues:
+	/// 	Worker loop.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessQueues();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Execute:
+	/// 	Calls the handler of a task. The lock is released during the call.
+	///----------------------------------------------------------------------------------------------------
+	void Execute(std::unique_lock<std::mutex>& aLock, const InputBindTask& aTask);
+};
+
+#endif
@@ -8,10 +8,12 @@
 
 #include "InputBindHandler.h"
 
+#include <chrono>
 #include <cstdarg>
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <thread>
 
 #include "Consts.h"
 #include "Index.h"
@@ -57,6 +59,11 @@ namespace InputBinds
 	{
 		InputBindApi->Deregister(aIdentifier);
 	}
+
+	void ADDONAPI_SetExecution(const char* aIdentifier, EInputBindExecution aExecution)
+	{
+		InputBindApi->SetExecution(aIdentifier, aExecution);
+	}
 }
 
 static bool IsLookupTableBuilt = false;
@@ -288,10 +295,24 @@ std::string CInputBindApi::IBToString(InputBind aInputBind, bool aPadded)
 }
 
 CInputBindApi::CInputBindApi(CLogHandler* aLogger)
+	: Executor(IB_EXECUTOR_WORKERS)
 {
 	this->Logger = aLogger;
 
 	this->Load();
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+	this->BuildLookup();
+}
+
+CInputBindApi::~CInputBindApi()
+{
+	for (InputBindLookup* lookup : this->RetiredLookups)
+	{
+		delete lookup;
+	}
+
+	delete this->Lookup.load();
 }
 
 UINT CInputBindApi::WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -542,6 +563,8 @@ void CInputBindApi::Register(const char* aIdentifier, EInputBindHandlerType aInp
 			it->second.HandlerType = aInputBindHandlerType;
 			it->second.Handler = aInputBindHandler;
 		}
+
+		this->BuildLookup();
 	}
 
 	this->Save();
@@ -560,6 +583,8 @@ void CInputBindApi::Deregister(const char* aIdentifier)
 		{
 			it->second.Handler = nullptr;
 		}
+
+		this->BuildLookup();
 	}
 
 	this->Save();
@@ -594,6 +619,8 @@ void CInputBindApi::Set(std::string aIdentifier, InputBind aInputBind)
 		const std::lock_guard<std::mutex> lock(this->Mutex);
 
 		this->Registry[aIdentifier].Bind = aInputBind;
+
+		this->BuildLookup();
 	}
 
 	this->Save();
@@ -601,38 +628,52 @@ void CInputBindApi::Set(std::string aIdentifier, InputBind aInputBind)
 
 bool CInputBindApi::Invoke(std::string aIdentifier, bool aIsRelease)
 {
-	bool called = false;
-
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
-	auto& bind = this->Registry[aIdentifier];
+	auto it = this->Registry.find(aIdentifier);
+
+	if (it == this->Registry.end())
+	{
+		return false;
+	}
 
-	void* handlerFunc = bind.Handler;
-	EInputBindHandlerType type = bind.HandlerType;
+	auto idIt = this->BindIDs.find(aIdentifier);
 
-	if (handlerFunc)
+	if (idIt == this->BindIDs.end())
 	{
-		if ((bind.HandlerType == EInputBindHandlerType::DownOnly && !aIsRelease) ||
-			bind.HandlerType == EInputBindHandlerType::DownAndRelease)
-		{
-			std::thread([aIdentifier, type, handlerFunc, aIsRelease]()
-			{
-				switch (type)
-				{
-					case EInputBindHandlerType::DownOnly:
-						((INPUTBINDS_PROCESS)handlerFunc)(aIdentifier.c_str());
-						break;
-					case EInputBindHandlerType::DownAndRelease:
-						((INPUTBINDS_PROCESS2)handlerFunc)(aIdentifier.c_str(), aIsRelease);
-						break;
-				}
-			}).detach();
+		return false;
+	}
 
-			called = true;
-		}
+	return this->Dispatch(idIt->second, it->first, it->second, aIsRelease);
+}
+
+void CInputBindApi::SetExecution(const char* aIdentifier, EInputBindExecution aExecution)
+{
+	if (!aIdentifier) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	auto it = this->Registry.find(aIdentifier);
+
+	if (it == this->Registry.end())
+	{
+		Logger->Warning(CH_INPUTBINDS, "Execution set for an InputBind that is not registered: %s", aIdentifier);
+		return;
 	}
 
-	return called;
+	it->second.Execution = aExecution;
+
+	this->BuildLookup();
+}
+
+void CInputBindApi::ProcessRenderQueue()
+{
+	this->Executor.ProcessRenderQueue();
+}
+
+InputBindExecutorStats CInputBindApi::GetExecutorStats() const
+{
+	return this->Executor.GetStats();
 }
 
 void CInputBindApi::Delete(std::string aIdentifier)
@@ -640,23 +681,41 @@ void CInputBindApi::Delete(std::string aIdentifier)
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
 	this->Registry.erase(aIdentifier);
+
+	this->BuildLookup();
 }
 
 int CInputBindApi::Verify(void* aStartAddress, void* aEndAddress)
 {
 	int refCounter = 0;
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
-
-	for (auto& [identifier, activekb] : this->Registry)
 	{
-		if (activekb.Handler >= aStartAddress && activekb.Handler <= aEndAddress)
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (auto& [identifier, activekb] : this->Registry)
 		{
-			activekb.Handler = nullptr;
-			refCounter++;
+			if (activekb.Handler >= aStartAddress && activekb.Handler <= aEndAddress)
+			{
+				activekb.Handler = nullptr;
+				refCounter++;
+			}
+		}
+
+		if (refCounter > 0)
+		{
+			this->BuildLookup();
 		}
 	}
 
+	/* a WndProc still holding the previous table could queue a handler after the purge */
+	while (this->LookupReaders.load() != 0)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	/* not under the mutex, a running handler may call back into the api */
+	this->Executor.Purge(aStartAddress, aEndAddress);
+
 	return refCounter;
 }
 
@@ -782,21 +841,41 @@ void CInputBindApi::Save()
 
 bool CInputBindApi::Press(const InputBind& aInputBind)
 {
-	auto heldBind = this->FindInputBind(aInputBind);
+	const InputBindLookup* lookup = this->AcquireLookup();
+
+	unsigned id = FindInputBind(lookup, aInputBind);
 
 	/* if held bind does not match any registered */
-	if (heldBind == this->Registry.end())
+	if (id == 0)
 	{
+		this->ReleaseLookup();
 		return false;
 	}
 
+	const InputBindEntry& entry = lookup->Binds[id];
+
 	/* track the actual bind/id combo */
-	this->HeldInputBinds[heldBind->first] = heldBind->second;
+	auto heldIt = std::find_if(this->HeldInputBinds.begin(), this->HeldInputBinds.end(), [id](const HeldInputBind& held)
+	{
+		return held.ID == id;
+	});
+
+	if (heldIt == this->HeldInputBinds.end())
+	{
+		this->HeldInputBinds.push_back(HeldInputBind{ id, entry.Bind.Bind });
+	}
+	else
+	{
+		heldIt->Bind = entry.Bind.Bind;
+	}
 
-	bool invoked = this->Invoke(heldBind->first);;
+	bool invoked = this->Dispatch(id, entry.Identifier, entry.Bind, false);
+	bool passThrough = entry.Identifier == KB_TOGGLEHIDEUI;
+
+	this->ReleaseLookup();
 
 	/* if was invoked -> stop processing (unless it was the togglehideui bind, pass through for multi hide)*/
-	if (invoked && heldBind->first != KB_TOGGLEHIDEUI)
+	if (invoked && !passThrough)
 	{
 		return true;
 	}
@@ -806,50 +885,54 @@ bool CInputBindApi::Press(const InputBind& aInputBind)
 
 void CInputBindApi::Release(unsigned int aModifierVK)
 {
-	std::vector<std::string> heldBindsPop;
+	const InputBindLookup* lookup = this->AcquireLookup();
 
-	for (auto& entry : this->HeldInputBinds)
+	auto it = this->HeldInputBinds.begin();
+	while (it != this->HeldInputBinds.end())
 	{
-		if (aModifierVK == VK_SHIFT && entry.second.Bind.Shift)
-		{
-			this->Invoke(entry.first, true);
-			heldBindsPop.push_back(entry.first);
-		}
-		else if (aModifierVK == VK_CONTROL && entry.second.Bind.Ctrl)
+		if ((aModifierVK == VK_SHIFT && it->Bind.Shift) ||
+			(aModifierVK == VK_CONTROL && it->Bind.Ctrl) ||
+			(aModifierVK == VK_MENU && it->Bind.Alt))
 		{
-			this->Invoke(entry.first, true);
-			heldBindsPop.push_back(entry.first);
+			if (lookup && it->ID < lookup->Binds.size())
+			{
+				this->Dispatch(it->ID, lookup->Binds[it->ID].Identifier, lookup->Binds[it->ID].Bind, true);
+			}
+
+			it = this->HeldInputBinds.erase(it);
 		}
-		else if (aModifierVK == VK_MENU && entry.second.Bind.Alt)
+		else
 		{
-			this->Invoke(entry.first, true);
-			heldBindsPop.push_back(entry.first);
+			++it;
 		}
 	}
 
-	for (auto entry : heldBindsPop)
-	{
-		this->HeldInputBinds.erase(entry);
-	}
+	this->ReleaseLookup();
 }
 
 void CInputBindApi::Release(EInputBindType aType, unsigned short aCode)
 {
-	std::vector<std::string> heldBindsPop;
+	const InputBindLookup* lookup = this->AcquireLookup();
 
-	for (auto& entry : this->HeldInputBinds)
+	auto it = this->HeldInputBinds.begin();
+	while (it != this->HeldInputBinds.end())
 	{
-		if (entry.second.Bind.Type == aType && entry.second.Bind.Code == aCode)
+		if (it->Bind.Type == aType && it->Bind.Code == aCode)
 		{
-			this->Invoke(entry.first, true);
-			heldBindsPop.push_back(entry.first);
+			if (lookup && it->ID < lookup->Binds.size())
+			{
+				this->Dispatch(it->ID, lookup->Binds[it->ID].Identifier, lookup->Binds[it->ID].Bind, true);
+			}
+
+			it = this->HeldInputBinds.erase(it);
+		}
+		else
+		{
+			++it;
 		}
 	}
 
-	for (auto entry : heldBindsPop)
-	{
-		this->HeldInputBinds.erase(entry);
-	}
+	this->ReleaseLookup();
 }
 
 void CInputBindApi::ReleaseAll()
@@ -858,18 +941,132 @@ void CInputBindApi::ReleaseAll()
 	this->IsCtrlHeld = false;
 	this->IsShiftHeld = false;
 
-	for (auto& bind : this->HeldInputBinds)
+	const InputBindLookup* lookup = this->AcquireLookup();
+
+	for (const HeldInputBind& held : this->HeldInputBinds)
 	{
-		this->Invoke(bind.first, true);
+		if (lookup && held.ID < lookup->Binds.size())
+		{
+			this->Dispatch(held.ID, lookup->Binds[held.ID].Identifier, lookup->Binds[held.ID].Bind, true);
+		}
 	}
 
+	this->ReleaseLookup();
+
 	this->HeldInputBinds.clear();
 }
 
-std::map<std::string, ManagedInputBind>::iterator CInputBindApi::FindInputBind(const InputBind& aInputBind)
+bool CInputBindApi::Dispatch(unsigned aID, const std::string& aIdentifier, const ManagedInputBind& aBind, bool aIsRelease)
 {
-	return std::find_if(this->Registry.begin(), this->Registry.end(), [aInputBind](auto& entry)
+	if (!aBind.Handler)
 	{
-		return entry.second.Bind == aInputBind;
-	});
+		return false;
+	}
+
+	if ((aBind.HandlerType == EInputBindHandlerType::DownOnly && !aIsRelease) ||
+		aBind.HandlerType == EInputBindHandlerType::DownAndRelease)
+	{
+		this->Executor.Enqueue(InputBindTask{ aID, aIdentifier, aBind.HandlerType, aBind.Handler, aIsRelease, 0 }, aBind.Execution);
+
+		return true;
+	}
+
+	return false;
+}
+
+int CInputBindApi::GetLookupSlot(const InputBind& aInputBind)
+{
+	unsigned type = static_cast<unsigned>(aInputBind.Type);
+	unsigned code = aInputBind.Code;
+
+	if (type == 0 || type >= IB_LOOKUP_TYPES) { return -1; }
+
+	/* fold the extended flag (0xE000) into bit 8 */
+	if ((code & 0xFF00) == 0xE000)
+	{
+		code = (code & 0xFF) | 0x100;
+	}
+	else if (code > 0xFF)
+	{
+		return -1;
+	}
+
+	unsigned modifiers = (aInputBind.Alt ? 1 : 0) | (aInputBind.Ctrl ? 2 : 0) | (aInputBind.Shift ? 4 : 0);
+
+	return static_cast<int>(((type * IB_LOOKUP_CODES) + code) * IB_LOOKUP_MODIFIERS + modifiers);
+}
+
+void CInputBindApi::BuildLookup()
+{
+	InputBindLookup* lookup = new InputBindLookup();
+	lookup->Slots.resize(IB_LOOKUP_SLOTS, 0);
+
+	for (auto& [identifier, bind] : this->Registry)
+	{
+		auto idIt = this->BindIDs.find(identifier);
+
+		if (idIt == this->BindIDs.end())
+		{
+			idIt = this->BindIDs.emplace(identifier, static_cast<unsigned>(this->BindIDs.size() + 1)).first;
+		}
+
+		if (lookup->Binds.size() <= idIt->second)
+		{
+			lookup->Binds.resize(this->BindIDs.size() + 1);
+		}
+
+		lookup->Binds[idIt->second] = InputBindEntry{ identifier, bind };
+
+		int slot = GetLookupSlot(bind.Bind);
+
+		/* first one wins, same as iterating the registry */
+		if (slot >= 0 && lookup->Slots[slot] == 0)
+		{
+			lookup->Slots[slot] = idIt->second;
+		}
+	}
+
+	/* deleted binds keep their ID, their entry stays empty */
+	lookup->Binds.resize(this->BindIDs.size() + 1);
+
+	InputBindLookup* previous = this->Lookup.exchange(lookup);
+
+	if (previous)
+	{
+		this->RetiredLookups.push_back(previous);
+	}
+
+	/* a reader that arrives after this point can only see the new table */
+	if (this->LookupReaders.load() == 0)
+	{
+		for (InputBindLookup* retired : this->RetiredLookups)
+		{
+			delete retired;
+		}
+
+		this->RetiredLookups.clear();
+	}
+}
+
+const InputBindLookup* CInputBindApi::AcquireLookup()
+{
+	this->LookupReaders++;
+
+	return this->Lookup.load();
+}
+
+void CInputBindApi::ReleaseLookup()
+{
+	this->LookupReaders--;
+}
+
+unsigned CInputBindApi::FindInputBind(const InputBindLookup* aLookup, const InputBind& aInputBind)
+{
+	if (!aLookup) { return 0; }
+
+	int slot = GetLookupSlot(aInputBind);
+
+	if (slot < 0) { return 0; }
+
+	return aLookup->Slots[slot];
 }
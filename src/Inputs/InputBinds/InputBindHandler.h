@@ -10,6 +10,7 @@
 #define INPUTBINDHANDLER_H
 
 #include <Windows.h>
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
@@ -17,11 +18,14 @@
 
 #include "FuncDefs.h"
 #include "InputBind.h"
+#include "InputBindExecutor.h"
+#include "InputBindLookup.h"
 #include "ManagedInputBind.h"
 
 #include "Services/Logging/LogHandler.h"
 
 constexpr const char* CH_INPUTBINDS = "InputBinds";
+constexpr size_t IB_EXECUTOR_WORKERS = 2;
 
 ///----------------------------------------------------------------------------------------------------
 /// InputBinds Namespace
@@ -63,6 +67,12 @@ namespace InputBinds
 	/// 	Addon API wrapper function for Deregister.
 	///----------------------------------------------------------------------------------------------------
 	void ADDONAPI_Deregister(const char* aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_SetExecution:
+	/// 	Addon API wrapper function for SetExecution.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_SetExecution(const char* aIdentifier, EInputBindExecution aExecution);
 }
 
 ///----------------------------------------------------------------------------------------------------
@@ -97,11 +107,12 @@ class CInputBindApi
 	///----------------------------------------------------------------------------------------------------
 	/// dtor
 	///----------------------------------------------------------------------------------------------------
-	~CInputBindApi() = default;
+	~CInputBindApi();
 
 	///----------------------------------------------------------------------------------------------------
 	/// WndProc:
 	/// 	Returns 0 if a InputBind was invoked.
+	/// 	Binds are matched via the lookup table, without locking.
 	///----------------------------------------------------------------------------------------------------
 	UINT WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
@@ -144,6 +155,24 @@ class CInputBindApi
 	///----------------------------------------------------------------------------------------------------
 	bool Invoke(std::string aIdentifier, bool aIsRelease = false);
 
+	///----------------------------------------------------------------------------------------------------
+	/// SetExecution:
+	/// 	Sets where the handler of an InputBind runs.
+	///----------------------------------------------------------------------------------------------------
+	void SetExecution(const char* aIdentifier, EInputBindExecution aExecution);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessRenderQueue:
+	/// 	Runs the handlers of InputBinds executed on the render thread. Called once per frame.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessRenderQueue();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetExecutorStats:
+	/// 	Returns the handler execution statistics.
+	///----------------------------------------------------------------------------------------------------
+	InputBindExecutorStats GetExecutorStats() const;
+
 	///----------------------------------------------------------------------------------------------------
 	/// Deletes:
 	/// 	Deletes a InputBind entirely.
@@ -153,6 +182,7 @@ class CInputBindApi
 	///----------------------------------------------------------------------------------------------------
 	/// Verify:
 	/// 	Removes all InputBindHandlers that are within the provided address space.
+	/// 	Pending handler calls into the address space are dropped.
 	///----------------------------------------------------------------------------------------------------
 	int Verify(void* aStartAddress, void* aEndAddress);
 
@@ -186,13 +216,20 @@ class CInputBindApi
 	mutable std::mutex						Mutex;
 	std::map<std::string, ManagedInputBind>	Registry;
 
-	bool									IsCapturing;
-	InputBind								CapturedInputBind;
+	bool									IsCapturing{ false };
+	InputBind								CapturedInputBind{};
 
-	bool									IsAltHeld;
-	bool									IsCtrlHeld;
-	bool									IsShiftHeld;
-	std::map<std::string, ManagedInputBind>	HeldInputBinds;
+	bool									IsAltHeld{ false };
+	bool									IsCtrlHeld{ false };
+	bool									IsShiftHeld{ false };
+	std::vector<HeldInputBind>				HeldInputBinds;
+
+	std::map<std::string, unsigned>			BindIDs;			/* identifier to bind ID, never reused */
+	std::atomic<InputBindLookup*>			Lookup{ nullptr };
+	std::atomic<int>						LookupReaders{ 0 };
+	std::vector<InputBindLookup*>			RetiredLookups;		/* freed once no reader is active */
+
+	CInputBindExecutor						Executor;
 
 	///----------------------------------------------------------------------------------------------------
 	/// Load:
@@ -231,11 +268,42 @@ class CInputBindApi
 	///----------------------------------------------------------------------------------------------------
 	void ReleaseAll();
 
+	///----------------------------------------------------------------------------------------------------
+	/// Dispatch:
+	/// 	Queues the handler of a bind, if it handles the given direction.
+	/// 	Returns true if the InputBind was dispatched.
+	///----------------------------------------------------------------------------------------------------
+	bool Dispatch(unsigned aID, const std::string& aIdentifier, const ManagedInputBind& aBind, bool aIsRelease);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetLookupSlot:
+	/// 	Returns the slot of an InputBind in the lookup table or -1 if it cannot be represented.
+	///----------------------------------------------------------------------------------------------------
+	static int GetLookupSlot(const InputBind& aInputBind);
+
+	///----------------------------------------------------------------------------------------------------
+	/// BuildLookup:
+	/// 	Rebuilds and publishes the lookup table. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void BuildLookup();
+
+	///----------------------------------------------------------------------------------------------------
+	/// AcquireLookup:
+	/// 	Returns the current lookup table, it stays valid until ReleaseLookup is called.
+	///----------------------------------------------------------------------------------------------------
+	const InputBindLookup* AcquireLookup();
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReleaseLookup:
+	/// 	Releases a lookup table acquired via AcquireLookup.
+	///----------------------------------------------------------------------------------------------------
+	void ReleaseLookup();
+
 	///----------------------------------------------------------------------------------------------------
 	/// FindInputBind:
-	/// 	Finds a registry entry based on the InputBind values.
+	/// 	Returns the ID of the bind matching the InputBind values or 0.
 	///----------------------------------------------------------------------------------------------------
-	std::map<std::string, ManagedInputBind>::iterator FindInputBind(const InputBind& aInputBind);
+	static unsigned FindInputBind(const InputBindLookup* aLookup, const InputBind& aInputBind);
 };
 
 #endif
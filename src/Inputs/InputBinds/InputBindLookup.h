@@ -0,0 +1,54 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  InputBindLookup.h
+/// Description  :  InputBindLookup struct definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef INPUTBINDLOOKUP_H
+#define INPUTBINDLOOKUP_H
+
+#include <string>
+#include <vector>
+
+#include "InputBind.h"
+#include "ManagedInputBind.h"
+
+/* keyboard codes are 8 bit scan codes plus the extended flag, mouse codes are EMouseButtons */
+constexpr unsigned IB_LOOKUP_TYPES		= 3;
+constexpr unsigned IB_LOOKUP_CODES		= 512;
+constexpr unsigned IB_LOOKUP_MODIFIERS	= 8;
+constexpr unsigned IB_LOOKUP_SLOTS		= IB_LOOKUP_TYPES * IB_LOOKUP_CODES * IB_LOOKUP_MODIFIERS;
+
+///----------------------------------------------------------------------------------------------------
+/// InputBindEntry Struct
+///----------------------------------------------------------------------------------------------------
+struct InputBindEntry
+{
+	std::string				Identifier;
+	ManagedInputBind		Bind;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// InputBindLookup Struct
+/// 	Immutable once published.
+/// 	Slots maps (type, code, modifiers) to a bind ID, 0 if nothing is bound.
+/// 	Binds maps a bind ID to the registry entry, IDs are never reused.
+///----------------------------------------------------------------------------------------------------
+struct InputBindLookup
+{
+	std::vector<unsigned>			Slots;
+	std::vector<InputBindEntry>		Binds;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// HeldInputBind Struct
+///----------------------------------------------------------------------------------------------------
+struct HeldInputBind
+{
+	unsigned				ID;
+	InputBind				Bind;
+};
+
+#endif
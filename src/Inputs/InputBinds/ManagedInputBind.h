@@ -11,6 +11,7 @@
 
 #include "InputBind.h"
 #include "EInputBindHandlerType.h"
+#include "EInputBindExecution.h"
 
 ///----------------------------------------------------------------------------------------------------
 /// ManagedInputBind Struct
@@ -20,6 +21,7 @@ struct ManagedInputBind
 	InputBind				Bind;
 	EInputBindHandlerType	HandlerType;
 	void*					Handler;
+	EInputBindExecution		Execution;
 };
 
 #endif
@@ -5,6 +5,7 @@
 
 typedef UINT	(*WNDPROC_CALLBACK)(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 typedef void	(*WNDPROC_ADDREM)(WNDPROC_CALLBACK aWndProcCallback);
+typedef void	(*WNDPROC_ADDFILTERED)(WNDPROC_CALLBACK aWndProcCallback, UINT aMsgFirst, UINT aMsgLast);
 typedef LRESULT	(*WNDPROC_SENDTOGAME)(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
 #endif
\ No newline at end of file
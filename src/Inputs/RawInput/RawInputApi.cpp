@@ -8,10 +8,17 @@
 
 #include "RawInputApi.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include "Hooks.h"
 #include "Renderer.h"
 #include "Shared.h"
 
+/* dispatches running on this thread, a callback can send a message that is dispatched from within */
+static thread_local int DispatchDepth = 0;
+
 namespace RawInput
 {
 	LRESULT ADDONAPI_SendWndProcToGame(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -24,26 +31,92 @@ namespace RawInput
 		RawInputApi->Register(aWndProcCallback);
 	}
 
+	void ADDONAPI_RegisterFiltered(WNDPROC_CALLBACK aWndProcCallback, UINT aMsgFirst, UINT aMsgLast)
+	{
+		RawInputApi->Register(aWndProcCallback, aMsgFirst, aMsgLast);
+	}
+
 	void ADDONAPI_Deregister(WNDPROC_CALLBACK aWndProcCallback)
 	{
 		RawInputApi->Deregister(aWndProcCallback);
 	}
 }
 
+CRawInputApi::CRawInputApi()
+{
+	this->Snapshot = new WndProcRegistry();
+}
+
+CRawInputApi::~CRawInputApi()
+{
+	for (WndProcRegistry* retired : this->RetiredSnapshots)
+	{
+		delete retired;
+	}
+
+	delete this->Snapshot.load();
+}
+
 UINT CRawInputApi::WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-	// don't pass to game if addon wndproc
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+	DispatchDepth++;
 
-	for (WNDPROC_CALLBACK wndprocCb : this->Registry)
+	/* callbacks may register or deregister from within, the snapshot stays valid until released */
+	this->SnapshotReaders++;
+	const WndProcRegistry* registry = this->Snapshot.load();
+
+	UINT result = 1;
+
+	/* the end of one callback is the start of the next, one clock read per called callback */
+	long long start = 0;
+
+	for (const WndProcCallback& entry : registry->Callbacks)
 	{
-		if (wndprocCb(hWnd, uMsg, wParam, lParam) == 0)
+		if (uMsg < entry.MsgFirst || uMsg > entry.MsgLast)
 		{
-			return 0;
+			start = 0;
+			continue;
 		}
+
+		if (start == 0)
+		{
+			start = std::chrono::high_resolution_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+		}
+
+		UINT ret = entry.Callback(hWnd, uMsg, wParam, lParam);
+
+		long long end = std::chrono::high_resolution_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+		long long time = end - start;
+		start = end;
+
+		/* only the window thread writes, no read-modify-write needed */
+		WndProcCallbackStats& stats = *entry.Stats;
+		stats.Calls.store(stats.Calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		stats.TotalTime.store(stats.TotalTime.load(std::memory_order_relaxed) + time, std::memory_order_relaxed);
+		if (time > stats.MaxTime.load(std::memory_order_relaxed))
+		{
+			stats.MaxTime.store(time, std::memory_order_relaxed);
+		}
+
+		CallbackWatchdog->Record(ECallbackType::WndProc, (void*)entry.Callback, time);
+
+		// don't pass to game if addon wndproc
+		if (ret == 0)
+		{
+			result = 0;
+			break;
+		}
+	}
+
+	/* only the outermost dispatch has ended with every callback of its snapshot */
+	if (--DispatchDepth == 0)
+	{
+		this->DispatchesCompleted++;
 	}
 
-	return 1;
+	this->SnapshotReaders--;
+
+	return result;
 }
 
 LRESULT CRawInputApi::SendWndProcToGame(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
@@ -51,33 +124,109 @@ LRESULT CRawInputApi::SendWndProcToGame(HWND hWnd, UINT uMsg, WPARAM wParam, LPA
 	return CallWindowProcA(Hooks::GW2::WndProc, Renderer::WindowHandle, uMsg, wParam, lParam);
 }
 
-void CRawInputApi::Register(WNDPROC_CALLBACK aWndProcCallback)
+void CRawInputApi::Register(WNDPROC_CALLBACK aWndProcCallback, UINT aMsgFirst, UINT aMsgLast)
 {
+	if (!aWndProcCallback || aMsgFirst > aMsgLast) { return; }
+
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
-	this->Registry.push_back(aWndProcCallback);
+	this->Registry.push_back(WndProcCallback{ aWndProcCallback, aMsgFirst, aMsgLast, std::make_shared<WndProcCallbackStats>() });
+
+	this->Publish();
 }
 
 void CRawInputApi::Deregister(WNDPROC_CALLBACK aWndProcCallback)
 {
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		this->Registry.erase(std::remove_if(this->Registry.begin(), this->Registry.end(), [aWndProcCallback](const WndProcCallback& entry)
+		{
+			return entry.Callback == aWndProcCallback;
+		}), this->Registry.end());
+
+		this->Publish();
+	}
 
-	this->Registry.erase(std::remove(this->Registry.begin(), this->Registry.end(), aWndProcCallback), this->Registry.end());
+	this->WaitForDispatch();
 }
 
 int CRawInputApi::Verify(void* aStartAddress, void* aEndAddress)
 {
 	int refCounter = 0;
 
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		auto it = std::remove_if(this->Registry.begin(), this->Registry.end(), [aStartAddress, aEndAddress](const WndProcCallback& entry)
+		{
+			return entry.Callback >= aStartAddress && entry.Callback <= aEndAddress;
+		});
+
+		refCounter = static_cast<int>(std::distance(it, this->Registry.end()));
+
+		if (refCounter == 0) { return 0; }
+
+		this->Registry.erase(it, this->Registry.end());
+		this->Publish();
+	}
+
+	this->WaitForDispatch();
+
+	return refCounter;
+}
+
+std::vector<WndProcCallbackInfo> CRawInputApi::GetCallbacks() const
+{
 	const std::lock_guard<std::mutex> lock(this->Mutex);
-	for (WNDPROC_CALLBACK wndprocCb : this->Registry)
+
+	std::vector<WndProcCallbackInfo> callbacks;
+	callbacks.reserve(this->Registry.size());
+
+	for (const WndProcCallback& entry : this->Registry)
+	{
+		callbacks.push_back(WndProcCallbackInfo{
+			entry.Callback,
+			entry.MsgFirst,
+			entry.MsgLast,
+			entry.Stats->Calls.load(),
+			entry.Stats->TotalTime.load(),
+			entry.Stats->MaxTime.load()
+		});
+	}
+
+	return callbacks;
+}
+
+void CRawInputApi::Publish()
+{
+	WndProcRegistry* registry = new WndProcRegistry();
+	registry->Callbacks = this->Registry;
+
+	this->RetiredSnapshots.push_back(this->Snapshot.exchange(registry));
+
+	/* a reader that arrives after this point can only see the new snapshot */
+	if (this->SnapshotReaders.load() == 0)
 	{
-		if (wndprocCb >= aStartAddress && wndprocCb <= aEndAddress)
+		for (WndProcRegistry* retired : this->RetiredSnapshots)
 		{
-			this->Registry.erase(std::remove(this->Registry.begin(), this->Registry.end(), wndprocCb), this->Registry.end());
-			refCounter++;
+			delete retired;
 		}
+
+		this->RetiredSnapshots.clear();
 	}
+}
 
-	return refCounter;
+void CRawInputApi::WaitForDispatch() const
+{
+	/* called from a callback on the window thread, the dispatch would wait for itself */
+	if (DispatchDepth > 0) { return; }
+
+	/* only a dispatch that was running before the new snapshot was published can call the old one */
+	unsigned long long dispatch = this->DispatchesCompleted.load();
+
+	while (this->SnapshotReaders.load() != 0 && this->DispatchesCompleted.load() == dispatch)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
 }
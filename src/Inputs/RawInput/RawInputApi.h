@@ -9,10 +9,13 @@
 #ifndef RAWINPUTAPI_H
 #define RAWINPUTAPI_H
 
+#include <atomic>
+#include <climits>
 #include <vector>
 #include <mutex>
 
 #include "FuncDefs.h"
+#include "WndProcCallback.h"
 
 ///----------------------------------------------------------------------------------------------------
 /// RawInput Namespace
@@ -31,6 +34,12 @@ namespace RawInput
 	///----------------------------------------------------------------------------------------------------
 	void ADDONAPI_Register(WNDPROC_CALLBACK aWndProcCallback);
 
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_RegisterFiltered:
+	/// 	Registers the provided WndProcCallback for messages within [aMsgFirst, aMsgLast].
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_RegisterFiltered(WNDPROC_CALLBACK aWndProcCallback, UINT aMsgFirst, UINT aMsgLast);
+
 	///----------------------------------------------------------------------------------------------------
 	/// ADDONAPI_Deregister:
 	/// 	Deregisters the provided WndProcCallback.
@@ -47,11 +56,11 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	/// ctor
 	///----------------------------------------------------------------------------------------------------
-	CRawInputApi() = default;
+	CRawInputApi();
 	///----------------------------------------------------------------------------------------------------
 	/// dtor
 	///----------------------------------------------------------------------------------------------------
-	~CRawInputApi() = default;
+	~CRawInputApi();
 
 	///----------------------------------------------------------------------------------------------------
 	/// WndProc:
@@ -67,25 +76,52 @@ public:
 
 	///----------------------------------------------------------------------------------------------------
 	/// Register:
-	/// 	Registers the provided WndProcCallback.
+	/// 	Registers the provided WndProcCallback for messages within [aMsgFirst, aMsgLast].
+	/// 	Registering the same callback again adds another range.
 	///----------------------------------------------------------------------------------------------------
-	void Register(WNDPROC_CALLBACK aWndProcCallback);
+	void Register(WNDPROC_CALLBACK aWndProcCallback, UINT aMsgFirst = 0, UINT aMsgLast = UINT_MAX);
 
 	///----------------------------------------------------------------------------------------------------
 	/// Deregister:
-	/// 	Deregisters the provided WndProcCallback.
+	/// 	Deregisters the provided WndProcCallback, for all of its ranges.
+	/// 	Returns once a message dispatch that might still call it has ended.
 	///----------------------------------------------------------------------------------------------------
 	void Deregister(WNDPROC_CALLBACK aWndProcCallback);
 
 	///----------------------------------------------------------------------------------------------------
 	/// Verify:
 	/// 	Removes all WndProc Callbacks that are within the provided address space.
+	/// 	Returns once a message dispatch that might still call them has ended.
 	///----------------------------------------------------------------------------------------------------
 	int Verify(void* aStartAddress, void* aEndAddress);
 
+	///----------------------------------------------------------------------------------------------------
+	/// GetCallbacks:
+	/// 	Returns a copy of the registered callbacks and their statistics.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<WndProcCallbackInfo> GetCallbacks() const;
+
 private:
-	mutable std::mutex				Mutex;
-	std::vector<WNDPROC_CALLBACK>	Registry;
+	mutable std::mutex					Mutex;
+	std::vector<WndProcCallback>		Registry;
+
+	std::atomic<WndProcRegistry*>		Snapshot{ nullptr };
+	std::atomic<int>					SnapshotReaders{ 0 };
+	std::atomic<unsigned long long>		DispatchesCompleted{ 0 };
+	std::vector<WndProcRegistry*>		RetiredSnapshots;	/* freed once no reader is active */
+
+	///----------------------------------------------------------------------------------------------------
+	/// Publish:
+	/// 	Publishes a snapshot of the registry. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void Publish();
+
+	///----------------------------------------------------------------------------------------------------
+	/// WaitForDispatch:
+	/// 	Waits until a message dispatch that might still call a retired snapshot has ended.
+	/// 	Returns immediately if called from within a dispatch. Must not be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void WaitForDispatch() const;
 };
 
 #endif
@@ -0,0 +1,64 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  WndProcCallback.h
+/// Description  :  WndProcCallback and WndProcRegistry struct definitions.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef WNDPROCCALLBACK_H
+#define WNDPROCCALLBACK_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "FuncDefs.h"
+
+///----------------------------------------------------------------------------------------------------
+/// WndProcCallbackStats Struct
+/// 	Only written by the window thread, read by anyone.
+///----------------------------------------------------------------------------------------------------
+struct WndProcCallbackStats
+{
+	std::atomic<unsigned long long>	Calls{ 0 };
+	std::atomic<long long>			TotalTime{ 0 };		/* nanoseconds */
+	std::atomic<long long>			MaxTime{ 0 };		/* nanoseconds */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// WndProcCallback Struct
+/// 	The callback is only called for messages within [MsgFirst, MsgLast].
+///----------------------------------------------------------------------------------------------------
+struct WndProcCallback
+{
+	WNDPROC_CALLBACK						Callback;
+	UINT									MsgFirst;
+	UINT									MsgLast;
+	std::shared_ptr<WndProcCallbackStats>	Stats;		/* shared between registry snapshots */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// WndProcRegistry Struct
+/// 	Immutable once published. Callbacks are in registration order.
+///----------------------------------------------------------------------------------------------------
+struct WndProcRegistry
+{
+	std::vector<WndProcCallback>			Callbacks;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// WndProcCallbackInfo Struct
+/// 	Copy of a registered callback and its statistics.
+///----------------------------------------------------------------------------------------------------
+struct WndProcCallbackInfo
+{
+	WNDPROC_CALLBACK						Callback;
+	UINT									MsgFirst;
+	UINT									MsgLast;
+	unsigned long long						Calls;
+	long long								TotalTime;	/* nanoseconds */
+	long long								MaxTime;	/* nanoseconds */
+};
+
+#endif
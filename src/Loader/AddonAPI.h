@@ -530,4 +530,176 @@ struct AddonAPI6 : AddonAPI
 	FontsVT									Fonts;
 };
 
+struct AddonAPI7 : AddonAPI
+{
+	/* Renderer */
+	IDXGISwapChain*							SwapChain;
+	ImGuiContext*							ImguiContext;
+	void*									ImguiMalloc;
+	void*									ImguiFree;
+
+	struct RendererVT
+	{
+		GUI_ADDRENDER						Register;
+		GUI_REMRENDER						Deregister;
+	};
+	RendererVT								Renderer;
+
+	/* Updater */
+	UPDATER_REQUESTUPDATE					RequestUpdate;
+
+	/* Logging */
+	LOGGER_LOG2								Log;
+
+	/* User Interface */
+	struct UIVT
+	{
+		ALERTS_NOTIFY						SendAlert;
+		GUI_REGISTERCLOSEONESCAPE			RegisterCloseOnEscape;
+		GUI_DEREGISTERCLOSEONESCAPE			DeregisterCloseOnEscape;
+	};
+	UIVT									UI;
+
+	/* Paths */
+	struct PathsVT
+	{
+		PATHS_GETGAMEDIR					GetGameDirectory;
+		PATHS_GETADDONDIR					GetAddonDirectory;
+		PATHS_GETCOMMONDIR					GetCommonDirectory;
+	};
+	PathsVT									Paths;
+
+	/* Minhook */
+	struct MinHookVT
+	{
+		MINHOOK_CREATE						Create;
+		MINHOOK_REMOVE						Remove;
+		MINHOOK_ENABLE						Enable;
+		MINHOOK_DISABLE						Disable;
+	};
+	MinHookVT								MinHook;
+
+	/* Events */
+	struct EventsVT
+	{
+		EVENTS_RAISE						Raise;
+		EVENTS_RAISENOTIFICATION			RaiseNotification;
+		EVENTS_RAISE_TARGETED				RaiseTargeted;
+		EVENTS_RAISENOTIFICATION_TARGETED	RaiseNotificationTargeted;
+		EVENTS_SUBSCRIBE					Subscribe;
+		EVENTS_SUBSCRIBE					Unsubscribe;
+		EVENTS_SUBSCRIBE_COMBATBATCH		SubscribeCombatBatch;
+		EVENTS_SUBSCRIBE_COMBATBATCH		UnsubscribeCombatBatch;
+		EVENTS_RAISE_QUEUED					RaiseQueued;
+		EVENTS_SETEXECUTION					SetExecution;
+	};
+	EventsVT								Events;
+
+	/* WndProc */
+	struct WndProcVT
+	{
+		WNDPROC_ADDREM						Register;
+		WNDPROC_ADDREM						Deregister;
+		WNDPROC_SENDTOGAME					SendToGameOnly;
+		WNDPROC_ADDFILTERED					RegisterFiltered;
+	};
+	WndProcVT								WndProc;
+
+	/* InputBinds */
+	struct InputBindsVT
+	{
+		INPUTBINDS_INVOKE						Invoke;
+		INPUTBINDS_REGISTERWITHSTRING2		RegisterWithString;
+		INPUTBINDS_REGISTERWITHSTRUCT2		RegisterWithStruct;
+		INPUTBINDS_DEREGISTER					Deregister;
+		INPUTBINDS_SETEXECUTION				SetExecution;
+	};
+	InputBindsVT							InputBinds;
+
+	/* GameBinds */
+	struct GameBindsVT
+	{
+		GAMEBINDS_PRESSASYNC				PressAsync;
+		GAMEBINDS_RELEASEASYNC				ReleaseAsync;
+		GAMEBINDS_INVOKEASYNC				InvokeAsync;
+		GAMEBINDS_PRESS						Press;
+		GAMEBINDS_RELEASE					Release;
+		GAMEBINDS_ISBOUND					IsBound;
+		GAMEBINDS_ISHELD					IsHeld;
+		GAMEBINDS_CANCEL					Cancel;
+		GAMEBINDS_INVOKESEQUENCE			InvokeSequence;
+		GAMEBINDS_CREATEMACRO				CreateMacro;
+		GAMEBINDS_INVOKEMACRO				InvokeMacro;
+		GAMEBINDS_DESTROYMACRO				DestroyMacro;
+	};
+	GameBindsVT								GameBinds;
+
+	/* DataLink */
+	struct DataLinkVT
+	{
+		DATALINK_GETRESOURCE				Get;
+		DATALINK_SHARERESOURCE				Share;
+		DATALINK_SHAREVERSIONEDRESOURCE		ShareVersioned;
+		DATALINK_READRESOURCE				Read;
+		DATALINK_INTERPOLATEMUMBLE			InterpolateMumble;
+		DATALINK_SHARECHANNEL				ShareChannel;
+		DATALINK_CHANNEL_WRITE				ChannelWrite;
+		DATALINK_CHANNEL_SUBSCRIBE			ChannelSubscribe;
+		DATALINK_CHANNEL_UNSUBSCRIBE		ChannelUnsubscribe;
+		DATALINK_CHANNEL_READ				ChannelRead;
+		DATALINK_GETHANDLE					GetHandle;
+		DATALINK_GETRESOURCEFROMHANDLE		GetFromHandle;
+	};
+	DataLinkVT								DataLink;
+
+	/* Textures */
+	struct TexturesVT
+	{
+		TEXTURES_GET						Get;
+		TEXTURES_GETHANDLE					GetHandle;
+		TEXTURES_GETORCREATEFROMFILE		GetOrCreateFromFile;
+		TEXTURES_GETORCREATEFROMRESOURCE	GetOrCreateFromResource;
+		TEXTURES_GETORCREATEFROMURL			GetOrCreateFromURL;
+		TEXTURES_GETORCREATEFROMMEMORY		GetOrCreateFromMemory;
+		TEXTURES_LOADFROMFILE2				LoadFromFile;
+		TEXTURES_LOADFROMRESOURCE2			LoadFromResource;
+		TEXTURES_LOADFROMURL2				LoadFromURL;
+		TEXTURES_LOADFROMMEMORY2			LoadFromMemory;
+	};
+	TexturesVT								Textures;
+
+	/* Shortcuts */
+	struct QuickAccessVT
+	{
+		QUICKACCESS_ADDSHORTCUT				Add;
+		QUICKACCESS_GENERIC					Remove;
+		QUICKACCESS_GENERIC					Notify;
+		QUICKACCESS_ADDSIMPLE2				AddContextMenu;
+		QUICKACCESS_GENERIC					RemoveContextMenu;
+	};
+	QuickAccessVT							QuickAccess;
+
+	/* Localization */
+	struct LocalizationVT
+	{
+		LOCALIZATION_TRANSLATE				Translate;
+		LOCALIZATION_TRANSLATETO			TranslateTo;
+		LOCALIZATION_SET					SetTranslatedString;
+	};
+	LocalizationVT							Localization;
+
+	/* Fonts */
+	struct FontsVT
+	{
+		FONTS_GETRELEASE					Get;
+		FONTS_GETRELEASE					Release;
+		FONTS_ADDFROMFILE					AddFromFile;
+		FONTS_ADDFROMRESOURCE				AddFromResource;
+		FONTS_ADDFROMMEMORY					AddFromMemory;
+		FONTS_RESIZE						Resize;
+		FONTS_REQUESTGLYPHS					RequestGlyphs;
+	};
+	FontsVT									Fonts;
+};
+
 #endif
@@ -23,6 +23,7 @@
 #include "AddonDefinition.h"
 #include "FuncDefs.h"
 
+#include "Events/CombatBatchApi.h"
 #include "Events/EventHandler.h"
 #include "GUI/Fonts/FontManager.h"
 #include "GUI/GUI.h"
@@ -85,7 +86,7 @@ namespace Loader
 
 	void Initialize()
 	{
-		NexusLink = (NexusLinkData*)DataLinkService->ShareResource(DL_NEXUS_LINK, sizeof(NexusLinkData), true);
+		NexusLink = (NexusLinkData*)DataLinkService->ShareVersionedResource(DL_NEXUS_LINK, sizeof(NexusLinkData), offsetof(NexusLinkData, Version), true);
 
 		if (State::Nexus == ENexusState::LOADED)
 		{
@@ -900,12 +901,18 @@ namespace Loader
 			void* endAddress = ((PBYTE)aAddon->Module) + aAddon->ModuleSize;
 
 			int evRefs = EventApi->Verify(startAddress, endAddress);
+			int cbRefs = CombatBatchApi->Verify(startAddress, endAddress);
 			int uiRefs = GUI::Verify(startAddress, endAddress);
 			int qaRefs = GUI::QuickAccess::Verify(startAddress, endAddress);
 			int kbRefs = InputBindApi->Verify(startAddress, endAddress);
 			int riRefs = RawInputApi->Verify(startAddress, endAddress);
 			int txRefs = TextureService->Verify(startAddress, endAddress);
-			int leftoverRefs = evRefs + uiRefs + qaRefs + kbRefs + riRefs + txRefs;
+			int gbRefs = GameBindsApi->Verify(startAddress, endAddress);
+			int dlRefs = DataLinkService->Verify(startAddress, endAddress);
+			int leftoverRefs = evRefs + cbRefs + uiRefs + qaRefs + kbRefs + riRefs + txRefs + gbRefs + dlRefs;
+
+			/* a reloaded addon starts with fresh timings */
+			CallbackWatchdog->Reset(startAddress, endAddress);
 
 			if (leftoverRefs > 0)
 			{
@@ -913,11 +920,14 @@ namespace Loader
 				str.append(" ");
 				str.append("Make sure your addon releases all references during Addon::Unload().\n");
 				if (evRefs) { str.append(String::Format("Events: %d\n", evRefs)); }
+				if (cbRefs) { str.append(String::Format("Combat batches: %d\n", cbRefs)); }
 				if (uiRefs) { str.append(String::Format("UI: %d\n", uiRefs)); }
 				if (qaRefs) { str.append(String::Format("QuickAccess: %d\n", qaRefs)); }
 				if (kbRefs) { str.append(String::Format("InputBinds: %d\n", kbRefs)); }
 				if (riRefs) { str.append(String::Format("WndProc: %d\n", riRefs)); }
-				if (txRefs) { str.append(String::Format("Textures: %d", txRefs)); }
+				if (txRefs) { str.append(String::Format("Textures: %d\n", txRefs)); }
+				if (gbRefs) { str.append(String::Format("Game bind macros: %d\n", gbRefs)); }
+				if (dlRefs) { str.append(String::Format("Channel consumers: %d", dlRefs)); }
 				Logger->Warning(CH_LOADER, str.c_str());
 			}
 		}
@@ -1554,6 +1564,115 @@ namespace Loader
 				api->Fonts.AddFromMemory = FontManager::ADDONAPI_AddFontFromMemory;
 				api->Fonts.Resize = FontManager::ADDONAPI_ResizeFont;
 
+				ApiDefs.insert({ aVersion, api });
+				return api;
+			}
+			case 7:
+			{
+				AddonAPI7* api = new AddonAPI7();
+
+				api->SwapChain = Renderer::SwapChain;
+				api->ImguiContext = Renderer::GuiContext;
+				api->ImguiMalloc = ImGui::MemAlloc;
+				api->ImguiFree = ImGui::MemFree;
+
+				api->Renderer.Register = GUI::Register;
+				api->Renderer.Deregister = GUI::Deregister;
+
+				api->RequestUpdate = Updater::ADDONAPI_RequestUpdate;
+
+				api->Log = LogHandler::ADDONAPI_LogMessage2;
+
+				api->UI.SendAlert = GUI::Alerts::Notify;
+				api->UI.RegisterCloseOnEscape = GUI::RegisterCloseOnEscape;
+				api->UI.DeregisterCloseOnEscape = GUI::DeregisterCloseOnEscape;
+
+				api->Paths.GetGameDirectory = Index::GetGameDirectory;
+				api->Paths.GetAddonDirectory = Index::GetAddonDirectory;
+				api->Paths.GetCommonDirectory = Index::GetCommonDirectory;
+
+				api->MinHook.Create = MH_CreateHook;
+				api->MinHook.Remove = MH_RemoveHook;
+				api->MinHook.Enable = MH_EnableHook;
+				api->MinHook.Disable = MH_DisableHook;
+
+				api->Events.Raise = Events::ADDONAPI_RaiseEvent;
+				api->Events.RaiseNotification = Events::ADDONAPI_RaiseNotification;
+				api->Events.RaiseTargeted = Events::ADDONAPI_RaiseEventTargeted;
+				api->Events.RaiseNotificationTargeted = Events::ADDONAPI_RaiseNotificationTargeted;
+				api->Events.Subscribe = Events::ADDONAPI_Subscribe;
+				api->Events.Unsubscribe = Events::ADDONAPI_Unsubscribe;
+				api->Events.SubscribeCombatBatch = Events::ADDONAPI_SubscribeCombatBatch;
+				api->Events.UnsubscribeCombatBatch = Events::ADDONAPI_UnsubscribeCombatBatch;
+				api->Events.RaiseQueued = Events::ADDONAPI_RaiseEventQueued;
+				api->Events.SetExecution = Events::ADDONAPI_SetExecution;
+
+				api->WndProc.Register = RawInput::ADDONAPI_Register;
+				api->WndProc.Deregister = RawInput::ADDONAPI_Deregister;
+				api->WndProc.SendToGameOnly = RawInput::ADDONAPI_SendWndProcToGame;
+				api->WndProc.RegisterFiltered = RawInput::ADDONAPI_RegisterFiltered;
+
+				api->InputBinds.Invoke = InputBinds::ADDONAPI_InvokeInputBind;
+				api->InputBinds.RegisterWithString = InputBinds::ADDONAPI_RegisterWithString2;
+				api->InputBinds.RegisterWithStruct = InputBinds::ADDONAPI_RegisterWithStruct2;
+				api->InputBinds.Deregister = InputBinds::ADDONAPI_Deregister;
+				api->InputBinds.SetExecution = InputBinds::ADDONAPI_SetExecution;
+
+				api->GameBinds.PressAsync = GameBinds::ADDONAPI_PressAsync;
+				api->GameBinds.ReleaseAsync = GameBinds::ADDONAPI_ReleaseAsync;
+				api->GameBinds.InvokeAsync = GameBinds::ADDONAPI_InvokeAsync;
+				api->GameBinds.Press = GameBinds::ADDONAPI_Press;
+				api->GameBinds.Release = GameBinds::ADDONAPI_Release;
+				api->GameBinds.IsBound = GameBinds::ADDONAPI_IsBound;
+				api->GameBinds.IsHeld = GameBinds::ADDONAPI_IsHeld;
+				api->GameBinds.Cancel = GameBinds::ADDONAPI_Cancel;
+				api->GameBinds.InvokeSequence = GameBinds::ADDONAPI_InvokeSequence;
+				api->GameBinds.CreateMacro = GameBinds::ADDONAPI_CreateMacro;
+				api->GameBinds.InvokeMacro = GameBinds::ADDONAPI_InvokeMacro;
+				api->GameBinds.DestroyMacro = GameBinds::ADDONAPI_DestroyMacro;
+
+				api->DataLink.Get = DataLink::ADDONAPI_GetResource;
+				api->DataLink.Share = DataLink::ADDONAPI_ShareResource;
+				api->DataLink.ShareVersioned = DataLink::ADDONAPI_ShareVersionedResource;
+				api->DataLink.Read = DataLink::ADDONAPI_ReadResource;
+				api->DataLink.InterpolateMumble = DataLink::ADDONAPI_InterpolateMumble;
+				api->DataLink.ShareChannel = DataLink::ADDONAPI_ShareChannel;
+				api->DataLink.ChannelWrite = Channel::Write;
+				api->DataLink.ChannelSubscribe = DataLink::ADDONAPI_ChannelSubscribe;
+				api->DataLink.ChannelUnsubscribe = DataLink::ADDONAPI_ChannelUnsubscribe;
+				api->DataLink.ChannelRead = Channel::Read;
+				api->DataLink.GetHandle = DataLink::ADDONAPI_GetHandle;
+				api->DataLink.GetFromHandle = DataLink::ADDONAPI_GetResourceFromHandle;
+
+				api->Textures.Get = TextureLoader::ADDONAPI_Get;
+				api->Textures.GetHandle = TextureLoader::ADDONAPI_GetHandle;
+				api->Textures.GetOrCreateFromFile = TextureLoader::ADDONAPI_GetOrCreateFromFile;
+				api->Textures.GetOrCreateFromResource = TextureLoader::ADDONAPI_GetOrCreateFromResource;
+				api->Textures.GetOrCreateFromURL = TextureLoader::ADDONAPI_GetOrCreateFromURL;
+				api->Textures.GetOrCreateFromMemory = TextureLoader::ADDONAPI_GetOrCreateFromMemory;
+				api->Textures.LoadFromFile = TextureLoader::ADDONAPI_LoadFromFile2;
+				api->Textures.LoadFromResource = TextureLoader::ADDONAPI_LoadFromResource2;
+				api->Textures.LoadFromURL = TextureLoader::ADDONAPI_LoadFromURL2;
+				api->Textures.LoadFromMemory = TextureLoader::ADDONAPI_LoadFromMemory2;
+
+				api->QuickAccess.Add = GUI::QuickAccess::AddShortcut;
+				api->QuickAccess.Remove = GUI::QuickAccess::RemoveShortcut;
+				api->QuickAccess.Notify = GUI::QuickAccess::NotifyShortcut;
+				api->QuickAccess.AddContextMenu = GUI::QuickAccess::AddSimpleShortcut2;
+				api->QuickAccess.RemoveContextMenu = GUI::QuickAccess::RemoveSimpleShortcut;
+
+				api->Localization.Translate = Localization::ADDONAPI_Translate;
+				api->Localization.TranslateTo = Localization::ADDONAPI_TranslateTo;
+				api->Localization.SetTranslatedString = Localization::ADDONAPI_Set;
+
+				api->Fonts.Get = FontManager::ADDONAPI_Get;
+				api->Fonts.Release = FontManager::ADDONAPI_Release;
+				api->Fonts.AddFromFile = FontManager::ADDONAPI_AddFontFromFile;
+				api->Fonts.AddFromResource = FontManager::ADDONAPI_AddFontFromResource;
+				api->Fonts.AddFromMemory = FontManager::ADDONAPI_AddFontFromMemory;
+				api->Fonts.Resize = FontManager::ADDONAPI_ResizeFont;
+				api->Fonts.RequestGlyphs = FontManager::ADDONAPI_RequestGlyphs;
+
 				ApiDefs.insert({ aVersion, api });
 				return api;
 			}
@@ -1578,6 +1697,8 @@ namespace Loader
 				return sizeof(AddonAPI5);
 			case 6:
 				return sizeof(AddonAPI6);
+			case 7:
+				return sizeof(AddonAPI7);
 		}
 
 		return 0;
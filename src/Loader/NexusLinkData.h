@@ -19,6 +19,9 @@ struct NexusLinkData
 	signed int	QuickAccessIconsCount;
 	signed int	QuickAccessMode;
 	bool		QuickAccessIsVertical;
+
+	/* Odd while Nexus is writing, advances by two with every change. Read with DataLink.Read for a consistent copy. */
+	unsigned	Version;
 };
 
 #endif
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 #include "Services/DataLink/DataLink.h"
 #include "GUI/GUI.h"
+#include "GUI/Fonts/FontManager.h"
 #include "Inputs/InputBinds/InputBindHandler.h"
 #include "Inputs/GameBinds/GameBindsHandler.h"
 #include "Loader/Loader.h"
@@ -149,6 +150,41 @@ namespace Main
 				}
 			}
 
+			/* milliseconds a single addon callback may take before it is reported */
+			if (!Settings::Settings[OPT_WATCHDOGTHRESHOLD].is_null())
+			{
+				float threshold = 0.0f;
+				Settings::Settings[OPT_WATCHDOGTHRESHOLD].get_to(threshold);
+				CallbackWatchdog->SetThreshold(static_cast<long long>(threshold * 1000000.0f));
+			}
+			else
+			{
+				Settings::Settings[OPT_WATCHDOGTHRESHOLD] = CW_DEFAULT_THRESHOLD / 1000000.0f;
+			}
+
+			/* aggregated once for every addon reading DL_COMBAT_STATS, instead of once per addon */
+			bool isCombatStatsEnabled = true;
+			if (!Settings::Settings[OPT_COMBATSTATS].is_null())
+			{
+				Settings::Settings[OPT_COMBATSTATS].get_to(isCombatStatsEnabled);
+			}
+			else
+			{
+				Settings::Settings[OPT_COMBATSTATS] = true;
+			}
+
+			if (isCombatStatsEnabled)
+			{
+				CombatStats* stats = (CombatStats*)DataLinkService->ShareVersionedResource(DL_COMBAT_STATS, sizeof(CombatStats), offsetof(CombatStats, Version), true);
+				CombatStatsEngine = new CCombatStats(stats);
+
+				/* the squad is tracked from the start, its events are only aggregated once an addon looks the stats up */
+				DataLinkService->SetOnAccess(DL_COMBAT_STATS, []()
+				{
+					CombatBatchApi->Subscribe(EV_ARCDPS_COMBATEVENT_SQUAD_RAW, [](const CombatBatch* aBatch) { CombatStatsEngine->Process(aBatch); });
+				});
+			}
+
 			//API::Initialize();
 
 			MumbleReader = new CMumbleReader(mumbleName);
@@ -179,10 +215,17 @@ namespace Main
 		{
 			State::Nexus = ENexusState::SHUTTING_DOWN;
 
+			// finish the recording before the events stop
+			CombatRecorder->Stop();
+
 			// free addons
 			Loader::Shutdown();
 
+			// queued events have no subscribers left
+			EventApi->Shutdown();
+
 			GUI::Shutdown();
+			CFontManager::GetInstance().Shutdown();
 			delete MumbleReader;
 
 			// shared mem
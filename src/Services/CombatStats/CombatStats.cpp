@@ -0,0 +1,547 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatStats.cpp
+/// Description  :  Aggregates damage and boon uptime of the squad once for all addons.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Services/CombatStats/CombatStats.h"
+
+#include <cstring>
+
+#include "Services/DataLink/SeqLock.h"
+
+namespace
+{
+	/* ArcDPS state changes and results, see the ArcDPS combat API */
+	constexpr const uint8_t CBTS_ENTERCOMBAT	= 1;
+	constexpr const uint8_t CBTS_EXITCOMBAT		= 2;
+	constexpr const uint8_t CBTB_ALL			= 1;
+	constexpr const uint8_t CBTR_NORMAL			= 0;
+	constexpr const uint8_t CBTR_CRIT			= 1;
+	constexpr const uint8_t CBTR_GLANCE			= 2;
+	constexpr const uint8_t CBTR_KILLINGBLOW	= 8;
+	constexpr const uint8_t CBTR_DOWNED			= 9;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetBoon:
+	/// 	Returns the index of the boon in CS_BOON_IDS, -1 if it is not tracked.
+	///----------------------------------------------------------------------------------------------------
+	int GetBoon(uint32_t aSkillID)
+	{
+		for (int i = 0; i < static_cast<int>(CS_BOONS); i++)
+		{
+			if (CS_BOON_IDS[i] == aSkillID) { return i; }
+		}
+
+		return -1;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsIntensity:
+	/// 	Stacks of intensity boons run in parallel, stacks of the others add up their duration.
+	///----------------------------------------------------------------------------------------------------
+	bool IsIntensity(int aBoon)
+	{
+		return CS_BOON_IDS[aBoon] == 740 || CS_BOON_IDS[aBoon] == 1122;
+	}
+
+	bool IsHit(uint8_t aResult)
+	{
+		return aResult == CBTR_NORMAL || aResult == CBTR_CRIT || aResult == CBTR_GLANCE ||
+			aResult == CBTR_KILLINGBLOW || aResult == CBTR_DOWNED;
+	}
+
+	uint32_t Hash(uint64_t aID)
+	{
+		return static_cast<uint32_t>((aID * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	void CopyName(char* aDestination, const char* aSource)
+	{
+		if (!aSource)
+		{
+			aDestination[0] = '\0';
+			return;
+		}
+
+		strncpy(aDestination, aSource, CS_NAME_LENGTH - 1);
+		aDestination[CS_NAME_LENGTH - 1] = '\0';
+	}
+}
+
+CCombatStats::CCombatStats(CombatStats* aStats)
+{
+	this->Stats = aStats;
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+	this->Publish();
+}
+
+void CCombatStats::Track(const EvCombatData* aCombatData)
+{
+	/* notifications have no event, a specialization on the source means a target change */
+	if (!aCombatData || aCombatData->Event || !aCombatData->Source || aCombatData->Source->Specialization != 0) { return; }
+
+	const ArcDPS::AgentShort* agent = aCombatData->Source;
+	const ArcDPS::AgentShort* details = aCombatData->Destination;
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	int slot = this->Find(agent->ID);
+
+	if (agent->Profession != 0)
+	{
+		/* also sent again when the subgroup changes */
+		if (slot < 0)
+		{
+			if (this->Count == CS_MAX_AGENTS) { return; }
+
+			slot = static_cast<int>(this->Count++);
+			this->IDs[slot] = agent->ID;
+			this->Clear(slot);
+			this->Insert(agent->ID, slot);
+		}
+
+		CopyName(this->Names[slot], agent->Name);
+		CopyName(this->Accounts[slot], details ? details->Name : nullptr);
+		this->InstIDs[slot] = details ? static_cast<uint16_t>(details->ID) : 0;
+		this->Professions[slot] = details ? details->Profession : 0;
+		this->Specializations[slot] = details ? details->Specialization : 0;
+		this->Subgroups[slot] = details ? details->Team : 0;
+		this->IsSelf[slot] = details && details->IsSelf;
+		this->IsSquadChanged = true;
+	}
+	else
+	{
+		if (slot < 0) { return; }
+
+		/* the last agent takes the slot, the lookup is rebuilt as its slot changed */
+		uint32_t last = --this->Count;
+
+		if (static_cast<uint32_t>(slot) != last)
+		{
+			this->IDs[slot] = this->IDs[last];
+			this->InstIDs[slot] = this->InstIDs[last];
+			memcpy(this->Names[slot], this->Names[last], CS_NAME_LENGTH);
+			memcpy(this->Accounts[slot], this->Accounts[last], CS_NAME_LENGTH);
+			this->Professions[slot] = this->Professions[last];
+			this->Specializations[slot] = this->Specializations[last];
+			this->Subgroups[slot] = this->Subgroups[last];
+			this->IsSelf[slot] = this->IsSelf[last];
+			this->IsInCombat[slot] = this->IsInCombat[last];
+			this->CombatStart[slot] = this->CombatStart[last];
+			this->CombatEnd[slot] = this->CombatEnd[last];
+			this->PowerDamage[slot] = this->PowerDamage[last];
+			this->ConditionDamage[slot] = this->ConditionDamage[last];
+			this->Hits[slot] = this->Hits[last];
+			this->Crits[slot] = this->Crits[last];
+
+			for (uint32_t i = 0; i < CS_WINDOW; i++)
+			{
+				this->Window[i][slot] = this->Window[i][last];
+			}
+
+			for (uint32_t i = 0; i < CS_BOONS; i++)
+			{
+				this->BoonTime[i][slot] = this->BoonTime[i][last];
+				this->BoonSince[i][slot] = this->BoonSince[i][last];
+				this->BoonUntil[i][slot] = this->BoonUntil[i][last];
+			}
+		}
+
+		memset(this->LookupIDs, 0, sizeof(this->LookupIDs));
+		memset(this->LookupSlots, 0, sizeof(this->LookupSlots));
+
+		for (uint32_t i = 0; i < this->Count; i++)
+		{
+			this->Insert(this->IDs[i], i);
+		}
+
+		this->IsSquadChanged = true;
+	}
+
+	this->Publish();
+}
+
+void CCombatStats::Process(const CombatBatch* aBatch)
+{
+	if (!aBatch || aBatch->Count == 0) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (uint32_t i = 0; i < aBatch->Count; i++)
+	{
+		uint64_t time = aBatch->Time[i];
+
+		if (time > this->Time)
+		{
+			this->Time = time;
+			this->Advance(time);
+		}
+
+		if (aBatch->IsStateChange[i])
+		{
+			int slot = this->Find(aBatch->SrcAgent[i]);
+
+			if (slot < 0) { continue; }
+
+			if (aBatch->IsStateChange[i] == CBTS_ENTERCOMBAT)
+			{
+				this->EnterCombat(slot, time);
+			}
+			else if (aBatch->IsStateChange[i] == CBTS_EXITCOMBAT && this->IsInCombat[slot])
+			{
+				this->IsInCombat[slot] = 0;
+				this->CombatEnd[slot] = time;
+
+				/* the final numbers must not wait for the interval */
+				this->PublishTime = 0;
+			}
+
+			continue;
+		}
+
+		if (aBatch->IsActivation[i]) { continue; }
+
+		if (aBatch->IsBuffRemove[i])
+		{
+			/* the source lost the buff */
+			if (aBatch->IsBuffRemove[i] != CBTB_ALL) { continue; }
+
+			int slot = this->Find(aBatch->SrcAgent[i]);
+			int boon = slot < 0 ? -1 : GetBoon(aBatch->SkillID[i]);
+
+			if (boon < 0 || !this->BoonSince[boon][slot]) { continue; }
+
+			uint64_t end = time < this->BoonUntil[boon][slot] ? time : this->BoonUntil[boon][slot];
+
+			if (end > this->BoonSince[boon][slot])
+			{
+				this->BoonTime[boon][slot] += end - this->BoonSince[boon][slot];
+			}
+
+			this->BoonSince[boon][slot] = 0;
+			continue;
+		}
+
+		if (aBatch->Buff[i] && aBatch->BuffDmg[i] == 0)
+		{
+			/* an application, the value is its duration */
+			if (aBatch->Value[i] <= 0) { continue; }
+
+			int slot = this->Find(aBatch->DstAgent[i]);
+			int boon = slot < 0 ? -1 : GetBoon(aBatch->SkillID[i]);
+
+			if (boon < 0) { continue; }
+
+			uint64_t& since = this->BoonSince[boon][slot];
+			uint64_t& until = this->BoonUntil[boon][slot];
+			uint64_t duration = static_cast<uint64_t>(aBatch->Value[i]);
+
+			/* ran out before, the coverage ended there */
+			if (since && until < time)
+			{
+				if (until > since)
+				{
+					this->BoonTime[boon][slot] += until - since;
+				}
+
+				since = 0;
+			}
+
+			if (!since)
+			{
+				since = time;
+				until = time;
+			}
+
+			if (IsIntensity(boon))
+			{
+				until = time + duration > until ? time + duration : until;
+			}
+			else
+			{
+				until = (until > time ? until : time) + duration;
+			}
+
+			continue;
+		}
+
+		int slot = this->Find(aBatch->SrcAgent[i]);
+
+		if (slot < 0)
+		{
+			/* pets and minions */
+			if (!aBatch->SrcMasterInstID[i]) { continue; }
+
+			slot = this->FindMaster(aBatch->SrcMasterInstID[i]);
+
+			if (slot < 0) { continue; }
+		}
+		else if (aBatch->SrcInstID[i])
+		{
+			this->InstIDs[slot] = aBatch->SrcInstID[i];
+		}
+
+		/* cleared when a new combat starts, so before anything is added */
+		this->EnterCombat(slot, time);
+
+		long long damage;
+
+		if (aBatch->Buff[i])
+		{
+			if (aBatch->Result[i] != CBTR_NORMAL) { continue; }
+
+			damage = aBatch->BuffDmg[i];
+			this->ConditionDamage[slot] += damage;
+		}
+		else
+		{
+			if (!IsHit(aBatch->Result[i])) { continue; }
+
+			damage = aBatch->Value[i];
+			this->PowerDamage[slot] += damage;
+			this->Hits[slot]++;
+
+			if (aBatch->Result[i] == CBTR_CRIT)
+			{
+				this->Crits[slot]++;
+			}
+		}
+
+		if (time > this->CombatEnd[slot])
+		{
+			this->CombatEnd[slot] = time;
+		}
+
+		/* late events of a second that already left the window are only part of the totals */
+		uint64_t second = time / 1000;
+		uint32_t bucket = static_cast<uint32_t>(second % CS_WINDOW);
+
+		if (this->WindowSeconds[bucket] == second)
+		{
+			this->Window[bucket][slot] += damage;
+		}
+	}
+
+	this->Publish();
+}
+
+void CCombatStats::Reset()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	for (uint32_t i = 0; i < this->Count; i++)
+	{
+		this->Clear(i);
+	}
+
+	/* not a squad change, but it must not wait for the interval either */
+	this->PublishTime = 0;
+	this->Publish();
+}
+
+int CCombatStats::Find(uint64_t aID) const
+{
+	uint32_t index = Hash(aID) & (LOOKUP_SIZE - 1);
+
+	/* the table is at most a quarter full, an empty slot ends the probe quickly */
+	while (this->LookupSlots[index])
+	{
+		if (this->LookupIDs[index] == aID)
+		{
+			return this->LookupSlots[index] - 1;
+		}
+
+		index = (index + 1) & (LOOKUP_SIZE - 1);
+	}
+
+	return -1;
+}
+
+int CCombatStats::FindMaster(uint16_t aInstID) const
+{
+	for (uint32_t i = 0; i < this->Count; i++)
+	{
+		if (this->InstIDs[i] == aInstID) { return static_cast<int>(i); }
+	}
+
+	return -1;
+}
+
+void CCombatStats::Insert(uint64_t aID, uint32_t aSlot)
+{
+	uint32_t index = Hash(aID) & (LOOKUP_SIZE - 1);
+
+	while (this->LookupSlots[index])
+	{
+		index = (index + 1) & (LOOKUP_SIZE - 1);
+	}
+
+	this->LookupIDs[index] = aID;
+	this->LookupSlots[index] = static_cast<uint8_t>(aSlot + 1);
+}
+
+void CCombatStats::Clear(uint32_t aSlot)
+{
+	this->IsInCombat[aSlot] = 0;
+	this->CombatStart[aSlot] = 0;
+	this->CombatEnd[aSlot] = 0;
+	this->PowerDamage[aSlot] = 0;
+	this->ConditionDamage[aSlot] = 0;
+	this->Hits[aSlot] = 0;
+	this->Crits[aSlot] = 0;
+
+	for (uint32_t i = 0; i < CS_WINDOW; i++)
+	{
+		this->Window[i][aSlot] = 0;
+	}
+
+	for (uint32_t i = 0; i < CS_BOONS; i++)
+	{
+		this->BoonTime[i][aSlot] = 0;
+		this->BoonSince[i][aSlot] = 0;
+		this->BoonUntil[i][aSlot] = 0;
+	}
+}
+
+void CCombatStats::EnterCombat(uint32_t aSlot, uint64_t aTime)
+{
+	if (this->IsInCombat[aSlot]) { return; }
+
+	/* boons that are still running count from the start of the new combat */
+	uint64_t since[CS_BOONS];
+	uint64_t until[CS_BOONS];
+
+	for (uint32_t i = 0; i < CS_BOONS; i++)
+	{
+		since[i] = this->BoonSince[i][aSlot] && this->BoonUntil[i][aSlot] > aTime ? aTime : 0;
+		until[i] = this->BoonUntil[i][aSlot];
+	}
+
+	this->Clear(aSlot);
+
+	for (uint32_t i = 0; i < CS_BOONS; i++)
+	{
+		this->BoonSince[i][aSlot] = since[i];
+		this->BoonUntil[i][aSlot] = since[i] ? until[i] : 0;
+	}
+
+	this->IsInCombat[aSlot] = 1;
+	this->CombatStart[aSlot] = aTime;
+	this->CombatEnd[aSlot] = aTime;
+}
+
+void CCombatStats::Advance(uint64_t aTime)
+{
+	uint64_t second = aTime / 1000;
+	uint32_t bucket = static_cast<uint32_t>(second % CS_WINDOW);
+
+	if (this->WindowSeconds[bucket] == second) { return; }
+
+	this->WindowSeconds[bucket] = second;
+	memset(this->Window[bucket], 0, sizeof(this->Window[bucket]));
+}
+
+void CCombatStats::Publish()
+{
+	if (!this->Stats) { return; }
+
+	if (!this->IsSquadChanged && this->PublishTime && this->Time < this->PublishTime + CS_PUBLISH_INTERVAL) { return; }
+
+	this->PublishTime = this->Time;
+
+	uint64_t second = this->Time / 1000;
+
+	/* per agent first, the windows and boons are then summed column by column */
+	uint64_t ends[CS_MAX_AGENTS];
+	float inverses[CS_MAX_AGENTS];
+	long long windowDamage[CS_MAX_AGENTS] = {};
+
+	for (uint32_t i = 0; i < this->Count; i++)
+	{
+		/* the combat lasts until now while the agent is in it */
+		ends[i] = this->IsInCombat[i] && this->Time > this->CombatEnd[i] ? this->Time : this->CombatEnd[i];
+
+		uint64_t duration = ends[i] - this->CombatStart[i];
+		inverses[i] = duration > 0 ? 1.0f / duration : 0.0f;
+	}
+
+	for (uint32_t b = 0; b < CS_WINDOW; b++)
+	{
+		if (this->WindowSeconds[b] + CS_WINDOW <= second) { continue; }
+
+		for (uint32_t i = 0; i < this->Count; i++)
+		{
+			windowDamage[i] += this->Window[b][i];
+		}
+	}
+
+	SeqLock::BeginWrite(&this->Stats->Version);
+
+	this->Stats->Revision = CS_VERSION;
+	this->Stats->Updates++;
+	this->Stats->Time = this->Time;
+	memcpy(this->Stats->BoonIDs, CS_BOON_IDS, sizeof(CS_BOON_IDS));
+	this->Stats->AgentCount = this->Count;
+
+	for (uint32_t i = 0; i < this->Count; i++)
+	{
+		CombatStatsAgent& agent = this->Stats->Agents[i];
+
+		if (this->IsSquadChanged)
+		{
+			agent.ID = this->IDs[i];
+			memcpy(agent.Name, this->Names[i], CS_NAME_LENGTH);
+			memcpy(agent.Account, this->Accounts[i], CS_NAME_LENGTH);
+			agent.Profession = this->Professions[i];
+			agent.Specialization = this->Specializations[i];
+			agent.Subgroup = this->Subgroups[i];
+			agent.IsSelf = this->IsSelf[i];
+		}
+
+		agent.IsInCombat = this->IsInCombat[i];
+		agent.CombatStart = this->CombatStart[i];
+		agent.CombatEnd = this->CombatEnd[i];
+		agent.PowerDamage = this->PowerDamage[i];
+		agent.ConditionDamage = this->ConditionDamage[i];
+		agent.Damage = this->PowerDamage[i] + this->ConditionDamage[i];
+		agent.Hits = this->Hits[i];
+		agent.Crits = this->Crits[i];
+
+		uint64_t duration = ends[i] - this->CombatStart[i];
+
+		/* at least a second, the first hit would be an absurd peak otherwise */
+		agent.Dps = !this->CombatStart[i] ? 0.0f : duration > 1000
+			? agent.Damage * 1000.0f * inverses[i]
+			: static_cast<float>(agent.Damage);
+
+		/* a combat shorter than the window is averaged over its own length */
+		uint64_t windowSeconds = duration / 1000 + 1 < CS_WINDOW ? duration / 1000 + 1 : CS_WINDOW;
+		agent.WindowDps = this->CombatStart[i] ? static_cast<float>(windowDamage[i]) / windowSeconds : 0.0f;
+	}
+
+	for (uint32_t b = 0; b < CS_BOONS; b++)
+	{
+		for (uint32_t i = 0; i < this->Count; i++)
+		{
+			uint64_t covered = this->BoonTime[b][i];
+			uint64_t since = this->BoonSince[b][i];
+			uint64_t until = this->BoonUntil[b][i] < ends[i] ? this->BoonUntil[b][i] : ends[i];
+
+			if (since && until > since)
+			{
+				covered += until - since;
+			}
+
+			float uptime = covered * inverses[i];
+			this->Stats->Agents[i].BoonUptime[b] = uptime < 1.0f ? uptime : 1.0f;
+		}
+	}
+
+	SeqLock::EndWrite(&this->Stats->Version);
+
+	this->IsSquadChanged = false;
+}
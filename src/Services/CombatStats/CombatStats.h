@@ -0,0 +1,209 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CombatStats.h
+/// Description  :  Aggregates damage and boon uptime of the squad once for all addons.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef COMBATSTATS_H
+#define COMBATSTATS_H
+
+#include <cstdint>
+#include <mutex>
+
+#include "Events/CombatBatch.h"
+
+constexpr const uint32_t CS_VERSION				= 1;		/* layout of CombatStats, readers check it before using the data */
+constexpr const uint32_t CS_MAX_AGENTS			= 64;		/* a full squad and a few that joined while others were still listed */
+constexpr const uint32_t CS_WINDOW				= 10;		/* seconds of the rolling window */
+constexpr const uint32_t CS_NAME_LENGTH			= 64;
+constexpr const uint32_t CS_BOONS				= 12;
+constexpr const uint64_t CS_PUBLISH_INTERVAL	= 100;		/* ms of combat between two updates, faster than a meter can be read */
+
+/* skill IDs of the tracked boons, in the order of CombatStatsAgent::BoonUptime */
+constexpr const uint32_t CS_BOON_IDS[CS_BOONS] = {
+	740,	/* Might */
+	725,	/* Fury */
+	1187,	/* Quickness */
+	30328,	/* Alacrity */
+	717,	/* Protection */
+	718,	/* Regeneration */
+	726,	/* Vigor */
+	743,	/* Aegis */
+	1122,	/* Stability */
+	719,	/* Swiftness */
+	26980,	/* Resistance */
+	873		/* Resolution */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CombatStatsAgent Struct
+/// 	Times are ArcDPS timestamps in milliseconds.
+///----------------------------------------------------------------------------------------------------
+struct CombatStatsAgent
+{
+	uint64_t			ID;
+	char				Name[CS_NAME_LENGTH];
+	char				Account[CS_NAME_LENGTH];
+	uint32_t			Profession;
+	uint32_t			Specialization;
+	uint16_t			Subgroup;
+	uint8_t				IsSelf;
+	uint8_t				IsInCombat;
+
+	uint64_t			CombatStart;
+	uint64_t			CombatEnd;		/* the newest event while in combat */
+
+	long long			Damage;
+	long long			PowerDamage;
+	long long			ConditionDamage;
+	uint32_t			Hits;
+	uint32_t			Crits;
+
+	float				Dps;			/* over the whole combat */
+	float				WindowDps;		/* over the last CS_WINDOW seconds */
+	float				BoonUptime[CS_BOONS];	/* 0 to 1, see CS_BOON_IDS */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CombatStats Struct
+/// 	Shared as DL_COMBAT_STATS, a versioned resource. Read it with ReadResource or the SeqLock protocol
+/// 	and only use it if Revision matches the CS_VERSION the addon was built with.
+/// 	Updated every CS_PUBLISH_INTERVAL and whenever the squad changes, compare the version to skip the copy.
+///----------------------------------------------------------------------------------------------------
+struct CombatStats
+{
+	uint32_t			Revision;
+	unsigned			Version;		/* seqlock, see SeqLock.h */
+	unsigned long long	Updates;		/* advances with every published batch */
+	uint64_t			Time;			/* the newest event */
+	uint32_t			BoonIDs[CS_BOONS];
+	uint32_t			AgentCount;
+	CombatStatsAgent	Agents[CS_MAX_AGENTS];
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CCombatStats Class
+/// 	Agents are added and removed by the squad notifications of ArcDPS, their events are aggregated
+/// 	from the batches of EV_ARCDPS_COMBATEVENT_SQUAD_RAW. Damage of pets and minions counts for their master.
+/// 	Boon uptime follows applications and full removals, single stack removals are not tracked.
+///----------------------------------------------------------------------------------------------------
+class CCombatStats
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CCombatStats(CombatStats* aStats);
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CCombatStats() = default;
+
+	CCombatStats(const CCombatStats&) = delete;
+	CCombatStats& operator=(const CCombatStats&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Track:
+	/// 	Adds or removes the agent of a squad notification, ignores combat events.
+	///----------------------------------------------------------------------------------------------------
+	void Track(const EvCombatData* aCombatData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Process:
+	/// 	Aggregates the batch and publishes the result, at most every CS_PUBLISH_INTERVAL while in combat.
+	///----------------------------------------------------------------------------------------------------
+	void Process(const CombatBatch* aBatch);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Reset:
+	/// 	Clears the stats of every agent, keeps the agents.
+	///----------------------------------------------------------------------------------------------------
+	void Reset();
+
+private:
+	std::mutex			Mutex;
+	CombatStats*		Stats;
+
+	/* struct of arrays, slot i of every array belongs to the same agent */
+	uint32_t			Count										= 0;
+	uint64_t			IDs[CS_MAX_AGENTS]							= {};
+	uint16_t			InstIDs[CS_MAX_AGENTS]						= {};
+	char				Names[CS_MAX_AGENTS][CS_NAME_LENGTH]		= {};
+	char				Accounts[CS_MAX_AGENTS][CS_NAME_LENGTH]		= {};
+	uint32_t			Professions[CS_MAX_AGENTS]					= {};
+	uint32_t			Specializations[CS_MAX_AGENTS]				= {};
+	uint16_t			Subgroups[CS_MAX_AGENTS]					= {};
+	uint8_t				IsSelf[CS_MAX_AGENTS]						= {};
+	uint8_t				IsInCombat[CS_MAX_AGENTS]					= {};
+	uint64_t			CombatStart[CS_MAX_AGENTS]					= {};
+	uint64_t			CombatEnd[CS_MAX_AGENTS]					= {};
+	long long			PowerDamage[CS_MAX_AGENTS]					= {};
+	long long			ConditionDamage[CS_MAX_AGENTS]				= {};
+	uint32_t			Hits[CS_MAX_AGENTS]							= {};
+	uint32_t			Crits[CS_MAX_AGENTS]						= {};
+
+	/* one bucket per second, a bucket is cleared for every agent when its second comes around again */
+	uint64_t			WindowSeconds[CS_WINDOW]					= {};
+	long long			Window[CS_WINDOW][CS_MAX_AGENTS]			= {};
+
+	/* per boon, the covered time that ended and the current coverage */
+	uint64_t			BoonTime[CS_BOONS][CS_MAX_AGENTS]			= {};
+	uint64_t			BoonSince[CS_BOONS][CS_MAX_AGENTS]			= {};
+	uint64_t			BoonUntil[CS_BOONS][CS_MAX_AGENTS]			= {};
+
+	/* open addressing, agent ID to slot + 1, rebuilt when an agent is removed */
+	static constexpr uint32_t LOOKUP_SIZE = CS_MAX_AGENTS * 4;
+	uint64_t			LookupIDs[LOOKUP_SIZE]						= {};
+	uint8_t				LookupSlots[LOOKUP_SIZE]					= {};
+
+	uint64_t			Time										= 0;
+	uint64_t			PublishTime									= 0;
+	bool				IsSquadChanged								= true;	/* the names are only copied then */
+
+	///----------------------------------------------------------------------------------------------------
+	/// Find:
+	/// 	Returns the slot of the agent, -1 if it is not tracked.
+	///----------------------------------------------------------------------------------------------------
+	int Find(uint64_t aID) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// FindMaster:
+	/// 	Returns the slot of the agent with the instance ID, -1 if it is not tracked.
+	///----------------------------------------------------------------------------------------------------
+	int FindMaster(uint16_t aInstID) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Insert:
+	/// 	Adds the agent to the lookup.
+	///----------------------------------------------------------------------------------------------------
+	void Insert(uint64_t aID, uint32_t aSlot);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Clear:
+	/// 	Clears the stats of the slot.
+	///----------------------------------------------------------------------------------------------------
+	void Clear(uint32_t aSlot);
+
+	///----------------------------------------------------------------------------------------------------
+	/// EnterCombat:
+	/// 	Starts a new combat of the slot if it was out of combat.
+	///----------------------------------------------------------------------------------------------------
+	void EnterCombat(uint32_t aSlot, uint64_t aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Advance:
+	/// 	Moves the rolling window to the second of the time.
+	///----------------------------------------------------------------------------------------------------
+	void Advance(uint64_t aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Publish:
+	/// 	Copies the accumulators to the shared resource.
+	/// 	Unless the squad changed or a combat ended, only if CS_PUBLISH_INTERVAL passed since the last time.
+	///----------------------------------------------------------------------------------------------------
+	void Publish();
+};
+
+#endif
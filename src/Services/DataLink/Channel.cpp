@@ -0,0 +1,233 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Channel.cpp
+/// Description  :  Lock-free ring buffer of fixed-size records within a shared resource.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Channel.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "SeqLock.h"
+
+static_assert(sizeof(std::atomic<unsigned long long>) == sizeof(unsigned long long), "The counters have to be plain integers in shared memory.");
+static_assert(std::atomic<unsigned long long>::is_always_lock_free, "The counters have to be lock-free to be shared across modules.");
+
+namespace
+{
+	std::atomic<unsigned long long>& Atomic(unsigned long long& aValue)
+	{
+		return reinterpret_cast<std::atomic<unsigned long long>&>(aValue);
+	}
+
+	std::atomic<unsigned>& Atomic(unsigned& aValue)
+	{
+		return reinterpret_cast<std::atomic<unsigned>&>(aValue);
+	}
+
+	unsigned char* GetSlot(ChannelHeader* aChannel, unsigned long long aSequence)
+	{
+		return reinterpret_cast<unsigned char*>(aChannel) + sizeof(ChannelHeader) + (aSequence & (aChannel->Capacity - 1)) * aChannel->SlotSize;
+	}
+
+	std::atomic<unsigned long long>& GetStamp(unsigned char* aSlot)
+	{
+		return *reinterpret_cast<std::atomic<unsigned long long>*>(aSlot);
+	}
+
+	bool IsValid(const ChannelHeader* aChannel, int aConsumer)
+	{
+		return aChannel && aChannel->Capacity && aConsumer >= 0 && aConsumer < static_cast<int>(DLC_MAX_CONSUMERS);
+	}
+}
+
+namespace Channel
+{
+	size_t GetSize(unsigned aRecordSize, unsigned aCapacity)
+	{
+		size_t slotSize = (sizeof(unsigned long long) + aRecordSize + 7) & ~static_cast<size_t>(7);
+
+		return sizeof(ChannelHeader) + slotSize * aCapacity;
+	}
+
+	bool Initialize(ChannelHeader* aChannel, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer)
+	{
+		if (!aChannel || aRecordSize == 0 || aCapacity == 0 || (aCapacity & (aCapacity - 1)) != 0) { return false; }
+
+		aChannel->RecordSize = aRecordSize;
+		aChannel->SlotSize = static_cast<unsigned>(GetSize(aRecordSize, 1) - sizeof(ChannelHeader));
+		aChannel->IsMultiProducer = aIsMultiProducer;
+
+		/* the capacity is set last, a channel without capacity is not initialized yet */
+		Atomic(aChannel->Capacity).store(aCapacity, std::memory_order_release);
+
+		return true;
+	}
+
+	bool Write(ChannelHeader* aChannel, const void* aRecord)
+	{
+		if (!aChannel || !aChannel->Capacity || !aRecord) { return false; }
+
+		unsigned long long sequence;
+
+		if (aChannel->IsMultiProducer)
+		{
+			sequence = Atomic(aChannel->Head).fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			sequence = Atomic(aChannel->Head).load(std::memory_order_relaxed);
+			Atomic(aChannel->Head).store(sequence + 1, std::memory_order_relaxed);
+		}
+
+		unsigned char* slot = GetSlot(aChannel, sequence);
+		std::atomic<unsigned long long>& stamp = GetStamp(slot);
+
+		unsigned long long writing = sequence * 2 + 1;
+		unsigned long long current = stamp.load(std::memory_order_relaxed);
+
+		for (unsigned i = 0; ; i++)
+		{
+			/* a producer a whole lap ahead already owns the slot */
+			if ((current & ~DLC_STAMP_SKIPPED) >= writing)
+			{
+				Atomic(aChannel->Dropped).fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			/* the previous lap is still being written */
+			if (current & 1)
+			{
+				/* its producer stalled or died, skip this sequence so consumers don't wait for it */
+				if (i >= SL_MAX_RETRIES)
+				{
+					if (stamp.compare_exchange_weak(current, (writing + 1) | DLC_STAMP_SKIPPED, std::memory_order_release, std::memory_order_relaxed))
+					{
+						Atomic(aChannel->Dropped).fetch_add(1, std::memory_order_relaxed);
+						return false;
+					}
+
+					continue;
+				}
+
+				std::this_thread::yield();
+				current = stamp.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (stamp.compare_exchange_weak(current, writing, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+
+		/* the odd stamp has to be visible before any of the record */
+		std::atomic_thread_fence(std::memory_order_release);
+
+		memcpy(slot + sizeof(unsigned long long), aRecord, aChannel->RecordSize);
+
+		if (!aChannel->IsMultiProducer)
+		{
+			stamp.store(writing + 1, std::memory_order_release);
+			return true;
+		}
+
+		/* the next lap skipped this slot while the write stalled, the record is lost */
+		if (!stamp.compare_exchange_strong(writing, writing + 1, std::memory_order_release, std::memory_order_relaxed))
+		{
+			Atomic(aChannel->Dropped).fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		return true;
+	}
+
+	int Subscribe(ChannelHeader* aChannel)
+	{
+		if (!aChannel || !aChannel->Capacity) { return -1; }
+
+		for (unsigned i = 0; i < DLC_MAX_CONSUMERS; i++)
+		{
+			ChannelConsumer& consumer = aChannel->Consumers[i];
+
+			unsigned expected = 0;
+
+			if (Atomic(consumer.IsSubscribed).compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+			{
+				Atomic(consumer.Overflows).store(0, std::memory_order_relaxed);
+				Atomic(consumer.Cursor).store(Atomic(aChannel->Head).load(std::memory_order_acquire), std::memory_order_release);
+				return static_cast<int>(i);
+			}
+		}
+
+		return -1;
+	}
+
+	void Unsubscribe(ChannelHeader* aChannel, int aConsumer)
+	{
+		if (!IsValid(aChannel, aConsumer)) { return; }
+
+		Atomic(aChannel->Consumers[aConsumer].IsSubscribed).store(0, std::memory_order_release);
+	}
+
+	bool Read(ChannelHeader* aChannel, int aConsumer, void* aOutRecord)
+	{
+		if (!IsValid(aChannel, aConsumer) || !aOutRecord) { return false; }
+
+		ChannelConsumer& consumer = aChannel->Consumers[aConsumer];
+
+		unsigned long long cursor = Atomic(consumer.Cursor).load(std::memory_order_relaxed);
+
+		for (unsigned i = 0; i < SL_MAX_RETRIES; i++)
+		{
+			unsigned char* slot = GetSlot(aChannel, cursor);
+			std::atomic<unsigned long long>& stamp = GetStamp(slot);
+
+			unsigned long long written = cursor * 2 + 2;
+			unsigned long long before = stamp.load(std::memory_order_acquire);
+
+			/* not written yet, or still being written */
+			if ((before & ~DLC_STAMP_SKIPPED) < written)
+			{
+				break;
+			}
+
+			/* its producer dropped the write, there is nothing to read */
+			if (before == (written | DLC_STAMP_SKIPPED))
+			{
+				cursor++;
+				continue;
+			}
+
+			if (before == written)
+			{
+				memcpy(aOutRecord, slot + sizeof(unsigned long long), aChannel->RecordSize);
+
+				/* the copy has to complete before the stamp is checked again */
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (stamp.load(std::memory_order_relaxed) == written)
+				{
+					Atomic(consumer.Cursor).store(cursor + 1, std::memory_order_release);
+					return true;
+				}
+			}
+
+			/* overwritten, skip to the oldest record that can still be read */
+			unsigned long long oldest = Atomic(aChannel->Head).load(std::memory_order_acquire) - aChannel->Capacity;
+
+			if (oldest <= cursor) { oldest = cursor + 1; }
+
+			Atomic(consumer.Overflows).fetch_add(oldest - cursor, std::memory_order_relaxed);
+			cursor = oldest;
+		}
+
+		Atomic(consumer.Cursor).store(cursor, std::memory_order_release);
+
+		return false;
+	}
+}
@@ -0,0 +1,96 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Channel.h
+/// Description  :  Lock-free ring buffer of fixed-size records within a shared resource.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <cstddef>
+
+constexpr const unsigned DLC_MAX_CONSUMERS			= 32;
+constexpr const unsigned long long DLC_STAMP_SKIPPED	= 1ull << 63;	/* on the written stamp of a dropped sequence */
+
+///----------------------------------------------------------------------------------------------------
+/// ChannelConsumer Struct
+/// 	Cursor and Overflows are only written by the thread owning the consumer.
+///----------------------------------------------------------------------------------------------------
+struct alignas(64) ChannelConsumer
+{
+	unsigned				IsSubscribed;
+	unsigned long long		Cursor;				/* sequence of the next record to read */
+	unsigned long long		Overflows;			/* records overwritten before they were read */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// ChannelHeader Struct
+/// 	Followed by Capacity slots of SlotSize bytes: an unsigned long long stamp and the record.
+/// 	The stamp of sequence S is 2S + 1 while being written and 2S + 2 once written.
+/// 	A sequence whose write was dropped is stamped 2S + 2 | DLC_STAMP_SKIPPED, consumers step over it.
+///----------------------------------------------------------------------------------------------------
+struct alignas(64) ChannelHeader
+{
+	unsigned				RecordSize;
+	unsigned				Capacity;			/* power of two */
+	unsigned				SlotSize;
+	unsigned				IsMultiProducer;
+
+	alignas(64)
+	unsigned long long		Head;				/* sequence of the next record to write */
+	unsigned long long		Dropped;			/* writes abandoned because a newer write owned the slot */
+
+	ChannelConsumer			Consumers[DLC_MAX_CONSUMERS];
+};
+
+///----------------------------------------------------------------------------------------------------
+/// Channel Namespace
+/// 	Every consumer receives every record. Producers never wait for consumers, a consumer that falls
+/// 	more than Capacity records behind skips the overwritten ones and counts them as overflows.
+///----------------------------------------------------------------------------------------------------
+namespace Channel
+{
+	///----------------------------------------------------------------------------------------------------
+	/// GetSize:
+	/// 	Returns the size of a channel, including the header.
+	///----------------------------------------------------------------------------------------------------
+	size_t GetSize(unsigned aRecordSize, unsigned aCapacity);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Initialize:
+	/// 	Initializes zeroed memory of GetSize bytes as a channel.
+	/// 	Returns false if the capacity is not a power of two.
+	///----------------------------------------------------------------------------------------------------
+	bool Initialize(ChannelHeader* aChannel, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Write:
+	/// 	Copies the record into the channel. Only one thread may write to a single producer channel.
+	/// 	Returns false if the write was dropped, because a producer a lap ahead owns the slot or
+	/// 	the write of the previous lap did not finish within SL_MAX_RETRIES.
+	///----------------------------------------------------------------------------------------------------
+	bool Write(ChannelHeader* aChannel, const void* aRecord);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Subscribe:
+	/// 	Returns a consumer that starts at the next written record, or -1 if there are no free consumers.
+	///----------------------------------------------------------------------------------------------------
+	int Subscribe(ChannelHeader* aChannel);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Unsubscribe:
+	/// 	Releases the consumer.
+	///----------------------------------------------------------------------------------------------------
+	void Unsubscribe(ChannelHeader* aChannel, int aConsumer);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Read:
+	/// 	Copies the next record of the consumer into aOutRecord. Only one thread may read per consumer.
+	/// 	Returns false if there is no new record.
+	///----------------------------------------------------------------------------------------------------
+	bool Read(ChannelHeader* aChannel, int aConsumer, void* aOutRecord);
+}
+
+#endif
@@ -8,6 +8,10 @@
 
 #include "DataLink.h"
 
+#include <algorithm>
+#include <cstring>
+#include <intrin.h>
+
 #include "Consts.h"
 #include "Shared.h"
 #include "State.h"
@@ -23,6 +27,51 @@ namespace DataLink
 	{
 		return DataLinkService->ShareResource(aIdentifier, aResourceSize, false);
 	}
+
+	void* ADDONAPI_ShareVersionedResource(const char* aIdentifier, size_t aResourceSize, size_t aVersionOffset)
+	{
+		return DataLinkService->ShareVersionedResource(aIdentifier, aResourceSize, aVersionOffset, false);
+	}
+
+	bool ADDONAPI_ReadResource(const char* aIdentifier, void* aBuffer, size_t aBufferSize, unsigned* aOutVersion)
+	{
+		return DataLinkService->ReadResource(aIdentifier, aBuffer, aBufferSize, aOutVersion);
+	}
+
+	DataLinkEntry* ADDONAPI_GetHandle(const char* aIdentifier)
+	{
+		return DataLinkService->GetHandle(aIdentifier);
+	}
+
+	void* ADDONAPI_GetResourceFromHandle(DataLinkEntry* aHandle)
+	{
+		return DataLinkService->GetResource(aHandle);
+	}
+
+	ChannelHeader* ADDONAPI_ShareChannel(const char* aIdentifier, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer)
+	{
+		return DataLinkService->ShareChannel(aIdentifier, aRecordSize, aCapacity, aIsMultiProducer, false);
+	}
+
+	int ADDONAPI_ChannelSubscribe(ChannelHeader* aChannel)
+	{
+		return DataLinkService->SubscribeChannel(aChannel, _ReturnAddress());
+	}
+
+	void ADDONAPI_ChannelUnsubscribe(ChannelHeader* aChannel, int aConsumer)
+	{
+		DataLinkService->UnsubscribeChannel(aChannel, aConsumer);
+	}
+
+	bool ADDONAPI_InterpolateMumble(long long aTime, MumbleSample* aOutSample)
+	{
+		return CMumbleHistory::Interpolate((MumbleHistory*)DataLinkService->GetResource(DL_MUMBLE_HISTORY), aTime, aOutSample);
+	}
+}
+
+CDataLink::CDataLink()
+{
+	this->Snapshot = new DataLinkSnapshot{};
 }
 
 CDataLink::~CDataLink()
@@ -33,52 +82,84 @@ CDataLink::~CDataLink()
 	{
 		const auto& it = this->Registry.begin();
 
-		switch (it->second.Type)
+		const LinkedResource* resource = it->second->Resource.load();
+
+		if (resource)
 		{
-		case ELinkedResourceType::Public:
-			if (it->second.Pointer)
+			switch (resource->Type)
 			{
-				UnmapViewOfFile((LPVOID)it->second.Pointer);
-				it->second.Pointer = nullptr;
+			case ELinkedResourceType::Public:
+				if (resource->Pointer)
+				{
+					UnmapViewOfFile((LPVOID)resource->Pointer);
+				}
+
+				if (resource->Handle)
+				{
+					CloseHandle(resource->Handle);
+				}
+				break;
+
+			case ELinkedResourceType::Internal:
+				if (resource->Pointer)
+				{
+					delete[] (char*)resource->Pointer;
+				}
+				break;
 			}
 
-			if (it->second.Handle)
-			{
-				CloseHandle(it->second.Handle);
-				it->second.Handle = nullptr;
-			}
-			break;
+			Logger->Info(CH_DATALINK, "Freed shared resource: \"%s\"", it->first.c_str());
 
-		case ELinkedResourceType::Internal:
-			if (it->second.Pointer)
-			{
-				delete it->second.Pointer;
-				it->second.Pointer = nullptr;
-			}
-			break;
+			delete resource;
 		}
 
-		Logger->Info(CH_DATALINK, "Freed shared resource: \"%s\"", it->first.c_str());
+		delete it->second;
 
 		this->Registry.erase(it);
 	}
+
+	/* retired resources share the memory of the current one, it was freed above */
+	for (const LinkedResource* retired : this->RetiredResources)
+	{
+		delete retired;
+	}
+
+	for (const DataLinkSnapshot* retired : this->RetiredSnapshots)
+	{
+		delete retired;
+	}
+
+	delete this->Snapshot.load();
 }
 
 void* CDataLink::GetResource(const char* aIdentifier)
 {
-	std::string str = aIdentifier;
+	if (!aIdentifier) { return nullptr; }
 
-	void* result = nullptr;
+	return this->GetResource(this->Access(aIdentifier));
+}
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+void* CDataLink::GetResource(const DataLinkEntry* aHandle)
+{
+	if (!aHandle) { return nullptr; }
 
-	const auto& it = this->Registry.find(str);
-	if (it != this->Registry.end())
-	{
-		result = it->second.Pointer;
-	}
+	const LinkedResource* resource = aHandle->Resource.load(std::memory_order_acquire);
 
-	return result;
+	return resource ? resource->Pointer : nullptr;
+}
+
+DataLinkEntry* CDataLink::GetHandle(const char* aIdentifier)
+{
+	if (!aIdentifier) { return nullptr; }
+
+	/* the entry never changes once it exists */
+	const DataLinkEntry* entry = this->Access(aIdentifier);
+
+	if (entry) { return const_cast<DataLinkEntry*>(entry); }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->GetOrCreateEntry(aIdentifier);
 }
 
 void* CDataLink::ShareResource(const char* aIdentifier, size_t aResourceSize, bool aIsPublic)
@@ -86,26 +167,33 @@ void* CDataLink::ShareResource(const char* aIdentifier, size_t aResourceSize, bo
 	return ShareResource(aIdentifier, aResourceSize, "", aIsPublic);
 }
 
+void CDataLink::SetOnAccess(const char* aIdentifier, void (*aCallback)())
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->GetOrCreateEntry(aIdentifier)->OnAccess.store(aCallback, std::memory_order_release);
+}
+
 void* CDataLink::ShareResource(const char* aIdentifier, size_t aResourceSize, const char* aUnderlyingName, bool aIsPublic)
 {
 	std::string str = aIdentifier;
 	std::string strOverride = aUnderlyingName;
 
-	void* result = nullptr;
-
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
 	/* resource already exists */
 	const auto& it = this->Registry.find(str);
-	if (it != this->Registry.end())
+	if (it != this->Registry.end() && it->second->Resource.load())
 	{
-		if (it->second.Size == aResourceSize)
+		const LinkedResource* existing = it->second->Resource.load();
+
+		if (existing->Size == aResourceSize)
 		{
-			return it->second.Pointer;
+			return existing->Pointer;
 		}
 		else
 		{
-			Logger->Warning(CH_DATALINK, "Resource with name \"%s\" already exists with size %u but size %u was requested.", str.c_str(), it->second.Size, aResourceSize);
+			Logger->Warning(CH_DATALINK, "Resource with name \"%s\" already exists with size %u but size %u was requested.", str.c_str(), existing->Size, aResourceSize);
 			return nullptr;
 		}
 	}
@@ -158,19 +246,255 @@ void* CDataLink::ShareResource(const char* aIdentifier, size_t aResourceSize, co
 		break;
 	}
 
+	/* initial null, before anyone can see it */
+	memset(resource.Pointer, 0, resource.Size);
+
 	/* store linkedresource */
-	this->Registry[str] = resource;
-	result = resource.Pointer;
+	this->Publish(this->GetOrCreateEntry(str), resource);
 
-	/* initial null */
-	memset(resource.Pointer, 0, resource.Size);
+	return resource.Pointer;
+}
+
+void* CDataLink::ShareVersionedResource(const char* aIdentifier, size_t aResourceSize, size_t aVersionOffset, bool aIsPublic)
+{
+	if (aVersionOffset + sizeof(unsigned) > aResourceSize || aVersionOffset % alignof(unsigned) != 0)
+	{
+		Logger->Warning(CH_DATALINK, "Resource with name \"%s\" cannot be versioned at offset %u with size %u.", aIdentifier, aVersionOffset, aResourceSize);
+		return nullptr;
+	}
+
+	void* result = this->ShareResource(aIdentifier, aResourceSize, aIsPublic);
+
+	if (!result) { return nullptr; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	DataLinkEntry* entry = this->Registry[aIdentifier];
+	LinkedResource resource = *entry->Resource.load();
+
+	if (resource.IsChannel)
+	{
+		Logger->Warning(CH_DATALINK, "Resource with name \"%s\" is a channel and cannot be versioned.", aIdentifier);
+		return nullptr;
+	}
+
+	if (resource.IsVersioned)
+	{
+		if (resource.VersionOffset != aVersionOffset)
+		{
+			Logger->Warning(CH_DATALINK, "Resource with name \"%s\" is already versioned at offset %u but offset %u was requested.", aIdentifier, resource.VersionOffset, aVersionOffset);
+			return nullptr;
+		}
+
+		return result;
+	}
+
+	resource.IsVersioned = true;
+	resource.VersionOffset = aVersionOffset;
+
+	this->Publish(entry, resource);
+
+	return result;
+}
+
+bool CDataLink::ReadResource(const char* aIdentifier, void* aBuffer, size_t aBufferSize, unsigned* aOutVersion)
+{
+	if (!aIdentifier || !aBuffer) { return false; }
+
+	const DataLinkEntry* entry = this->Access(aIdentifier);
+
+	if (!entry) { return false; }
+
+	/* resources are never freed while running, the copy happens without any lock */
+	const LinkedResource* resource = entry->Resource.load(std::memory_order_acquire);
+
+	if (!resource || !resource->Pointer) { return false; }
+
+	size_t size = aBufferSize < resource->Size ? aBufferSize : resource->Size;
+
+	if (!resource->IsVersioned)
+	{
+		memcpy(aBuffer, resource->Pointer, size);
+		if (aOutVersion) { *aOutVersion = 0; }
+		return true;
+	}
+
+	const unsigned* version = (const unsigned*)((const char*)resource->Pointer + resource->VersionOffset);
+
+	return SeqLock::Read(version, resource->Pointer, aBuffer, size, aOutVersion);
+}
+
+ChannelHeader* CDataLink::ShareChannel(const char* aIdentifier, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer, bool aIsPublic)
+{
+	if (aRecordSize == 0 || aCapacity == 0 || (aCapacity & (aCapacity - 1)) != 0)
+	{
+		Logger->Warning(CH_DATALINK, "Channel with name \"%s\" cannot have %u records of size %u, the capacity has to be a power of two.", aIdentifier, aCapacity, aRecordSize);
+		return nullptr;
+	}
+
+	ChannelHeader* result = (ChannelHeader*)this->ShareResource(aIdentifier, Channel::GetSize(aRecordSize, aCapacity), aIsPublic);
+
+	if (!result) { return nullptr; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	DataLinkEntry* entry = this->Registry[aIdentifier];
+	LinkedResource resource = *entry->Resource.load();
+
+	/* a public channel might have been initialized by another module already */
+	if (resource.IsChannel || result->Capacity != 0)
+	{
+		if (result->RecordSize != aRecordSize || result->Capacity != aCapacity || (result->IsMultiProducer != 0) != aIsMultiProducer)
+		{
+			Logger->Warning(CH_DATALINK, "Channel with name \"%s\" already exists with %u records of size %u but %u records of size %u were requested.", aIdentifier, result->Capacity, result->RecordSize, aCapacity, aRecordSize);
+			return nullptr;
+		}
+	}
+	else if (!resource.IsVersioned)
+	{
+		Channel::Initialize(result, aRecordSize, aCapacity, aIsMultiProducer);
+	}
+	else
+	{
+		Logger->Warning(CH_DATALINK, "Resource with name \"%s\" is versioned and cannot be a channel.", aIdentifier);
+		return nullptr;
+	}
+
+	if (!resource.IsChannel)
+	{
+		resource.IsChannel = true;
+
+		this->Publish(entry, resource);
+	}
 
 	return result;
 }
 
-std::unordered_map<std::string, LinkedResource> CDataLink::GetRegistry()
+int CDataLink::SubscribeChannel(ChannelHeader* aChannel, void* aOwner)
+{
+	int consumer = Channel::Subscribe(aChannel);
+
+	if (consumer < 0) { return consumer; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->Subscriptions.push_back(ChannelSubscription{ aChannel, consumer, aOwner });
+
+	return consumer;
+}
+
+void CDataLink::UnsubscribeChannel(ChannelHeader* aChannel, int aConsumer)
 {
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
-	return this->Registry;
+	auto it = std::find_if(this->Subscriptions.begin(), this->Subscriptions.end(), [aChannel, aConsumer](const ChannelSubscription& sub)
+	{
+		return sub.Channel == aChannel && sub.Consumer == aConsumer;
+	});
+
+	/* released under the lock, so the slot is not subscribed again before the entry is gone */
+	Channel::Unsubscribe(aChannel, aConsumer);
+
+	if (it != this->Subscriptions.end())
+	{
+		this->Subscriptions.erase(it);
+	}
+}
+
+int CDataLink::Verify(void* aStartAddress, void* aEndAddress)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	int refCounter = 0;
+
+	this->Subscriptions.erase(std::remove_if(this->Subscriptions.begin(), this->Subscriptions.end(), [aStartAddress, aEndAddress, &refCounter](const ChannelSubscription& sub)
+	{
+		if (sub.Owner < aStartAddress || sub.Owner > aEndAddress) { return false; }
+
+		Channel::Unsubscribe(sub.Channel, sub.Consumer);
+		refCounter++;
+		return true;
+	}), this->Subscriptions.end());
+
+	return refCounter;
+}
+
+const DataLinkSnapshot* CDataLink::GetSnapshot() const
+{
+	return this->Snapshot.load(std::memory_order_acquire);
+}
+
+const DataLinkEntry* CDataLink::Find(const char* aIdentifier) const
+{
+	const DataLinkSnapshot* snapshot = this->Snapshot.load(std::memory_order_acquire);
+
+	/* no allocation, the identifier is compared in place */
+	auto it = std::lower_bound(snapshot->Entries.begin(), snapshot->Entries.end(), aIdentifier, [](const DataLinkEntry* aEntry, const char* aName)
+	{
+		return strcmp(aEntry->Identifier.c_str(), aName) < 0;
+	});
+
+	if (it != snapshot->Entries.end() && strcmp((*it)->Identifier.c_str(), aIdentifier) == 0)
+	{
+		return *it;
+	}
+
+	return nullptr;
+}
+
+const DataLinkEntry* CDataLink::Access(const char* aIdentifier)
+{
+	const DataLinkEntry* entry = this->Find(aIdentifier);
+
+	/* a single load on every lookup, exchanged so the callback only runs once */
+	if (entry && entry->OnAccess.load(std::memory_order_relaxed))
+	{
+		void (*callback)() = const_cast<DataLinkEntry*>(entry)->OnAccess.exchange(nullptr, std::memory_order_acq_rel);
+
+		if (callback) { callback(); }
+	}
+
+	return entry;
+}
+
+DataLinkEntry* CDataLink::GetOrCreateEntry(const std::string& aIdentifier)
+{
+	const auto& it = this->Registry.find(aIdentifier);
+	if (it != this->Registry.end())
+	{
+		return it->second;
+	}
+
+	DataLinkEntry* entry = new DataLinkEntry();
+	entry->Identifier = aIdentifier;
+	entry->Resource = nullptr;
+	entry->OnAccess = nullptr;
+
+	this->Registry[aIdentifier] = entry;
+
+	const DataLinkSnapshot* current = this->Snapshot.load();
+
+	DataLinkSnapshot* snapshot = new DataLinkSnapshot();
+	snapshot->Generation = current->Generation + 1;
+	snapshot->Entries = current->Entries;
+	snapshot->Entries.insert(std::upper_bound(snapshot->Entries.begin(), snapshot->Entries.end(), entry, [](const DataLinkEntry* aLhs, const DataLinkEntry* aRhs)
+	{
+		return strcmp(aLhs->Identifier.c_str(), aRhs->Identifier.c_str()) < 0;
+	}), entry);
+
+	/* readers might still be searching the old one, entries are only added so it is kept until shutdown */
+	this->RetiredSnapshots.push_back(this->Snapshot.exchange(snapshot));
+
+	return entry;
+}
+
+void CDataLink::Publish(DataLinkEntry* aEntry, const LinkedResource& aResource)
+{
+	const LinkedResource* previous = aEntry->Resource.exchange(new LinkedResource(aResource));
+
+	/* the previous one might still be read, it shares the memory and is freed on shutdown */
+	if (previous)
+	{
+		this->RetiredResources.push_back(previous);
+	}
 }
@@ -9,11 +9,16 @@
 #ifndef DATALINK_H
 #define DATALINK_H
 
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "LinkedResource.h"
+#include "Channel.h"
+#include "SeqLock.h"
+#include "Services/Mumble/History.h"
 
 constexpr const char* CH_DATALINK = "DataLink";
 
@@ -33,9 +38,60 @@ namespace DataLink
 	/// 	Addon API wrapper function for ShareResource.
 	///----------------------------------------------------------------------------------------------------
 	void* ADDONAPI_ShareResource(const char* aIdentifier, size_t aResourceSize);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_ShareVersionedResource:
+	/// 	Addon API wrapper function for ShareVersionedResource.
+	///----------------------------------------------------------------------------------------------------
+	void* ADDONAPI_ShareVersionedResource(const char* aIdentifier, size_t aResourceSize, size_t aVersionOffset);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_ReadResource:
+	/// 	Addon API wrapper function for ReadResource.
+	///----------------------------------------------------------------------------------------------------
+	bool ADDONAPI_ReadResource(const char* aIdentifier, void* aBuffer, size_t aBufferSize, unsigned* aOutVersion);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_GetHandle:
+	/// 	Addon API wrapper function for GetHandle.
+	///----------------------------------------------------------------------------------------------------
+	DataLinkEntry* ADDONAPI_GetHandle(const char* aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_GetResourceFromHandle:
+	/// 	Addon API wrapper function for GetResource with a handle.
+	///----------------------------------------------------------------------------------------------------
+	void* ADDONAPI_GetResourceFromHandle(DataLinkEntry* aHandle);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_ShareChannel:
+	/// 	Addon API wrapper function for ShareChannel.
+	///----------------------------------------------------------------------------------------------------
+	ChannelHeader* ADDONAPI_ShareChannel(const char* aIdentifier, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_ChannelSubscribe:
+	/// 	Addon API wrapper function for SubscribeChannel.
+	///----------------------------------------------------------------------------------------------------
+	int ADDONAPI_ChannelSubscribe(ChannelHeader* aChannel);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_ChannelUnsubscribe:
+	/// 	Addon API wrapper function for UnsubscribeChannel.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_ChannelUnsubscribe(ChannelHeader* aChannel, int aConsumer);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_InterpolateMumble:
+	/// 	Addon API wrapper function for CMumbleHistory::Interpolate on DL_MUMBLE_HISTORY.
+	///----------------------------------------------------------------------------------------------------
+	bool ADDONAPI_InterpolateMumble(long long aTime, MumbleSample* aOutSample);
 }
+
 ///----------------------------------------------------------------------------------------------------
 /// CDataLink Class
+/// 	Lookups never lock, they read the published snapshot. Resources are never freed while running,
+/// 	neither are their entries, so handles and pointers stay valid until shutdown.
 ///----------------------------------------------------------------------------------------------------
 class CDataLink
 {
@@ -43,7 +99,7 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	/// ctor
 	///----------------------------------------------------------------------------------------------------
-	CDataLink() = default;
+	CDataLink();
 	///----------------------------------------------------------------------------------------------------
 	/// dtor
 	///----------------------------------------------------------------------------------------------------
@@ -55,12 +111,31 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	void* GetResource(const char* aIdentifier);
 
+	///----------------------------------------------------------------------------------------------------
+	/// GetResource:
+	/// 	Retrieves the resource of the given handle, nullptr if it was not shared yet.
+	///----------------------------------------------------------------------------------------------------
+	void* GetResource(const DataLinkEntry* aHandle);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetHandle:
+	/// 	Resolves the identifier once. The handle is valid until shutdown, even before the resource is shared.
+	///----------------------------------------------------------------------------------------------------
+	DataLinkEntry* GetHandle(const char* aIdentifier);
+
 	///----------------------------------------------------------------------------------------------------
 	/// ShareResource:
 	/// 	Allocates memory of the given size, accessible via the provided identifier.
 	///----------------------------------------------------------------------------------------------------
 	void* ShareResource(const char* aIdentifier, size_t aResourceSize, bool aIsPublic);
 
+	///----------------------------------------------------------------------------------------------------
+	/// SetOnAccess:
+	/// 	Calls aCallback once, on the first GetResource, GetHandle or ReadResource of the identifier.
+	/// 	Lets Nexus provide a resource only once an addon asks for it.
+	///----------------------------------------------------------------------------------------------------
+	void SetOnAccess(const char* aIdentifier, void (*aCallback)());
+
 	///----------------------------------------------------------------------------------------------------
 	/// ShareResource:
 	/// 	Allocates memory of the given size, accessible via the provided identifier,
@@ -69,14 +144,95 @@ public:
 	void* ShareResource(const char* aIdentifier, size_t aResourceSize, const char* aUnderlyingName, bool aIsPublic);
 
 	///----------------------------------------------------------------------------------------------------
-	/// GetRegistry:
-	/// 	Returns a copy of the registry.
+	/// ShareVersionedResource:
+	/// 	Allocates memory of the given size, accessible via the provided identifier.
+	/// 	Writes to it follow the SeqLock protocol on the unsigned version at aVersionOffset.
+	///----------------------------------------------------------------------------------------------------
+	void* ShareVersionedResource(const char* aIdentifier, size_t aResourceSize, size_t aVersionOffset, bool aIsPublic);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReadResource:
+	/// 	Copies up to aBufferSize bytes of the resource into aBuffer.
+	/// 	Versioned resources are copied consistently, aOutVersion is the version of the copy.
+	/// 	Returns false if the resource does not exist or no consistent copy could be made.
+	///----------------------------------------------------------------------------------------------------
+	bool ReadResource(const char* aIdentifier, void* aBuffer, size_t aBufferSize, unsigned* aOutVersion);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ShareChannel:
+	/// 	Allocates a channel of aCapacity records of aRecordSize bytes, accessible via the provided identifier.
+	/// 	Returns the existing channel if it was already shared with the same record size and capacity.
+	///----------------------------------------------------------------------------------------------------
+	ChannelHeader* ShareChannel(const char* aIdentifier, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer, bool aIsPublic);
+
 	///----------------------------------------------------------------------------------------------------
-	std::unordered_map<std::string, LinkedResource> GetRegistry();
+	/// SubscribeChannel:
+	/// 	Subscribes a consumer of the channel for the module aOwner is within, see Channel::Subscribe.
+	///----------------------------------------------------------------------------------------------------
+	int SubscribeChannel(ChannelHeader* aChannel, void* aOwner);
+
+	///----------------------------------------------------------------------------------------------------
+	/// UnsubscribeChannel:
+	/// 	Releases the consumer, see Channel::Unsubscribe.
+	///----------------------------------------------------------------------------------------------------
+	void UnsubscribeChannel(ChannelHeader* aChannel, int aConsumer);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Verify:
+	/// 	Releases the channel consumers subscribed from within the provided address space.
+	/// 	Returns the amount of released consumers.
+	///----------------------------------------------------------------------------------------------------
+	int Verify(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetSnapshot:
+	/// 	Returns the current snapshot of all entries. It stays valid until shutdown.
+	///----------------------------------------------------------------------------------------------------
+	const DataLinkSnapshot* GetSnapshot() const;
 
 private:
-	std::mutex										Mutex;
-	std::unordered_map<std::string, LinkedResource>	Registry;
+	///----------------------------------------------------------------------------------------------------
+	/// ChannelSubscription Struct
+	///----------------------------------------------------------------------------------------------------
+	struct ChannelSubscription
+	{
+		ChannelHeader*								Channel;
+		int											Consumer;
+		void*										Owner;
+	};
+
+	std::mutex										Mutex;				/* writers only */
+	std::unordered_map<std::string, DataLinkEntry*>	Registry;
+	std::vector<ChannelSubscription>				Subscriptions;
+
+	std::atomic<const DataLinkSnapshot*>			Snapshot;
+	std::vector<const DataLinkSnapshot*>			RetiredSnapshots;
+	std::vector<const LinkedResource*>				RetiredResources;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Find:
+	/// 	Returns the entry of the identifier from the snapshot, nullptr if there is none.
+	///----------------------------------------------------------------------------------------------------
+	const DataLinkEntry* Find(const char* aIdentifier) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Access:
+	/// 	Find, calling the OnAccess callback of the entry if it has not been called yet.
+	///----------------------------------------------------------------------------------------------------
+	const DataLinkEntry* Access(const char* aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetOrCreateEntry:
+	/// 	Returns the entry of the identifier, publishes a new snapshot if it was created.
+	/// 	Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	DataLinkEntry* GetOrCreateEntry(const std::string& aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Publish:
+	/// 	Publishes an immutable copy of the resource on the entry. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void Publish(DataLinkEntry* aEntry, const LinkedResource& aResource);
 };
 
 #endif
@@ -1,7 +1,21 @@
 #ifndef DATALINK_FUNCDEFS_H
 #define DATALINK_FUNCDEFS_H
 
+struct ChannelHeader;
+struct DataLinkEntry;
+struct MumbleSample;
+
 typedef void* (*DATALINK_GETRESOURCE)(const char* aIdentifier);
 typedef void* (*DATALINK_SHARERESOURCE)(const char* aIdentifier, size_t aResourceSize);
+typedef void* (*DATALINK_SHAREVERSIONEDRESOURCE)(const char* aIdentifier, size_t aResourceSize, size_t aVersionOffset);
+typedef bool (*DATALINK_READRESOURCE)(const char* aIdentifier, void* aBuffer, size_t aBufferSize, unsigned* aOutVersion);
+typedef DataLinkEntry* (*DATALINK_GETHANDLE)(const char* aIdentifier);
+typedef void* (*DATALINK_GETRESOURCEFROMHANDLE)(DataLinkEntry* aHandle);
+typedef ChannelHeader* (*DATALINK_SHARECHANNEL)(const char* aIdentifier, unsigned aRecordSize, unsigned aCapacity, bool aIsMultiProducer);
+typedef bool (*DATALINK_CHANNEL_WRITE)(ChannelHeader* aChannel, const void* aRecord);
+typedef int (*DATALINK_CHANNEL_SUBSCRIBE)(ChannelHeader* aChannel);
+typedef void (*DATALINK_CHANNEL_UNSUBSCRIBE)(ChannelHeader* aChannel, int aConsumer);
+typedef bool (*DATALINK_CHANNEL_READ)(ChannelHeader* aChannel, int aConsumer, void* aOutRecord);
+typedef bool (*DATALINK_INTERPOLATEMUMBLE)(long long aTime, MumbleSample* aOutSample);
 
 #endif
\ No newline at end of file
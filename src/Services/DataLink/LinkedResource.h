@@ -10,7 +10,9 @@
 #define LINKEDRESOURCE_H
 
 #include <Windows.h>
+#include <atomic>
 #include <string>
+#include <vector>
 
 ///----------------------------------------------------------------------------------------------------
 /// ELinkedResourceType enum
@@ -32,6 +34,30 @@ struct LinkedResource
 	void*					Pointer;			/* The pointer to the resource. */
 	size_t					Size;				/* The size of the resource. */
 	std::string				UnderlyingName;		/* The real name of the memory mapped file.*/
+	bool					IsVersioned;		/* Whether writes follow the SeqLock protocol. */
+	size_t					VersionOffset;		/* The offset of the version within the resource. */
+	bool					IsChannel;			/* Whether the resource is a channel, see Channel.h. */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// DataLinkEntry data struct
+/// 	Exists once per identifier until shutdown and doubles as the handle to the resource.
+///----------------------------------------------------------------------------------------------------
+struct DataLinkEntry
+{
+	std::string								Identifier;
+	std::atomic<const LinkedResource*>		Resource;	/* Immutable once published, nullptr until shared. */
+	std::atomic<void (*)()>					OnAccess;	/* Called by the first lookup, then nullptr. */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// DataLinkSnapshot data struct
+/// 	Immutable once published.
+///----------------------------------------------------------------------------------------------------
+struct DataLinkSnapshot
+{
+	unsigned long long						Generation;	/* Advances with every published snapshot. */
+	std::vector<const DataLinkEntry*>		Entries;	/* Sorted by identifier. */
 };
 
 #endif
@@ -0,0 +1,107 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  SeqLock.h
+/// Description  :  Sequence lock protocol for versioned shared resources.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+constexpr unsigned SL_MAX_RETRIES = 4096; /* a writer that died while writing must not hang the reader */
+
+static_assert(sizeof(std::atomic<unsigned>) == sizeof(unsigned), "The version has to be a plain unsigned in shared memory.");
+static_assert(std::atomic<unsigned>::is_always_lock_free, "The version has to be lock-free to be shared across modules.");
+
+///----------------------------------------------------------------------------------------------------
+/// SeqLock Namespace
+/// 	The version is odd while a write is in progress and advances by two with every write.
+/// 	Readers copy the data and retry if the version was odd or changed during the copy.
+/// 	Addons may implement the same protocol on the version field of a versioned resource.
+///----------------------------------------------------------------------------------------------------
+namespace SeqLock
+{
+	///----------------------------------------------------------------------------------------------------
+	/// BeginWrite:
+	/// 	Marks the start of a write. Concurrent writers wait for each other.
+	///----------------------------------------------------------------------------------------------------
+	inline void BeginWrite(unsigned* aVersion)
+	{
+		std::atomic<unsigned>* version = reinterpret_cast<std::atomic<unsigned>*>(aVersion);
+
+		unsigned current = version->load(std::memory_order_relaxed);
+
+		while ((current & 1) || !version->compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			if (current & 1)
+			{
+				std::this_thread::yield();
+				current = version->load(std::memory_order_relaxed);
+			}
+		}
+
+		/* the odd version has to be visible before any of the data */
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// EndWrite:
+	/// 	Marks the end of a write and publishes the new version.
+	///----------------------------------------------------------------------------------------------------
+	inline void EndWrite(unsigned* aVersion)
+	{
+		std::atomic<unsigned>* version = reinterpret_cast<std::atomic<unsigned>*>(aVersion);
+
+		version->fetch_add(1, std::memory_order_release);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetVersion:
+	/// 	Returns the current version without copying, e.g. to check whether anything changed.
+	///----------------------------------------------------------------------------------------------------
+	inline unsigned GetVersion(const unsigned* aVersion)
+	{
+		return reinterpret_cast<const std::atomic<unsigned>*>(aVersion)->load(std::memory_order_acquire);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Read:
+	/// 	Copies aSize bytes from aSource to aDestination, consistent with the version.
+	/// 	Returns false if no consistent copy could be made, aOutVersion is the version of the copy.
+	///----------------------------------------------------------------------------------------------------
+	inline bool Read(const unsigned* aVersion, const void* aSource, void* aDestination, size_t aSize, unsigned* aOutVersion = nullptr)
+	{
+		const std::atomic<unsigned>* version = reinterpret_cast<const std::atomic<unsigned>*>(aVersion);
+
+		for (unsigned i = 0; i < SL_MAX_RETRIES; i++)
+		{
+			unsigned before = version->load(std::memory_order_acquire);
+
+			if (before & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			memcpy(aDestination, aSource, aSize);
+
+			/* the copy has to complete before the version is checked again */
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (version->load(std::memory_order_relaxed) == before)
+			{
+				if (aOutVersion) { *aOutVersion = before; }
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+#endif
@@ -0,0 +1,247 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  LocalePack.cpp
+/// Description  :  Compiled, memory mapped locale files.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "LocalePack.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace LocalePack
+{
+	constexpr unsigned	MAGIC	= 0x504C584E; /* "NXLP" */
+	constexpr unsigned	VERSION	= 1;
+
+	bool Compile(const std::filesystem::path& aPath, unsigned long long aSignature, unsigned aLocaleCount,
+		const std::string& aIdentifier, const std::string& aDisplayName, const std::map<std::string, std::string>& aTexts)
+	{
+		PackHeader header{};
+		header.Magic = MAGIC;
+		header.Version = VERSION;
+		header.Signature = aSignature;
+		header.LocaleCount = aLocaleCount;
+		header.Count = static_cast<unsigned>(aTexts.size());
+		header.Index = sizeof(PackHeader);
+		header.Strings = header.Index + header.Count * sizeof(PackEntry);
+
+		std::vector<PackEntry> entries;
+		entries.reserve(aTexts.size());
+
+		std::vector<char> strings;
+
+		auto append = [&](const std::string& aString) -> unsigned
+		{
+			unsigned offset = header.Strings + static_cast<unsigned>(strings.size());
+			strings.insert(strings.end(), aString.c_str(), aString.c_str() + aString.size() + 1);
+			return offset;
+		};
+
+		header.Identifier = append(aIdentifier);
+		header.DisplayName = append(aDisplayName);
+
+		/* std::map is ordered the same way as strcmp, which Find relies on */
+		for (auto& [key, value] : aTexts)
+		{
+			PackEntry entry{};
+			entry.Key = append(key);
+			entry.Value = append(value);
+			entries.push_back(entry);
+		}
+
+		header.Size = header.Strings + static_cast<unsigned>(strings.size());
+
+		/* write to a temporary file first, so a crash never leaves a truncated pack behind */
+		try
+		{
+			std::filesystem::path tmpPath = aPath;
+			tmpPath += ".tmp";
+
+			{
+				std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+				if (!file.is_open()) { return false; }
+
+				file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+				file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+				file.write(strings.data(), strings.size());
+				if (!file.good()) { return false; }
+			}
+
+			std::filesystem::rename(tmpPath, aPath);
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ReadInfo(const std::filesystem::path& aPath, unsigned long long aSignature, unsigned& aOutLocaleCount,
+		std::string& aOutIdentifier, std::string& aOutDisplayName)
+	{
+		std::ifstream file(aPath, std::ios::binary);
+		if (!file.is_open()) { return false; }
+
+		PackHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(PackHeader));
+
+		if (!file.good()) { return false; }
+		if (header.Magic != MAGIC || header.Version != VERSION || header.Signature != aSignature) { return false; }
+
+		/* identifier and display name are the first two strings */
+		file.seekg(header.Identifier);
+		if (!std::getline(file, aOutIdentifier, '\0')) { return false; }
+
+		file.seekg(header.DisplayName);
+		if (!std::getline(file, aOutDisplayName, '\0')) { return false; }
+
+		aOutLocaleCount = header.LocaleCount;
+
+		return !aOutIdentifier.empty();
+	}
+}
+
+CLocalePack::~CLocalePack()
+{
+	this->Close();
+}
+
+bool CLocalePack::Open(const std::filesystem::path& aPath, unsigned long long aSignature)
+{
+	this->Close();
+
+	this->File = CreateFileW(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (this->File == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(this->File, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(PackHeader)) || size.QuadPart > UINT_MAX)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->Mapping = CreateFileMappingW(this->File, 0, PAGE_READONLY, 0, 0, 0);
+	if (!this->Mapping)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->View = static_cast<const char*>(MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!this->View)
+	{
+		this->Close();
+		return false;
+	}
+
+	const PackHeader* header = reinterpret_cast<const PackHeader*>(this->View);
+	unsigned long long fileSize = static_cast<unsigned long long>(size.QuadPart);
+
+	bool isValid = header->Magic == LocalePack::MAGIC
+		&& header->Version == LocalePack::VERSION
+		&& header->Signature == aSignature
+		&& header->Size == fileSize
+		&& header->Index == sizeof(PackHeader)
+		&& header->Strings == header->Index + static_cast<unsigned long long>(header->Count) * sizeof(PackEntry)
+		&& header->Strings < fileSize
+		&& this->View[fileSize - 1] == '\0';
+
+	/* every offset has to point into the string pool, which is null terminated as a whole */
+	if (isValid)
+	{
+		const PackEntry* entries = reinterpret_cast<const PackEntry*>(this->View + header->Index);
+
+		auto inPool = [&](unsigned aOffset) { return aOffset >= header->Strings && aOffset < fileSize; };
+
+		isValid = inPool(header->Identifier) && inPool(header->DisplayName);
+
+		for (unsigned i = 0; isValid && i < header->Count; i++)
+		{
+			isValid = inPool(entries[i].Key) && inPool(entries[i].Value);
+		}
+	}
+
+	if (!isValid)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->Header = header;
+	this->Entries = reinterpret_cast<const PackEntry*>(this->View + header->Index);
+
+	return true;
+}
+
+void CLocalePack::Close()
+{
+	if (this->View)
+	{
+		UnmapViewOfFile(this->View);
+	}
+
+	if (this->Mapping)
+	{
+		CloseHandle(this->Mapping);
+	}
+
+	if (this->File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(this->File);
+	}
+
+	this->File = INVALID_HANDLE_VALUE;
+	this->Mapping = nullptr;
+	this->View = nullptr;
+	this->Header = nullptr;
+	this->Entries = nullptr;
+}
+
+const char* CLocalePack::Find(const char* aIdentifier) const
+{
+	if (!this->Header || !aIdentifier) { return nullptr; }
+
+	size_t lo = 0;
+	size_t hi = this->Header->Count;
+
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		int cmp = strcmp(this->View + this->Entries[mid].Key, aIdentifier);
+
+		if (cmp == 0)
+		{
+			return this->View + this->Entries[mid].Value;
+		}
+		else if (cmp < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return nullptr;
+}
+
+size_t CLocalePack::Count() const
+{
+	return this->Header ? this->Header->Count : 0;
+}
+
+const char* CLocalePack::GetKey(size_t aIndex) const
+{
+	return this->View + this->Entries[aIndex].Key;
+}
+
+const char* CLocalePack::GetValue(size_t aIndex) const
+{
+	return this->View + this->Entries[aIndex].Value;
+}
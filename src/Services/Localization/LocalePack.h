@@ -0,0 +1,133 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  LocalePack.h
+/// Description  :  Compiled, memory mapped locale files.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef LOCALEPACK_H
+#define LOCALEPACK_H
+
+#include <Windows.h>
+#include <filesystem>
+#include <map>
+#include <string>
+
+///----------------------------------------------------------------------------------------------------
+/// LocalePack Namespace
+/// 	A pack holds all texts of a single language: a header, an index of key/value offsets sorted by
+/// 	key and a pool of null terminated strings. It is mapped as is, nothing is parsed or copied.
+///----------------------------------------------------------------------------------------------------
+namespace LocalePack
+{
+	///----------------------------------------------------------------------------------------------------
+	/// Compile:
+	/// 	Writes a pack for a language to aPath.
+	/// 	aSignature identifies the sources, aLocaleCount is the amount of packs compiled from them.
+	/// 	Returns true on success.
+	///----------------------------------------------------------------------------------------------------
+	bool Compile(const std::filesystem::path& aPath, unsigned long long aSignature, unsigned aLocaleCount,
+		const std::string& aIdentifier, const std::string& aDisplayName, const std::map<std::string, std::string>& aTexts);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReadInfo:
+	/// 	Reads only the header and names of a pack without mapping it.
+	/// 	Returns false if the pack is invalid or was not compiled from aSignature.
+	///----------------------------------------------------------------------------------------------------
+	bool ReadInfo(const std::filesystem::path& aPath, unsigned long long aSignature, unsigned& aOutLocaleCount,
+		std::string& aOutIdentifier, std::string& aOutDisplayName);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// PackHeader data struct
+///----------------------------------------------------------------------------------------------------
+struct PackHeader
+{
+	unsigned			Magic;
+	unsigned			Version;
+	unsigned long long	Signature;
+	unsigned			LocaleCount;	/* packs compiled from the same sources */
+	unsigned			Count;			/* entries in the index */
+	unsigned			Identifier;		/* offset of the language identifier */
+	unsigned			DisplayName;	/* offset of the display name */
+	unsigned			Index;			/* offset of the first PackEntry */
+	unsigned			Strings;		/* offset of the string pool */
+	unsigned			Size;			/* total size of the pack */
+	unsigned			Reserved;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// PackEntry data struct
+///----------------------------------------------------------------------------------------------------
+struct PackEntry
+{
+	unsigned			Key;			/* offset of the identifier */
+	unsigned			Value;			/* offset of the text */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CLocalePack Class
+/// 	Read-only view of a compiled pack. Returned strings point into the mapping and stay valid until
+/// 	the pack is closed.
+///----------------------------------------------------------------------------------------------------
+class CLocalePack
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CLocalePack() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CLocalePack();
+
+	CLocalePack(const CLocalePack&) = delete;
+	CLocalePack& operator=(const CLocalePack&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Open:
+	/// 	Maps the pack at aPath and validates it against aSignature. Returns true on success.
+	///----------------------------------------------------------------------------------------------------
+	bool Open(const std::filesystem::path& aPath, unsigned long long aSignature);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Close:
+	/// 	Unmaps the pack.
+	///----------------------------------------------------------------------------------------------------
+	void Close();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Find:
+	/// 	Returns the text with the given identifier or nullptr.
+	///----------------------------------------------------------------------------------------------------
+	const char* Find(const char* aIdentifier) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Count:
+	/// 	Returns the amount of texts.
+	///----------------------------------------------------------------------------------------------------
+	size_t Count() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetKey:
+	/// 	Returns the identifier at aIndex, in ascending order.
+	///----------------------------------------------------------------------------------------------------
+	const char* GetKey(size_t aIndex) const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetValue:
+	/// 	Returns the text at aIndex, in ascending order of the identifiers.
+	///----------------------------------------------------------------------------------------------------
+	const char* GetValue(size_t aIndex) const;
+
+private:
+	HANDLE					File		= INVALID_HANDLE_VALUE;
+	HANDLE					Mapping		= nullptr;
+	const char*				View		= nullptr;
+	const PackHeader*		Header		= nullptr;
+	const PackEntry*		Entries		= nullptr;
+};
+
+#endif
@@ -8,6 +8,9 @@
 
 #include "Localization.h"
 
+#include <algorithm>
+#include <fstream>
+
 #include "Consts.h"
 #include "Shared.h"
 
@@ -35,6 +38,23 @@ namespace Localization
 CLocalization::~CLocalization()
 {
 	this->ClearLocaleAtlas();
+
+	for (char* str : this->StringPool)
+	{
+		free(str);
+	}
+
+	for (TranslationTable* table : this->RetiredTables)
+	{
+		delete table;
+	}
+
+	for (auto& [path, pack] : this->Packs)
+	{
+		delete pack;
+	}
+
+	delete this->Table.load();
 }
 
 bool CLocalization::Advance()
@@ -47,8 +67,33 @@ bool CLocalization::Advance()
 		didModify = true;
 	}
 
+	std::unordered_set<std::string> requested;
+
+	{
+		const std::lock_guard<std::mutex> lock(this->RequestMutex);
+		requested.swap(this->Requested);
+	}
+
 	const std::lock_guard<std::mutex> lock(this->Mutex);
 
+	for (const std::string& identifier : requested)
+	{
+		auto atlasIt = this->LocaleAtlas.find(identifier);
+
+		if (atlasIt != this->LocaleAtlas.end() && !atlasIt->second.Pack)
+		{
+			this->LoadPack(&atlasIt->second);
+			didModify = true;
+		}
+	}
+
+	/* the active texts changed, which affects the glyphs needed */
+	if (this->IsActiveLocaleChanged)
+	{
+		this->IsActiveLocaleChanged = false;
+		didModify = true;
+	}
+
 	while (this->Queued.size() > 0)
 	{
 		QueuedTranslation& item = this->Queued.front();
@@ -57,7 +102,7 @@ bool CLocalization::Advance()
 
 		if (atlasIt != this->LocaleAtlas.end())
 		{
-			atlasIt->second.Texts[item.Identifier] = _strdup(item.Text.c_str());
+			atlasIt->second.Overlay[item.Identifier] = this->AllocString(item.Text);
 		}
 
 		this->Queued.erase(this->Queued.begin());
@@ -65,63 +110,98 @@ bool CLocalization::Advance()
 		didModify = true;
 	}
 
+	if (didModify)
+	{
+		this->Publish();
+	}
+	else
+	{
+		/* tables retired while a Translate was in progress */
+		this->FreeRetired();
+	}
+
 	return didModify;
 }
 
 const char* CLocalization::Translate(const char* aIdentifier, const char* aLanguageIdentifier)
 {
-	if (!IsLocaleAtlasBuilt)
+	if (!aIdentifier) { return aIdentifier; }
+
+	/* a table published after this point is not freed until the lookup is done */
+	this->Readers++;
+
+	const TranslationTable* table = this->Table.load();
+
+	/* atlas was never built, cannot localize */
+	if (!table)
 	{
-		/* atlas was never built, cannot localize */
+		this->Readers--;
 		return aIdentifier;
 	}
 
-	std::string identifier = aIdentifier;
-
-	if (aLanguageIdentifier)
+	/* the active language is used until the requested one is published */
+	if (aLanguageIdentifier && table->Unloaded.find(aLanguageIdentifier) != table->Unloaded.end())
 	{
-		std::string languageIdentifier = aLanguageIdentifier;
+		this->RequestLanguage(aLanguageIdentifier);
+	}
 
-		auto atlasIt = LocaleAtlas.find(languageIdentifier);
+	const std::atomic<unsigned>* id = this->Identifiers.Find(aIdentifier);
 
-		if (atlasIt != LocaleAtlas.end())
-		{
-			auto it = atlasIt->second.Texts.find(identifier);
+	/* not part of any language */
+	const char* str = id ? Resolve(table, id->load(std::memory_order_acquire), aLanguageIdentifier) : nullptr;
 
-			if (it != atlasIt->second.Texts.end())
-			{
-				return it->second;
-			}
-		}
-	}
+	this->Readers--;
+
+	return str ? str : aIdentifier;
+}
+
+const char* CLocalization::Translate(unsigned aHandle, const char* aLanguageIdentifier)
+{
+	this->Readers++;
 
-	if (ActiveLocale)
+	const TranslationTable* table = this->Table.load();
+
+	if (!table)
 	{
-		auto it = ActiveLocale->Texts.find(identifier);
+		this->Readers--;
+		return nullptr;
+	}
 
-		if (it != ActiveLocale->Texts.end())
-		{
-			return it->second;
-		}
+	if (aLanguageIdentifier && table->Unloaded.find(aLanguageIdentifier) != table->Unloaded.end())
+	{
+		this->RequestLanguage(aLanguageIdentifier);
 	}
 
-	if (!ActiveLocale || ActiveLocale->DisplayName != "English")
+	const char* str = Resolve(table, aHandle, aLanguageIdentifier);
+
+	this->Readers--;
+
+	return str;
+}
+
+unsigned CLocalization::GetHandle(const char* aIdentifier)
+{
+	if (!aIdentifier) { return 0; }
+
+	const std::atomic<unsigned>* existing = this->Identifiers.Find(aIdentifier);
+	if (existing)
 	{
-		auto atlasIt = LocaleAtlas.find("en");
+		unsigned id = existing->load(std::memory_order_acquire);
+		if (id) { return id; }
+	}
 
-		if (atlasIt != LocaleAtlas.end())
-		{
-			auto it = atlasIt->second.Texts.find(identifier);
+	const std::lock_guard<std::mutex> lock(this->Mutex);
 
-			if (it != atlasIt->second.Texts.end())
-			{
-				return it->second;
-			}
-		}
+	size_t count = this->IdentifierNames.size();
+	unsigned id = this->Intern(aIdentifier);
+
+	/* new identifier, tables have to cover it before the handle is used */
+	if (this->IdentifierNames.size() != count)
+	{
+		this->Publish();
 	}
 
-	/* no active language set and no language specified, cannot localize */
-	return aIdentifier;
+	return id;
 }
 
 void CLocalization::Set(const char* aIdentifier, const char* aLanguageIdentifier, const char* aString)
@@ -131,35 +211,65 @@ void CLocalization::Set(const char* aIdentifier, const char* aLanguageIdentifier
 		return;
 	}
 
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
 	this->Queued.push_back({ aIdentifier, aLanguageIdentifier, aString });
 }
 
 void CLocalization::SetLanguage(const std::string& aIdentifier)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	this->SetLanguageInternal(aIdentifier);
+}
+
+void CLocalization::SetLanguageInternal(const std::string& aIdentifier)
 {
 	auto atlasIt = this->LocaleAtlas.find(aIdentifier);
 
+	Locale* previous = this->ActiveLocale;
+
 	/* find via identifier */
 	if (atlasIt != this->LocaleAtlas.end())
 	{
 		this->ActiveLocale = &atlasIt->second;
-		return;
 	}
-
-	/* find via display name */
-	for (auto& it : this->LocaleAtlas)
+	else
 	{
-		if (it.second.DisplayName == aIdentifier)
+		this->ActiveLocale = nullptr;
+
+		/* find via display name */
+		for (auto& it : this->LocaleAtlas)
 		{
-			this->ActiveLocale = &it.second;
-			return;
+			if (it.second.DisplayName == aIdentifier)
+			{
+				this->ActiveLocale = &it.second;
+				break;
+			}
 		}
 	}
 
-	this->ActiveLocale = nullptr;
+	if (this->ActiveLocale)
+	{
+		this->LoadPack(this->ActiveLocale);
+	}
+
+	if (this->ActiveLocale != previous)
+	{
+		this->IsActiveLocaleChanged = true;
+
+		/* only publish once the atlas is built, Advance does it otherwise */
+		if (this->IsLocaleAtlasBuilt)
+		{
+			this->Publish();
+		}
+	}
 }
 
 std::vector<std::string> CLocalization::GetLanguages()
 {
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
 	std::vector<std::string> langs;
 
 	for (auto& it : this->LocaleAtlas)
@@ -172,6 +282,8 @@ std::vector<std::string> CLocalization::GetLanguages()
 
 const std::string& CLocalization::GetActiveLanguage()
 {
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
 	if (this->ActiveLocale)
 	{
 		return this->ActiveLocale->DisplayName;
@@ -197,21 +309,357 @@ void CLocalization::BuildLocaleAtlas()
 	ClearLocaleAtlas();
 
 	const std::lock_guard<std::mutex> lock(this->Mutex);
-	/* find files, merge files, alloc strings */
-	for (const std::filesystem::directory_entry entry : std::filesystem::directory_iterator(this->Directory))
+
+	std::filesystem::path packDirectory = this->Directory / "Packs";
+
+	/* the sources are identified by their names, sizes and modification times */
+	std::vector<std::filesystem::path> sources;
+	unsigned long long signature = 14695981039346656037ULL;
+
+	auto hash = [&signature](const void* aData, size_t aSize)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(aData);
+		for (size_t i = 0; i < aSize; i++)
+		{
+			signature ^= bytes[i];
+			signature *= 1099511628211ULL;
+		}
+	};
+
+	try
+	{
+		for (const std::filesystem::directory_entry entry : std::filesystem::directory_iterator(this->Directory))
+		{
+			std::filesystem::path path = entry.path();
+
+			if (path.extension() != ".json")
+			{
+				continue;
+			}
+
+			if (std::filesystem::file_size(path) == 0)
+			{
+				continue;
+			}
+
+			sources.push_back(path);
+		}
+
+		std::sort(sources.begin(), sources.end());
+
+		for (const std::filesystem::path& path : sources)
+		{
+			std::string filename = path.filename().string();
+			unsigned long long size = std::filesystem::file_size(path);
+			long long time = std::filesystem::last_write_time(path).time_since_epoch().count();
+
+			hash(filename.c_str(), filename.size() + 1);
+			hash(&size, sizeof(size));
+			hash(&time, sizeof(time));
+		}
+
+		std::filesystem::create_directories(packDirectory);
+	}
+	catch (const std::filesystem::filesystem_error& ex)
+	{
+		Logger->Warning(CH_LOCALIZATION, "Locale directory could not be read. Error: %s", ex.what());
+		return;
+	}
+
+	this->Signature = signature;
+
+	char suffix[24];
+	sprintf_s(suffix, "_%016llX.lpk", signature);
+
+	/* find packs compiled from these sources */
+	std::map<std::string, std::pair<std::string, std::filesystem::path>> packs;
+	bool isComplete = false;
+
+	for (int attempt = 0; attempt < 2 && !isComplete; attempt++)
+	{
+		if (attempt > 0)
+		{
+			this->CompilePacks(sources, packDirectory);
+		}
+
+		packs.clear();
+		unsigned expected = 0;
+
+		for (const std::filesystem::directory_entry entry : std::filesystem::directory_iterator(packDirectory))
+		{
+			std::filesystem::path path = entry.path();
+			std::string filename = path.filename().string();
+
+			if (filename.size() <= strlen(suffix) || filename.compare(filename.size() - strlen(suffix), std::string::npos, suffix) != 0)
+			{
+				continue;
+			}
+
+			unsigned localeCount = 0;
+			std::string identifier;
+			std::string displayName;
+
+			if (LocalePack::ReadInfo(path, signature, localeCount, identifier, displayName))
+			{
+				expected = localeCount;
+				packs[identifier] = { displayName, path };
+			}
+		}
+
+		isComplete = packs.size() == expected && (expected > 0 || sources.empty());
+	}
+
+	if (!isComplete)
+	{
+		Logger->Warning(CH_LOCALIZATION, "Locale packs could not be compiled.");
+	}
+
+	for (auto& [identifier, pack] : packs)
+	{
+		Locale& loc = this->LocaleAtlas[identifier];
+		loc.DisplayName = pack.first;
+		loc.Path = pack.second;
+	}
+
+	this->IsLocaleAtlasBuilt = true;
+
+	/* english is the fallback for every other language */
+	auto enIt = this->LocaleAtlas.find("en");
+	if (enIt != this->LocaleAtlas.end())
+	{
+		this->LoadPack(&enIt->second);
+	}
+
+	if (this->ActiveLocale)
+	{
+		this->SetLanguageInternal(this->ActiveLocale->DisplayName);
+	}
+
+	this->Publish();
+}
+
+void CLocalization::ClearLocaleAtlas()
+{
+	if (!this->IsLocaleAtlasBuilt)
+	{
+		return;
+	}
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	/* the packs stay mapped, readers may still hold their strings */
+	for (auto& locale : this->LocaleAtlas)
+	{
+		locale.second.Pack = nullptr;
+		locale.second.Path.clear();
+	}
+
+	this->IsLocaleAtlasBuilt = false;
+}
+
+std::vector<const char*> CLocalization::GetAllTexts()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	std::vector<const char*> allTexts;
+
+	for (auto& [atlasId, atlasLocale] : this->LocaleAtlas)
+	{
+		if (atlasLocale.Pack)
+		{
+			for (size_t i = 0; i < atlasLocale.Pack->Count(); i++)
+			{
+				allTexts.push_back(atlasLocale.Pack->GetValue(i));
+			}
+		}
+
+		for (auto& [textId, textVal] : atlasLocale.Overlay)
+		{
+			allTexts.push_back(textVal);
+		}
+	}
+
+	return allTexts;
+}
+
+std::vector<const char*> CLocalization::GetActiveTexts()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	std::vector<const char*> activeTexts;
+
+	for (auto& [atlasId, atlasLocale] : this->LocaleAtlas)
 	{
-		std::filesystem::path path = entry.path();
+		/* display names are shown in the language selector */
+		activeTexts.push_back(atlasLocale.DisplayName.c_str());
 
-		if (path.extension() != ".json")
+		if (&atlasLocale != this->ActiveLocale && atlasId != "en")
 		{
 			continue;
 		}
 
-		if (std::filesystem::file_size(path) == 0)
+		if (atlasLocale.Pack)
+		{
+			for (size_t i = 0; i < atlasLocale.Pack->Count(); i++)
+			{
+				activeTexts.push_back(atlasLocale.Pack->GetValue(i));
+			}
+		}
+
+		for (auto& [textId, textVal] : atlasLocale.Overlay)
+		{
+			activeTexts.push_back(textVal);
+		}
+	}
+
+	return activeTexts;
+}
+
+size_t CLocalization::GetRetiredCount()
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	return this->RetiredTables.size();
+}
+
+unsigned CLocalization::Intern(const std::string& aIdentifier)
+{
+	/* ID 0 is reserved for "not assigned yet" */
+	if (this->IdentifierNames.empty())
+	{
+		this->IdentifierNames.push_back(nullptr);
+	}
+
+	std::atomic<unsigned>* slot = this->Identifiers.FindOrInsert(aIdentifier.c_str());
+
+	unsigned id = slot->load(std::memory_order_relaxed);
+
+	if (id == 0)
+	{
+		id = static_cast<unsigned>(this->IdentifierNames.size());
+		this->IdentifierNames.push_back(this->AllocString(aIdentifier));
+		slot->store(id, std::memory_order_release);
+	}
+
+	return id;
+}
+
+const char* CLocalization::AllocString(const std::string& aString)
+{
+	char* str = _strdup(aString.c_str());
+	this->StringPool.push_back(str);
+	return str;
+}
+
+void CLocalization::Publish()
+{
+	/* assign IDs to all identifiers */
+	for (auto& [atlasId, atlasLocale] : this->LocaleAtlas)
+	{
+		if (atlasLocale.Pack)
 		{
+			for (size_t i = 0; i < atlasLocale.Pack->Count(); i++)
+			{
+				this->Intern(atlasLocale.Pack->GetKey(i));
+			}
+		}
+
+		for (auto& [textId, textVal] : atlasLocale.Overlay)
+		{
+			this->Intern(textId);
+		}
+	}
+
+	auto enIt = this->LocaleAtlas.find("en");
+	const Locale* english = enIt != this->LocaleAtlas.end() ? &enIt->second : nullptr;
+
+	/* english is only a fallback for other languages */
+	if (english == this->ActiveLocale)
+	{
+		english = nullptr;
+	}
+
+	auto lookup = [](const Locale* aLocale, const char* aIdentifier) -> const char*
+	{
+		if (!aLocale) { return nullptr; }
+
+		if (!aLocale->Overlay.empty())
+		{
+			auto it = aLocale->Overlay.find(aIdentifier);
+			if (it != aLocale->Overlay.end()) { return it->second; }
+		}
+
+		return aLocale->Pack ? aLocale->Pack->Find(aIdentifier) : nullptr;
+	};
+
+	size_t count = this->IdentifierNames.size();
+
+	TranslationTable* table = new TranslationTable();
+	table->Active.resize(count, nullptr);
+
+	for (size_t i = 1; i < count; i++)
+	{
+		const char* identifier = this->IdentifierNames[i];
+
+		const char* str = lookup(this->ActiveLocale, identifier);
+		if (!str) { str = lookup(english, identifier); }
+		if (!str) { str = this->IdentifierNames[i]; }
+
+		table->Active[i] = str;
+	}
+
+	for (auto& [atlasId, atlasLocale] : this->LocaleAtlas)
+	{
+		/* languages without a mapped pack are loaded on first use */
+		if (!atlasLocale.Pack && !atlasLocale.Path.empty())
+		{
+			table->Unloaded.insert(atlasId);
 			continue;
 		}
 
+		std::vector<const char*>& texts = table->Locales[atlasId];
+		texts.resize(count, nullptr);
+
+		for (size_t i = 1; i < count; i++)
+		{
+			const char* str = lookup(&atlasLocale, this->IdentifierNames[i]);
+			texts[i] = str ? str : table->Active[i];
+		}
+	}
+
+	TranslationTable* previous = this->Table.exchange(table);
+
+	if (previous)
+	{
+		this->RetiredTables.push_back(previous);
+	}
+
+	this->FreeRetired();
+}
+
+void CLocalization::FreeRetired()
+{
+	if (this->RetiredTables.empty()) { return; }
+
+	/* a reader that arrives after this point can only see the current table */
+	if (this->Readers.load() != 0) { return; }
+
+	for (TranslationTable* retired : this->RetiredTables)
+	{
+		delete retired;
+	}
+
+	this->RetiredTables.clear();
+}
+
+void CLocalization::CompilePacks(const std::vector<std::filesystem::path>& aSources, const std::filesystem::path& aPackDirectory)
+{
+	std::map<std::string, std::map<std::string, std::string>> texts;
+	std::map<std::string, std::string> displayNames;
+
+	/* merge all files of a language */
+	for (const std::filesystem::path& path : aSources)
+	{
 		try
 		{
 			std::ifstream file(path);
@@ -233,20 +681,15 @@ void CLocalization::BuildLocaleAtlas()
 				continue;
 			}
 
-			std::string locId = localeJson["Identifier"].get<std::string>();;
+			std::string locId = localeJson["Identifier"].get<std::string>();
 
-			auto atlasIt = this->LocaleAtlas.find(locId);
-
-			Locale loc{};
-			if (atlasIt != this->LocaleAtlas.end())
-			{
-				loc = atlasIt->second;
-			}
+			std::map<std::string, std::string>& locTexts = texts[locId];
+			std::string& displayName = displayNames[locId];
 
 			/* DisplayName can be null, hopefully *any* of the files have it set, if not fallback to identifier */
-			if (!localeJson["DisplayName"].is_null() && loc.DisplayName.empty())
+			if (!localeJson["DisplayName"].is_null() && displayName.empty())
 			{
-				localeJson["DisplayName"].get_to(loc.DisplayName);
+				localeJson["DisplayName"].get_to(displayName);
 			}
 
 			for (auto& [key, value] : localeJson["Texts"].items())
@@ -256,19 +699,9 @@ void CLocalization::BuildLocaleAtlas()
 					continue;
 				}
 
-				auto txtIt = loc.Texts.find(key);
-
-				/* if a value is already set, clear it. only used when merging */
-				if (txtIt != loc.Texts.end())
-				{
-					free((char*)txtIt->second);
-					txtIt->second = nullptr;
-				}
-
-				loc.Texts[key] = _strdup(value.get<std::string>().c_str());
+				/* if a value is already set, it is overwritten. only used when merging */
+				locTexts[key] = value.get<std::string>();
 			}
-
-			this->LocaleAtlas[locId] = loc;
 		}
 		catch (json::parse_error& ex)
 		{
@@ -276,46 +709,94 @@ void CLocalization::BuildLocaleAtlas()
 		}
 	}
 
-	this->IsLocaleAtlasBuilt = true;
+	/* packs of previous sources are outdated */
+	try
+	{
+		for (const std::filesystem::directory_entry entry : std::filesystem::directory_iterator(aPackDirectory))
+		{
+			if (entry.path().extension() == ".lpk" && this->Packs.find(entry.path()) == this->Packs.end())
+			{
+				std::error_code ec;
+				std::filesystem::remove(entry.path(), ec);
+			}
+		}
+	}
+	catch (...) {}
 
-	if (this->ActiveLocale)
+	char suffix[24];
+	sprintf_s(suffix, "_%016llX.lpk", this->Signature);
+
+	for (auto& [locId, locTexts] : texts)
 	{
-		this->SetLanguage(this->ActiveLocale->DisplayName);
+		std::string& displayName = displayNames[locId];
+
+		if (displayName.empty())
+		{
+			displayName = locId;
+		}
+
+		std::filesystem::path path = aPackDirectory / (locId + suffix);
+
+		if (!LocalePack::Compile(path, this->Signature, static_cast<unsigned>(texts.size()), locId, displayName, locTexts))
+		{
+			Logger->Warning(CH_LOCALIZATION, "Locale pack %s could not be written.", path.filename().string().c_str());
+		}
 	}
+
+	Logger->Info(CH_LOCALIZATION, "Compiled %u locale pack(s) from %u file(s).", static_cast<unsigned>(texts.size()), static_cast<unsigned>(aSources.size()));
 }
 
-void CLocalization::ClearLocaleAtlas()
+void CLocalization::LoadPack(Locale* aLocale)
 {
-	if (!this->IsLocaleAtlasBuilt)
+	if (aLocale->Pack || aLocale->Path.empty())
 	{
 		return;
 	}
 
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+	auto packIt = this->Packs.find(aLocale->Path);
 
-	/* delete strings */
-	for (auto& locale : this->LocaleAtlas)
+	if (packIt != this->Packs.end())
 	{
-		for (auto& text : locale.second.Texts)
-		{
-			free((char*)text.second);
-		}
+		aLocale->Pack = packIt->second;
+		return;
 	}
 
-	this->IsLocaleAtlasBuilt = false;
+	CLocalePack* pack = new CLocalePack();
+
+	if (!pack->Open(aLocale->Path, this->Signature))
+	{
+		Logger->Warning(CH_LOCALIZATION, "Locale pack %s could not be loaded.", aLocale->Path.filename().string().c_str());
+		delete pack;
+
+		/* don't try again */
+		aLocale->Path.clear();
+		return;
+	}
+
+	this->Packs[aLocale->Path] = pack;
+	aLocale->Pack = pack;
 }
 
-std::vector<const char*> CLocalization::GetAllTexts()
+void CLocalization::RequestLanguage(const char* aLanguageIdentifier)
 {
-	std::vector<const char*> allTexts;
+	const std::lock_guard<std::mutex> lock(this->RequestMutex);
 
-	for (auto& [atlasId, atlasLocale] : this->LocaleAtlas)
+	this->Requested.insert(aLanguageIdentifier);
+}
+
+const char* CLocalization::Resolve(const TranslationTable* aTable, unsigned aID, const char* aLanguageIdentifier)
+{
+	if (aID == 0 || aID >= aTable->Active.size()) { return nullptr; }
+
+	if (aLanguageIdentifier)
 	{
-		for (auto& [textId, textVal] : atlasLocale.Texts)
+		auto it = aTable->Locales.find(aLanguageIdentifier);
+
+		if (it != aTable->Locales.end())
 		{
-			allTexts.push_back(textVal);
+			return it->second[aID];
 		}
 	}
 
-	return allTexts;
+	return aTable->Active[aID];
 }
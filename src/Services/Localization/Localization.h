@@ -9,10 +9,17 @@
 #ifndef LOCALIZATION_H
 #define LOCALIZATION_H
 
+#include <atomic>
 #include <mutex>
 #include <filesystem>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "LocalePack.h"
+#include "Util/ConcurrentMap.h"
 
 constexpr const char* CH_LOCALIZATION = "Localization";
 
@@ -45,8 +52,10 @@ namespace Localization
 ///----------------------------------------------------------------------------------------------------
 struct Locale
 {
-	std::string DisplayName;
-	std::map<std::string, const char*> Texts;
+	std::string							DisplayName;
+	std::filesystem::path				Path;		/* compiled pack */
+	CLocalePack*						Pack		= nullptr;	/* nullptr until the language is needed */
+	std::map<std::string, const char*>	Overlay;	/* strings set at runtime, take precedence over the pack */
 };
 
 ///----------------------------------------------------------------------------------------------------
@@ -59,6 +68,18 @@ struct QueuedTranslation
 	std::string Text;
 };
 
+///----------------------------------------------------------------------------------------------------
+/// TranslationTable data struct
+/// 	Immutable once published. Indexed by the dense identifier ID, fallbacks are already resolved,
+/// 	untranslated entries point to the identifier itself.
+///----------------------------------------------------------------------------------------------------
+struct TranslationTable
+{
+	std::vector<const char*>									Active;		/* active language -> english -> identifier */
+	std::unordered_map<std::string, std::vector<const char*>>	Locales;	/* language -> active language -> english -> identifier */
+	std::unordered_set<std::string>								Unloaded;	/* languages whose pack is not mapped yet */
+};
+
 ///----------------------------------------------------------------------------------------------------
 /// CLocalization Class
 ///----------------------------------------------------------------------------------------------------
@@ -76,7 +97,8 @@ public:
 
 	///----------------------------------------------------------------------------------------------------
 	/// Advance:
-	/// 	Processes new strings and adds them to the atlas.
+	/// 	Processes new strings and adds them to the overlay of their language.
+	/// 	Loads the languages requested by Translate.
 	///----------------------------------------------------------------------------------------------------
 	bool Advance();
 
@@ -84,9 +106,26 @@ public:
 	/// Translate:
 	/// 	Returns the translated string with the given identifier and language.
 	/// 	If no language is specified, the currently set one will be used.
+	/// 	Lock-free, the returned string stays valid for the lifetime of CLocalization.
+	/// 	Translating into a language that is not loaded yet requests it and falls back to the
+	/// 	active language, until Advance published it.
 	///----------------------------------------------------------------------------------------------------
 	const char* Translate(const char* aIdentifier, const char* aLanguageIdentifier = nullptr);
 
+	///----------------------------------------------------------------------------------------------------
+	/// Translate:
+	/// 	Returns the translated string for a handle acquired via GetHandle, with the same fallbacks.
+	///----------------------------------------------------------------------------------------------------
+	const char* Translate(unsigned aHandle, const char* aLanguageIdentifier = nullptr);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetHandle:
+	/// 	Returns a handle for an identifier, translating it skips hashing the identifier.
+	/// 	Handles are indices into every published table, they stay valid across language changes
+	/// 	and reloads for the lifetime of CLocalization.
+	///----------------------------------------------------------------------------------------------------
+	unsigned GetHandle(const char* aIdentifier);
+
 	///----------------------------------------------------------------------------------------------------
 	/// Set:
 	/// 	Adds or sets/overrides a localized string with a given identifier.
@@ -114,27 +153,43 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	/// SetLocaleDirectory:
 	/// 	Sets the directory from which the LocaleAtlas is built.
+	/// 	Compiled packs are kept in the "Packs" subdirectory.
 	///----------------------------------------------------------------------------------------------------
 	void SetLocaleDirectory(std::filesystem::path aPath);
 
 	///----------------------------------------------------------------------------------------------------
 	/// BuildLocaleAtlas:
 	/// 	Builds the LocaleAtlas, if the directory is set.
+	/// 	The JSON sources are only parsed if they changed since the packs were compiled.
+	/// 	Only the active language and english are loaded.
 	///----------------------------------------------------------------------------------------------------
 	void BuildLocaleAtlas();
 
 	///----------------------------------------------------------------------------------------------------
 	/// ClearLocaleAtlas:
-	/// 	Clears the LocaleAtlas.
+	/// 	Clears the LocaleAtlas. Strings set at runtime are kept.
 	///----------------------------------------------------------------------------------------------------
 	void ClearLocaleAtlas();
 
 	///----------------------------------------------------------------------------------------------------
 	/// GetAllTexts:
-	/// 	Returns every single string.
+	/// 	Returns every single string of the loaded languages.
 	///----------------------------------------------------------------------------------------------------
 	std::vector<const char*> GetAllTexts();
 
+	///----------------------------------------------------------------------------------------------------
+	/// GetActiveTexts:
+	/// 	Returns the strings of the active language and the english fallback,
+	/// 	as well as the display names of all languages.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<const char*> GetActiveTexts();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetRetiredCount:
+	/// 	Returns the amount of replaced tables that are not freed yet.
+	///----------------------------------------------------------------------------------------------------
+	size_t GetRetiredCount();
+
 private:
 
 	std::mutex								Mutex;
@@ -147,6 +202,72 @@ private:
 
 	bool IsLocaleDirectorySet				= false;
 	bool IsLocaleAtlasBuilt					= false;
+	bool IsActiveLocaleChanged				= false;
+
+	CConcurrentMap<std::atomic<unsigned>>	Identifiers;		/* identifier to dense ID, 0 until assigned */
+	std::vector<const char*>				IdentifierNames;	/* dense ID to identifier */
+	std::vector<char*>						StringPool;			/* every string ever published, released with this */
+	unsigned long long						Signature			= 0;
+	std::map<std::filesystem::path, CLocalePack*>	Packs;			/* every pack ever loaded, released with this */
+	std::atomic<TranslationTable*>			Table{ nullptr };
+	std::vector<TranslationTable*>			RetiredTables;		/* readers may still hold these, freed once there are none */
+	std::atomic<int>						Readers{ 0 };		/* Translate calls in progress */
+	std::mutex								RequestMutex;
+	std::unordered_set<std::string>			Requested;			/* languages to load on the next Advance */
+
+	///----------------------------------------------------------------------------------------------------
+	/// SetLanguageInternal:
+	/// 	Sets the currently active language. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void SetLanguageInternal(const std::string& aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CompilePacks:
+	/// 	Parses the JSON sources and writes a pack per language. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void CompilePacks(const std::vector<std::filesystem::path>& aSources, const std::filesystem::path& aPackDirectory);
+
+	///----------------------------------------------------------------------------------------------------
+	/// LoadPack:
+	/// 	Maps the pack of a language, if it isn't yet. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void LoadPack(Locale* aLocale);
+
+	///----------------------------------------------------------------------------------------------------
+	/// RequestLanguage:
+	/// 	Queues a language to be loaded on the next Advance. Never waits for the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void RequestLanguage(const char* aLanguageIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Intern:
+	/// 	Returns the dense ID of an identifier, assigns one if needed. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	unsigned Intern(const std::string& aIdentifier);
+
+	///----------------------------------------------------------------------------------------------------
+	/// AllocString:
+	/// 	Copies a string into the pool. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	const char* AllocString(const std::string& aString);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Publish:
+	/// 	Builds a new TranslationTable and swaps it in. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void Publish();
+
+	///----------------------------------------------------------------------------------------------------
+	/// FreeRetired:
+	/// 	Frees the replaced tables, if no Translate is in progress. Has to be called while holding the Mutex.
+	///----------------------------------------------------------------------------------------------------
+	void FreeRetired();
+
+	///----------------------------------------------------------------------------------------------------
+	/// Resolve:
+	/// 	Returns the string for an ID in a table or nullptr if the ID is not part of it.
+	///----------------------------------------------------------------------------------------------------
+	static const char* Resolve(const TranslationTable* aTable, unsigned aID, const char* aLanguageIdentifier);
 };
 
 #endif
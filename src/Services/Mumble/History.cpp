@@ -0,0 +1,256 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  History.cpp
+/// Description  :  Keeps a history of timestamped MumbleLink samples for interpolation.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Services/Mumble/History.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "Services/DataLink/SeqLock.h"
+
+namespace
+{
+	std::atomic<unsigned long long>* Count(MumbleHistory* aHistory)
+	{
+		return reinterpret_cast<std::atomic<unsigned long long>*>(&aHistory->Count);
+	}
+
+	const std::atomic<unsigned long long>* Count(const MumbleHistory* aHistory)
+	{
+		return reinterpret_cast<const std::atomic<unsigned long long>*>(&aHistory->Count);
+	}
+
+	void Store(long long* aField, long long aValue)
+	{
+		reinterpret_cast<std::atomic<long long>*>(aField)->store(aValue, std::memory_order_relaxed);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReadSlot:
+	/// 	Copies the sample with the provided index. Returns false if it was overwritten.
+	///----------------------------------------------------------------------------------------------------
+	bool ReadSlot(const MumbleHistory* aHistory, unsigned long long aIndex, MumbleSample* aOutSample)
+	{
+		const MumbleHistorySlot& slot = aHistory->Slots[aIndex & (MH_SAMPLES - 1)];
+
+		MumbleHistorySlot copy;
+
+		if (!SeqLock::Read(&slot.Version, &slot, &copy, sizeof(MumbleHistorySlot))) { return false; }
+
+		if (copy.Index != aIndex) { return false; }
+
+		*aOutSample = copy.Sample;
+		return true;
+	}
+
+	Vector3 Lerp(const Vector3& aFrom, const Vector3& aTo, double aFactor)
+	{
+		return Vector3{
+			static_cast<float>(aFrom.X + (aTo.X - aFrom.X) * aFactor),
+			static_cast<float>(aFrom.Y + (aTo.Y - aFrom.Y) * aFactor),
+			static_cast<float>(aFrom.Z + (aTo.Z - aFrom.Z) * aFactor)
+		};
+	}
+
+	float Distance(const Vector3& aFrom, const Vector3& aTo)
+	{
+		float x = aTo.X - aFrom.X;
+		float y = aTo.Y - aFrom.Y;
+		float z = aTo.Z - aFrom.Z;
+
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsTeleport:
+	/// 	Returns true if the samples must not be interpolated, e.g. after a waypoint or map change.
+	///----------------------------------------------------------------------------------------------------
+	bool IsTeleport(const MumbleSample& aOlder, const MumbleSample& aNewer)
+	{
+		return aNewer.Time <= aOlder.Time ||
+			Distance(aOlder.AvatarPosition, aNewer.AvatarPosition) > MH_TELEPORT_DISTANCE ||
+			Distance(aOlder.CameraPosition, aNewer.CameraPosition) > MH_TELEPORT_DISTANCE;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Blend:
+	/// 	Interpolates between the samples, a factor above one extrapolates.
+	///----------------------------------------------------------------------------------------------------
+	void Blend(const MumbleSample& aOlder, const MumbleSample& aNewer, double aFactor, MumbleSample* aOutSample)
+	{
+		aOutSample->UITick = aFactor < 1.0 ? aOlder.UITick : aNewer.UITick;
+		aOutSample->AvatarPosition = Lerp(aOlder.AvatarPosition, aNewer.AvatarPosition, aFactor);
+		aOutSample->CameraPosition = Lerp(aOlder.CameraPosition, aNewer.CameraPosition, aFactor);
+
+		/* the front is a direction, keep it normalized */
+		Vector3 front = Lerp(aOlder.CameraFront, aNewer.CameraFront, aFactor);
+		float length = sqrtf(front.X * front.X + front.Y * front.Y + front.Z * front.Z);
+
+		if (length > 0.0001f)
+		{
+			aOutSample->CameraFront = Vector3{ front.X / length, front.Y / length, front.Z / length };
+		}
+		else
+		{
+			aOutSample->CameraFront = aNewer.CameraFront;
+		}
+	}
+}
+
+CMumbleHistory::CMumbleHistory(Mumble::Data* aMumbleLink, MumbleHistory* aHistory)
+{
+	this->MumbleLink = aMumbleLink;
+	this->History = aHistory;
+}
+
+bool CMumbleHistory::Sample(long long aFrameTime, MumbleSample* aOutSample)
+{
+	if (!this->History) { return false; }
+
+	Store(&this->History->FrameTime, aFrameTime);
+
+	if (!this->MumbleLink || this->MumbleLink->UITick == this->PreviousTick) { return false; }
+
+	/* the game writes the link without a version, the tick alone does not show a read overlapping an update:
+	 * read twice, an update in between or during either read leaves the reads or the tick different */
+	for (size_t i = 0; i < 3; i++)
+	{
+		unsigned tick = this->MumbleLink->UITick;
+
+		Vector3 reads[2][3];
+
+		for (size_t r = 0; r < 2; r++)
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			reads[r][0] = this->MumbleLink->AvatarPosition;
+			reads[r][1] = this->MumbleLink->CameraPosition;
+			reads[r][2] = this->MumbleLink->CameraFront;
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (this->MumbleLink->UITick == tick && memcmp(reads[0], reads[1], sizeof(reads[0])) == 0)
+		{
+			MumbleSample sample{};
+			sample.Time = aFrameTime;
+			sample.UITick = tick;
+			sample.AvatarPosition = reads[0][0];
+			sample.CameraPosition = reads[0][1];
+			sample.CameraFront = reads[0][2];
+
+			this->PreviousTick = tick;
+			this->Push(sample);
+
+			if (aOutSample) { *aOutSample = sample; }
+
+			return true;
+		}
+	}
+
+	/* the game kept writing, the next frame reads again */
+	return false;
+}
+
+void CMumbleHistory::Push(const MumbleSample& aSample)
+{
+	if (!this->History) { return; }
+
+	/* single writer, the count does not change underneath */
+	unsigned long long index = Count(this->History)->load(std::memory_order_relaxed);
+
+	if (index > 0)
+	{
+		long long interval = aSample.Time - this->History->Slots[(index - 1) & (MH_SAMPLES - 1)].Sample.Time;
+
+		/* smoothed, a single hitch should not make every overlay lag behind */
+		Store(&this->History->Interval, this->History->Interval == 0
+			? interval
+			: this->History->Interval + (interval - this->History->Interval) / 8);
+	}
+
+	MumbleHistorySlot& slot = this->History->Slots[index & (MH_SAMPLES - 1)];
+
+	SeqLock::BeginWrite(&slot.Version);
+	slot.Index = index;
+	slot.Sample = aSample;
+	SeqLock::EndWrite(&slot.Version);
+
+	Count(this->History)->store(index + 1, std::memory_order_release);
+}
+
+bool CMumbleHistory::Interpolate(const MumbleHistory* aHistory, long long aTime, MumbleSample* aOutSample)
+{
+	if (!aHistory || !aOutSample) { return false; }
+
+	unsigned long long count = Count(aHistory)->load(std::memory_order_acquire);
+
+	if (count == 0) { return false; }
+
+	unsigned long long oldest = count > MH_SAMPLES ? count - MH_SAMPLES : 0;
+
+	MumbleSample newer;
+
+	/* only overwritten if the writer lapped the whole ring in the meantime */
+	if (!ReadSlot(aHistory, count - 1, &newer)) { return false; }
+
+	if (aTime >= newer.Time)
+	{
+		MumbleSample older;
+
+		if (count - 1 > oldest && ReadSlot(aHistory, count - 2, &older) && !IsTeleport(older, newer))
+		{
+			long long ahead = aTime - newer.Time < MH_MAX_EXTRAPOLATION ? aTime - newer.Time : MH_MAX_EXTRAPOLATION;
+
+			Blend(older, newer, 1.0 + static_cast<double>(ahead) / static_cast<double>(newer.Time - older.Time), aOutSample);
+			aOutSample->Time = newer.Time + ahead;
+		}
+		else
+		{
+			*aOutSample = newer;
+		}
+
+		return true;
+	}
+
+	for (unsigned long long i = count - 1; i > oldest; i--)
+	{
+		MumbleSample older;
+
+		/* the writer overwrote the rest of the walk, what is left is the oldest sample */
+		if (!ReadSlot(aHistory, i - 1, &older)) { break; }
+
+		if (older.Time <= aTime)
+		{
+			if (IsTeleport(older, newer))
+			{
+				*aOutSample = older;
+			}
+			else
+			{
+				Blend(older, newer, static_cast<double>(aTime - older.Time) / static_cast<double>(newer.Time - older.Time), aOutSample);
+			}
+
+			aOutSample->Time = aTime;
+			return true;
+		}
+
+		newer = older;
+	}
+
+	/* clamped, the time of the sample tells how far off it is */
+	*aOutSample = newer;
+	return true;
+}
+
+long long CMumbleHistory::GetTime()
+{
+	return std::chrono::steady_clock::now().time_since_epoch() / std::chrono::microseconds(1);
+}
@@ -0,0 +1,105 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  History.h
+/// Description  :  Keeps a history of timestamped MumbleLink samples for interpolation.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef MUMBLE_HISTORY_H
+#define MUMBLE_HISTORY_H
+
+#include "Services/Mumble/Definitions/Mumble.h"
+
+constexpr const unsigned MH_SAMPLES					= 64;		/* power of two, about one second of gameplay */
+constexpr const long long MH_MAX_EXTRAPOLATION		= 100000;	/* us, a stalled game must not drift overlays away */
+constexpr const float MH_TELEPORT_DISTANCE			= 25.0f;	/* m, movement between two samples that is not interpolated */
+
+static_assert((MH_SAMPLES & (MH_SAMPLES - 1)) == 0, "The sample count has to be a power of two.");
+
+///----------------------------------------------------------------------------------------------------
+/// MumbleSample Struct
+/// 	Time is in microseconds of the steady clock (QueryPerformanceCounter).
+///----------------------------------------------------------------------------------------------------
+struct MumbleSample
+{
+	long long			Time;
+	unsigned			UITick;
+	Vector3				AvatarPosition;
+	Vector3				CameraPosition;
+	Vector3				CameraFront;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// MumbleHistorySlot Struct
+///----------------------------------------------------------------------------------------------------
+struct MumbleHistorySlot
+{
+	unsigned			Version;	/* seqlock, see SeqLock.h */
+	unsigned long long	Index;		/* the slot was overwritten if it does not match the expected index */
+	MumbleSample		Sample;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// MumbleHistory Struct
+/// 	Shared as DL_MUMBLE_HISTORY. Written by the render thread once per frame.
+/// 	Overlays should interpolate to FrameTime - Interval, so there are samples on both sides.
+///----------------------------------------------------------------------------------------------------
+struct MumbleHistory
+{
+	unsigned long long	Count;		/* samples ever pushed, the newest is in Slots[(Count - 1) % MH_SAMPLES] */
+	long long			FrameTime;	/* time of the current frame */
+	long long			Interval;	/* average time between two samples */
+	MumbleHistorySlot	Slots[MH_SAMPLES];
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CMumbleHistory Class
+/// 	Single writer, any amount of readers. Readers never block the writer.
+///----------------------------------------------------------------------------------------------------
+class CMumbleHistory
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CMumbleHistory(Mumble::Data* aMumbleLink, MumbleHistory* aHistory);
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CMumbleHistory() = default;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Sample:
+	/// 	Sets the frame time and pushes a sample if the game updated the MumbleLink.
+	/// 	Has to be called once per frame from the same thread. Returns true and the sample if one was pushed.
+	///----------------------------------------------------------------------------------------------------
+	bool Sample(long long aFrameTime, MumbleSample* aOutSample = nullptr);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Push:
+	/// 	Pushes a sample, overwriting the oldest one.
+	///----------------------------------------------------------------------------------------------------
+	void Push(const MumbleSample& aSample);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Interpolate:
+	/// 	Interpolates the history to the provided time. Extrapolates up to MH_MAX_EXTRAPOLATION past the
+	/// 	newest sample and clamps to the oldest sample. Returns false if there are no samples.
+	///----------------------------------------------------------------------------------------------------
+	static bool Interpolate(const MumbleHistory* aHistory, long long aTime, MumbleSample* aOutSample);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTime:
+	/// 	Returns the current time in the unit of the samples.
+	///----------------------------------------------------------------------------------------------------
+	static long long GetTime();
+
+private:
+	Mumble::Data*		MumbleLink;
+	MumbleHistory*		History;
+
+	unsigned			PreviousTick	= 0;
+};
+
+#endif
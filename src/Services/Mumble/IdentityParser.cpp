@@ -0,0 +1,435 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  IdentityParser.cpp
+/// Description  :  Parses the MumbleLink identity without allocating.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Services/Mumble/IdentityParser.h"
+
+#include <cstring>
+#include <cwchar>
+
+namespace Mumble
+{
+	namespace
+	{
+		constexpr unsigned MAX_DEPTH = 8; /* nesting of skipped values, the identity is flat */
+
+		///----------------------------------------------------------------------------------------------------
+		/// Cursor Struct
+		///----------------------------------------------------------------------------------------------------
+		struct Cursor
+		{
+			const wchar_t*	It;
+			const wchar_t*	End;
+		};
+
+		void SkipWhitespace(Cursor& aCursor)
+		{
+			while (aCursor.It < aCursor.End && (*aCursor.It == L' ' || *aCursor.It == L'\t' || *aCursor.It == L'\n' || *aCursor.It == L'\r'))
+			{
+				aCursor.It++;
+			}
+		}
+
+		bool Consume(Cursor& aCursor, wchar_t aChar)
+		{
+			SkipWhitespace(aCursor);
+
+			if (aCursor.It >= aCursor.End || *aCursor.It != aChar) { return false; }
+
+			aCursor.It++;
+			return true;
+		}
+
+		bool ParseHex4(Cursor& aCursor, unsigned* aOutValue)
+		{
+			if (aCursor.End - aCursor.It < 4) { return false; }
+
+			unsigned value = 0;
+
+			for (int i = 0; i < 4; i++, aCursor.It++)
+			{
+				wchar_t c = *aCursor.It;
+				value <<= 4;
+
+				if		(c >= L'0' && c <= L'9') { value |= c - L'0'; }
+				else if (c >= L'a' && c <= L'f') { value |= c - L'a' + 10; }
+				else if (c >= L'A' && c <= L'F') { value |= c - L'A' + 10; }
+				else { return false; }
+			}
+
+			*aOutValue = value;
+			return true;
+		}
+
+		///----------------------------------------------------------------------------------------------------
+		/// ParseString:
+		/// 	Parses a string as UTF-8 into aOut, if provided. aOutTruncated is set if it did not fit.
+		///----------------------------------------------------------------------------------------------------
+		bool ParseString(Cursor& aCursor, char* aOut, size_t aOutSize, bool* aOutTruncated)
+		{
+			if (!Consume(aCursor, L'"')) { return false; }
+
+			size_t length = 0;
+			bool isTruncated = false;
+
+			while (true)
+			{
+				if (aCursor.It >= aCursor.End) { return false; }
+
+				unsigned codepoint = static_cast<unsigned>(*aCursor.It++);
+
+				if (codepoint == L'"') { break; }
+				if (codepoint < 0x20) { return false; }
+
+				if (codepoint == L'\\')
+				{
+					if (aCursor.It >= aCursor.End) { return false; }
+
+					switch (*aCursor.It++)
+					{
+					case L'"':	codepoint = '"';	break;
+					case L'\\':	codepoint = '\\';	break;
+					case L'/':	codepoint = '/';	break;
+					case L'b':	codepoint = '\b';	break;
+					case L'f':	codepoint = '\f';	break;
+					case L'n':	codepoint = '\n';	break;
+					case L'r':	codepoint = '\r';	break;
+					case L't':	codepoint = '\t';	break;
+					case L'u':
+						if (!ParseHex4(aCursor, &codepoint)) { return false; }
+						break;
+					default:
+						return false;
+					}
+
+					/* escaped surrogate pair */
+					if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+					{
+						unsigned low = 0;
+
+						if (aCursor.End - aCursor.It < 2 || aCursor.It[0] != L'\\' || aCursor.It[1] != L'u') { return false; }
+						aCursor.It += 2;
+						if (!ParseHex4(aCursor, &low) || low < 0xDC00 || low > 0xDFFF) { return false; }
+
+						codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+					{
+						return false;
+					}
+				}
+				else if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+				{
+					/* raw UTF-16 surrogate pair */
+					if (aCursor.It >= aCursor.End) { return false; }
+
+					unsigned low = static_cast<unsigned>(*aCursor.It++);
+					if (low < 0xDC00 || low > 0xDFFF) { return false; }
+
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				else if ((codepoint >= 0xDC00 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+				{
+					return false;
+				}
+
+				if (!aOut || isTruncated) { continue; }
+
+				char utf8[4];
+				size_t size = 0;
+
+				if (codepoint < 0x80)
+				{
+					utf8[size++] = static_cast<char>(codepoint);
+				}
+				else if (codepoint < 0x800)
+				{
+					utf8[size++] = static_cast<char>(0xC0 | (codepoint >> 6));
+					utf8[size++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+				}
+				else if (codepoint < 0x10000)
+				{
+					utf8[size++] = static_cast<char>(0xE0 | (codepoint >> 12));
+					utf8[size++] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+					utf8[size++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+				}
+				else
+				{
+					utf8[size++] = static_cast<char>(0xF0 | (codepoint >> 18));
+					utf8[size++] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+					utf8[size++] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+					utf8[size++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+				}
+
+				/* keep room for the terminator */
+				if (length + size >= aOutSize)
+				{
+					isTruncated = true;
+					continue;
+				}
+
+				memcpy(aOut + length, utf8, size);
+				length += size;
+			}
+
+			if (aOut) { aOut[length] = 0; }
+			if (aOutTruncated) { *aOutTruncated = isTruncated; }
+
+			return true;
+		}
+
+		///----------------------------------------------------------------------------------------------------
+		/// ParseNumber:
+		/// 	Parses a JSON number. Integers are exact up to 2^53, like the double they are stored in.
+		///----------------------------------------------------------------------------------------------------
+		bool ParseNumber(Cursor& aCursor, double* aOutValue)
+		{
+			SkipWhitespace(aCursor);
+
+			bool isNegative = false;
+			unsigned long long mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+
+			if (aCursor.It < aCursor.End && *aCursor.It == L'-')
+			{
+				isNegative = true;
+				aCursor.It++;
+			}
+
+			if (aCursor.It >= aCursor.End || *aCursor.It < L'0' || *aCursor.It > L'9') { return false; }
+
+			/* no leading zeros */
+			if (*aCursor.It == L'0' && aCursor.It + 1 < aCursor.End && aCursor.It[1] >= L'0' && aCursor.It[1] <= L'9') { return false; }
+
+			while (aCursor.It < aCursor.End && *aCursor.It >= L'0' && *aCursor.It <= L'9')
+			{
+				if (digits < 19) { mantissa = mantissa * 10 + (*aCursor.It - L'0'); digits++; }
+				else { exponent++; }
+				aCursor.It++;
+			}
+
+			if (aCursor.It < aCursor.End && *aCursor.It == L'.')
+			{
+				aCursor.It++;
+
+				if (aCursor.It >= aCursor.End || *aCursor.It < L'0' || *aCursor.It > L'9') { return false; }
+
+				while (aCursor.It < aCursor.End && *aCursor.It >= L'0' && *aCursor.It <= L'9')
+				{
+					if (digits < 19) { mantissa = mantissa * 10 + (*aCursor.It - L'0'); digits++; exponent--; }
+					aCursor.It++;
+				}
+			}
+
+			if (aCursor.It < aCursor.End && (*aCursor.It == L'e' || *aCursor.It == L'E'))
+			{
+				aCursor.It++;
+
+				bool isExponentNegative = false;
+				int value = 0;
+
+				if (aCursor.It < aCursor.End && (*aCursor.It == L'+' || *aCursor.It == L'-'))
+				{
+					isExponentNegative = *aCursor.It == L'-';
+					aCursor.It++;
+				}
+
+				if (aCursor.It >= aCursor.End || *aCursor.It < L'0' || *aCursor.It > L'9') { return false; }
+
+				while (aCursor.It < aCursor.End && *aCursor.It >= L'0' && *aCursor.It <= L'9')
+				{
+					if (value < 10000) { value = value * 10 + (*aCursor.It - L'0'); }
+					aCursor.It++;
+				}
+
+				exponent += isExponentNegative ? -value : value;
+			}
+
+			/* both operands are exact for the values in the identity, so the result is correctly rounded */
+			double value = static_cast<double>(mantissa);
+			double scale = 1.0;
+			for (int i = 0; i < (exponent < 0 ? -exponent : exponent) && i < 400; i++) { scale *= 10.0; }
+			value = exponent < 0 ? value / scale : value * scale;
+
+			*aOutValue = isNegative ? -value : value;
+			return true;
+		}
+
+		bool ParseLiteral(Cursor& aCursor, const wchar_t* aLiteral)
+		{
+			SkipWhitespace(aCursor);
+
+			size_t length = wcslen(aLiteral);
+
+			if (static_cast<size_t>(aCursor.End - aCursor.It) < length || wcsncmp(aCursor.It, aLiteral, length) != 0) { return false; }
+
+			aCursor.It += length;
+			return true;
+		}
+
+		bool ParseBool(Cursor& aCursor, bool* aOutValue)
+		{
+			if (ParseLiteral(aCursor, L"true"))		{ *aOutValue = true;	return true; }
+			if (ParseLiteral(aCursor, L"false"))	{ *aOutValue = false;	return true; }
+
+			return false;
+		}
+
+		bool ParseUnsigned(Cursor& aCursor, unsigned* aOutValue)
+		{
+			double value;
+
+			if (!ParseNumber(aCursor, &value)) { return false; }
+
+			*aOutValue = static_cast<unsigned>(static_cast<long long>(value));
+			return true;
+		}
+
+		///----------------------------------------------------------------------------------------------------
+		/// SkipValue:
+		/// 	Skips over any value, for keys that are not part of the identity.
+		///----------------------------------------------------------------------------------------------------
+		bool SkipValue(Cursor& aCursor, unsigned aDepth)
+		{
+			if (aDepth > MAX_DEPTH) { return false; }
+
+			SkipWhitespace(aCursor);
+
+			if (aCursor.It >= aCursor.End) { return false; }
+
+			double number;
+
+			switch (*aCursor.It)
+			{
+			case L'"':
+				return ParseString(aCursor, nullptr, 0, nullptr);
+			case L't':
+				return ParseLiteral(aCursor, L"true");
+			case L'f':
+				return ParseLiteral(aCursor, L"false");
+			case L'n':
+				return ParseLiteral(aCursor, L"null");
+			case L'{':
+				aCursor.It++;
+				if (Consume(aCursor, L'}')) { return true; }
+				do
+				{
+					if (!ParseString(aCursor, nullptr, 0, nullptr) || !Consume(aCursor, L':') || !SkipValue(aCursor, aDepth + 1)) { return false; }
+				} while (Consume(aCursor, L','));
+				return Consume(aCursor, L'}');
+			case L'[':
+				aCursor.It++;
+				if (Consume(aCursor, L']')) { return true; }
+				do
+				{
+					if (!SkipValue(aCursor, aDepth + 1)) { return false; }
+				} while (Consume(aCursor, L','));
+				return Consume(aCursor, L']');
+			default:
+				return ParseNumber(aCursor, &number);
+			}
+		}
+	}
+
+	bool ParseIdentity(const wchar_t* aIdentity, size_t aLength, Identity* aOutIdentity)
+	{
+		if (!aIdentity || !aOutIdentity) { return false; }
+
+		/* the buffer is not necessarily terminated */
+		size_t length = 0;
+		while (length < aLength && aIdentity[length]) { length++; }
+
+		Cursor cursor{ aIdentity, aIdentity + length };
+
+		if (!Consume(cursor, L'{')) { return false; }
+
+		if (!Consume(cursor, L'}'))
+		{
+			do
+			{
+				char key[16];
+				bool isTruncated = false;
+
+				if (!ParseString(cursor, key, sizeof(key), &isTruncated) || !Consume(cursor, L':')) { return false; }
+
+				/* a truncated key would match a known prefix */
+				if (isTruncated)
+				{
+					if (!SkipValue(cursor, 0)) { return false; }
+					continue;
+				}
+
+				bool isValid = true;
+				unsigned value = 0;
+
+				if (strcmp(key, "name") == 0)
+				{
+					isValid = ParseString(cursor, aOutIdentity->Name, sizeof(aOutIdentity->Name), nullptr);
+				}
+				else if (strcmp(key, "profession") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->Profession = static_cast<decltype(aOutIdentity->Profession)>(value);
+				}
+				else if (strcmp(key, "spec") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->Specialization = static_cast<decltype(aOutIdentity->Specialization)>(value);
+				}
+				else if (strcmp(key, "race") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->Race = static_cast<decltype(aOutIdentity->Race)>(value);
+				}
+				else if (strcmp(key, "map_id") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->MapID = static_cast<decltype(aOutIdentity->MapID)>(value);
+				}
+				else if (strcmp(key, "world_id") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->WorldID = static_cast<decltype(aOutIdentity->WorldID)>(value);
+				}
+				else if (strcmp(key, "team_color_id") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->TeamColorID = static_cast<decltype(aOutIdentity->TeamColorID)>(value);
+				}
+				else if (strcmp(key, "commander") == 0)
+				{
+					isValid = ParseBool(cursor, &aOutIdentity->IsCommander);
+				}
+				else if (strcmp(key, "fov") == 0)
+				{
+					double fov = 0;
+					isValid = ParseNumber(cursor, &fov);
+					aOutIdentity->FOV = static_cast<float>(fov);
+				}
+				else if (strcmp(key, "uisz") == 0)
+				{
+					isValid = ParseUnsigned(cursor, &value);
+					aOutIdentity->UISize = static_cast<decltype(aOutIdentity->UISize)>(value);
+				}
+				else
+				{
+					isValid = SkipValue(cursor, 0);
+				}
+
+				if (!isValid) { return false; }
+			} while (Consume(cursor, L','));
+
+			if (!Consume(cursor, L'}')) { return false; }
+		}
+
+		/* nothing but whitespace may follow */
+		SkipWhitespace(cursor);
+
+		return cursor.It == cursor.End;
+	}
+}
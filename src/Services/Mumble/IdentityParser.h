@@ -0,0 +1,31 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  IdentityParser.h
+/// Description  :  Parses the MumbleLink identity without allocating.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef MUMBLE_IDENTITYPARSER_H
+#define MUMBLE_IDENTITYPARSER_H
+
+#include <cstddef>
+
+#include "Services/Mumble/Definitions/Mumble.h"
+
+///----------------------------------------------------------------------------------------------------
+/// Mumble Namespace
+///----------------------------------------------------------------------------------------------------
+namespace Mumble
+{
+	///----------------------------------------------------------------------------------------------------
+	/// ParseIdentity:
+	/// 	Parses the identity JSON object of at most aLength characters into aOutIdentity.
+	/// 	Unknown keys are skipped, known keys that are missing keep their previous value.
+	/// 	The name is UTF-8 and truncated to fit, without splitting a character.
+	/// 	Returns false if the JSON is malformed, aOutIdentity might be partially written.
+	///----------------------------------------------------------------------------------------------------
+	bool ParseIdentity(const wchar_t* aIdentity, size_t aLength, Identity* aOutIdentity);
+}
+
+#endif
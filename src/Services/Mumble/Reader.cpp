@@ -8,6 +8,10 @@
 
 #include "Services/Mumble/Reader.h"
 
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+
 #include "Consts.h"
 #include "Shared.h" /* FIXME: This is included at the moment because the LogHandler isn't dependency-injected. Fix before 2024/06/30. */
 #include "Renderer.h"
@@ -15,9 +19,7 @@
 
 #include "Events/EventHandler.h"
 #include "Services/DataLink/DataLink.h"
-
-#include "nlohmann/json.hpp"
-using json = nlohmann::json;
+#include "Services/Mumble/IdentityParser.h"
 
 using namespace Mumble;
 
@@ -98,7 +100,8 @@ CMumbleReader::CMumbleReader(std::string aMumbleName)
 
 	/* share the linked mem regardless whether it's disabled, for dependant addons */
 	MumbleLink = (Mumble::Data*)DataLinkService->ShareResource(DL_MUMBLE_LINK, sizeof(Mumble::Data), aMumbleName.c_str(), true);
-	Hooks::NexusLink = NexusLink = (NexusLinkData*)DataLinkService->ShareResource(DL_NEXUS_LINK, sizeof(NexusLinkData), true);
+	Hooks::NexusLink = NexusLink = (NexusLinkData*)DataLinkService->ShareVersionedResource(DL_NEXUS_LINK, sizeof(NexusLinkData), offsetof(NexusLinkData, Version), true);
+	MumbleHistory* history = (MumbleHistory*)DataLinkService->ShareResource(DL_MUMBLE_HISTORY, sizeof(MumbleHistory), true);
 
 	if (aMumbleName == "0")
 	{
@@ -106,6 +109,9 @@ CMumbleReader::CMumbleReader(std::string aMumbleName)
 	}
 	else
 	{
+		/* sampled by the render thread, in sync with the frames addons draw */
+		Hooks::MumbleHistory = this->History = new CMumbleHistory(MumbleLink, history);
+
 		this->IsRunning = true;
 		this->Thread = std::thread(&CMumbleReader::Advance, this);
 	}
@@ -113,76 +119,130 @@ CMumbleReader::CMumbleReader(std::string aMumbleName)
 
 CMumbleReader::~CMumbleReader()
 {
-	this->IsRunning = false;
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+		this->IsRunning = false;
+	}
+
+	this->ConVar.notify_all();
 
 	if (this->Thread.joinable())
 	{
 		this->Thread.join();
 	}
+
+	Hooks::MumbleHistory = nullptr;
+	delete this->History;
 }
 
 void CMumbleReader::Advance()
 {
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
 	while (this->IsRunning)
 	{
-		this->Flip = !this->Flip; // every other tick so it gets refreshed every 100ms
-		if (this->Flip)
+		lock.unlock();
+
+		/* a copy the game wrote into is dropped, the next tick reads again */
+		bool isConsistent = this->ReadSnapshot();
+
+		long long now = std::chrono::steady_clock::now().time_since_epoch() / std::chrono::milliseconds(1);
+
+		if (isConsistent && now - this->LastMovementCheck >= MR_MOVEMENT_INTERVAL)
 		{
-			this->NexusLink->IsGameplay = this->PreviousTick != this->MumbleLink->UITick ||
+			this->LastMovementCheck = now;
+
+			bool isGameplay = this->PreviousTick != this->Snapshot.UITick ||
 				(this->PreviousFrameCounter == Renderer::FrameCounter && this->NexusLink->IsGameplay);
-			this->NexusLink->IsMoving = this->PreviousAvatarPosition != this->MumbleLink->AvatarPosition;
-			this->NexusLink->IsCameraMoving = this->PreviousCameraFront != this->MumbleLink->CameraFront;
+			bool isMoving = this->PreviousAvatarPosition != this->Snapshot.AvatarPosition;
+			bool isCameraMoving = this->PreviousCameraFront != this->Snapshot.CameraFront;
+
+			/* only advance the version if something changed, so addons can skip their work */
+			if (this->NexusLink->IsGameplay != isGameplay ||
+				this->NexusLink->IsMoving != isMoving ||
+				this->NexusLink->IsCameraMoving != isCameraMoving)
+			{
+				SeqLock::BeginWrite(&this->NexusLink->Version);
+				this->NexusLink->IsGameplay = isGameplay;
+				this->NexusLink->IsMoving = isMoving;
+				this->NexusLink->IsCameraMoving = isCameraMoving;
+				SeqLock::EndWrite(&this->NexusLink->Version);
+			}
 
 			this->PreviousFrameCounter = Renderer::FrameCounter;
-			this->PreviousTick = this->MumbleLink->UITick;
-			this->PreviousAvatarPosition = this->MumbleLink->AvatarPosition;
-			this->PreviousCameraFront = this->MumbleLink->CameraFront;
+			this->PreviousTick = this->Snapshot.UITick;
+			this->PreviousAvatarPosition = this->Snapshot.AvatarPosition;
+			this->PreviousCameraFront = this->Snapshot.CameraFront;
 		}
 
-		if (this->MumbleLink->Identity[0])
+		/* the identity rarely changes, only parse it if the raw string did */
+		if (isConsistent && this->Snapshot.Identity[0] && wcscmp(this->Snapshot.Identity, this->PreviousIdentity) != 0)
 		{
-			/* cache identity */
-			this->PreviousIdentity = *IdentityParsed;
+			memcpy(this->PreviousIdentity, this->Snapshot.Identity, sizeof(this->PreviousIdentity));
 
-			try
-			{
-				/* parse and assign current identity */
-				json j = json::parse(MumbleLink->Identity);
-				strcpy(IdentityParsed->Name, j["name"].get<std::string>().c_str());
-				j["profession"].get_to(IdentityParsed->Profession);
-				j["spec"].get_to(IdentityParsed->Specialization);
-				j["race"].get_to(IdentityParsed->Race);
-				j["map_id"].get_to(IdentityParsed->MapID);
-				j["world_id"].get_to(IdentityParsed->WorldID);
-				j["team_color_id"].get_to(IdentityParsed->TeamColorID);
-				j["commander"].get_to(IdentityParsed->IsCommander);
-				j["fov"].get_to(IdentityParsed->FOV);
-				j["uisz"].get_to(IdentityParsed->UISize);
-			}
-			catch (json::parse_error& ex)
-			{
-				Logger->Trace(CH_MUMBLE_READER, "MumbleLink could not be parsed. Parse Error: %s", ex.what());
-			}
-			catch (json::type_error& ex)
+			Identity identity = *IdentityParsed;
+
+			if (!Mumble::ParseIdentity(this->Snapshot.Identity, sizeof(this->Snapshot.Identity) / sizeof(this->Snapshot.Identity[0]), &identity))
 			{
-				Logger->Trace(CH_MUMBLE_READER, "MumbleLink could not be parsed. Type Error: %s", ex.what());
+				Logger->Trace(CH_MUMBLE_READER, "MumbleLink could not be parsed.");
 			}
-			catch (...)
+			else if (identity != *IdentityParsed)
 			{
-				Logger->Trace(CH_MUMBLE_READER, "MumbleLink could not be parsed. Unknown Error.");
-			}
+				*IdentityParsed = identity;
 
-			/* notify (also notifies the GUI to update its scaling factor) */
-			if (*IdentityParsed != this->PreviousIdentity)
-			{
+				/* notify (also notifies the GUI to update its scaling factor) */
 				EventApi->Raise("EV_MUMBLE_IDENTITY_UPDATED", IdentityParsed);
 			}
 		}
-		for (size_t i = 0; i < 50; i++)
-		{
-			if (!this->IsRunning) { return; } // abort if shutdown during sleep
 
-			Sleep(1);
+		lock.lock();
+
+		/* abort if shutdown during sleep */
+		this->ConVar.wait_for(lock, std::chrono::milliseconds(this->GetTickRate()), [this] { return !this->IsRunning; });
+	}
+}
+
+bool CMumbleReader::ReadSnapshot()
+{
+	/* the game writes the link without a version, the tick alone does not show a copy overlapping an update:
+	 * copy twice, an update in between or during either copy leaves the copies or the tick different */
+	for (size_t i = 0; i < 3; i++)
+	{
+		unsigned tick = this->MumbleLink->UITick;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		memcpy(&this->Snapshot, this->MumbleLink, sizeof(Mumble::Data));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		memcpy(&this->SnapshotCheck, this->MumbleLink, sizeof(Mumble::Data));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (this->MumbleLink->UITick == tick && this->Snapshot.UITick == tick &&
+			memcmp(&this->Snapshot, &this->SnapshotCheck, sizeof(Mumble::Data)) == 0)
+		{
+			/* the identity is parsed as a string, never run past the buffer */
+			this->Snapshot.Identity[(sizeof(this->Snapshot.Identity) / sizeof(this->Snapshot.Identity[0])) - 1] = 0;
+			return true;
 		}
 	}
+
+	return false;
+}
+
+unsigned CMumbleReader::GetTickRate() const
+{
+	if (Renderer::WindowHandle && IsIconic(Renderer::WindowHandle))
+	{
+		return MR_TICK_MINIMIZED;
+	}
+
+	if (!this->NexusLink->IsGameplay)
+	{
+		return MR_TICK_MENU;
+	}
+
+	return MR_TICK_GAMEPLAY;
 }
@@ -9,10 +9,13 @@
 #ifndef MUMBLE_READER_H
 #define MUMBLE_READER_H
 
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <string>
 
 #include "Services/Mumble/Definitions/Mumble.h"
+#include "Services/Mumble/History.h"
 #include "Loader/NexusLinkData.h"
 
 /* Log Channel*/
@@ -24,6 +27,12 @@ constexpr const float SC_NORMAL						= 1.00f;
 constexpr const float SC_LARGE						= 1.11f;
 constexpr const float SC_LARGER						= 1.22f;
 
+/* Tick Rate (ms) */
+constexpr const unsigned MR_TICK_GAMEPLAY			= 20;
+constexpr const unsigned MR_TICK_MENU				= 250;
+constexpr const unsigned MR_TICK_MINIMIZED			= 1000;
+constexpr const unsigned MR_MOVEMENT_INTERVAL		= 100;	/* the game might not update the link between two faster ticks */
+
 ///----------------------------------------------------------------------------------------------------
 /// Mumble Namespace
 ///----------------------------------------------------------------------------------------------------
@@ -57,17 +66,22 @@ public:
 	~CMumbleReader();
 private:
 	std::thread			Thread;
+	std::mutex			Mutex;
+	std::condition_variable	ConVar;
 	bool				IsRunning				= false;
 
 	std::string			Name;
 	Mumble::Data*		MumbleLink				= nullptr;
 	NexusLinkData*		NexusLink				= nullptr;
+	CMumbleHistory*		History					= nullptr;
+	Mumble::Data		Snapshot				= {};
+	Mumble::Data		SnapshotCheck			= {};	/* second copy, compared against the Snapshot */
 
-	bool				Flip					= false;
+	long long			LastMovementCheck		= 0;
 	unsigned			PreviousTick			= 0;
 	Vector3				PreviousAvatarPosition	= {};
 	Vector3				PreviousCameraFront		= {};
-	Mumble::Identity	PreviousIdentity		= Mumble::Identity{};
+	decltype(Mumble::Data::Identity) PreviousIdentity = {};	/* raw, parsing is skipped if unchanged */
 	long long			PreviousFrameCounter	= 0;
 
 	///----------------------------------------------------------------------------------------------------
@@ -75,6 +89,19 @@ private:
 	/// 	Reader loop function.
 	///----------------------------------------------------------------------------------------------------
 	void Advance();
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReadSnapshot:
+	/// 	Copies the MumbleLink into the Snapshot. Returns false if the game kept writing during the copy,
+	/// 	detected by a changed tick or by a second copy that differs.
+	///----------------------------------------------------------------------------------------------------
+	bool ReadSnapshot();
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTickRate:
+	/// 	Returns the milliseconds until the next tick: fast in gameplay, slow in menus or minimized.
+	///----------------------------------------------------------------------------------------------------
+	unsigned GetTickRate() const;
 };
 
 #endif
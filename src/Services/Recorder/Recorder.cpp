@@ -0,0 +1,177 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Recorder.cpp
+/// Description  :  Records combat events and MumbleLink samples for replaying them offline.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Recorder.h"
+
+#include "Consts.h"
+#include "Shared.h"
+
+#include "Util/Paths.h"
+#include "Util/Time.h"
+
+CCombatRecorder::~CCombatRecorder()
+{
+	this->Stop();
+}
+
+bool CCombatRecorder::Start(const std::filesystem::path& aPath)
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	if (this->Encoder) { return false; }
+
+	Path::CreateDir(aPath.parent_path());
+
+	this->File.open(aPath, std::ios::binary | std::ios::trunc);
+
+	if (!this->File.is_open() || !Recording::WriteHeader(this->File, Time::GetTimestamp()))
+	{
+		this->File.close();
+		Logger->Warning(CH_CORE, "Could not create recording \"%s\".", aPath.string().c_str());
+		return false;
+	}
+
+	this->Encoder = new CRecordingEncoder();
+	this->Path = aPath;
+	this->StartTime = this->LastTime = CMumbleHistory::GetTime();
+	this->Events = 0;
+	this->Frames = 0;
+	this->RawBytes = 0;
+	this->WrittenBytes = sizeof(RecordingHeader);
+	this->IsStopping = false;
+
+	this->Thread = std::thread(&CCombatRecorder::ProcessQueue, this);
+
+	this->Active = true;
+
+	Logger->Info(CH_CORE, "Recording to \"%s\".", aPath.string().c_str());
+
+	return true;
+}
+
+void CCombatRecorder::Stop()
+{
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		if (!this->Encoder) { return; }
+
+		this->Active = false;
+
+		this->Enqueue();
+		this->IsStopping = true;
+
+		delete this->Encoder;
+		this->Encoder = nullptr;
+	}
+
+	this->ConVar.notify_one();
+	this->Thread.join();
+
+	this->File.close();
+
+	RecorderStats stats = this->GetStats();
+	Logger->Info(CH_CORE, "Recorded %llu events and %llu frames to \"%s\" (%llu bytes).", stats.Events, stats.Frames, stats.Path.string().c_str(), stats.WrittenBytes);
+}
+
+bool CCombatRecorder::IsRecording() const
+{
+	return this->Active;
+}
+
+void CCombatRecorder::RecordCombat(ECombatStream aStream, const EvCombatData* aCombatData)
+{
+	if (!this->Active.load(std::memory_order_relaxed)) { return; }
+
+	long long time = CMumbleHistory::GetTime();
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	/* stopped in the meantime */
+	if (!this->Encoder) { return; }
+
+	this->Encoder->Combat(time - this->StartTime, aStream, aCombatData);
+	this->Events++;
+	this->LastTime = time;
+
+	if (this->Encoder->IsFull())
+	{
+		this->Enqueue();
+	}
+}
+
+void CCombatRecorder::RecordFrame(long long aFrameTime, const MumbleSample* aSample)
+{
+	if (!this->Active.load(std::memory_order_relaxed)) { return; }
+
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	if (!this->Encoder) { return; }
+
+	this->Encoder->Frame(aFrameTime - this->StartTime, aSample);
+	this->Frames++;
+	this->LastTime = aFrameTime;
+
+	if (this->Encoder->IsFull())
+	{
+		this->Enqueue();
+	}
+}
+
+RecorderStats CCombatRecorder::GetStats() const
+{
+	const std::lock_guard<std::mutex> lock(this->Mutex);
+
+	RecorderStats stats{};
+	stats.IsRecording = this->Encoder != nullptr;
+	stats.Path = this->Path;
+	stats.Duration = this->LastTime - this->StartTime;
+	stats.Events = this->Events;
+	stats.Frames = this->Frames;
+	stats.RawBytes = this->RawBytes;
+	stats.WrittenBytes = this->WrittenBytes;
+
+	return stats;
+}
+
+void CCombatRecorder::Enqueue()
+{
+	this->Queue.emplace_back();
+	this->Encoder->TakeBlock(this->Queue.back());
+
+	this->RawBytes += this->Queue.back().Data.size();
+
+	this->ConVar.notify_one();
+}
+
+void CCombatRecorder::ProcessQueue()
+{
+	std::unique_lock<std::mutex> lock(this->Mutex);
+
+	for (;;)
+	{
+		this->ConVar.wait(lock, [this] { return !this->Queue.empty() || this->IsStopping; });
+
+		if (this->Queue.empty()) { break; }
+
+		RecordingBlock block = std::move(this->Queue.front());
+		this->Queue.pop_front();
+
+		/* compressing takes a while, the game threads keep recording meanwhile */
+		lock.unlock();
+		size_t written = Recording::WriteBlock(this->File, block);
+		lock.lock();
+
+		if (written == 0 && !block.Data.empty())
+		{
+			Logger->Warning(CH_CORE, "Could not write to recording \"%s\".", this->Path.string().c_str());
+		}
+
+		this->WrittenBytes += written;
+	}
+}
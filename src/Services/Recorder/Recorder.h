@@ -0,0 +1,125 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Recorder.h
+/// Description  :  Records combat events and MumbleLink samples for replaying them offline.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Recording.h"
+
+///----------------------------------------------------------------------------------------------------
+/// RecorderStats Struct
+///----------------------------------------------------------------------------------------------------
+struct RecorderStats
+{
+	bool					IsRecording;
+	std::filesystem::path	Path;
+	long long				Duration;		/* microseconds */
+	unsigned long long		Events;
+	unsigned long long		Frames;
+	unsigned long long		RawBytes;
+	unsigned long long		WrittenBytes;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CCombatRecorder Class
+/// 	Tees the combat events raised by the ArcDPS bridge and the frames into a recording.
+/// 	Records are encoded under a lock, full blocks are compressed and written on a separate thread.
+///----------------------------------------------------------------------------------------------------
+class CCombatRecorder
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CCombatRecorder() = default;
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CCombatRecorder();
+
+	CCombatRecorder(const CCombatRecorder&) = delete;
+	CCombatRecorder& operator=(const CCombatRecorder&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Start:
+	/// 	Starts recording into the file. Returns false if already recording or the file can't be created.
+	///----------------------------------------------------------------------------------------------------
+	bool Start(const std::filesystem::path& aPath);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Stop:
+	/// 	Writes the remaining records and closes the file.
+	///----------------------------------------------------------------------------------------------------
+	void Stop();
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsRecording:
+	/// 	Returns true if recording.
+	///----------------------------------------------------------------------------------------------------
+	bool IsRecording() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// RecordCombat:
+	/// 	Records a combat event. Called by CEventApi::Raise.
+	///----------------------------------------------------------------------------------------------------
+	void RecordCombat(ECombatStream aStream, const EvCombatData* aCombatData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// RecordFrame:
+	/// 	Records a frame, aSample is nullptr if the MumbleLink was not updated. Called once per frame.
+	///----------------------------------------------------------------------------------------------------
+	void RecordFrame(long long aFrameTime, const MumbleSample* aSample);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetStats:
+	/// 	Returns the stats of the current or last recording.
+	///----------------------------------------------------------------------------------------------------
+	RecorderStats GetStats() const;
+
+private:
+	mutable std::mutex					Mutex;
+	std::condition_variable				ConVar;
+	std::thread							Thread;
+	std::atomic<bool>					Active{ false };
+
+	CRecordingEncoder*					Encoder			= nullptr;
+	std::deque<RecordingBlock>			Queue;
+	bool								IsStopping		= false;
+
+	std::ofstream						File;
+	std::filesystem::path				Path;
+	long long							StartTime		= 0;
+	long long							LastTime		= 0;
+
+	unsigned long long					Events			= 0;
+	unsigned long long					Frames			= 0;
+	unsigned long long					RawBytes		= 0;
+	std::atomic<unsigned long long>		WrittenBytes{ 0 };
+
+	///----------------------------------------------------------------------------------------------------
+	/// Enqueue:
+	/// 	Hands the current block to the writer thread. Mutex has to be held.
+	///----------------------------------------------------------------------------------------------------
+	void Enqueue();
+
+	///----------------------------------------------------------------------------------------------------
+	/// ProcessQueue:
+	/// 	Compresses and writes the queued blocks until stopped.
+	///----------------------------------------------------------------------------------------------------
+	void ProcessQueue();
+};
+
+#endif
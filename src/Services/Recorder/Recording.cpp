@@ -0,0 +1,414 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Recording.cpp
+/// Description  :  Encodes and decodes recordings of combat events and MumbleLink samples.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Recording.h"
+
+#include <cstring>
+
+#include "Util/Compression.h"
+
+namespace
+{
+	constexpr uint8_t HAS_EVENT			= 1 << 0;
+	constexpr uint8_t HAS_SOURCE		= 1 << 1;
+	constexpr uint8_t HAS_DESTINATION	= 1 << 2;
+	constexpr uint8_t HAS_SKILLNAME		= 1 << 3;
+
+	constexpr size_t MAX_BLOCK_SIZE		= RC_BLOCK_SIZE * 16; /* a record never exceeds a block by much, anything larger is corrupt */
+
+	uint64_t ZigZag(int64_t aValue)
+	{
+		return (static_cast<uint64_t>(aValue) << 1) ^ static_cast<uint64_t>(aValue >> 63);
+	}
+
+	int64_t UnZigZag(uint64_t aValue)
+	{
+		return static_cast<int64_t>(aValue >> 1) ^ -static_cast<int64_t>(aValue & 1);
+	}
+}
+
+namespace Recording
+{
+	bool WriteHeader(std::ostream& aStream, int64_t aTimestamp)
+	{
+		RecordingHeader header{};
+		memcpy(header.Magic, RC_MAGIC, sizeof(RC_MAGIC));
+		header.Version = RC_VERSION;
+		header.Timestamp = aTimestamp;
+
+		aStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		return aStream.good();
+	}
+
+	size_t WriteBlock(std::ostream& aStream, const RecordingBlock& aBlock)
+	{
+		if (aBlock.Data.empty()) { return 0; }
+
+		std::vector<unsigned char> compressed(Compression::GetBound(aBlock.Data.size()));
+		size_t compressedSize = Compression::Compress(aBlock.Data.data(), aBlock.Data.size(), compressed.data());
+
+		RecordingBlockHeader header{};
+		header.RawSize = static_cast<uint32_t>(aBlock.Data.size());
+		header.Records = aBlock.Records;
+		header.BaseTime = aBlock.BaseTime;
+
+		/* random data does not get smaller, store it as is */
+		const unsigned char* data = aBlock.Data.data();
+
+		if (compressedSize < aBlock.Data.size())
+		{
+			header.CompressedSize = static_cast<uint32_t>(compressedSize);
+			data = compressed.data();
+		}
+		else
+		{
+			header.CompressedSize = header.RawSize;
+		}
+
+		aStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		aStream.write(reinterpret_cast<const char*>(data), header.CompressedSize);
+
+		return aStream.good() ? sizeof(header) + header.CompressedSize : 0;
+	}
+}
+
+void CRecordingEncoder::Combat(long long aTime, ECombatStream aStream, const EvCombatData* aCombatData)
+{
+	if (!aCombatData) { return; }
+
+	/* defined before the record that refers to them */
+	uint32_t srcName = aCombatData->Source ? this->String(aCombatData->Source->Name) : 0;
+	uint32_t dstName = aCombatData->Destination ? this->String(aCombatData->Destination->Name) : 0;
+	uint32_t skillName = this->String(aCombatData->SkillName);
+
+	uint8_t flags = 0;
+	if (aCombatData->Event)			{ flags |= HAS_EVENT; }
+	if (aCombatData->Source)		{ flags |= HAS_SOURCE; }
+	if (aCombatData->Destination)	{ flags |= HAS_DESTINATION; }
+	if (aCombatData->SkillName)		{ flags |= HAS_SKILLNAME; }
+
+	this->Begin(ERecordType::Combat, aTime);
+	this->Block.Data.push_back(static_cast<uint8_t>(aStream));
+	this->Block.Data.push_back(flags);
+
+	if (aCombatData->Event)			{ this->Bytes(aCombatData->Event, sizeof(ArcDPS::CombatEvent)); }
+	if (aCombatData->Source)		{ this->Agent(aCombatData->Source, srcName); }
+	if (aCombatData->Destination)	{ this->Agent(aCombatData->Destination, dstName); }
+	if (aCombatData->SkillName)		{ this->Varint(skillName); }
+
+	this->Varint(aCombatData->ID);
+	this->Varint(aCombatData->Revision);
+}
+
+void CRecordingEncoder::Frame(long long aTime, const MumbleSample* aSample)
+{
+	this->Begin(ERecordType::Frame, aTime);
+	this->Block.Data.push_back(aSample ? 1 : 0);
+
+	if (aSample)
+	{
+		this->Varint(aSample->UITick);
+		this->Bytes(&aSample->AvatarPosition, sizeof(Vector3));
+		this->Bytes(&aSample->CameraPosition, sizeof(Vector3));
+		this->Bytes(&aSample->CameraFront, sizeof(Vector3));
+	}
+}
+
+bool CRecordingEncoder::IsFull() const
+{
+	return this->Block.Data.size() >= RC_BLOCK_SIZE;
+}
+
+void CRecordingEncoder::TakeBlock(RecordingBlock& aOutBlock)
+{
+	aOutBlock = std::move(this->Block);
+
+	this->Block = RecordingBlock{};
+	this->Block.BaseTime = this->PreviousTime;
+	this->Block.Data.reserve(RC_BLOCK_SIZE + 1024);
+}
+
+void CRecordingEncoder::Begin(ERecordType aType, long long aTime)
+{
+	this->Block.Data.push_back(static_cast<uint8_t>(aType));
+
+	/* signed, records of different threads are not strictly ordered */
+	this->Varint(ZigZag(aTime - this->PreviousTime));
+	this->PreviousTime = aTime;
+
+	this->Block.Records++;
+}
+
+uint32_t CRecordingEncoder::String(const char* aString)
+{
+	if (!aString) { return 0; }
+
+	auto it = this->Strings.find(aString);
+
+	if (it != this->Strings.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = static_cast<uint32_t>(this->Strings.size() + 1);
+	size_t length = strlen(aString);
+
+	this->Strings.emplace(aString, index);
+
+	this->Block.Data.push_back(static_cast<uint8_t>(ERecordType::String));
+	this->Varint(index);
+	this->Varint(length);
+	this->Bytes(aString, length);
+
+	this->Block.Records++;
+
+	return index;
+}
+
+void CRecordingEncoder::Agent(const ArcDPS::AgentShort* aAgent, uint32_t aNameIndex)
+{
+	this->Varint(aNameIndex);
+	this->Varint(aAgent->ID);
+	this->Varint(aAgent->Profession);
+	this->Varint(aAgent->Specialization);
+	this->Varint(aAgent->IsSelf);
+	this->Varint(aAgent->Team);
+}
+
+void CRecordingEncoder::Bytes(const void* aData, size_t aSize)
+{
+	const unsigned char* data = static_cast<const unsigned char*>(aData);
+	this->Block.Data.insert(this->Block.Data.end(), data, data + aSize);
+}
+
+void CRecordingEncoder::Varint(uint64_t aValue)
+{
+	while (aValue >= 0x80)
+	{
+		this->Block.Data.push_back(static_cast<uint8_t>(aValue) | 0x80);
+		aValue >>= 7;
+	}
+
+	this->Block.Data.push_back(static_cast<uint8_t>(aValue));
+}
+
+bool CRecordingReader::Open(const std::filesystem::path& aPath)
+{
+	this->File.open(aPath, std::ios::binary);
+
+	if (!this->File.is_open()) { return false; }
+
+	this->File.read(reinterpret_cast<char*>(&this->Header), sizeof(this->Header));
+
+	return this->File.good() &&
+		memcmp(this->Header.Magic, RC_MAGIC, sizeof(RC_MAGIC)) == 0 &&
+		this->Header.Version == RC_VERSION;
+}
+
+const RecordedEvent* CRecordingReader::Next()
+{
+	while (!this->Corrupt)
+	{
+		if (this->Remaining == 0)
+		{
+			if (!this->ReadBlock()) { return nullptr; }
+			continue;
+		}
+
+		this->Remaining--;
+
+		uint8_t type;
+		if (!this->Bytes(&type, sizeof(type))) { break; }
+
+		if (type == static_cast<uint8_t>(ERecordType::String))
+		{
+			uint64_t index, length;
+
+			/* defined in order, exactly once */
+			if (!this->Varint(index) || !this->Varint(length) || index != this->Strings.size() + 1 || length > this->Block.size() - this->Position) { break; }
+
+			this->Strings.emplace_back(reinterpret_cast<const char*>(&this->Block[this->Position]), static_cast<size_t>(length));
+			this->Position += static_cast<size_t>(length);
+			continue;
+		}
+
+		uint64_t delta;
+		if (!this->Varint(delta)) { break; }
+
+		RecordedEvent& ev = this->Current;
+		ev = RecordedEvent{};
+		ev.Type = static_cast<ERecordType>(type);
+		ev.Time = this->PreviousTime += UnZigZag(delta);
+
+		if (ev.Type == ERecordType::Combat)
+		{
+			uint8_t stream, flags;
+			uint64_t skillName = 0, id, revision;
+
+			if (!this->Bytes(&stream, sizeof(stream)) || !this->Bytes(&flags, sizeof(flags)) || stream >= static_cast<uint8_t>(ECombatStream::COUNT)) { break; }
+			if ((flags & HAS_EVENT) && !this->Bytes(&ev.Event, sizeof(ev.Event))) { break; }
+			if ((flags & HAS_SOURCE) && !this->Agent(&ev.Source)) { break; }
+			if ((flags & HAS_DESTINATION) && !this->Agent(&ev.Destination)) { break; }
+			if ((flags & HAS_SKILLNAME) && !this->Varint(skillName)) { break; }
+			if (!this->Varint(id) || !this->Varint(revision)) { break; }
+
+			ev.Stream = static_cast<ECombatStream>(stream);
+			ev.CombatData.Event = (flags & HAS_EVENT) ? &ev.Event : nullptr;
+			ev.CombatData.Source = (flags & HAS_SOURCE) ? &ev.Source : nullptr;
+			ev.CombatData.Destination = (flags & HAS_DESTINATION) ? &ev.Destination : nullptr;
+			ev.CombatData.SkillName = this->GetString(skillName);
+			ev.CombatData.ID = id;
+			ev.CombatData.Revision = revision;
+
+			if (this->Corrupt) { break; }
+
+			return &ev;
+		}
+
+		if (ev.Type == ERecordType::Frame)
+		{
+			uint8_t hasSample;
+
+			if (!this->Bytes(&hasSample, sizeof(hasSample))) { break; }
+
+			if (hasSample)
+			{
+				uint64_t tick;
+
+				if (!this->Varint(tick) ||
+					!this->Bytes(&ev.Sample.AvatarPosition, sizeof(Vector3)) ||
+					!this->Bytes(&ev.Sample.CameraPosition, sizeof(Vector3)) ||
+					!this->Bytes(&ev.Sample.CameraFront, sizeof(Vector3))) { break; }
+
+				ev.HasSample = true;
+				ev.Sample.Time = ev.Time;
+				ev.Sample.UITick = static_cast<unsigned>(tick);
+			}
+
+			return &ev;
+		}
+
+		/* unknown record type, the size is unknown as well */
+		break;
+	}
+
+	this->Corrupt = true;
+	return nullptr;
+}
+
+bool CRecordingReader::IsCorrupt() const
+{
+	return this->Corrupt;
+}
+
+int64_t CRecordingReader::GetTimestamp() const
+{
+	return this->Header.Timestamp;
+}
+
+bool CRecordingReader::ReadBlock()
+{
+	RecordingBlockHeader header;
+
+	this->File.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	/* a recording that was not stopped properly ends within a block */
+	if (this->File.gcount() != sizeof(header)) { return false; }
+
+	if (header.RawSize == 0 || header.RawSize > MAX_BLOCK_SIZE || header.CompressedSize > header.RawSize)
+	{
+		this->Corrupt = true;
+		return false;
+	}
+
+	this->Block.resize(header.RawSize);
+
+	if (header.CompressedSize == header.RawSize)
+	{
+		this->File.read(reinterpret_cast<char*>(this->Block.data()), header.RawSize);
+
+		if (this->File.gcount() != header.RawSize) { return false; }
+	}
+	else
+	{
+		this->Compressed.resize(header.CompressedSize);
+		this->File.read(reinterpret_cast<char*>(this->Compressed.data()), header.CompressedSize);
+
+		if (this->File.gcount() != header.CompressedSize) { return false; }
+
+		if (Compression::Decompress(this->Compressed.data(), header.CompressedSize, this->Block.data(), header.RawSize) != header.RawSize)
+		{
+			this->Corrupt = true;
+			return false;
+		}
+	}
+
+	this->Position = 0;
+	this->Remaining = header.Records;
+	this->PreviousTime = header.BaseTime;
+
+	return true;
+}
+
+char* CRecordingReader::GetString(uint64_t aIndex)
+{
+	if (aIndex == 0) { return nullptr; }
+
+	if (aIndex > this->Strings.size())
+	{
+		this->Corrupt = true;
+		return nullptr;
+	}
+
+	return &this->Strings[static_cast<size_t>(aIndex - 1)][0];
+}
+
+bool CRecordingReader::Agent(ArcDPS::AgentShort* aOutAgent)
+{
+	uint64_t name, id, profession, specialization, isSelf, team;
+
+	if (!this->Varint(name) || !this->Varint(id) || !this->Varint(profession) ||
+		!this->Varint(specialization) || !this->Varint(isSelf) || !this->Varint(team)) { return false; }
+
+	aOutAgent->Name = this->GetString(name);
+	aOutAgent->ID = static_cast<uintptr_t>(id);
+	aOutAgent->Profession = static_cast<uint32_t>(profession);
+	aOutAgent->Specialization = static_cast<uint32_t>(specialization);
+	aOutAgent->IsSelf = static_cast<uint32_t>(isSelf);
+	aOutAgent->Team = static_cast<uint16_t>(team);
+
+	return !this->Corrupt;
+}
+
+bool CRecordingReader::Bytes(void* aOut, size_t aSize)
+{
+	if (aSize > this->Block.size() - this->Position) { return false; }
+
+	memcpy(aOut, &this->Block[this->Position], aSize);
+	this->Position += aSize;
+
+	return true;
+}
+
+bool CRecordingReader::Varint(uint64_t& aOutValue)
+{
+	aOutValue = 0;
+
+	for (unsigned shift = 0; shift < 64; shift += 7)
+	{
+		if (this->Position >= this->Block.size()) { return false; }
+
+		uint8_t byte = this->Block[this->Position++];
+		aOutValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+		if (!(byte & 0x80)) { return true; }
+	}
+
+	return false;
+}
@@ -0,0 +1,222 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Recording.h
+/// Description  :  Encodes and decodes recordings of combat events and MumbleLink samples.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Events/CombatBatch.h"
+#include "Events/CombatBatchApi.h"
+#include "Services/Mumble/History.h"
+
+/* Platform independent, the replay tool reads recordings on Linux. */
+
+constexpr const char RC_MAGIC[4]			= { 'N', 'X', 'R', 'C' };
+constexpr const uint32_t RC_VERSION			= 1;
+constexpr const size_t RC_BLOCK_SIZE		= 65536; /* uncompressed bytes per block */
+
+///----------------------------------------------------------------------------------------------------
+/// ERecordType Enum
+///----------------------------------------------------------------------------------------------------
+enum class ERecordType : uint8_t
+{
+	None,
+	String,		/* defines a string once, combat records refer to it by index */
+	Combat,		/* a combat event as raised by the ArcDPS bridge */
+	Frame		/* a rendered frame, with the MumbleLink sample if the game updated it */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// RecordingHeader Struct
+///----------------------------------------------------------------------------------------------------
+struct RecordingHeader
+{
+	char				Magic[4];
+	uint32_t			Version;
+	int64_t				Timestamp;		/* unix time of the start */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// RecordingBlockHeader Struct
+/// 	Followed by CompressedSize bytes. The block is stored as is if CompressedSize equals RawSize.
+///----------------------------------------------------------------------------------------------------
+struct RecordingBlockHeader
+{
+	uint32_t			RawSize;
+	uint32_t			CompressedSize;
+	uint32_t			Records;
+	uint32_t			Reserved;
+	int64_t				BaseTime;		/* the records store the difference to the previous one */
+};
+
+///----------------------------------------------------------------------------------------------------
+/// RecordingBlock Struct
+///----------------------------------------------------------------------------------------------------
+struct RecordingBlock
+{
+	int64_t						BaseTime;
+	uint32_t					Records;
+	std::vector<unsigned char>	Data;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// RecordedEvent Struct
+/// 	The pointers of CombatData point into the struct and the string table of the reader.
+///----------------------------------------------------------------------------------------------------
+struct RecordedEvent
+{
+	ERecordType			Type;
+	long long			Time;			/* microseconds since the start of the recording */
+
+	/* Combat */
+	ECombatStream		Stream;
+	EvCombatData		CombatData;
+	ArcDPS::CombatEvent	Event;
+	ArcDPS::AgentShort	Source;
+	ArcDPS::AgentShort	Destination;
+
+	/* Frame */
+	bool				HasSample;
+	MumbleSample		Sample;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// Recording Namespace
+///----------------------------------------------------------------------------------------------------
+namespace Recording
+{
+	///----------------------------------------------------------------------------------------------------
+	/// WriteHeader:
+	/// 	Writes the file header.
+	///----------------------------------------------------------------------------------------------------
+	bool WriteHeader(std::ostream& aStream, int64_t aTimestamp);
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteBlock:
+	/// 	Compresses and writes the block. Returns the amount of bytes written, or 0 on failure.
+	///----------------------------------------------------------------------------------------------------
+	size_t WriteBlock(std::ostream& aStream, const RecordingBlock& aBlock);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CRecordingEncoder Class
+/// 	Appends records to an uncompressed block. Not thread-safe.
+///----------------------------------------------------------------------------------------------------
+class CRecordingEncoder
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// Combat:
+	/// 	Appends a combat event and the strings it uses for the first time.
+	///----------------------------------------------------------------------------------------------------
+	void Combat(long long aTime, ECombatStream aStream, const EvCombatData* aCombatData);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Frame:
+	/// 	Appends a frame, aSample is nullptr if the MumbleLink was not updated.
+	///----------------------------------------------------------------------------------------------------
+	void Frame(long long aTime, const MumbleSample* aSample);
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsFull:
+	/// 	Returns true if the block reached RC_BLOCK_SIZE and should be taken.
+	///----------------------------------------------------------------------------------------------------
+	bool IsFull() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// TakeBlock:
+	/// 	Moves the records into aOutBlock and starts a new block. The strings stay defined.
+	///----------------------------------------------------------------------------------------------------
+	void TakeBlock(RecordingBlock& aOutBlock);
+
+private:
+	RecordingBlock								Block{};
+	long long									PreviousTime	= 0;
+	std::unordered_map<std::string, uint32_t>	Strings;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Begin:
+	/// 	Appends the type and the time of a record.
+	///----------------------------------------------------------------------------------------------------
+	void Begin(ERecordType aType, long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// String:
+	/// 	Returns the index of the string, defining it first if it is new. 0 is nullptr.
+	///----------------------------------------------------------------------------------------------------
+	uint32_t String(const char* aString);
+
+	void Agent(const ArcDPS::AgentShort* aAgent, uint32_t aNameIndex);
+	void Bytes(const void* aData, size_t aSize);
+	void Varint(uint64_t aValue);
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CRecordingReader Class
+///----------------------------------------------------------------------------------------------------
+class CRecordingReader
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// Open:
+	/// 	Opens the recording and reads the header. Returns false if it is not a recording.
+	///----------------------------------------------------------------------------------------------------
+	bool Open(const std::filesystem::path& aPath);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Next:
+	/// 	Returns the next event, valid until the next call. Returns nullptr at the end or if corrupt.
+	///----------------------------------------------------------------------------------------------------
+	const RecordedEvent* Next();
+
+	///----------------------------------------------------------------------------------------------------
+	/// IsCorrupt:
+	/// 	Returns true if Next stopped because of malformed data.
+	///----------------------------------------------------------------------------------------------------
+	bool IsCorrupt() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTimestamp:
+	/// 	Returns the unix time the recording started at.
+	///----------------------------------------------------------------------------------------------------
+	int64_t GetTimestamp() const;
+
+private:
+	std::ifstream				File;
+	RecordingHeader				Header{};
+	bool						Corrupt			= false;
+
+	std::vector<unsigned char>	Compressed;
+	std::vector<unsigned char>	Block;
+	size_t						Position		= 0;
+	uint32_t					Remaining		= 0;	/* records left in the block */
+	long long					PreviousTime	= 0;
+
+	std::deque<std::string>		Strings;		/* a deque, the agents point into it */
+	RecordedEvent				Current{};
+
+	///----------------------------------------------------------------------------------------------------
+	/// ReadBlock:
+	/// 	Reads and decompresses the next block. Returns false at the end or if corrupt.
+	///----------------------------------------------------------------------------------------------------
+	bool ReadBlock();
+
+	char* GetString(uint64_t aIndex);
+	bool Agent(ArcDPS::AgentShort* aOutAgent);
+	bool Bytes(void* aOut, size_t aSize);
+	bool Varint(uint64_t& aOutValue);
+};
+
+#endif
@@ -37,6 +37,11 @@ const char* OPT_ALWAYSSHOWQUICKACCESS		= "AlwaysShowQuickAccess";
 const char* OPT_GLOBALSCALE					= "GlobalScale";
 const char* OPT_SHOWADDONSWINDOWAFTERDUU	= "ShowAddonsWindowAfterDisableUntilUpdate";
 const char* OPT_USERFONT					= "UserFont";
+const char* OPT_WATCHDOGTHRESHOLD			= "WatchdogThreshold";
+const char* OPT_RENDERBUDGET				= "RenderBudget";
+const char* OPT_RENDERBUDGETADDON			= "RenderBudgetAddon";
+const char* OPT_RENDERBUDGETTOTAL			= "RenderBudgetTotal";
+const char* OPT_COMBATSTATS					= "CombatStats";
 
 namespace Settings
 {
@@ -36,6 +36,11 @@ extern const char* OPT_ALWAYSSHOWQUICKACCESS;
 extern const char* OPT_GLOBALSCALE;
 extern const char* OPT_SHOWADDONSWINDOWAFTERDUU;
 extern const char* OPT_USERFONT;
+extern const char* OPT_WATCHDOGTHRESHOLD;
+extern const char* OPT_RENDERBUDGET;
+extern const char* OPT_RENDERBUDGETADDON;
+extern const char* OPT_RENDERBUDGETTOTAL;
+extern const char* OPT_COMBATSTATS;
 
 ///----------------------------------------------------------------------------------------------------
 /// Settings Namespace
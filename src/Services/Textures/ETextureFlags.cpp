@@ -0,0 +1,27 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ETextureFlags.cpp
+/// Description  :  Contains the ETextureFlags enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "ETextureFlags.h"
+
+#include <type_traits>
+
+ETextureFlags operator|(ETextureFlags lhs, ETextureFlags rhs)
+{
+	return static_cast<ETextureFlags>(
+		std::underlying_type_t<ETextureFlags>(lhs) |
+		std::underlying_type_t<ETextureFlags>(rhs)
+		);
+}
+
+ETextureFlags operator&(ETextureFlags lhs, ETextureFlags rhs)
+{
+	return static_cast<ETextureFlags>(
+		std::underlying_type_t<ETextureFlags>(lhs) &
+		std::underlying_type_t<ETextureFlags>(rhs)
+		);
+}
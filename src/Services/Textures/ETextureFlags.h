@@ -0,0 +1,26 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ETextureFlags.h
+/// Description  :  Contains the ETextureFlags enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef ETEXTUREFLAGS_H
+#define ETEXTUREFLAGS_H
+
+///----------------------------------------------------------------------------------------------------
+/// ETextureFlags Enumeration
+///----------------------------------------------------------------------------------------------------
+enum class ETextureFlags
+{
+	None			= 0,
+	GenerateMips	= 1 << 0,	/* generates a mip chain, improves quality when drawing large images small */
+	Compress		= 1 << 1	/* encodes the texture as BC3, only applies if the dimensions are a multiple of 4 */
+};
+
+ETextureFlags operator|(ETextureFlags lhs, ETextureFlags rhs);
+
+ETextureFlags operator&(ETextureFlags lhs, ETextureFlags rhs);
+
+#endif
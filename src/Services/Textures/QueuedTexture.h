@@ -10,8 +10,10 @@
 #define QUEUEDTEXTURE_H
 
 #include <string>
+#include <vector>
 
 #include "FuncDefs.h"
+#include "TextureLevel.h"
 
 ///----------------------------------------------------------------------------------------------------
 /// QueuedTexture data struct
@@ -23,6 +25,8 @@ struct QueuedTexture
 	std::string Identifier;
 	unsigned char* Data;
 	TEXTURES_RECEIVECALLBACK Callback;
+	std::vector<TextureLevel> Levels;	/* if set, Data was already processed into these */
+	bool IsCompressed;
 };
 
 #endif
@@ -0,0 +1,25 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureLevel.h
+/// Description  :  Contains the TextureLevel data struct definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef TEXTURELEVEL_H
+#define TEXTURELEVEL_H
+
+#include <vector>
+
+///----------------------------------------------------------------------------------------------------
+/// TextureLevel data struct
+///----------------------------------------------------------------------------------------------------
+struct TextureLevel
+{
+	unsigned					Width;
+	unsigned					Height;
+	unsigned					Pitch;	/* bytes per row of pixels, or per row of 4x4 blocks if compressed */
+	std::vector<unsigned char>	Data;
+};
+
+#endif
@@ -0,0 +1,23 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureLoadOptions.h
+/// Description  :  Contains the TextureLoadOptions data struct definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef TEXTURELOADOPTIONS_H
+#define TEXTURELOADOPTIONS_H
+
+#include "ETextureFlags.h"
+
+///----------------------------------------------------------------------------------------------------
+/// TextureLoadOptions data struct
+///----------------------------------------------------------------------------------------------------
+struct TextureLoadOptions
+{
+	ETextureFlags	Flags;
+	unsigned		MipLevels;	/* maximum amount of mip levels including the base level, 0 = full chain */
+};
+
+#endif
@@ -18,6 +18,8 @@
 #include "Index.h"
 #include "Renderer.h"
 
+#include "TextureProcessor.h"
+
 /* For some reason this has to be defined AND included here. */
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
@@ -30,6 +32,11 @@ namespace TextureLoader
 		return TextureService->Get(aIdentifier);
 	}
 
+	Texture* const* ADDONAPI_GetHandle(const char* aIdentifier)
+	{
+		return TextureService->GetHandle(aIdentifier);
+	}
+
 	Texture* ADDONAPI_GetOrCreateFromFile(const char* aIdentifier, const char* aFilename)
 	{
 		return TextureService->GetOrCreate(aIdentifier, aFilename);
@@ -69,33 +76,55 @@ namespace TextureLoader
 	{
 		TextureService->Load(aIdentifier, aData, aSize, aCallback, true);
 	}
+
+	void ADDONAPI_LoadFromFile2(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions)
+	{
+		TextureService->Load(aIdentifier, aFilename, aCallback, true, aOptions ? *aOptions : TextureLoadOptions{});
+	}
+
+	void ADDONAPI_LoadFromResource2(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions)
+	{
+		TextureService->Load(aIdentifier, aResourceID, aModule, aCallback, true, aOptions ? *aOptions : TextureLoadOptions{});
+	}
+
+	void ADDONAPI_LoadFromURL2(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions)
+	{
+		TextureService->Load(aIdentifier, aRemote, aEndpoint, aCallback, true, aOptions ? *aOptions : TextureLoadOptions{});
+	}
+
+	void ADDONAPI_LoadFromMemory2(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions)
+	{
+		TextureService->Load(aIdentifier, aData, aSize, aCallback, true, aOptions ? *aOptions : TextureLoadOptions{});
+	}
 }
 
+/* handles are exposed to addons as plain pointers to the slot */
+static_assert(sizeof(std::atomic<Texture*>) == sizeof(Texture*), "Texture slot must be layout compatible with Texture*.");
+static_assert(std::atomic<Texture*>::is_always_lock_free, "Texture slot must be lock-free.");
+
 void CTextureLoader::Advance()
 {
 	const std::lock_guard<std::mutex> lock(Mutex);
-	while (this->QueuedTextures.size() > 0)
+	for (QueuedTexture& qtex : this->QueuedTextures)
 	{
-		this->CreateTexture(this->QueuedTextures.front());
-		this->QueuedTextures.erase(this->QueuedTextures.begin());
+		this->QueuedIdentifiers.erase(qtex.Identifier);
+		this->CreateTexture(std::move(qtex));
 	}
+	this->QueuedTextures.clear();
 }
 
 Texture* CTextureLoader::Get(const char* aIdentifier)
 {
-	std::string str = aIdentifier;
+	std::atomic<Texture*>* slot = this->Registry.Find(aIdentifier);
 
-	Texture* result = nullptr;
+	return slot ? slot->load(std::memory_order_acquire) : nullptr;
+}
 
-	{
-		const std::lock_guard<std::mutex> lock(Mutex);
-		if (this->Registry.find(str) != this->Registry.end())
-		{
-			result = this->Registry[str];
-		}
-	}
+Texture* const* CTextureLoader::GetHandle(const char* aIdentifier)
+{
+	std::atomic<Texture*>* slot = this->Registry.FindOrInsert(aIdentifier);
 
-	return result;
+	return reinterpret_cast<Texture* const*>(slot);
 }
 
 Texture* CTextureLoader::GetOrCreate(const char* aIdentifier, const char* aFilename)
@@ -162,7 +191,7 @@ Texture* CTextureLoader::GetOrCreate(const char* aIdentifier, void* aData, size_
 	return result;
 }
 
-void CTextureLoader::Load(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing)
+void CTextureLoader::Load(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing, TextureLoadOptions aOptions)
 {
 	//Logger->Info(CH_TEXTURES, "this->LoadFromFile(aIdentifier: %s, aFilename: %s, aCallback: %p)", aIdentifier, aFilename, aCallback);
 
@@ -177,7 +206,7 @@ void CTextureLoader::Load(const char* aIdentifier, const char* aFilename, TEXTUR
 		}
 		return;
 	}
-	else if (this->OverrideTexture(aIdentifier, aCallback))
+	else if (this->OverrideTexture(aIdentifier, aCallback, aOptions))
 	{
 		return;
 	}
@@ -193,10 +222,10 @@ void CTextureLoader::Load(const char* aIdentifier, const char* aFilename, TEXTUR
 	int image_height = 0;
 	unsigned char* image_data = stbi_load(aFilename, &image_width, &image_height, NULL, 4);
 
-	this->QueueTexture(aIdentifier, image_data, image_width, image_height, aCallback);
+	this->QueueTexture(aIdentifier, image_data, image_width, image_height, aCallback, aOptions);
 }
 
-void CTextureLoader::Load(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing)
+void CTextureLoader::Load(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing, TextureLoadOptions aOptions)
 {
 	//Logger->Info(CH_TEXTURES, "this->LoadFromResource(aIdentifier: %s, aResourceID: %u, aModule: %p, aCallback: %p)", aIdentifier, aResourceID, aModule, aCallback);
 
@@ -211,7 +240,7 @@ void CTextureLoader::Load(const char* aIdentifier, unsigned aResourceID, HMODULE
 		}
 		return;
 	}
-	else if (this->OverrideTexture(aIdentifier, aCallback))
+	else if (this->OverrideTexture(aIdentifier, aCallback, aOptions))
 	{
 		return;
 	}
@@ -249,10 +278,10 @@ void CTextureLoader::Load(const char* aIdentifier, unsigned aResourceID, HMODULE
 	int image_components = 0;
 	unsigned char* image_data = stbi_load_from_memory((const stbi_uc*)imageFile, imageFileSize, &image_width, &image_height, &image_components, 4);
 
-	this->QueueTexture(str.c_str(), image_data, image_width, image_height, aCallback);
+	this->QueueTexture(str.c_str(), image_data, image_width, image_height, aCallback, aOptions);
 }
 
-void CTextureLoader::Load(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing)
+void CTextureLoader::Load(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing, TextureLoadOptions aOptions)
 {
 	//Logger->Info(CH_TEXTURES, "this->LoadFromURL(aIdentifier: %s, aRemote: %s, aEndpoint: %s, aCallback: %p)", aIdentifier, aRemote, aEndpoint, aCallback);
 
@@ -267,7 +296,7 @@ void CTextureLoader::Load(const char* aIdentifier, const char* aRemote, const ch
 		}
 		return;
 	}
-	else if (this->OverrideTexture(aIdentifier, aCallback))
+	else if (this->OverrideTexture(aIdentifier, aCallback, aOptions))
 	{
 		return;
 	}
@@ -275,7 +304,7 @@ void CTextureLoader::Load(const char* aIdentifier, const char* aRemote, const ch
 	std::string remote = aRemote;
 	std::string endpoint = aEndpoint;
 
-	std::thread([this, str, remote, endpoint, aCallback]() {
+	std::thread([this, str, remote, endpoint, aCallback, aOptions]() {
 		httplib::Client client(remote);
 		client.enable_server_certificate_verification(false);
 		auto result = client.Get(endpoint);
@@ -305,11 +334,11 @@ void CTextureLoader::Load(const char* aIdentifier, const char* aRemote, const ch
 
 		delete[] remote_data;
 
-		this->QueueTexture(str.c_str(), data, image_width, image_height, aCallback);
+		this->QueueTexture(str.c_str(), data, image_width, image_height, aCallback, aOptions);
 	}).detach();
 }
 
-void CTextureLoader::Load(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing)
+void CTextureLoader::Load(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing, TextureLoadOptions aOptions)
 {
 	//Logger->Info(CH_TEXTURES, "this->LoadFromMemory(aIdentifier: %s, aData: %p, aSize: %u, aCallback: %p)", aIdentifier, aData, aSize, aCallback);
 
@@ -324,7 +353,7 @@ void CTextureLoader::Load(const char* aIdentifier, void* aData, size_t aSize, TE
 		}
 		return;
 	}
-	else if (this->OverrideTexture(aIdentifier, aCallback))
+	else if (this->OverrideTexture(aIdentifier, aCallback, aOptions))
 	{
 		return;
 	}
@@ -334,14 +363,23 @@ void CTextureLoader::Load(const char* aIdentifier, void* aData, size_t aSize, TE
 	int image_components = 0;
 	unsigned char* image_data = stbi_load_from_memory((const stbi_uc*)aData, static_cast<int>(aSize), &image_width, &image_height, &image_components, 4);
 
-	this->QueueTexture(str.c_str(), image_data, image_width, image_height, aCallback);
+	this->QueueTexture(str.c_str(), image_data, image_width, image_height, aCallback, aOptions);
 }
 
 std::map<std::string, Texture*> CTextureLoader::GetRegistry() const
 {
-	const std::lock_guard<std::mutex> lock(this->Mutex);
+	std::map<std::string, Texture*> registry;
 
-	return this->Registry;
+	this->Registry.ForEach([&registry](const std::string& aIdentifier, const std::atomic<Texture*>& aSlot)
+	{
+		Texture* tex = aSlot.load(std::memory_order_acquire);
+		if (tex)
+		{
+			registry[aIdentifier] = tex;
+		}
+	});
+
+	return registry;
 }
 
 std::vector<QueuedTexture> CTextureLoader::GetQueuedTextures() const
@@ -369,7 +407,7 @@ int CTextureLoader::Verify(void* aStartAddress, void* aEndAddress)
 	return refCounter;
 }
 
-bool CTextureLoader::OverrideTexture(const char* aIdentifier, TEXTURES_RECEIVECALLBACK aCallback)
+bool CTextureLoader::OverrideTexture(const char* aIdentifier, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions aOptions)
 {
 	std::string file = aIdentifier;
 	file.append(".png");
@@ -382,24 +420,22 @@ bool CTextureLoader::OverrideTexture(const char* aIdentifier, TEXTURES_RECEIVECA
 		int image_height = 0;
 		unsigned char* image_data = stbi_load(customPath.string().c_str(), &image_width, &image_height, NULL, 4);
 
-		this->QueueTexture(aIdentifier, image_data, image_width, image_height, aCallback);
+		this->QueueTexture(aIdentifier, image_data, image_width, image_height, aCallback, aOptions);
 		return true;
 	}
 	return false;
 }
 
-void CTextureLoader::QueueTexture(const char* aIdentifier, unsigned char* aImageData, unsigned aWidth, unsigned aHeight, TEXTURES_RECEIVECALLBACK aCallback)
+void CTextureLoader::QueueTexture(const char* aIdentifier, unsigned char* aImageData, unsigned aWidth, unsigned aHeight, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions aOptions)
 {
 	std::string str = aIdentifier;
 
 	{
 		const std::lock_guard<std::mutex> lock(this->Mutex);
-		for (QueuedTexture& tex : this->QueuedTextures)
+		if (!this->QueuedIdentifiers.insert(str).second)
 		{
-			if (tex.Identifier == str)
-			{
-				return;
-			}
+			stbi_image_free(aImageData);
+			return;
 		}
 	}
 
@@ -412,9 +448,34 @@ void CTextureLoader::QueueTexture(const char* aIdentifier, unsigned char* aImage
 	raw.Height = aHeight;
 	raw.Callback = aCallback;
 
+	if (aImageData && aOptions.Flags != ETextureFlags::None)
+	{
+		bool mips = (aOptions.Flags & ETextureFlags::GenerateMips) == ETextureFlags::GenerateMips;
+		bool compress = (aOptions.Flags & ETextureFlags::Compress) == ETextureFlags::Compress;
+
+		raw.Levels = TextureProcessor::GenerateMips(aImageData, aWidth, aHeight, mips ? aOptions.MipLevels : 1);
+
+		if (compress && TextureProcessor::CanCompress(aWidth, aHeight))
+		{
+			for (TextureLevel& level : raw.Levels)
+			{
+				level = TextureProcessor::CompressBC3(level);
+			}
+			raw.IsCompressed = true;
+		}
+		else if (compress)
+		{
+			Logger->Debug(CH_TEXTURES, "Cannot compress %s, dimensions %ux%u are not a multiple of 4.", str.c_str(), aWidth, aHeight);
+		}
+
+		/* the raw image is no longer needed, the levels hold a copy */
+		stbi_image_free(aImageData);
+		raw.Data = nullptr;
+	}
+
 	{
 		const std::lock_guard<std::mutex> lock(this->Mutex);
-		this->QueuedTextures.push_back(raw);
+		this->QueuedTextures.push_back(std::move(raw));
 	}
 }
 
@@ -431,20 +492,32 @@ void CTextureLoader::CreateTexture(QueuedTexture aQueuedTexture)
 	ZeroMemory(&desc, sizeof(desc));
 	desc.Width = aQueuedTexture.Width;
 	desc.Height = aQueuedTexture.Height;
-	desc.MipLevels = 1;
+	desc.MipLevels = aQueuedTexture.Levels.size() > 0 ? static_cast<UINT>(aQueuedTexture.Levels.size()) : 1;
 	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.Format = aQueuedTexture.IsCompressed ? DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
 	desc.SampleDesc.Count = 1;
 	desc.Usage = D3D11_USAGE_DEFAULT;
 	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 	desc.CPUAccessFlags = 0;
 
 	ID3D11Texture2D* pTexture = NULL;
-	D3D11_SUBRESOURCE_DATA subResource{};
-	subResource.pSysMem = aQueuedTexture.Data;
-	subResource.SysMemPitch = desc.Width * 4;
-	subResource.SysMemSlicePitch = 0;
-	Renderer::Device->CreateTexture2D(&desc, &subResource, &pTexture);
+	std::vector<D3D11_SUBRESOURCE_DATA> subResources(desc.MipLevels);
+	if (aQueuedTexture.Levels.size() > 0)
+	{
+		for (size_t i = 0; i < aQueuedTexture.Levels.size(); i++)
+		{
+			subResources[i].pSysMem = aQueuedTexture.Levels[i].Data.data();
+			subResources[i].SysMemPitch = aQueuedTexture.Levels[i].Pitch;
+			subResources[i].SysMemSlicePitch = 0;
+		}
+	}
+	else
+	{
+		subResources[0].pSysMem = aQueuedTexture.Data;
+		subResources[0].SysMemPitch = desc.Width * 4;
+		subResources[0].SysMemSlicePitch = 0;
+	}
+	Renderer::Device->CreateTexture2D(&desc, subResources.data(), &pTexture);
 
 	if (!pTexture)
 	{
@@ -456,7 +529,7 @@ void CTextureLoader::CreateTexture(QueuedTexture aQueuedTexture)
 	// Create texture view
 	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
 	ZeroMemory(&srvDesc, sizeof(srvDesc));
-	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	srvDesc.Format = desc.Format;
 	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Texture2D.MipLevels = desc.MipLevels;
 	srvDesc.Texture2D.MostDetailedMip = 0;
@@ -464,7 +537,7 @@ void CTextureLoader::CreateTexture(QueuedTexture aQueuedTexture)
 	Renderer::Device->CreateShaderResourceView(pTexture, &srvDesc, &tex->Resource);
 	pTexture->Release();
 
-	this->Registry[aQueuedTexture.Identifier] = tex;
+	this->Registry.FindOrInsert(aQueuedTexture.Identifier.c_str())->store(tex, std::memory_order_release);
 	if (aQueuedTexture.Callback)
 	{
 		aQueuedTexture.Callback(aQueuedTexture.Identifier.c_str(), tex);
@@ -10,16 +10,21 @@
 #define TEXTURELOADER_H
 
 #include <Windows.h>
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "FuncDefs.h"
 
 #include "Texture.h"
+#include "TextureLoadOptions.h"
 #include "QueuedTexture.h"
 
+#include "Util/ConcurrentMap.h"
+
 constexpr const char* CH_TEXTURES = "Textures";
 
 ///----------------------------------------------------------------------------------------------------
@@ -33,6 +38,12 @@ namespace TextureLoader
 	///----------------------------------------------------------------------------------------------------
 	Texture* ADDONAPI_Get(const char* aIdentifier);
 
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_GetHandle:
+	/// 	Addon API wrapper function for GetHandle.
+	///----------------------------------------------------------------------------------------------------
+	Texture* const* ADDONAPI_GetHandle(const char* aIdentifier);
+
 	///----------------------------------------------------------------------------------------------------
 	/// ADDONAPI_GetOrCreateFromFile:
 	/// 	Addon API wrapper function for GetOrCreate from file.
@@ -80,6 +91,30 @@ namespace TextureLoader
 	/// 	Addon API wrapper function for LoadFromMemory.
 	///----------------------------------------------------------------------------------------------------
 	void ADDONAPI_LoadFromMemory(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_LoadFromFile2:
+	/// 	Addon API wrapper function for LoadFromFile with load options.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_LoadFromFile2(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_LoadFromResource2:
+	/// 	Addon API wrapper function for LoadFromResource with load options.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_LoadFromResource2(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_LoadFromURL2:
+	/// 	Addon API wrapper function for LoadFromURL with load options.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_LoadFromURL2(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions);
+
+	///----------------------------------------------------------------------------------------------------
+	/// ADDONAPI_LoadFromMemory2:
+	/// 	Addon API wrapper function for LoadFromMemory with load options.
+	///----------------------------------------------------------------------------------------------------
+	void ADDONAPI_LoadFromMemory2(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions* aOptions);
 }
 
 ///----------------------------------------------------------------------------------------------------
@@ -109,6 +144,14 @@ public:
 	///----------------------------------------------------------------------------------------------------
 	Texture* Get(const char* aIdentifier);
 
+	///----------------------------------------------------------------------------------------------------
+	/// GetHandle:
+	/// 	Returns a stable slot for the texture with the given identifier, creating an empty one if needed.
+	/// 	The slot holds nullptr until the texture is created and stays valid until shutdown,
+	/// 	so per-frame callers can resolve it once instead of calling Get every frame.
+	///----------------------------------------------------------------------------------------------------
+	Texture* const* GetHandle(const char* aIdentifier);
+
 	///----------------------------------------------------------------------------------------------------
 	/// GetOrCreate:
 	/// 	Returns a Texture* with the given identifier or creates it from file path.
@@ -137,29 +180,29 @@ public:
 	/// Load:
 	/// 	Requests to load a texture from file and returns to the given callback.
 	///----------------------------------------------------------------------------------------------------
-	void Load(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false);
+	void Load(const char* aIdentifier, const char* aFilename, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// Load:
 	/// 	Requests to load a texture from an embedded resource and returns to the given callback.
 	///----------------------------------------------------------------------------------------------------
-	void Load(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false);
+	void Load(const char* aIdentifier, unsigned aResourceID, HMODULE aModule, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// Load:
 	/// 	Requests to load a texture from remote URL and returns to the given callback.
 	///----------------------------------------------------------------------------------------------------
-	void Load(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false);
+	void Load(const char* aIdentifier, const char* aRemote, const char* aEndpoint, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// Load:
 	/// 	Requests to load a texture from memory and returns to the given callback.
 	///----------------------------------------------------------------------------------------------------
-	void Load(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false);
+	void Load(const char* aIdentifier, void* aData, size_t aSize, TEXTURES_RECEIVECALLBACK aCallback, bool aIsShadowing = false, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// GetRegistry:
-	/// 	Returns a copy of the registry.
+	/// 	Returns a copy of the registry. Slots without a created texture are omitted.
 	///----------------------------------------------------------------------------------------------------
 	std::map<std::string, Texture*> GetRegistry() const;
 
@@ -176,21 +219,23 @@ public:
 	int Verify(void* aStartAddress, void* aEndAddress);
 
 private:
-	mutable std::mutex				Mutex;
-	std::map<std::string, Texture*>	Registry;
-	std::vector<QueuedTexture>		QueuedTextures;
+	mutable std::mutex							Mutex;
+	CConcurrentMap<std::atomic<Texture*>>		Registry;
+	std::vector<QueuedTexture>					QueuedTextures;
+	std::unordered_set<std::string>				QueuedIdentifiers;
 
 	///----------------------------------------------------------------------------------------------------
 	/// OverrideTexture:
 	/// 	Internal function to override texture load with custom user texture on disk.
 	///----------------------------------------------------------------------------------------------------
-	bool OverrideTexture(const char* aIdentifier, TEXTURES_RECEIVECALLBACK aCallback);
+	bool OverrideTexture(const char* aIdentifier, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// QueueTexture:
 	/// 	Pushes a texture into the queue to load during the next frame.
+	/// 	Mips and compression are done here, on the thread that decoded the image.
 	///----------------------------------------------------------------------------------------------------
-	void QueueTexture(const char* aIdentifier, unsigned char* aImageData, unsigned aWidth, unsigned aHeight, TEXTURES_RECEIVECALLBACK aCallback);
+	void QueueTexture(const char* aIdentifier, unsigned char* aImageData, unsigned aWidth, unsigned aHeight, TEXTURES_RECEIVECALLBACK aCallback, TextureLoadOptions aOptions = {});
 
 	///----------------------------------------------------------------------------------------------------
 	/// CreateTexture:
@@ -0,0 +1,412 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureProcessor.cpp
+/// Description  :  Provides CPU-side mip generation and block compression for RGBA textures.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "TextureProcessor.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace TextureProcessor
+{
+	unsigned GetMipCount(unsigned aWidth, unsigned aHeight)
+	{
+		unsigned count = 1;
+		unsigned size = (std::max)(aWidth, aHeight);
+
+		while (size > 1)
+		{
+			size >>= 1;
+			count++;
+		}
+
+		return count;
+	}
+
+	void Downsample(const unsigned char* aSource, unsigned aWidth, unsigned aHeight, unsigned char* aDestination)
+	{
+		unsigned dstWidth = (std::max)(1u, aWidth / 2);
+		unsigned dstHeight = (std::max)(1u, aHeight / 2);
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(2);
+
+		for (unsigned y = 0; y < dstHeight; y++)
+		{
+			/* clamp rows for images that are only a single pixel high */
+			const unsigned char* row0 = aSource + (size_t)(std::min)(y * 2, aHeight - 1) * aWidth * 4;
+			const unsigned char* row1 = aSource + (size_t)(std::min)(y * 2 + 1, aHeight - 1) * aWidth * 4;
+			unsigned char* dst = aDestination + (size_t)y * dstWidth * 4;
+
+			unsigned x = 0;
+
+			/* 4 source pixels of both rows -> 2 destination pixels */
+			for (; x + 2 <= dstWidth && (x + 2) * 2 <= aWidth; x += 2)
+			{
+				__m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+				__m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+				/* add the horizontal neighbour, the sum ends up in the lower 64 bits */
+				lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+				hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+				__m128i sum = _mm_unpacklo_epi64(lo, hi);
+				sum = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+
+				_mm_storel_epi64((__m128i*)(dst + x * 4), _mm_packus_epi16(sum, zero));
+			}
+
+			/* remainder and odd widths, columns are clamped like the rows */
+			for (; x < dstWidth; x++)
+			{
+				unsigned x0 = (std::min)(x * 2, aWidth - 1) * 4;
+				unsigned x1 = (std::min)(x * 2 + 1, aWidth - 1) * 4;
+
+				for (unsigned c = 0; c < 4; c++)
+				{
+					unsigned sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					dst[x * 4 + c] = static_cast<unsigned char>((sum + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	std::vector<TextureLevel> GenerateMips(const unsigned char* aData, unsigned aWidth, unsigned aHeight, unsigned aMaxLevels)
+	{
+		std::vector<TextureLevel> levels;
+
+		if (!aData || aWidth == 0 || aHeight == 0) { return levels; }
+
+		unsigned count = GetMipCount(aWidth, aHeight);
+		if (aMaxLevels != 0 && aMaxLevels < count)
+		{
+			count = aMaxLevels;
+		}
+
+		levels.reserve(count);
+
+		TextureLevel base{};
+		base.Width = aWidth;
+		base.Height = aHeight;
+		base.Pitch = aWidth * 4;
+		base.Data.assign(aData, aData + (size_t)aWidth * aHeight * 4);
+		levels.push_back(std::move(base));
+
+		while (levels.size() < count)
+		{
+			const TextureLevel& prev = levels.back();
+
+			TextureLevel next{};
+			next.Width = (std::max)(1u, prev.Width / 2);
+			next.Height = (std::max)(1u, prev.Height / 2);
+			next.Pitch = next.Width * 4;
+			next.Data.resize((size_t)next.Width * next.Height * 4);
+
+			Downsample(prev.Data.data(), prev.Width, prev.Height, next.Data.data());
+
+			levels.push_back(std::move(next));
+		}
+
+		return levels;
+	}
+
+	bool CanCompress(unsigned aWidth, unsigned aHeight)
+	{
+		/* D3D11 requires the base level of block compressed textures to be a multiple of 4 */
+		return aWidth != 0 && aHeight != 0 && aWidth % 4 == 0 && aHeight % 4 == 0;
+	}
+
+	static unsigned short PackRGB565(const unsigned char* aColor)
+	{
+		return static_cast<unsigned short>(((aColor[0] >> 3) << 11) | ((aColor[1] >> 2) << 5) | (aColor[2] >> 3));
+	}
+
+	static void UnpackRGB565(unsigned short aColor, unsigned char* aOut)
+	{
+		unsigned r = (aColor >> 11) & 31;
+		unsigned g = (aColor >> 5) & 63;
+		unsigned b = aColor & 31;
+
+		aOut[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+		aOut[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+		aOut[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+		aOut[3] = 255;
+	}
+
+	static void EncodeAlphaBlock(const unsigned char* aBlock, unsigned char* aOut)
+	{
+		unsigned char minA = 255;
+		unsigned char maxA = 0;
+
+		for (unsigned i = 0; i < 16; i++)
+		{
+			minA = (std::min)(minA, aBlock[i * 4 + 3]);
+			maxA = (std::max)(maxA, aBlock[i * 4 + 3]);
+		}
+
+		aOut[0] = maxA;
+		aOut[1] = minA;
+		std::memset(aOut + 2, 0, 6);
+
+		if (maxA == minA) { return; }
+
+		/* 8 alpha mode: a0, a1, then 6 interpolated values from a0 to a1 */
+		unsigned char palette[8];
+		palette[0] = maxA;
+		palette[1] = minA;
+		for (unsigned i = 1; i < 7; i++)
+		{
+			palette[i + 1] = static_cast<unsigned char>(((7 - i) * maxA + i * minA + 3) / 7);
+		}
+
+		unsigned long long bits = 0;
+		for (unsigned i = 0; i < 16; i++)
+		{
+			int a = aBlock[i * 4 + 3];
+			unsigned best = 0;
+			int bestDist = 256;
+
+			for (unsigned p = 0; p < 8; p++)
+			{
+				int dist = std::abs(a - palette[p]);
+				if (dist < bestDist)
+				{
+					bestDist = dist;
+					best = p;
+				}
+			}
+
+			bits |= (unsigned long long)best << (i * 3);
+		}
+
+		for (unsigned i = 0; i < 6; i++)
+		{
+			aOut[2 + i] = static_cast<unsigned char>(bits >> (i * 8));
+		}
+	}
+
+	static void EncodeColorBlock(const unsigned char* aBlock, unsigned char* aOut)
+	{
+		int minC[3] = { 255, 255, 255 };
+		int maxC[3] = { 0, 0, 0 };
+		int mean[3] = { 0, 0, 0 };
+
+		for (unsigned i = 0; i < 16; i++)
+		{
+			for (unsigned c = 0; c < 3; c++)
+			{
+				minC[c] = (std::min)(minC[c], (int)aBlock[i * 4 + c]);
+				maxC[c] = (std::max)(maxC[c], (int)aBlock[i * 4 + c]);
+				mean[c] += aBlock[i * 4 + c];
+			}
+		}
+
+		/* pick the bounding box diagonal that follows the colors, using green as reference axis */
+		int covRG = 0;
+		int covBG = 0;
+		for (unsigned i = 0; i < 16; i++)
+		{
+			int r = aBlock[i * 4 + 0] * 16 - mean[0];
+			int g = aBlock[i * 4 + 1] * 16 - mean[1];
+			int b = aBlock[i * 4 + 2] * 16 - mean[2];
+			covRG += r * g;
+			covBG += b * g;
+		}
+		if (covRG < 0) { std::swap(minC[0], maxC[0]); }
+		if (covBG < 0) { std::swap(minC[2], maxC[2]); }
+
+		/* inset the box by 1/16th to reduce the error on the end points */
+		unsigned char endpoints[2][4];
+		for (unsigned c = 0; c < 3; c++)
+		{
+			int inset = (maxC[c] - minC[c]) / 16;
+			endpoints[0][c] = static_cast<unsigned char>((std::clamp)(maxC[c] - inset, 0, 255));
+			endpoints[1][c] = static_cast<unsigned char>((std::clamp)(minC[c] + inset, 0, 255));
+		}
+
+		unsigned short c0 = PackRGB565(endpoints[0]);
+		unsigned short c1 = PackRGB565(endpoints[1]);
+
+		/* c0 > c1 selects the 4 color mode, BC3 always uses it but decoders may not */
+		if (c0 < c1) { std::swap(c0, c1); }
+
+		aOut[0] = static_cast<unsigned char>(c0);
+		aOut[1] = static_cast<unsigned char>(c0 >> 8);
+		aOut[2] = static_cast<unsigned char>(c1);
+		aOut[3] = static_cast<unsigned char>(c1 >> 8);
+		std::memset(aOut + 4, 0, 4);
+
+		if (c0 == c1) { return; }
+
+		unsigned char palette[4][4];
+		UnpackRGB565(c0, palette[0]);
+		UnpackRGB565(c1, palette[1]);
+		for (unsigned c = 0; c < 3; c++)
+		{
+			palette[2][c] = static_cast<unsigned char>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+			palette[3][c] = static_cast<unsigned char>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+		}
+
+		unsigned bits = 0;
+		for (unsigned i = 0; i < 16; i++)
+		{
+			unsigned best = 0;
+			int bestDist = INT_MAX;
+
+			for (unsigned p = 0; p < 4; p++)
+			{
+				int dr = aBlock[i * 4 + 0] - palette[p][0];
+				int dg = aBlock[i * 4 + 1] - palette[p][1];
+				int db = aBlock[i * 4 + 2] - palette[p][2];
+				int dist = dr * dr + dg * dg + db * db;
+
+				if (dist < bestDist)
+				{
+					bestDist = dist;
+					best = p;
+				}
+			}
+
+			bits |= best << (i * 2);
+		}
+
+		aOut[4] = static_cast<unsigned char>(bits);
+		aOut[5] = static_cast<unsigned char>(bits >> 8);
+		aOut[6] = static_cast<unsigned char>(bits >> 16);
+		aOut[7] = static_cast<unsigned char>(bits >> 24);
+	}
+
+	TextureLevel CompressBC3(const TextureLevel& aLevel)
+	{
+		unsigned blocksX = (std::max)(1u, (aLevel.Width + 3) / 4);
+		unsigned blocksY = (std::max)(1u, (aLevel.Height + 3) / 4);
+
+		TextureLevel result{};
+		result.Width = aLevel.Width;
+		result.Height = aLevel.Height;
+		result.Pitch = blocksX * 16;
+		result.Data.resize((size_t)result.Pitch * blocksY);
+
+		unsigned char block[16 * 4];
+
+		for (unsigned by = 0; by < blocksY; by++)
+		{
+			for (unsigned bx = 0; bx < blocksX; bx++)
+			{
+				/* gather the block, clamping at the edges of small mip levels */
+				for (unsigned y = 0; y < 4; y++)
+				{
+					unsigned sy = (std::min)(by * 4 + y, aLevel.Height - 1);
+					for (unsigned x = 0; x < 4; x++)
+					{
+						unsigned sx = (std::min)(bx * 4 + x, aLevel.Width - 1);
+						std::memcpy(&block[(y * 4 + x) * 4], &aLevel.Data[(size_t)sy * aLevel.Pitch + sx * 4], 4);
+					}
+				}
+
+				unsigned char* out = &result.Data[(size_t)by * result.Pitch + bx * 16];
+				EncodeAlphaBlock(block, out);
+				EncodeColorBlock(block, out + 8);
+			}
+		}
+
+		return result;
+	}
+
+	TextureLevel DecompressBC3(const TextureLevel& aLevel)
+	{
+		unsigned blocksX = (std::max)(1u, (aLevel.Width + 3) / 4);
+		unsigned blocksY = (std::max)(1u, (aLevel.Height + 3) / 4);
+
+		TextureLevel result{};
+		result.Width = aLevel.Width;
+		result.Height = aLevel.Height;
+		result.Pitch = aLevel.Width * 4;
+		result.Data.resize((size_t)result.Pitch * aLevel.Height);
+
+		for (unsigned by = 0; by < blocksY; by++)
+		{
+			for (unsigned bx = 0; bx < blocksX; bx++)
+			{
+				const unsigned char* in = &aLevel.Data[(size_t)by * aLevel.Pitch + bx * 16];
+
+				unsigned char alpha[8];
+				alpha[0] = in[0];
+				alpha[1] = in[1];
+				for (unsigned i = 1; i < 7; i++)
+				{
+					alpha[i + 1] = in[0] > in[1]
+						? static_cast<unsigned char>(((7 - i) * in[0] + i * in[1] + 3) / 7)
+						: static_cast<unsigned char>(i < 5 ? ((5 - i) * in[0] + i * in[1] + 2) / 5 : (i == 5 ? 0 : 255));
+				}
+
+				unsigned long long alphaBits = 0;
+				for (unsigned i = 0; i < 6; i++)
+				{
+					alphaBits |= (unsigned long long)in[2 + i] << (i * 8);
+				}
+
+				unsigned short c0 = static_cast<unsigned short>(in[8] | (in[9] << 8));
+				unsigned short c1 = static_cast<unsigned short>(in[10] | (in[11] << 8));
+				unsigned colorBits = in[12] | (in[13] << 8) | (in[14] << 16) | ((unsigned)in[15] << 24);
+
+				unsigned char palette[4][4];
+				UnpackRGB565(c0, palette[0]);
+				UnpackRGB565(c1, palette[1]);
+				for (unsigned c = 0; c < 3; c++)
+				{
+					palette[2][c] = static_cast<unsigned char>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+					palette[3][c] = static_cast<unsigned char>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+				}
+
+				for (unsigned i = 0; i < 16; i++)
+				{
+					unsigned x = bx * 4 + (i % 4);
+					unsigned y = by * 4 + (i / 4);
+					if (x >= aLevel.Width || y >= aLevel.Height) { continue; }
+
+					unsigned char* px = &result.Data[(size_t)y * result.Pitch + x * 4];
+					const unsigned char* color = palette[(colorBits >> (i * 2)) & 3];
+					px[0] = color[0];
+					px[1] = color[1];
+					px[2] = color[2];
+					px[3] = alpha[(alphaBits >> (i * 3)) & 7];
+				}
+			}
+		}
+
+		return result;
+	}
+
+	double GetPSNR(const TextureLevel& aReference, const TextureLevel& aLevel)
+	{
+		if (aReference.Width != aLevel.Width || aReference.Height != aLevel.Height) { return 0.0; }
+
+		double sum = 0.0;
+		size_t samples = (size_t)aReference.Width * aReference.Height * 4;
+
+		for (unsigned y = 0; y < aReference.Height; y++)
+		{
+			for (unsigned x = 0; x < aReference.Width * 4; x++)
+			{
+				double diff = (double)aReference.Data[(size_t)y * aReference.Pitch + x] - (double)aLevel.Data[(size_t)y * aLevel.Pitch + x];
+				sum += diff * diff;
+			}
+		}
+
+		if (sum == 0.0 || samples == 0) { return INFINITY; }
+
+		double mse = sum / (double)samples;
+		return 10.0 * std::log10((255.0 * 255.0) / mse);
+	}
+}
@@ -0,0 +1,66 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  TextureProcessor.h
+/// Description  :  Provides CPU-side mip generation and block compression for RGBA textures.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef TEXTUREPROCESSOR_H
+#define TEXTUREPROCESSOR_H
+
+#include <vector>
+
+#include "TextureLevel.h"
+
+///----------------------------------------------------------------------------------------------------
+/// TextureProcessor Namespace
+/// 	Does not depend on D3D, so it can run on any thread (and any platform).
+///----------------------------------------------------------------------------------------------------
+namespace TextureProcessor
+{
+	///----------------------------------------------------------------------------------------------------
+	/// GetMipCount:
+	/// 	Returns the amount of levels of a full mip chain for the given dimensions.
+	///----------------------------------------------------------------------------------------------------
+	unsigned GetMipCount(unsigned aWidth, unsigned aHeight);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Downsample:
+	/// 	Box filters an RGBA image to half its size into aDestination.
+	/// 	aDestination must hold max(1, w/2) * max(1, h/2) pixels.
+	///----------------------------------------------------------------------------------------------------
+	void Downsample(const unsigned char* aSource, unsigned aWidth, unsigned aHeight, unsigned char* aDestination);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GenerateMips:
+	/// 	Returns the base level and its mip chain, limited to aMaxLevels. 0 = full chain.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<TextureLevel> GenerateMips(const unsigned char* aData, unsigned aWidth, unsigned aHeight, unsigned aMaxLevels);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CanCompress:
+	/// 	Returns true if a texture of the given dimensions can be block compressed.
+	///----------------------------------------------------------------------------------------------------
+	bool CanCompress(unsigned aWidth, unsigned aHeight);
+
+	///----------------------------------------------------------------------------------------------------
+	/// CompressBC3:
+	/// 	Encodes an uncompressed RGBA level as BC3.
+	///----------------------------------------------------------------------------------------------------
+	TextureLevel CompressBC3(const TextureLevel& aLevel);
+
+	///----------------------------------------------------------------------------------------------------
+	/// DecompressBC3:
+	/// 	Decodes a BC3 level back to RGBA. Used to measure the encoding quality.
+	///----------------------------------------------------------------------------------------------------
+	TextureLevel DecompressBC3(const TextureLevel& aLevel);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetPSNR:
+	/// 	Returns the peak signal-to-noise ratio in dB between two RGBA levels of equal size.
+	///----------------------------------------------------------------------------------------------------
+	double GetPSNR(const TextureLevel& aReference, const TextureLevel& aLevel);
+}
+
+#endif
@@ -0,0 +1,49 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CallbackTiming.h
+/// Description  :  CallbackTiming and CallbackTimingInfo struct definitions.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef CALLBACKTIMING_H
+#define CALLBACKTIMING_H
+
+#include <atomic>
+
+#include "ECallbackType.h"
+
+/* bucket i counts calls below 2^i microseconds, the last one everything above */
+constexpr unsigned CW_HISTOGRAM_BUCKETS = 16;
+
+///----------------------------------------------------------------------------------------------------
+/// CallbackTiming Struct
+/// 	A slot is claimed once by setting Callback and never released.
+///----------------------------------------------------------------------------------------------------
+struct CallbackTiming
+{
+	std::atomic<void*>				Callback{ nullptr };
+	std::atomic<unsigned long long>	Calls{ 0 };
+	std::atomic<long long>			TotalTime{ 0 };			/* nanoseconds */
+	std::atomic<long long>			MaxTime{ 0 };			/* nanoseconds */
+	std::atomic<unsigned long long>	Exceeded{ 0 };			/* calls above the threshold */
+	std::atomic<long long>			LastReported{ 0 };		/* nanoseconds, rate limits the log */
+	std::atomic<unsigned long long>	Histogram[CW_HISTOGRAM_BUCKETS]{};
+};
+
+///----------------------------------------------------------------------------------------------------
+/// CallbackTimingInfo Struct
+/// 	Copy of a CallbackTiming.
+///----------------------------------------------------------------------------------------------------
+struct CallbackTimingInfo
+{
+	ECallbackType					Type;
+	void*							Callback;
+	unsigned long long				Calls;
+	long long						TotalTime;				/* nanoseconds */
+	long long						MaxTime;				/* nanoseconds */
+	unsigned long long				Exceeded;
+	unsigned long long				Histogram[CW_HISTOGRAM_BUCKETS];
+};
+
+#endif
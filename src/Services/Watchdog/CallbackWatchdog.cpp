@@ -0,0 +1,188 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CallbackWatchdog.cpp
+/// Description  :  Records the execution time of addon callbacks and reports slow ones.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "CallbackWatchdog.h"
+
+#include <cstdint>
+
+#include "Loader/Loader.h"
+
+CCallbackWatchdog::CCallbackWatchdog(CLogHandler* aLogger)
+{
+	this->Logger = aLogger;
+}
+
+void CCallbackWatchdog::Record(ECallbackType aType, void* aCallback, long long aTime)
+{
+	CallbackTiming* timing = this->FindSlot(aType, aCallback);
+
+	if (!timing)
+	{
+		this->Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	timing->Calls.fetch_add(1, std::memory_order_relaxed);
+	timing->TotalTime.fetch_add(aTime, std::memory_order_relaxed);
+
+	long long max = timing->MaxTime.load(std::memory_order_relaxed);
+	while (aTime > max && !timing->MaxTime.compare_exchange_weak(max, aTime, std::memory_order_relaxed)) {}
+
+	/* bucket by the bit length of the microseconds */
+	unsigned long long us = aTime > 0 ? static_cast<unsigned long long>(aTime) / 1000 : 0;
+	unsigned bucket = 0;
+	while (us && bucket < CW_HISTOGRAM_BUCKETS - 1)
+	{
+		us >>= 1;
+		bucket++;
+	}
+	timing->Histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+	if (aTime > this->Threshold.load(std::memory_order_relaxed))
+	{
+		timing->Exceeded.fetch_add(1, std::memory_order_relaxed);
+
+		long long now = CCallbackWatchdog::Now();
+		long long last = timing->LastReported.load(std::memory_order_relaxed);
+
+		/* only one thread wins the report for this interval */
+		if ((last == 0 || now - last >= CW_REPORT_INTERVAL) &&
+			timing->LastReported.compare_exchange_strong(last, now, std::memory_order_relaxed))
+		{
+			this->Report(aType, aCallback, aTime);
+		}
+	}
+}
+
+void CCallbackWatchdog::SetThreshold(long long aThreshold)
+{
+	this->Threshold = aThreshold > 0 ? aThreshold : CW_DEFAULT_THRESHOLD;
+}
+
+long long CCallbackWatchdog::GetThreshold() const
+{
+	return this->Threshold;
+}
+
+void CCallbackWatchdog::Reset(void* aStartAddress, void* aEndAddress)
+{
+	for (auto& slots : this->Slots)
+	{
+		for (CallbackTiming& timing : slots)
+		{
+			void* callback = timing.Callback.load();
+
+			if (!callback || callback < aStartAddress || callback > aEndAddress)
+			{
+				continue;
+			}
+
+			/* the slot stays claimed, a reloaded addon might get the same address */
+			timing.Calls = 0;
+			timing.TotalTime = 0;
+			timing.MaxTime = 0;
+			timing.Exceeded = 0;
+			timing.LastReported = 0;
+			for (std::atomic<unsigned long long>& bucket : timing.Histogram)
+			{
+				bucket = 0;
+			}
+		}
+	}
+}
+
+std::vector<CallbackTimingInfo> CCallbackWatchdog::GetTimings() const
+{
+	std::vector<CallbackTimingInfo> timings;
+
+	for (size_t type = 0; type < (size_t)ECallbackType::COUNT; type++)
+	{
+		for (const CallbackTiming& timing : this->Slots[type])
+		{
+			void* callback = timing.Callback.load();
+
+			if (!callback || timing.Calls.load() == 0) { continue; }
+
+			CallbackTimingInfo info{};
+			info.Type = (ECallbackType)type;
+			info.Callback = callback;
+			info.Calls = timing.Calls.load();
+			info.TotalTime = timing.TotalTime.load();
+			info.MaxTime = timing.MaxTime.load();
+			info.Exceeded = timing.Exceeded.load();
+			for (unsigned i = 0; i < CW_HISTOGRAM_BUCKETS; i++)
+			{
+				info.Histogram[i] = timing.Histogram[i].load();
+			}
+
+			timings.push_back(info);
+		}
+	}
+
+	return timings;
+}
+
+unsigned long long CCallbackWatchdog::GetDropped() const
+{
+	return this->Dropped;
+}
+
+const char* CCallbackWatchdog::GetTypeName(ECallbackType aType)
+{
+	switch (aType)
+	{
+		case ECallbackType::WndProc:		return "WndProc";
+		case ECallbackType::PreRender:		return "PreRender";
+		case ECallbackType::Render:			return "Render";
+		case ECallbackType::PostRender:		return "PostRender";
+		case ECallbackType::OptionsRender:	return "OptionsRender";
+		case ECallbackType::Event:			return "Event";
+	}
+
+	return "(null)";
+}
+
+CallbackTiming* CCallbackWatchdog::FindSlot(ECallbackType aType, void* aCallback)
+{
+	CallbackTiming* slots = this->Slots[(size_t)aType];
+
+	/* fibonacci hash of the address, probe linearly */
+	size_t index = static_cast<size_t>((reinterpret_cast<uintptr_t>(aCallback) * 0x9E3779B97F4A7C15ull) >> 32) & (CW_SLOTS - 1);
+
+	for (unsigned i = 0; i < CW_SLOTS; i++)
+	{
+		CallbackTiming& timing = slots[(index + i) & (CW_SLOTS - 1)];
+		void* callback = timing.Callback.load(std::memory_order_acquire);
+
+		if (callback == aCallback)
+		{
+			return &timing;
+		}
+
+		if (callback == nullptr)
+		{
+			void* expected = nullptr;
+			if (timing.Callback.compare_exchange_strong(expected, aCallback, std::memory_order_acq_rel) || expected == aCallback)
+			{
+				return &timing;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void CCallbackWatchdog::Report(ECallbackType aType, void* aCallback, long long aTime)
+{
+	this->Logger->Warning(CH_WATCHDOG, "%s callback %p of \"%s\" took %.2fms. (Threshold: %.2fms)",
+		CCallbackWatchdog::GetTypeName(aType),
+		aCallback,
+		Loader::GetOwner(aCallback).c_str(),
+		aTime / 1000000.0,
+		this->Threshold.load() / 1000000.0);
+}
@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  CallbackWatchdog.h
+/// Description  :  Records the execution time of addon callbacks and reports slow ones.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef CALLBACKWATCHDOG_H
+#define CALLBACKWATCHDOG_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "CallbackTiming.h"
+#include "ECallbackType.h"
+#include "Services/Logging/LogHandler.h"
+
+constexpr const char* CH_WATCHDOG = "Watchdog";
+
+constexpr unsigned	CW_SLOTS				= 256;			/* per callback type, power of two */
+constexpr long long	CW_DEFAULT_THRESHOLD	= 10000000;		/* nanoseconds */
+constexpr long long	CW_REPORT_INTERVAL		= 10000000000;	/* nanoseconds between two reports of the same callback */
+
+///----------------------------------------------------------------------------------------------------
+/// CCallbackWatchdog Class
+/// 	Recording is lock-free and allocation-free.
+///----------------------------------------------------------------------------------------------------
+class CCallbackWatchdog
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CCallbackWatchdog(CLogHandler* aLogger);
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CCallbackWatchdog() = default;
+
+	CCallbackWatchdog(const CCallbackWatchdog&) = delete;
+	CCallbackWatchdog& operator=(const CCallbackWatchdog&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Now:
+	/// 	Returns a timestamp in nanoseconds.
+	///----------------------------------------------------------------------------------------------------
+	static inline long long Now()
+	{
+		return std::chrono::high_resolution_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Record:
+	/// 	Records one call of a callback that took aTime nanoseconds.
+	/// 	Calls above the threshold are logged with the owning addon, at most once per interval.
+	///----------------------------------------------------------------------------------------------------
+	void Record(ECallbackType aType, void* aCallback, long long aTime);
+
+	///----------------------------------------------------------------------------------------------------
+	/// SetThreshold:
+	/// 	Sets the threshold in nanoseconds.
+	///----------------------------------------------------------------------------------------------------
+	void SetThreshold(long long aThreshold);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetThreshold:
+	/// 	Returns the threshold in nanoseconds.
+	///----------------------------------------------------------------------------------------------------
+	long long GetThreshold() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Reset:
+	/// 	Clears the timings of all callbacks within the provided address space.
+	///----------------------------------------------------------------------------------------------------
+	void Reset(void* aStartAddress, void* aEndAddress);
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTimings:
+	/// 	Returns a copy of all recorded timings.
+	///----------------------------------------------------------------------------------------------------
+	std::vector<CallbackTimingInfo> GetTimings() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetDropped:
+	/// 	Returns the amount of calls that could not be recorded, because all slots were taken.
+	///----------------------------------------------------------------------------------------------------
+	unsigned long long GetDropped() const;
+
+	///----------------------------------------------------------------------------------------------------
+	/// GetTypeName:
+	/// 	Returns the display name of a callback type.
+	///----------------------------------------------------------------------------------------------------
+	static const char* GetTypeName(ECallbackType aType);
+
+private:
+	CLogHandler*						Logger;
+
+	std::atomic<long long>				Threshold{ CW_DEFAULT_THRESHOLD };
+	std::atomic<unsigned long long>		Dropped{ 0 };
+
+	CallbackTiming						Slots[(size_t)ECallbackType::COUNT][CW_SLOTS];
+
+	///----------------------------------------------------------------------------------------------------
+	/// FindSlot:
+	/// 	Returns the slot of a callback, claims a free one if it has none yet.
+	///----------------------------------------------------------------------------------------------------
+	CallbackTiming* FindSlot(ECallbackType aType, void* aCallback);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Report:
+	/// 	Logs a call above the threshold.
+	///----------------------------------------------------------------------------------------------------
+	void Report(ECallbackType aType, void* aCallback, long long aTime);
+};
+
+#endif
@@ -0,0 +1,26 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ECallbackType.h
+/// Description  :  ECallbackType enum definition.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef ECALLBACKTYPE_H
+#define ECALLBACKTYPE_H
+
+///----------------------------------------------------------------------------------------------------
+/// ECallbackType Enum
+///----------------------------------------------------------------------------------------------------
+typedef enum class ECallbackType
+{
+	WndProc,
+	PreRender,
+	Render,
+	PostRender,
+	OptionsRender,
+	Event,
+	COUNT
+} ECBType;
+
+#endif
@@ -18,9 +18,13 @@ CUpdater*					UpdateService		= new CUpdater();
 CTextureLoader*				TextureService		= new CTextureLoader();
 CDataLink*					DataLinkService		= new CDataLink();
 CEventApi*					EventApi			= new CEventApi();
+CCombatBatchApi*			CombatBatchApi		= new CCombatBatchApi();
+CCombatRecorder*			CombatRecorder		= new CCombatRecorder();
+CCombatStats*				CombatStatsEngine	= nullptr;
 CRawInputApi*				RawInputApi			= new CRawInputApi();
 CInputBindApi*				InputBindApi		= nullptr; //new CInputBindApi();
 CGameBindsApi*				GameBindsApi		= nullptr; //new CGameBindsApi();
+CCallbackWatchdog*			CallbackWatchdog	= new CCallbackWatchdog(Logger);
 
 ImFont*						MonospaceFont		= nullptr;
 ImFont*						UserFont			= nullptr;
@@ -12,7 +12,11 @@
 #include "Services/Updater/Updater.h"
 #include "Services/Textures/TextureLoader.h"
 #include "Services/DataLink/DataLink.h"
+#include "Services/CombatStats/CombatStats.h"
+#include "Services/Recorder/Recorder.h"
+#include "Services/Watchdog/CallbackWatchdog.h"
 #include "Events/EventHandler.h"
+#include "Events/CombatBatchApi.h"
 #include "Inputs/RawInput/RawInputApi.h"
 #include "Inputs/InputBinds/InputBindHandler.h"
 #include "Inputs/GameBinds/GameBindsHandler.h"
@@ -36,9 +40,13 @@ extern CUpdater*					UpdateService;
 extern CTextureLoader*				TextureService;
 extern CDataLink*					DataLinkService;
 extern CEventApi*					EventApi;
+extern CCombatBatchApi*				CombatBatchApi;
+extern CCombatRecorder*				CombatRecorder;
+extern CCombatStats*				CombatStatsEngine;
 extern CRawInputApi*				RawInputApi;
 extern CInputBindApi*				InputBindApi;
 extern CGameBindsApi*				GameBindsApi;
+extern CCallbackWatchdog*			CallbackWatchdog;
 
 extern ImFont*						MonospaceFont;	/* default/monospace/console font */
 extern ImFont*						UserFont;		/* custom user font */
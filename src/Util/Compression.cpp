@@ -0,0 +1,200 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Compression.cpp
+/// Description  :  Contains a fast LZ77 block compression.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#include "Compression.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	constexpr size_t MIN_MATCH		= 4;
+	constexpr size_t MAX_OFFSET		= 65535;
+	constexpr unsigned HASH_BITS	= 12;
+
+	uint32_t Read32(const unsigned char* aPtr)
+	{
+		uint32_t value;
+		memcpy(&value, aPtr, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t aValue)
+	{
+		return (aValue * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	unsigned char* WriteLength(unsigned char* aOut, size_t aLength)
+	{
+		while (aLength >= 255)
+		{
+			*aOut++ = 255;
+			aLength -= 255;
+		}
+
+		*aOut++ = static_cast<unsigned char>(aLength);
+		return aOut;
+	}
+
+	bool ReadLength(const unsigned char*& aIn, const unsigned char* aEnd, size_t& aLength)
+	{
+		unsigned char byte;
+
+		do
+		{
+			if (aIn >= aEnd) { return false; }
+
+			byte = *aIn++;
+			aLength += byte;
+		} while (byte == 255);
+
+		return true;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// WriteSequence:
+	/// 	Writes the literals and the match. A match length of 0 ends the block.
+	///----------------------------------------------------------------------------------------------------
+	unsigned char* WriteSequence(unsigned char* aOut, const unsigned char* aLiterals, size_t aLiteralLength, size_t aOffset, size_t aMatchLength)
+	{
+		unsigned char* token = aOut++;
+
+		size_t matchCode = aMatchLength ? aMatchLength - MIN_MATCH : 0;
+
+		*token = static_cast<unsigned char>(((aLiteralLength < 15 ? aLiteralLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+
+		if (aLiteralLength >= 15) { aOut = WriteLength(aOut, aLiteralLength - 15); }
+
+		if (aLiteralLength)
+		{
+			memcpy(aOut, aLiterals, aLiteralLength);
+			aOut += aLiteralLength;
+		}
+
+		if (aMatchLength)
+		{
+			*aOut++ = static_cast<unsigned char>(aOffset & 0xFF);
+			*aOut++ = static_cast<unsigned char>(aOffset >> 8);
+
+			if (matchCode >= 15) { aOut = WriteLength(aOut, matchCode - 15); }
+		}
+
+		return aOut;
+	}
+}
+
+namespace Compression
+{
+	size_t GetBound(size_t aSize)
+	{
+		return aSize + aSize / 255 + 16;
+	}
+
+	size_t Compress(const void* aSrc, size_t aSize, void* aDst)
+	{
+		const unsigned char* in = static_cast<const unsigned char*>(aSrc);
+		unsigned char* out = static_cast<unsigned char*>(aDst);
+
+		uint32_t table[1 << HASH_BITS] = {};
+
+		size_t anchor = 0;
+		size_t pos = 0;
+
+		while (pos + MIN_MATCH <= aSize)
+		{
+			uint32_t value = Read32(in + pos);
+			uint32_t& entry = table[Hash(value)];
+			size_t candidate = entry;
+			entry = static_cast<uint32_t>(pos);
+
+			if (candidate < pos && pos - candidate <= MAX_OFFSET && Read32(in + candidate) == value)
+			{
+				size_t length = MIN_MATCH;
+
+				while (pos + length < aSize && in[candidate + length] == in[pos + length])
+				{
+					length++;
+				}
+
+				out = WriteSequence(out, in + anchor, pos - anchor, pos - candidate, length);
+
+				pos += length;
+				anchor = pos;
+
+				/* the position before the next one is likely to start a match again */
+				if (pos + 2 <= aSize)
+				{
+					table[Hash(Read32(in + pos - 2))] = static_cast<uint32_t>(pos - 2);
+				}
+			}
+			else
+			{
+				/* skip faster through data that does not compress */
+				pos += 1 + ((pos - anchor) >> 6);
+			}
+		}
+
+		out = WriteSequence(out, in + anchor, aSize - anchor, 0, 0);
+
+		return static_cast<size_t>(out - static_cast<unsigned char*>(aDst));
+	}
+
+	size_t Decompress(const void* aSrc, size_t aSize, void* aDst, size_t aDstSize)
+	{
+		const unsigned char* in = static_cast<const unsigned char*>(aSrc);
+		const unsigned char* end = in + aSize;
+		unsigned char* dst = static_cast<unsigned char*>(aDst);
+		unsigned char* out = dst;
+		unsigned char* outEnd = dst + aDstSize;
+
+		while (in < end)
+		{
+			unsigned char token = *in++;
+
+			size_t literalLength = token >> 4;
+
+			if (literalLength == 15 && !ReadLength(in, end, literalLength)) { return 0; }
+
+			if (literalLength > static_cast<size_t>(end - in) || literalLength > static_cast<size_t>(outEnd - out)) { return 0; }
+
+			memcpy(out, in, literalLength);
+			in += literalLength;
+			out += literalLength;
+
+			/* the last sequence has no match */
+			if (in == end) { break; }
+
+			if (end - in < 2) { return 0; }
+
+			size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+
+			if (offset == 0 || offset > static_cast<size_t>(out - dst)) { return 0; }
+
+			size_t matchLength = token & 15;
+
+			if (matchLength == 15 && !ReadLength(in, end, matchLength)) { return 0; }
+
+			matchLength += MIN_MATCH;
+
+			if (matchLength > static_cast<size_t>(outEnd - out)) { return 0; }
+
+			/* byte by byte, the match may overlap the output */
+			const unsigned char* match = out - offset;
+
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				out[i] = match[i];
+			}
+
+			out += matchLength;
+		}
+
+		return static_cast<size_t>(out - dst);
+	}
+}
@@ -0,0 +1,42 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  Compression.h
+/// Description  :  Contains a fast LZ77 block compression.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cstddef>
+
+///----------------------------------------------------------------------------------------------------
+/// Compression Namespace
+/// 	Sequences of a token, literals and a match, like the LZ4 block format.
+/// 	Trades ratio for speed, a block of 64 KiB compresses in well under a millisecond.
+///----------------------------------------------------------------------------------------------------
+namespace Compression
+{
+	///----------------------------------------------------------------------------------------------------
+	/// GetBound:
+	/// 	Returns the size a compressed block of aSize bytes can take at most.
+	///----------------------------------------------------------------------------------------------------
+	size_t GetBound(size_t aSize);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Compress:
+	/// 	Compresses aSize bytes into aDst, which has to hold GetBound(aSize) bytes.
+	/// 	Returns the compressed size.
+	///----------------------------------------------------------------------------------------------------
+	size_t Compress(const void* aSrc, size_t aSize, void* aDst);
+
+	///----------------------------------------------------------------------------------------------------
+	/// Decompress:
+	/// 	Decompresses a block into aDst, which holds aDstSize bytes.
+	/// 	Returns the decompressed size, or 0 if the block is malformed or does not fit.
+	///----------------------------------------------------------------------------------------------------
+	size_t Decompress(const void* aSrc, size_t aSize, void* aDst, size_t aDstSize);
+}
+
+#endif
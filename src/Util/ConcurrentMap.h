@@ -0,0 +1,228 @@
+///----------------------------------------------------------------------------------------------------
+/// Copyright (c) Raidcore.GG - All rights reserved.
+///
+/// Name         :  ConcurrentMap.h
+/// Description  :  Insert-only string keyed hash map with wait-free lookups.
+/// Authors      :  K. Bieniek
+///----------------------------------------------------------------------------------------------------
+
+#ifndef CONCURRENTMAP_H
+#define CONCURRENTMAP_H
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+///----------------------------------------------------------------------------------------------------
+/// CConcurrentMap Class
+/// 	Entries are never removed, so a returned T* stays valid for the lifetime of the map.
+/// 	Lookups never lock, inserts are serialized.
+///----------------------------------------------------------------------------------------------------
+template <typename T>
+class CConcurrentMap
+{
+public:
+	///----------------------------------------------------------------------------------------------------
+	/// ctor
+	///----------------------------------------------------------------------------------------------------
+	CConcurrentMap(size_t aCapacity = 64)
+	{
+		size_t capacity = 8;
+		while (capacity < aCapacity) { capacity <<= 1; }
+
+		this->Current.store(new Table(capacity), std::memory_order_relaxed);
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// dtor
+	///----------------------------------------------------------------------------------------------------
+	~CConcurrentMap()
+	{
+		for (Node* node : this->Nodes)
+		{
+			delete node;
+		}
+
+		for (Table* table : this->Retired)
+		{
+			delete table;
+		}
+
+		delete this->Current.load(std::memory_order_relaxed);
+	}
+
+	CConcurrentMap(const CConcurrentMap&) = delete;
+	CConcurrentMap& operator=(const CConcurrentMap&) = delete;
+
+	///----------------------------------------------------------------------------------------------------
+	/// Hash:
+	/// 	Returns the FNV-1a hash of a string.
+	///----------------------------------------------------------------------------------------------------
+	static unsigned long long Hash(const char* aKey, size_t aLength)
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < aLength; i++)
+		{
+			hash ^= static_cast<unsigned char>(aKey[i]);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Find:
+	/// 	Returns a pointer to the value with the given key or nullptr. Wait-free.
+	///----------------------------------------------------------------------------------------------------
+	T* Find(const char* aKey) const
+	{
+		if (!aKey) { return nullptr; }
+
+		size_t length = std::strlen(aKey);
+		unsigned long long hash = Hash(aKey, length);
+
+		const Table* table = this->Current.load(std::memory_order_acquire);
+		size_t mask = table->Capacity - 1;
+
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			Node* node = table->Buckets[i].load(std::memory_order_acquire);
+
+			if (!node) { return nullptr; }
+
+			if (node->Hash == hash && node->Key.length() == length && std::memcmp(node->Key.c_str(), aKey, length) == 0)
+			{
+				return &node->Value;
+			}
+		}
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// FindOrInsert:
+	/// 	Returns a pointer to the value with the given key, inserts a value initialized one if needed.
+	///----------------------------------------------------------------------------------------------------
+	T* FindOrInsert(const char* aKey, bool* aOutInserted = nullptr)
+	{
+		if (aOutInserted) { *aOutInserted = false; }
+
+		if (!aKey) { return nullptr; }
+
+		if (T* existing = this->Find(aKey))
+		{
+			return existing;
+		}
+
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		/* could have been inserted while waiting for the lock */
+		if (T* existing = this->Find(aKey))
+		{
+			return existing;
+		}
+
+		Node* node = new Node{};
+		node->Key = aKey;
+		node->Hash = Hash(node->Key.c_str(), node->Key.length());
+
+		Table* table = this->Current.load(std::memory_order_relaxed);
+
+		/* keep the load factor at or below 1/2 */
+		if ((this->Nodes.size() + 1) * 2 > table->Capacity)
+		{
+			Table* grown = new Table(table->Capacity * 2);
+			for (Node* existing : this->Nodes)
+			{
+				grown->Insert(existing);
+			}
+
+			this->Current.store(grown, std::memory_order_release);
+
+			/* readers may still be probing the old table, it is released with the map */
+			this->Retired.push_back(table);
+			table = grown;
+		}
+
+		table->Insert(node);
+		this->Nodes.push_back(node);
+
+		if (aOutInserted) { *aOutInserted = true; }
+
+		return &node->Value;
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// Count:
+	/// 	Returns the amount of entries.
+	///----------------------------------------------------------------------------------------------------
+	size_t Count() const
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		return this->Nodes.size();
+	}
+
+	///----------------------------------------------------------------------------------------------------
+	/// ForEach:
+	/// 	Invokes aFunc(const std::string& aKey, T& aValue) for every entry in insertion order.
+	///----------------------------------------------------------------------------------------------------
+	template <typename F>
+	void ForEach(F aFunc) const
+	{
+		const std::lock_guard<std::mutex> lock(this->Mutex);
+
+		for (Node* node : this->Nodes)
+		{
+			aFunc(node->Key, node->Value);
+		}
+	}
+
+private:
+	struct Node
+	{
+		unsigned long long	Hash;
+		std::string			Key;
+		T					Value;
+	};
+
+	struct Table
+	{
+		size_t					Capacity;
+		std::atomic<Node*>*		Buckets;
+
+		Table(size_t aCapacity)
+			: Capacity(aCapacity)
+			, Buckets(new std::atomic<Node*>[aCapacity])
+		{
+			for (size_t i = 0; i < aCapacity; i++)
+			{
+				this->Buckets[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		~Table()
+		{
+			delete[] this->Buckets;
+		}
+
+		void Insert(Node* aNode)
+		{
+			size_t mask = this->Capacity - 1;
+			for (size_t i = aNode->Hash & mask;; i = (i + 1) & mask)
+			{
+				if (!this->Buckets[i].load(std::memory_order_relaxed))
+				{
+					this->Buckets[i].store(aNode, std::memory_order_release);
+					return;
+				}
+			}
+		}
+	};
+
+	mutable std::mutex		Mutex;
+	std::atomic<Table*>		Current;
+	std::vector<Table*>		Retired;
+	std::vector<Node*>		Nodes;
+};
+
+#endif